@@ -0,0 +1,69 @@
+// Tests that an aggregation which would otherwise scan the whole collection reads only the fields
+// it depends on from a columnstore index, and that the documents it reassembles match those of a
+// collection scan.
+//
+// Relies on the initial $match being pushed into the query system, and on the collection not being
+// sharded, since a column scan cannot filter out orphans.
+// @tags: [assumes_unsharded_collection, do_not_wrap_aggregations_in_facets]
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");  // For 'aggPlanHasStage' and other explain helpers.
+
+const coll = db.use_column_scan;
+coll.drop();
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 100; ++i) {
+    bulk.insert({_id: i, x: "string" + i, a: -i, y: i % 2, big: "z".repeat(100)});
+}
+assert.writeOK(bulk.execute());
+assert.commandWorked(coll.createIndex({x: "columnstore", a: "columnstore", y: "columnstore"}));
+
+function usesColumnScan(pipeline) {
+    const explainOutput = coll.explain().aggregate(pipeline);
+    return isQueryPlan(explainOutput) ? planHasStage(db, explainOutput, "COLUMN_SCAN")
+                                      : aggPlanHasStage(explainOutput, "COLUMN_SCAN");
+}
+
+function sortDocs(docs) {
+    return docs.sort((lhs, rhs) => bsonWoCompare(lhs, rhs));
+}
+
+function assertUsesColumnScan(pipeline) {
+    assert(usesColumnScan(pipeline),
+           "Expected pipeline " + tojsononeline(pipeline) +
+               " to use a column scan: " + tojson(coll.explain().aggregate(pipeline)));
+
+    // Hinting a collection scan keeps the columnstore index out, so it gives the expected results.
+    // The comparison is sensitive to the order of the fields in each document.
+    const expected = sortDocs(coll.aggregate(pipeline, {hint: {$natural: 1}}).toArray());
+    const actual = sortDocs(coll.aggregate(pipeline).toArray());
+    assert.eq(expected.length, actual.length);
+    for (let i = 0; i < expected.length; ++i) {
+        assert.eq(0,
+                  bsonWoCompare(expected[i], actual[i]),
+                  tojson(expected[i]) + " != " + tojson(actual[i]));
+    }
+}
+
+// A $group over filtered documents.
+assertUsesColumnScan([{$match: {y: 1}}, {$group: {_id: "$y", total: {$sum: "$a"}}}]);
+
+// A $project which the query system could push down as a projection on a collection scan.
+assertUsesColumnScan([{$match: {a: {$lt: -50}}}, {$project: {_id: 0, a: 1, x: 1}}]);
+
+// The reassembled documents keep the order the fields were stored in, not the order of the index
+// or of the field names.
+const projected = coll.aggregate([{$match: {a: 0}}, {$project: {_id: 0, y: 1, x: 1, a: 1}}])
+                      .toArray();
+assert.eq(1, projected.length);
+assert.eq(["x", "a", "y"], Object.keys(projected[0]));
+
+// A pipeline which depends on a field the index does not store falls back to the query system.
+assert(!usesColumnScan([{$match: {y: 1}}, {$group: {_id: "$big"}}]));
+
+// So does a pipeline whose $match the query system can answer with an index.
+assert.commandWorked(coll.createIndex({a: 1}));
+assert(!usesColumnScan([{$match: {a: -5}}, {$project: {_id: 0, a: 1, x: 1}}]));
+}());
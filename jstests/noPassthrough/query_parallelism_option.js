@@ -0,0 +1,67 @@
+// Tests the 'parallelism' option of the find and aggregate commands, which sets the number of
+// workers a query may use to scan a collection in place of the server parameters.
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");  // For 'getPlanStage' and 'getAggPlanStage'.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const testDB = conn.getDB("test");
+const coll = testDB.query_parallelism_option;
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 1000; ++i) {
+    bulk.insert({_id: i, a: i, b: i % 10});
+}
+assert.writeOK(bulk.execute());
+
+// Parallel scans are off by default, and the collection must be big enough to be worth splitting.
+assert.commandWorked(
+    testDB.adminCommand({setParameter: 1, internalQueryParallelCollectionScanWorkers: 1}));
+assert.commandWorked(
+    testDB.adminCommand({setParameter: 1, internalQueryParallelCollectionScanMinRecords: 1}));
+
+const filter = {b: {$gte: 5}};
+
+function findPlan(extraOptions) {
+    const explain = assert.commandWorked(testDB.runCommand(
+        {explain: Object.assign({find: coll.getName(), filter: filter}, extraOptions)}));
+    return explain.queryPlanner.winningPlan;
+}
+
+assert.neq(null, getPlanStage(findPlan({}), "COLLSCAN"));
+const parallelScan = getPlanStage(findPlan({parallelism: 4}), "PARALLEL_COLLSCAN");
+assert.neq(null, parallelScan, tojson(findPlan({parallelism: 4})));
+assert.eq(null, getPlanStage(findPlan({parallelism: 1}), "PARALLEL_COLLSCAN"));
+
+const findResult = assert.commandWorked(testDB.runCommand(
+    {find: coll.getName(), filter: filter, parallelism: 4, batchSize: 1000}));
+assert.eq(500, findResult.cursor.firstBatch.length, tojson(findResult));
+
+// The option is validated.
+for (let parallelism of [0, -1, 65]) {
+    assert.commandFailedWithCode(
+        testDB.runCommand({find: coll.getName(), filter: filter, parallelism: parallelism}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        testDB.runCommand(
+            {aggregate: coll.getName(), pipeline: [], cursor: {}, parallelism: parallelism}),
+        ErrorCodes.BadValue);
+}
+
+// An aggregation scans in parallel as well, and its $group aggregates the scanned documents on
+// several threads.
+const pipeline = [{$match: filter}, {$group: {_id: "$b", count: {$sum: 1}, total: {$sum: "$a"}}}];
+const aggExplain = assert.commandWorked(testDB.runCommand(
+    {aggregate: coll.getName(), pipeline: pipeline, explain: true, parallelism: 4}));
+assert.neq(null, getAggPlanStage(aggExplain, "PARALLEL_COLLSCAN"), tojson(aggExplain));
+
+const sortById = (lhs, rhs) => lhs._id - rhs._id;
+const expected = coll.aggregate(pipeline).toArray().sort(sortById);
+assert.eq(5, expected.length, tojson(expected));
+const actual = coll.aggregate(pipeline, {parallelism: 4}).toArray().sort(sortById);
+assert.eq(expected, actual);
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,78 @@
+// Tests that the commands which report on every client, such as serverStatus and lockInfo, work
+// while queries have operations running on the query worker pool. Those operations take no locks of
+// their own and must not be asked for any.
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");  // For 'getPlanStage'.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const testDB = conn.getDB("test");
+const adminDB = conn.getDB("admin");
+const coll = testDB.query_workers_server_status;
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 1000; ++i) {
+    bulk.insert({_id: i, a: i, b: i % 10});
+}
+assert.writeOK(bulk.execute());
+
+function assertReportingCommandsWork() {
+    const serverStatus = assert.commandWorked(adminDB.runCommand({serverStatus: 1}));
+    assert(serverStatus.hasOwnProperty("globalLock"), tojson(serverStatus));
+    assert.commandWorked(adminDB.runCommand({lockInfo: 1}));
+    assert.commandWorked(adminDB.currentOp({$all: true}));
+}
+
+// A parallel collection scan keeps its workers, and their operations, for the life of its cursor.
+assert.commandWorked(
+    adminDB.runCommand({setParameter: 1, internalQueryParallelCollectionScanWorkers: 4}));
+assert.commandWorked(
+    adminDB.runCommand({setParameter: 1, internalQueryParallelCollectionScanMinRecords: 1}));
+
+const explain = coll.find({b: {$gte: 0}}).explain();
+assert.neq(
+    null, getPlanStage(explain.queryPlanner.winningPlan, "PARALLEL_COLLSCAN"), tojson(explain));
+
+const cursor = coll.find({b: {$gte: 0}}).batchSize(2);
+assert(cursor.hasNext());
+assertReportingCommandsWork();
+assert.eq(1000, cursor.itcount());
+assertReportingCommandsWork();
+assert.commandWorked(
+    adminDB.runCommand({setParameter: 1, internalQueryParallelCollectionScanWorkers: 1}));
+
+// Concurrent plan trials only keep their workers for the trial period, so report on every client
+// over and over from another shell while queries are planned.
+assert.commandWorked(
+    adminDB.runCommand({setParameter: 1, internalQueryEnableParallelPlanEvaluation: true}));
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({b: 1}));
+
+const query = {a: {$gte: 0}, b: {$gte: 0}};
+const allPlans = coll.find(query).explain("allPlansExecution").executionStats.allPlansExecution;
+assert.gte(allPlans.length, 2, tojson(allPlans));
+assert(allPlans[0].hasOwnProperty("trialRounds"), tojson(allPlans));
+
+const stopColl = testDB.query_workers_server_status_stop;
+const awaitReporter = startParallelShell(() => {
+    const stopColl = db.getSiblingDB("test").query_workers_server_status_stop;
+    const adminDB = db.getSiblingDB("admin");
+    while (stopColl.findOne() === null) {
+        assert.commandWorked(adminDB.runCommand({serverStatus: 1}));
+        assert.commandWorked(adminDB.runCommand({lockInfo: 1}));
+        assert.commandWorked(adminDB.currentOp({$all: true}));
+    }
+}, conn.port);
+
+for (let i = 0; i < 200; ++i) {
+    // Clear the plan cache so that every query is multi-planned again.
+    assert.commandWorked(coll.runCommand("planCacheClear"));
+    assert.eq(1000, coll.find(query).itcount());
+}
+assert.writeOK(stopColl.insert({}));
+awaitReporter();
+
+MongoRunner.stopMongod(conn);
+}());
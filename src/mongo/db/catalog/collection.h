@@ -218,6 +218,12 @@ public:
 
     virtual bool requiresIdIndex() const = 0;
 
+    /**
+     * Returns true if documents are keyed by their _id in the RecordStore instead of through an
+     * _id index. See clustered_id.h.
+     */
+    virtual bool isClustered() const = 0;
+
     virtual Snapshotted<BSONObj> docFor(OperationContext* const opCtx, RecordId loc) const = 0;
 
     /**
@@ -255,6 +255,11 @@ bool CollectionImpl::requiresIdIndex() const {
         return false;
     }
 
+    if (isClustered()) {
+        // Documents are already keyed by _id in the record store.
+        return false;
+    }
+
     if (_ns.isSystem()) {
         StringData shortName = _ns.coll().substr(_ns.coll().find('.') + 1);
         if (shortName == "indexes" || shortName == "namespaces" || shortName == "profile") {
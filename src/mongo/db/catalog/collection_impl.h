@@ -104,6 +104,10 @@ public:
 
     bool requiresIdIndex() const final;
 
+    bool isClustered() const final {
+        return _recordStore->isClustered();
+    }
+
     Snapshotted<BSONObj> docFor(OperationContext* opCtx, RecordId loc) const final {
         return Snapshotted<BSONObj>(opCtx->recoveryUnit()->getSnapshotId(),
                                     _recordStore->dataFor(opCtx, loc).releaseToBson());
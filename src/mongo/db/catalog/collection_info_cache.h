@@ -30,6 +30,8 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/pipeline_shape_cache.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_settings.h"
@@ -58,6 +60,16 @@ public:
      */
     virtual PlanCache* getPlanCache() const = 0;
 
+    /**
+     * Get the PipelineShapeCache for this collection.
+     */
+    virtual PipelineShapeCache* getPipelineShapeCache() const = 0;
+
+    /**
+     * Get the statistics of this collection's indexes.
+     */
+    virtual CollectionIndexStatistics* getIndexStatistics() const = 0;
+
     /**
      * Get the QuerySettings for this collection.
      */
@@ -71,7 +83,8 @@ public:
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
-     * representing the date/time the counter is valid from.
+     * representing the date/time the counter is valid from, and the index's statistics if it has
+     * any.
      *
      * Note for performance that this method returns a copy of a StringMap.
      */
@@ -100,7 +113,7 @@ public:
     virtual void droppedIndex(OperationContext* const opCtx, const StringData indexName) = 0;
 
     /**
-     * Removes all cached query plans.
+     * Removes all cached query plans and pipeline shapes.
      */
     virtual void clearQueryCache() = 0;
 
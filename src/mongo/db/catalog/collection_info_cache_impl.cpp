@@ -57,6 +57,8 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _ns(ns),
       _keysComputed(false),
       _planCache(std::make_unique<PlanCache>(ns.ns())),
+      _pipelineShapeCache(std::make_unique<PipelineShapeCache>()),
+      _indexStatistics(std::make_unique<CollectionIndexStatistics>()),
       _querySettings(std::make_unique<QuerySettings>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
@@ -157,12 +159,23 @@ void CollectionInfoCacheImpl::clearQueryCache() {
     if (nullptr != _planCache.get()) {
         _planCache->clear();
     }
+    if (nullptr != _pipelineShapeCache.get()) {
+        _pipelineShapeCache->clear();
+    }
 }
 
 PlanCache* CollectionInfoCacheImpl::getPlanCache() const {
     return _planCache.get();
 }
 
+PipelineShapeCache* CollectionInfoCacheImpl::getPipelineShapeCache() const {
+    return _pipelineShapeCache.get();
+}
+
+CollectionIndexStatistics* CollectionInfoCacheImpl::getIndexStatistics() const {
+    return _indexStatistics.get();
+}
+
 QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
@@ -177,6 +190,9 @@ void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCt
         _collection->getIndexCatalog()->getIndexIterator(opCtx, includeUnfinishedIndexes);
     while (ii->more()) {
         const IndexCatalogEntry* ice = ii->next();
+        if (ice->descriptor()->getIndexType() == IndexType::INDEX_COLUMN) {
+            continue;
+        }
         indexCores.emplace_back(indexInfoFromIndexCatalogEntry(*ice));
     }
 
@@ -206,6 +222,7 @@ void CollectionInfoCacheImpl::addedIndex(OperationContext* opCtx, const IndexDes
     rebuildIndexData(opCtx);
 
     _indexUsageTracker.registerIndex(desc->indexName(), desc->keyPattern());
+    _indexStatistics->remove(desc->indexName());
 }
 
 void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData indexName) {
@@ -214,6 +231,7 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
     rebuildIndexData(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
+    _indexStatistics->remove(indexName);
 }
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
@@ -225,7 +243,13 @@ void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
 }
 
 CollectionIndexUsageMap CollectionInfoCacheImpl::getIndexUsageStats() const {
-    return _indexUsageTracker.getUsageStats();
+    auto usageStats = _indexUsageTracker.getUsageStats();
+    for (auto&& indexStats : usageStats) {
+        if (auto statistics = _indexStatistics->get(indexStats.first)) {
+            indexStats.second.statistics = statistics->toBSON();
+        }
+    }
+    return usageStats;
 }
 
 void CollectionInfoCacheImpl::setNs(NamespaceString ns) {
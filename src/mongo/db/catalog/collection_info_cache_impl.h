@@ -32,6 +32,8 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/pipeline_shape_cache.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -55,6 +57,16 @@ public:
      */
     PlanCache* getPlanCache() const;
 
+    /**
+     * Get the PipelineShapeCache for this collection.
+     */
+    PipelineShapeCache* getPipelineShapeCache() const override;
+
+    /**
+     * Get the statistics of this collection's indexes.
+     */
+    CollectionIndexStatistics* getIndexStatistics() const override;
+
     /**
      * Get the QuerySettings for this collection.
      */
@@ -68,7 +80,8 @@ public:
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
-     * representing the date/time the counter is valid from.
+     * representing the date/time the counter is valid from, and the index's statistics if it has
+     * any.
      *
      * Note for performance that this method returns a copy of a StringMap.
      */
@@ -98,7 +111,7 @@ public:
     void droppedIndex(OperationContext* opCtx, StringData indexName);
 
     /**
-     * Removes all cached query plans.
+     * Removes all cached query plans and pipeline shapes.
      */
     void clearQueryCache();
 
@@ -127,6 +140,12 @@ private:
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
 
+    // A cache for the stages the query system provides for aggregation pipelines.
+    std::unique_ptr<PipelineShapeCache> _pipelineShapeCache;
+
+    // The statistics the planner uses to estimate the cost of index scans.
+    std::unique_ptr<CollectionIndexStatistics> _indexStatistics;
+
     // Query settings.
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
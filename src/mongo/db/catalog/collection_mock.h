@@ -88,6 +88,10 @@ public:
         std::abort();
     }
 
+    bool isClustered() const {
+        return false;
+    }
+
     Snapshotted<BSONObj> docFor(OperationContext* opCtx, RecordId loc) const {
         std::abort();
     }
@@ -175,6 +175,8 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             continue;
         } else if (fieldName == "temp") {
             collectionOptions.temp = e.trueValue();
+        } else if (fieldName == "clustered") {
+            collectionOptions.clustered = e.trueValue();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -265,6 +267,18 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (collectionOptions.clustered) {
+        if (collectionOptions.capped) {
+            return Status(ErrorCodes::InvalidOptions, "A clustered collection cannot be capped");
+        }
+        if (!collectionOptions.idIndex.isEmpty() || collectionOptions.autoIndexId == YES) {
+            return Status(ErrorCodes::InvalidOptions, "A clustered collection has no _id index");
+        }
+        if (!collectionOptions.viewOn.empty()) {
+            return Status(ErrorCodes::InvalidOptions, "A view cannot be clustered");
+        }
+    }
+
     return collectionOptions;
 }
 
@@ -298,6 +312,9 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
     if (temp)
         builder->appendBool("temp", true);
 
+    if (clustered)
+        builder->appendBool("clustered", true);
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -371,6 +388,10 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (clustered != other.clustered) {
+        return false;
+    }
+
     if (storageEngine.woCompare(other.storageEngine) != 0) {
         return false;
     }
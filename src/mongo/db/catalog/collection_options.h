@@ -124,6 +124,10 @@ struct CollectionOptions {
 
     bool temp = false;
 
+    // Whether documents are stored keyed by their _id instead of having an _id index. See
+    // clustered_id.h.
+    bool clustered = false;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
@@ -57,6 +57,27 @@ TEST(CollectionOptions, SimpleRoundTrip) {
     checkRoundTrip(options);
 }
 
+TEST(CollectionOptions, ClusteredRoundTrip) {
+    CollectionOptions options = assertGet(CollectionOptions::parse(fromjson("{clustered: true}")));
+    ASSERT(options.clustered);
+    checkRoundTrip(options);
+
+    CollectionOptions unclustered;
+    ASSERT_FALSE(options.matchesStorageOptions(unclustered, nullptr));
+}
+
+TEST(CollectionOptions, ClusteredIncompatibleOptions) {
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              CollectionOptions::parse(fromjson("{clustered: true, capped: true, size: 1024}"))
+                  .getStatus());
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              CollectionOptions::parse(fromjson("{clustered: true, autoIndexId: true}"))
+                  .getStatus());
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              CollectionOptions::parse(fromjson("{clustered: true, idIndex: {key: {_id: 1}}}"))
+                  .getStatus());
+}
+
 TEST(CollectionOptions, Validate) {
     CollectionOptions options;
     ASSERT_OK(options.validateForStorage());
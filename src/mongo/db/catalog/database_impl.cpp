@@ -626,6 +626,11 @@ Collection* DatabaseImpl::createCollection(OperationContext* opCtx,
     }
 
     _checkCanCreateCollection(opCtx, nss, optionsWithUUID);
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "Cannot create clustered collection " << nss
+                          << ": the storage engine does not support clustered collections",
+            !options.clustered ||
+                opCtx->getServiceContext()->getStorageEngine()->supportsClusteredIdCollections());
     audit::logCreateCollection(&cc(), nss.ns());
 
     log() << "createCollection: " << nss << " with " << (generatedUUID ? "generated" : "provided")
@@ -591,7 +591,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
 
     const bool isSparse = spec["sparse"].trueValue();
 
-    if (pluginName == IndexNames::WILDCARD) {
+    if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
         if (isSparse) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
@@ -611,6 +611,12 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
         }
     }
 
+    if (pluginName == IndexNames::COLUMN && spec.getField("partialFilterExpression")) {
+        return Status(ErrorCodes::CannotCreateIndex,
+                      str::stream() << "Index type '" << pluginName
+                                    << "' does not support the partialFilterExpression option");
+    }
+
     // Ensure if there is a filter, its valid.
     BSONElement filterElement = spec.getField("partialFilterExpression");
     if (filterElement) {
@@ -1293,8 +1299,12 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
         BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
         MultikeyPaths multikeyPaths;
 
-        index->accessMethod()->getKeys(
-            *bsonRecord.docPtr, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+        index->accessMethod()->getKeys(*bsonRecord.docPtr,
+                                       options.getKeysMode,
+                                       &keys,
+                                       &multikeyMetadataKeys,
+                                       &multikeyPaths,
+                                       bsonRecord.id);
 
         Status status = _indexKeys(opCtx,
                                    index,
@@ -1448,8 +1458,12 @@ void IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
     // deleted.
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
 
-    entry->accessMethod()->getKeys(
-        obj, IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered, &keys, nullptr, nullptr);
+    entry->accessMethod()->getKeys(obj,
+                                   IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
+                                   &keys,
+                                   nullptr,
+                                   nullptr,
+                                   loc);
 
     _unindexKeys(opCtx, entry, {keys.begin(), keys.end()}, obj, loc, logIfError, keysDeletedOut);
 }
@@ -137,7 +137,7 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                                           << static_cast<int>(indexVersion)};
                 }
 
-                if (pluginName == IndexNames::WILDCARD) {
+                if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
                     return {code,
                             str::stream() << "'" << pluginName
                                           << "' index plugin is not allowed with index version v:"
@@ -184,6 +184,22 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
             return Status(code, "wildcard indexes do not allow compounding");
         }
 
+        // Every field of a columnstore index is stored as its own column, so each one must name the
+        // columnstore plugin, and only top-level fields can be columns.
+        if (pluginName == IndexNames::COLUMN) {
+            if (keyElement.type() != BSONType::String) {
+                return Status(code,
+                              str::stream() << "Every value in a '" << IndexNames::COLUMN
+                                            << "' index key pattern must be the string '"
+                                            << IndexNames::COLUMN << "'");
+            }
+            if (keyElement.fieldNameStringData().find('.') != std::string::npos) {
+                return Status(code,
+                              str::stream() << "'" << IndexNames::COLUMN
+                                            << "' indexes only support top-level fields");
+            }
+        }
+
         // Ensure that the fields on which we are building the index are valid: a field must not
         // begin with a '$' unless it is part of a wildcard, DBRef or text index, and a field path
         // cannot contain an empty field. If a field cannot be created or updated, it should not be
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -47,17 +48,21 @@
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logger/redaction.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -70,6 +75,26 @@ MONGO_FAIL_POINT_DEFINE(hangAfterIndexBuildOf);
 MONGO_FAIL_POINT_DEFINE(hangAndThenFailIndexBuild);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
 
+namespace {
+
+// The collection scan hands documents to the key generation threads in batches of up to this many
+// documents per thread, or of up to kKeyGenerationBatchBytes in all, whichever comes first.
+const size_t kKeyGenerationBatchDocsPerWorker = 256;
+const size_t kKeyGenerationBatchBytes = 16 * 1024 * 1024;
+
+std::unique_ptr<ThreadPool> makeKeyGenerationPool(size_t numWorkers) {
+    ThreadPool::Options options;
+    options.threadNamePrefix = "index-build-keygen-";
+    options.poolName = "index build key generation Pool";
+    options.maxThreads = options.minThreads = numWorkers;
+    options.onCreateThread = [](const std::string&) { Client::initThread(getThreadName()); };
+    auto pool = std::make_unique<ThreadPool>(options);
+    pool->startup();
+    return pool;
+}
+
+}  // namespace
+
 MultiIndexBlock::~MultiIndexBlock() {
     invariant(_buildIsCleanedUp);
 }
@@ -273,6 +298,13 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
             indexSpecs.size();
     }
 
+    // Hybrid builds and non-hybrid foreground builds use the bulk builder, into which several
+    // threads may generate keys while the collection is scanned.
+    const bool useBulk =
+        _method == IndexBuildMethod::kHybrid || _method == IndexBuildMethod::kForeground;
+    _numKeyGenerationWorkers =
+        useBulk ? static_cast<size_t>(maxIndexBuildKeyGenerationThreads.load()) : 1;
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -305,13 +337,11 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
         if (!status.isOK())
             return status;
 
-        // Hybrid builds and non-hybrid foreground builds use the bulk builder.
-        const bool useBulk =
-            _method == IndexBuildMethod::kHybrid || _method == IndexBuildMethod::kForeground;
         if (useBulk) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes,
+                                                  _numKeyGenerationWorkers);
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -332,7 +362,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
               << " using method: " << _method;
         if (index.bulk)
             log() << "build may temporarily use up to "
-                  << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+                  << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM and "
+                  << _numKeyGenerationWorkers << " key generation threads";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -386,12 +417,22 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
     }
     MultikeyPathTracker::get(opCtx).startTrackingMultikeyPathInfo();
 
-    const char* curopMessage = "Index Build: scanning collection";
     const auto numRecords = collection->numRecords(opCtx);
+
+    // Documents are scanned on this thread, which holds the collection lock and the storage
+    // snapshot, and handed in batches to threads which generate and sort their keys. Small
+    // collections are not worth starting threads for.
+    const size_t numWorkers =
+        numRecords > kKeyGenerationBatchDocsPerWorker ? _numKeyGenerationWorkers : 1;
+    std::string curopMessage = "Index Build: scanning collection";
+    if (numWorkers > 1) {
+        curopMessage = str::stream() << curopMessage << " with " << numWorkers
+                                     << " key generation threads";
+    }
     ProgressMeterHolder progress;
     {
         stdx::unique_lock<Client> lk(*opCtx->getClient());
-        progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, numRecords));
+        progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage.c_str(), numRecords));
     }
 
     if (MONGO_FAIL_POINT(hangAfterSettingUpIndexBuild)) {
@@ -431,6 +472,65 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         _method != IndexBuildMethod::kBackground && useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // The batch being filled by the scan, and the batch the workers are generating keys from. The
+    // pool is joined on the way out, before the batches are destroyed.
+    std::vector<std::pair<BSONObj, RecordId>> batch;
+    std::vector<std::pair<BSONObj, RecordId>> inFlight;
+    size_t batchBytes = 0;
+    stdx::mutex workerMutex;
+    Status workerStatus = Status::OK();
+    std::unique_ptr<ThreadPool> workerPool;
+    if (numWorkers > 1) {
+        workerPool = makeKeyGenerationPool(numWorkers);
+    }
+    ON_BLOCK_EXIT([&] {
+        if (workerPool) {
+            workerPool->shutdown();
+            workerPool->join();
+        }
+    });
+
+    // Waits until the workers are done with the batch in flight, and returns the first error any
+    // of them hit.
+    auto waitForWorkers = [&]() -> Status {
+        workerPool->waitForIdle();
+        stdx::lock_guard<stdx::mutex> lk(workerMutex);
+        return workerStatus;
+    };
+
+    // Hands the batch filled by the scan to the workers, each taking a contiguous slice of it.
+    auto dispatchBatch = [&]() -> Status {
+        Status status = waitForWorkers();
+        if (!status.isOK()) {
+            return status;
+        }
+        if (State::kAborted == _getState()) {
+            return {ErrorCodes::IndexBuildAborted,
+                    str::stream() << "Index build aborted: " << _abortReason};
+        }
+
+        inFlight.clear();
+        inFlight.swap(batch);
+        batchBytes = 0;
+        const size_t sliceSize = (inFlight.size() + numWorkers - 1) / numWorkers;
+        for (size_t worker = 0; worker * sliceSize < inFlight.size(); ++worker) {
+            const size_t begin = worker * sliceSize;
+            const size_t end = std::min(inFlight.size(), begin + sliceSize);
+            workerPool->schedule([&, worker, begin, end](auto status) {
+                for (size_t i = begin; status.isOK() && i < end; ++i) {
+                    status = _insertFromWorker(worker, inFlight[i].first, inFlight[i].second);
+                }
+                if (!status.isOK()) {
+                    stdx::lock_guard<stdx::mutex> lk(workerMutex);
+                    if (workerStatus.isOK()) {
+                        workerStatus = status;
+                    }
+                }
+            });
+        }
+        return Status::OK();
+    };
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -460,6 +560,26 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
 
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
+            if (workerPool) {
+                // The workers generate keys from an owned copy, since the scan moves on.
+                batch.emplace_back(objToIndex.value().getOwned(), loc);
+                batchBytes += objToIndex.value().objsize();
+                if (batch.size() >= numWorkers * kKeyGenerationBatchDocsPerWorker ||
+                    batchBytes >= kKeyGenerationBatchBytes) {
+                    Status status = dispatchBatch();
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+
+                failPointHangDuringBuild(&hangAfterIndexBuildOf, "after", objToIndex.value());
+
+                progress->hit();
+                n++;
+                retries = 0;
+                continue;
+            }
+
             WriteUnitOfWork wunit(opCtx);
             Status ret = insert(opCtx, objToIndex.value(), loc);
             if (_method == IndexBuildMethod::kBackground)
@@ -508,6 +628,16 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         return exec->getMemberObjectStatus(objToIndex.value());
     }
 
+    if (workerPool) {
+        Status status = batch.empty() ? Status::OK() : dispatchBatch();
+        if (status.isOK()) {
+            status = waitForWorkers();
+        }
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     if (MONGO_FAIL_POINT(leaveIndexBuildUnfinishedForShutdown)) {
         log() << "Index build interrupted due to 'leaveIndexBuildUnfinishedForShutdown' failpoint. "
                  "Mimicing shutdown error code.";
@@ -573,6 +703,23 @@ Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, cons
     return Status::OK();
 }
 
+Status MultiIndexBlock::_insertFromWorker(size_t worker,
+                                          const BSONObj& doc,
+                                          const RecordId& loc) {
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
+            continue;
+        }
+
+        invariant(_indexes[i].bulk);
+        Status idxStatus =
+            _indexes[i].bulk->insertFromWorker(worker, doc, loc, _indexes[i].options);
+        if (!idxStatus.isOK())
+            return idxStatus;
+    }
+    return Status::OK();
+}
+
 Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx) {
     return dumpInsertsFromBulk(opCtx, nullptr);
 }
@@ -602,11 +749,20 @@ Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx,
         IndexCatalogEntry* entry = _indexes[i].block->getEntry();
         LOG(1) << "index build: inserting from external sorter into index: "
                << entry->descriptor()->indexName();
+
+        // The planner only uses statistics for btree indexes, whose keys hold the indexed values.
+        if (internalQueryPlannerEnableIndexStatistics.load() &&
+            entry->descriptor()->getAccessMethodName() == IndexNames::BTREE) {
+            _indexes[i].statistics = std::make_unique<IndexStatisticsBuilder>(
+                entry->descriptor()->keyPattern(), _indexes[i].bulk->getKeysInserted());
+        }
+
         Status status = _indexes[i].real->commitBulk(opCtx,
                                                      _indexes[i].bulk.get(),
                                                      dupsAllowed,
                                                      dupRecords,
-                                                     (dupRecords) ? nullptr : &dupKeysInserted);
+                                                     (dupRecords) ? nullptr : &dupKeysInserted,
+                                                     _indexes[i].statistics.get());
         if (!status.isOK()) {
             return status;
         }
@@ -751,6 +907,20 @@ Status MultiIndexBlock::commit(OperationContext* opCtx,
 
         _indexes[i].block->success(opCtx, collection);
 
+        // Keys written by concurrent operations after the bulk load are missing from the
+        // statistics. They are refreshed by sampling once the collection has changed enough.
+        if (_indexes[i].statistics) {
+            const auto numRecords = collection->numRecords(opCtx);
+            auto statistics = _indexes[i].statistics->done(
+                IndexStatistics::Source::kIndexBuild, numRecords, numRecords);
+            opCtx->recoveryUnit()->onCommit(
+                [infoCache = collection->infoCache(),
+                 indexName = _indexes[i].block->getIndexName(),
+                 statistics = std::move(statistics)](boost::optional<Timestamp>) {
+                    infoCache->getIndexStatistics()->set(indexName, statistics);
+                });
+        }
+
         // The bulk builder will track multikey information itself. Non-bulk builders re-use the
         // code path that a typical insert/update uses. State is altered on the non-bulk build
         // path to accumulate the multikey information on the `MultikeyPathTracker`.
@@ -45,6 +45,7 @@
 #include "mongo/db/catalog/index_build_block.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
@@ -302,12 +303,21 @@ private:
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
         std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
 
+        // Gathers the index's statistics from the keys inserted by the bulk builder, if any.
+        std::unique_ptr<IndexStatisticsBuilder> statistics;
+
         InsertDeleteOptions options;
     };
 
     Status _dumpInsertsFromBulk(std::set<RecordId>* dupRecords,
                                 std::vector<BSONObj>* dupKeysInserted);
 
+    /**
+     * Inserts 'doc' into the bulk builder of each index as 'worker'. Called concurrently by the
+     * key generation threads of insertAllDocumentsInCollection().
+     */
+    Status _insertFromWorker(size_t worker, const BSONObj& doc, const RecordId& loc);
+
     /**
      * Returns the current state.
      */
@@ -334,6 +344,10 @@ private:
 
     bool _ignoreUnique = false;
 
+    // The number of threads that may generate keys into the bulk builders concurrently. Only
+    // builds which use the bulk builders have more than one.
+    size_t _numKeyGenerationWorkers = 1;
+
     bool _needToCleanup = true;
 
     // Set to true when no work remains to be done, the object can safely destruct without leaving
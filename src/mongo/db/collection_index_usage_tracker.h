@@ -67,12 +67,14 @@ public:
         IndexUsageStats(const IndexUsageStats& other)
             : accesses(other.accesses.load()),
               trackerStartTime(other.trackerStartTime),
-              indexKey(other.indexKey) {}
+              indexKey(other.indexKey),
+              statistics(other.statistics) {}
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
+            statistics = other.statistics;
             return *this;
         }
 
@@ -84,6 +86,10 @@ public:
 
         // An owned copy of the associated IndexDescriptor's index key.
         BSONObj indexKey;
+
+        // The index's statistics, as gathered for the query planner. Empty if it has none. Not
+        // maintained by the tracker, but filled in by the CollectionInfoCache.
+        BSONObj statistics;
     };
 
     /**
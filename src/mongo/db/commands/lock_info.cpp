@@ -89,8 +89,9 @@ public:
             stdx::lock_guard<Client> lk(*client);
             const OperationContext* clientOpCtx = client->getOperationContext();
 
-            // Operation context specific information
-            if (clientOpCtx) {
+            // Operation context specific information. Query worker operations hold no locks of
+            // their own, so there is nothing to attribute to them.
+            if (clientOpCtx && !clientOpCtx->lockState()->isNoop()) {
                 BSONObjBuilder infoBuilder;
                 // The client information
                 client->reportState(infoBuilder);
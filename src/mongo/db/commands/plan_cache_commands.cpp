@@ -293,7 +293,12 @@ Status PlanCacheClear::runPlanCacheCommand(OperationContext* opCtx,
         // No collection - nothing to do. Return OK status.
         return Status::OK();
     }
-    return clear(opCtx, planCache, ns, cmdObj);
+    status = clear(opCtx, planCache, ns, cmdObj);
+    if (status.isOK() && !cmdObj.hasField("query")) {
+        // Which stages of a pipeline the query system can provide depends on its cached plans.
+        ctx.getCollection()->infoCache()->getPipelineShapeCache()->clear();
+    }
+    return status;
 }
 
 // static
@@ -46,12 +46,16 @@ public:
         return true;
     }
 
+    /**
+     * Reported by the serverStatus and lockInfo commands for every client with an operation, so
+     * these must not fail. Real lockers are numbered from 1, so id 0 never names one of them.
+     */
     virtual ClientState getClientState() const {
-        MONGO_UNREACHABLE;
+        return kInactive;
     }
 
     virtual LockerId getId() const {
-        MONGO_UNREACHABLE;
+        return 0;
     }
 
     stdx::thread::id getThreadId() const override {
@@ -101,6 +101,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
+#include "mongo/db/periodic_runner_job_refresh_index_statistics.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -621,6 +622,10 @@ ExitCode _initAndListen(int listenPort) {
         }
     }
 
+    // Start up a background task to periodically refresh the statistics the query planner uses to
+    // estimate the cost of index scans.
+    PeriodicThreadToRefreshIndexStatistics::get(serviceContext)->start();
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -936,6 +941,8 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     }
 
     if (auto storageEngine = serviceContext->getStorageEngine()) {
+        PeriodicThreadToRefreshIndexStatistics::get(serviceContext)->stop();
+
         if (storageEngine->supportsReadConcernSnapshot()) {
             PeriodicThreadToAbortExpiredTransactions::get(serviceContext)->stop();
             PeriodicThreadToDecreaseSnapshotHistoryCachePressure::get(serviceContext)->stop();
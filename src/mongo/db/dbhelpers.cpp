@@ -51,6 +51,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/util/log.h"
@@ -63,6 +64,26 @@ using std::set;
 using std::string;
 using std::unique_ptr;
 
+namespace {
+
+/**
+ * Looks up the document with the given _id in a clustered collection, where the _id determines
+ * the RecordId and there is no _id index. Returns a null RecordId if there is no such document.
+ */
+RecordId findClusteredId(OperationContext* opCtx, Collection* collection, const BSONElement& id) {
+    invariant(collection->isClustered());
+    auto swKey = clustered_id::keyForId(id);
+    if (!swKey.isOK())
+        return RecordId();
+
+    RecordData unused;
+    if (!collection->getRecordStore()->findRecord(opCtx, swKey.getValue(), &unused))
+        return RecordId();
+    return swKey.getValue();
+}
+
+}  // namespace
+
 /* fetch a single object from collection ns that matches query
    set your db SavedContext first
 */
@@ -146,6 +167,17 @@ bool Helpers::findById(OperationContext* opCtx,
     if (nsFound)
         *nsFound = true;
 
+    if (collection->isClustered()) {
+        if (indexFound)
+            *indexFound = 1;
+
+        RecordId loc = findClusteredId(opCtx, collection, query["_id"]);
+        if (loc.isNull())
+            return false;
+        result = collection->docFor(opCtx, loc).value();
+        return true;
+    }
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
 
@@ -166,6 +198,9 @@ RecordId Helpers::findById(OperationContext* opCtx,
                            Collection* collection,
                            const BSONObj& idquery) {
     verify(collection);
+    if (collection->isClustered())
+        return findClusteredId(opCtx, collection, idquery["_id"]);
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
     uassert(13430, "no _id index", desc);
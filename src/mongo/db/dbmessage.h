@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/client/constants.h"
@@ -448,6 +450,9 @@ struct DbResponse {
     // Cursor ID when running on exhaust mode. Defaults to '0', indicating
     // that the cursor is exhausted.
     long long exhaustCursorId = 0;
+    // When set on an exhaust 'getMore' response, the body of the command to run as the next
+    // 'synthetic' exhaust request in place of the original request.
+    boost::optional<BSONObj> nextInvocation;
 };
 
 /**
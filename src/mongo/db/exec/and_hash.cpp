@@ -29,6 +29,7 @@
 
 #include "mongo/db/exec/and_hash.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/exec/and_common.h"
@@ -93,7 +94,7 @@ bool AndHashStage::isEOF() {
     // Or we're streaming in results from the last child.
 
     // If there's nothing to probe against, we're EOF.
-    if (_dataMap.empty()) {
+    if (intersectionIsEmpty()) {
         return true;
     }
 
@@ -165,6 +166,11 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     if (_hashingChildren) {
         // Check memory usage of previously hashed results.
         if (_memUsage > _maxMemUsage) {
+            if (_allowRecordIdIntersection && !_recordIdIntersection) {
+                switchToRecordIdIntersection();
+                return PlanStage::NEED_TIME;
+            }
+
             str::stream ss;
             ss << "hashed AND stage buffered data usage of " << _memUsage
                << " bytes exceeds internal limit of " << kDefaultMaxMemUsageBytes << " bytes";
@@ -189,11 +195,15 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // hash map.
 
     // We should be EOF if we're not hashing results and the dataMap is empty.
-    verify(!_dataMap.empty());
+    verify(!intersectionIsEmpty());
 
     // We probe _dataMap with the last child.
     verify(_currentChild == _children.size() - 1);
 
+    return returnLastChildResult(out);
+}
+
+PlanStage::StageState AndHashStage::returnLastChildResult(WorkingSetID* out) {
     // Get the next result for the (_children.size() - 1)-th child.
     StageState childStatus = workChild(_children.size() - 1, out);
     if (PlanStage::ADVANCED != childStatus) {
@@ -208,17 +218,39 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // with no record id.
     invariant(member->hasRecordId());
 
-    DataMap::iterator it = _dataMap.find(member->recordId);
-    if (_dataMap.end() == it) {
+    if (!_bloomFilter.mayContain(member->recordId)) {
+        ++_specificStats.bloomFilterRejects;
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
+    if (_recordIdIntersection) {
+        // Only the record id matters to our consumer, so return the child's own WSM the first
+        // time we see each record id of the intersection.
+        auto it = std::lower_bound(_recordIds.begin(), _recordIds.end(), member->recordId);
+        if (_recordIds.end() == it || *it != member->recordId) {
+            _ws->free(*out);
+            return PlanStage::NEED_TIME;
+        }
+
+        const size_t index = it - _recordIds.begin();
+        if (_recordIdsReturned[index]) {
+            _ws->free(*out);
+            return PlanStage::NEED_TIME;
+        }
+        _recordIdsReturned[index] = true;
+        ++_numRecordIdsReturned;
+        return PlanStage::ADVANCED;
+    }
+
+    WorkingSetID hashID = _dataMap.erase(member->recordId);
+    if (WorkingSet::INVALID_ID == hashID) {
         // Child's output wasn't in every previous child.  Throw it out.
         _ws->free(*out);
         return PlanStage::NEED_TIME;
     } else {
         // Child's output was in every previous child.  Merge any key data in
         // the child's output and free the child's just-outputted WSM.
-        WorkingSetID hashID = it->second;
-        _dataMap.erase(it);
-
         AndCommon::mergeFrom(_ws, hashID, *member);
         _ws->free(*out);
 
@@ -251,7 +283,15 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         // with no record id.
         invariant(member->hasRecordId());
 
-        if (!_dataMap.insert(std::make_pair(member->recordId, id)).second) {
+        if (_recordIdIntersection) {
+            // Duplicates are removed once the child is done.
+            _recordIds.push_back(member->recordId);
+            _ws->free(id);
+            _memUsage += sizeof(RecordId);
+            return PlanStage::NEED_TIME;
+        }
+
+        if (!_dataMap.insert(member->recordId, id)) {
             // Didn't insert because we already had this RecordId inside the map. This should only
             // happen if we're seeing a newer copy of the same doc in a more recent snapshot.
             // Throw out the newer copy of the doc.
@@ -270,13 +310,21 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         // Done reading child 0.
         _currentChild = 1;
 
+        if (_recordIdIntersection) {
+            std::sort(_recordIds.begin(), _recordIds.end());
+            _recordIds.erase(std::unique(_recordIds.begin(), _recordIds.end()), _recordIds.end());
+            _memUsage = _recordIds.size() * sizeof(RecordId);
+        }
+
         // If our first child was empty, don't scan any others, no possible results.
-        if (_dataMap.empty()) {
+        if (intersectionIsEmpty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        _specificStats.mapAfterChild.push_back(_recordIdIntersection ? _recordIds.size()
+                                                                     : _dataMap.size());
+        rebuildBloomFilter();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus) {
@@ -308,19 +356,27 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // WSM with no record id.
         invariant(member->hasRecordId());
 
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
-            // Ignore.  It's not in any previous child.
+        if (!_bloomFilter.mayContain(member->recordId)) {
+            // Ignore.  It's certainly not in every previous child.
+            ++_specificStats.bloomFilterRejects;
+        } else if (_recordIdIntersection) {
+            if (std::binary_search(_recordIds.begin(), _recordIds.end(), member->recordId)) {
+                // Duplicates are removed once the child is done.
+                _seenRecordIds.push_back(member->recordId);
+                _memUsage += sizeof(RecordId);
+            }
         } else {
-            // We have a hit.  Copy data into the WSM we already have.
-            _seenMap.insert(member->recordId);
-            WorkingSetID olderMemberID = _dataMap[member->recordId];
-            WorkingSetMember* olderMember = _ws->get(olderMemberID);
-            size_t memUsageBefore = olderMember->getMemUsage();
+            WorkingSetID olderMemberID = _dataMap.mark(member->recordId);
+            if (WorkingSet::INVALID_ID != olderMemberID) {
+                // We have a hit.  Copy data into the WSM we already have.
+                WorkingSetMember* olderMember = _ws->get(olderMemberID);
+                size_t memUsageBefore = olderMember->getMemUsage();
 
-            AndCommon::mergeFrom(_ws, olderMemberID, *member);
+                AndCommon::mergeFrom(_ws, olderMemberID, *member);
 
-            // Update memory stats.
-            _memUsage += olderMember->getMemUsage() - memUsageBefore;
+                // Update memory stats.
+                _memUsage += olderMember->getMemUsage() - memUsageBefore;
+            }
         }
         _ws->free(id);
         return PlanStage::NEED_TIME;
@@ -328,36 +384,38 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // Finished with a child.
         ++_currentChild;
 
-        // Keep elements of _dataMap that are in _seenMap.
-        DataMap::iterator it = _dataMap.begin();
-        while (it != _dataMap.end()) {
-            if (_seenMap.end() == _seenMap.find(it->first)) {
-                DataMap::iterator toErase = it;
-                ++it;
-
+        if (_recordIdIntersection) {
+            // Keep the record ids that this child produced.
+            std::sort(_seenRecordIds.begin(), _seenRecordIds.end());
+            _seenRecordIds.erase(std::unique(_seenRecordIds.begin(), _seenRecordIds.end()),
+                                 _seenRecordIds.end());
+            _recordIds.swap(_seenRecordIds);
+            _seenRecordIds.clear();
+            _memUsage = _recordIds.size() * sizeof(RecordId);
+        } else {
+            // Keep elements of _dataMap that this child marked.
+            _dataMap.eraseUnmarked([&](WorkingSetID toErase) {
                 // Update memory stats.
-                WorkingSetMember* member = _ws->get(toErase->second);
+                WorkingSetMember* member = _ws->get(toErase);
                 _memUsage -= member->getMemUsage();
 
-                _ws->free(toErase->second);
-                _dataMap.erase(toErase);
-            } else {
-                ++it;
-            }
+                _ws->free(toErase);
+            });
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
-
-        _seenMap.clear();
+        _specificStats.mapAfterChild.push_back(_recordIdIntersection ? _recordIds.size()
+                                                                     : _dataMap.size());
 
         // _dataMap is now the intersection of the first _currentChild nodes.
 
         // If we have nothing to AND with after finishing any child, stop.
-        if (_dataMap.empty()) {
+        if (intersectionIsEmpty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
 
+        rebuildBloomFilter();
+
         // We've finished scanning all children.  Return results with the next call to work().
         if (_currentChild == _children.size()) {
             _hashingChildren = false;
@@ -379,6 +437,47 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+void AndHashStage::switchToRecordIdIntersection() {
+    invariant(!_recordIdIntersection);
+    _recordIdIntersection = true;
+    _specificStats.recordIdIntersection = true;
+
+    _recordIds.reserve(_dataMap.size());
+    _dataMap.forEach([&](RecordId recordId, WorkingSetID id, bool marked) {
+        _recordIds.push_back(recordId);
+        if (marked) {
+            _seenRecordIds.push_back(recordId);
+        }
+        _ws->free(id);
+    });
+    _dataMap.clear();
+
+    std::sort(_recordIds.begin(), _recordIds.end());
+    _recordIdsReturned.assign(_recordIds.size(), false);
+    _memUsage = (_recordIds.size() + _seenRecordIds.size()) * sizeof(RecordId);
+}
+
+void AndHashStage::rebuildBloomFilter() {
+    if (_recordIdIntersection) {
+        _bloomFilter.reset(_recordIds.size());
+        for (auto&& recordId : _recordIds) {
+            _bloomFilter.add(recordId);
+        }
+        _recordIdsReturned.assign(_recordIds.size(), false);
+    } else {
+        _bloomFilter.reset(_dataMap.size());
+        _dataMap.forEach(
+            [&](RecordId recordId, WorkingSetID, bool) { _bloomFilter.add(recordId); });
+    }
+}
+
+bool AndHashStage::intersectionIsEmpty() const {
+    if (_recordIdIntersection) {
+        return _numRecordIdsReturned == _recordIds.size();
+    }
+    return _dataMap.empty();
+}
+
 unique_ptr<PlanStageStats> AndHashStage::getStats() {
     _commonStats.isEOF = isEOF();
 
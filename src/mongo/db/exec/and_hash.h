@@ -32,11 +32,10 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_hash_table.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
-#include "mongo/stdx/unordered_map.h"
-#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
@@ -44,6 +43,13 @@ namespace mongo {
  * Reads from N children, each of which must have a valid RecordId. Uses a hash table to intersect
  * the outputs of the N children based on their record ids, and outputs the intersection.
  *
+ * A Bloom filter over the current intersection lets most non-matching record ids from the second
+ * and later children be discarded without probing the hash table.
+ *
+ * If the buffered data outgrows the memory limit and allowRecordIdIntersection() has been called,
+ * the stage drops the buffered working set members and continues by intersecting sorted arrays of
+ * record ids, returning the last child's members. Otherwise, the stage fails.
+ *
  * Preconditions: Valid RecordId. More than one child.
  */
 class AndHashStage final : public PlanStage {
@@ -57,6 +63,15 @@ public:
 
     void addChild(PlanStage* child);
 
+    /**
+     * Declares that the consumer of this stage needs only the record ids of the results, and not
+     * any index key data from children other than the last, so that the stage may fall back to
+     * intersecting record ids alone instead of failing once it reaches its memory limit.
+     */
+    void allowRecordIdIntersection() {
+        _allowRecordIdIntersection = true;
+    }
+
     /**
      * Returns memory usage.
      * For testing only.
@@ -82,6 +97,23 @@ private:
     StageState readFirstChild(WorkingSetID* out);
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
+    StageState returnLastChildResult(WorkingSetID* out);
+
+    /**
+     * Frees the working set members held in '_dataMap' and moves their record ids into
+     * '_recordIds', and those of members seen by the current child into '_seenRecordIds'.
+     */
+    void switchToRecordIdIntersection();
+
+    /**
+     * Rebuilds '_bloomFilter' from the record ids of the current intersection.
+     */
+    void rebuildBloomFilter();
+
+    /**
+     * Returns true if no record id of the current intersection remains to be returned.
+     */
+    bool intersectionIsEmpty() const;
 
     // Not owned by us.
     WorkingSet* _ws;
@@ -92,14 +124,26 @@ private:
     std::vector<WorkingSetID> _lookAheadResults;
 
     // _dataMap is filled out by the first child and probed by subsequent children.  This is the
-    // hash table that we create by intersecting _children and probe with the last child.
-    typedef stdx::unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
-    DataMap _dataMap;
-
-    // Keeps track of what elements from _dataMap subsequent children have seen.
-    // Only used while _hashingChildren.
-    typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
-    SeenMap _seenMap;
+    // hash table that we create by intersecting _children and probe with the last child. While
+    // _hashingChildren, the entries seen by the current child are marked.
+    RecordIdHashTable _dataMap;
+
+    // Holds the record ids of _dataMap once the first child is done.  Probed before _dataMap.
+    RecordIdBloomFilter _bloomFilter;
+
+    // Set by allowRecordIdIntersection().
+    bool _allowRecordIdIntersection = false;
+
+    // True once we have given up _dataMap and intersect record ids only.  In this mode,
+    // _recordIds holds the sorted intersection of the children read so far, or the record ids
+    // read from the first child, and _seenRecordIds those of _recordIds which the current child
+    // has produced.  _recordIdsReturned marks the entries of _recordIds that the last child has
+    // already produced, so that each is returned only once.
+    bool _recordIdIntersection = false;
+    std::vector<RecordId> _recordIds;
+    std::vector<RecordId> _seenRecordIds;
+    std::vector<bool> _recordIdsReturned;
+    size_t _numRecordIdsReturned = 0;
 
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
@@ -111,7 +155,8 @@ private:
     AndHashStats _specificStats;
 
     // The usage in bytes of all buffered data that we're holding.
-    // Memory usage is calculated from keys held in _dataMap only.
+    // Memory usage is calculated from keys held in _dataMap only, or from the record ids held
+    // once we intersect record ids alone.
     // For simplicity, results in _lookAheadResults do not count towards the limit.
     size_t _memUsage;
 
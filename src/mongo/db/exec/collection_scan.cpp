@@ -76,6 +76,13 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
         invariant(params.direction == CollectionScanParams::FORWARD);
         invariant(collection->ns().isOplog());
     }
+    _specificStats.minRecord = params.minRecord;
+    _specificStats.maxRecord = params.maxRecord;
+    if (params.minRecord || params.maxRecord) {
+        // RecordIds are only ordered like the documents' _id values in clustered collections.
+        invariant(params.direction == CollectionScanParams::FORWARD);
+        invariant(collection->isClustered());
+    }
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
 
     // Set early stop condition.
@@ -148,6 +155,13 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
                     record = _cursor->seekExact(*startLoc);
                 }
             }
+        } else if (_lastSeenId.isNull() && _params.minRecord) {
+            boost::optional<RecordId> startLoc =
+                collection()->getRecordStore()->oplogStartHack(getOpCtx(), *_params.minRecord);
+            if (startLoc && !startLoc->isNull()) {
+                LOG(3) << "Using direct clustered collection seek";
+                record = _cursor->seekExact(*startLoc);
+            }
         }
 
         if (!record) {
@@ -174,6 +188,12 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_params.maxRecord && record->id > *_params.maxRecord) {
+        // No later record can be within the bounds of a clustered collection scan.
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -51,6 +51,15 @@ struct CollectionScanParams {
     // oplog scans.
     boost::optional<Timestamp> maxTs;
 
+    // If present, the collection scan will seek directly to the RecordId as close to 'minRecord'
+    // as possible without going higher. Must only be set on forward scans of clustered
+    // collections.
+    boost::optional<RecordId> minRecord;
+
+    // If present, the collection scan will return EOF the first time it sees a RecordId greater
+    // than 'maxRecord'. Must only be set on forward scans of clustered collections.
+    boost::optional<RecordId> maxRecord;
+
     Direction direction = FORWARD;
 
     // Do we want the scan to be 'tailable'?  Only meaningful if the collection is capped.
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/column_scan.h"
+
+#include <memory>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/column_key_generator.h"
+#include "mongo/db/index/index_descriptor.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+
+// static
+const char* ColumnScan::kStageType = "COLUMN_SCAN";
+
+ColumnScan::ColumnScan(OperationContext* opCtx,
+                       const IndexDescriptor* descriptor,
+                       std::vector<std::string> fields,
+                       WorkingSet* workingSet,
+                       const MatchExpression* filter)
+    : RequiresIndexStage(kStageType, opCtx, descriptor),
+      _workingSet(workingSet),
+      _filter(filter) {
+    invariant(descriptor->getIndexType() == IndexType::INDEX_COLUMN);
+
+    _rowCursor.column = ColumnKeyGenerator::kRowColumn.toString();
+    for (auto&& field : fields) {
+        _fieldCursors.push_back({field, nullptr, boost::none});
+    }
+
+    _specificStats.indexName = descriptor->indexName();
+    _specificStats.keyPattern = descriptor->keyPattern();
+    _specificStats.fields = std::move(fields);
+}
+
+void ColumnScan::openCursors() {
+    auto open = [&](ColumnCursor* column) {
+        column->cursor = indexAccessMethod()->newCursor(getOpCtx());
+        column->cursor->setEndPosition(ColumnKeyGenerator::makeColumnPrefix(column->column),
+                                       true);
+        column->next = _lastSeenId.isNull()
+            ? column->cursor->seek(ColumnKeyGenerator::makeColumnPrefix(column->column), true)
+            : column->cursor->seek(
+                  ColumnKeyGenerator::makeColumnPrefix(column->column, _lastSeenId), false);
+        ++_specificStats.keysExamined;
+    };
+
+    open(&_rowCursor);
+    for (auto&& column : _fieldCursors) {
+        open(&column);
+    }
+    _cursorsOpen = true;
+}
+
+void ColumnScan::advance(ColumnCursor* column) {
+    column->next = column->cursor->next();
+    ++_specificStats.keysExamined;
+}
+
+PlanStage::StageState ColumnScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF)
+        return PlanStage::IS_EOF;
+
+    RecordId id;
+    BSONObj doc;
+    try {
+        if (!_cursorsOpen) {
+            openCursors();
+        }
+
+        if (!_rowCursor.next) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+        id = _rowCursor.next->loc;
+
+        BSONObjBuilder values;
+        for (auto&& column : _fieldCursors) {
+            // Every column entry has a matching row entry, so within one snapshot this only skips
+            // entries if the columns were positioned independently.
+            while (column.next && column.next->loc < id) {
+                advance(&column);
+            }
+            if (column.next && column.next->loc == id) {
+                values.appendAs(ColumnKeyGenerator::extractValue(column.next->key),
+                                column.column);
+                advance(&column);
+            }
+        }
+
+        // Lay the fields out in the order the row entry says they were stored in the document.
+        BSONObj valuesObj = values.done();
+        BSONObjBuilder bob;
+        for (auto&& name : ColumnKeyGenerator::extractValue(_rowCursor.next->key).Obj()) {
+            BSONElement value = valuesObj[name.valueStringData()];
+            if (!value.eoo()) {
+                bob.append(value);
+            }
+        }
+        doc = bob.obj();
+        advance(&_rowCursor);
+    } catch (const WriteConflictException&) {
+        // Reopen every cursor past the last complete document next time.
+        _cursorsOpen = false;
+        _rowCursor.cursor.reset();
+        for (auto&& column : _fieldCursors) {
+            column.cursor.reset();
+        }
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    _lastSeenId = id;
+
+    WorkingSetID memberID = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(memberID);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), std::move(doc));
+    member->transitionToOwnedObj();
+
+    if (!Filter::passes(member, _filter)) {
+        _workingSet->free(memberID);
+        return PlanStage::NEED_TIME;
+    }
+
+    *out = memberID;
+    return PlanStage::ADVANCED;
+}
+
+bool ColumnScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ColumnScan::doSaveStateRequiresIndex() {
+    _cursorsOpen = false;
+    _rowCursor.cursor.reset();
+    _rowCursor.next = boost::none;
+    for (auto&& column : _fieldCursors) {
+        column.cursor.reset();
+        column.next = boost::none;
+    }
+}
+
+void ColumnScan::doRestoreStateRequiresIndex() {}
+
+void ColumnScan::doDetachFromOperationContext() {
+    invariant(!_cursorsOpen);
+}
+
+void ColumnScan::doReattachToOperationContext() {}
+
+unique_ptr<PlanStageStats> ColumnScan::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    unique_ptr<PlanStageStats> ret =
+        std::make_unique<PlanStageStats>(_commonStats, STAGE_COLUMN_SCAN);
+    ret->specific = std::make_unique<ColumnScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ColumnScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/exec/requires_index_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+class WorkingSet;
+
+/**
+ * Reassembles documents from a columnstore index. Only the columns for 'fields' are read, so the
+ * cost of the scan is proportional to the size of the requested fields rather than the size of the
+ * documents. Each returned WorkingSetMember is in OWNED_OBJ state and holds a document containing
+ * the requested fields that were present in the original document, in the order they were stored.
+ *
+ * Results are returned in RecordId order. If 'filter' is non-null, documents which do not match it
+ * are discarded; every field the filter depends on must be included in 'fields'.
+ *
+ * Only created by aggregation, when the pipeline depends on a known set of top-level fields which
+ * are all covered by a columnstore index and the query would otherwise need a collection scan.
+ */
+class ColumnScan final : public RequiresIndexStage {
+public:
+    ColumnScan(OperationContext* opCtx,
+               const IndexDescriptor* descriptor,
+               std::vector<std::string> fields,
+               WorkingSet* workingSet,
+               const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
+    StageType stageType() const final {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+protected:
+    void doSaveStateRequiresIndex() final;
+
+    void doRestoreStateRequiresIndex() final;
+
+private:
+    /**
+     * A cursor over a single column of the index, and the entry it is positioned on. The entry is
+     * the next one for the scan to consume, or boost::none if the column is exhausted.
+     */
+    struct ColumnCursor {
+        std::string column;
+        std::unique_ptr<SortedDataInterface::Cursor> cursor;
+        boost::optional<IndexKeyEntry> next;
+    };
+
+    /**
+     * Opens a cursor on every column, positioned on the first entry after '_lastSeenId'.
+     */
+    void openCursors();
+
+    /**
+     * Advances 'column' to its next entry.
+     */
+    void advance(ColumnCursor* column);
+
+    // The WorkingSet we annotate with results.  Not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    // The reserved row column, which has one entry per document.
+    ColumnCursor _rowCursor;
+
+    // One cursor per requested field, in the order of the fields.
+    std::vector<ColumnCursor> _fieldCursors;
+
+    // Whether the cursors are open. They are closed when saving, since the columns are independent
+    // cursors and repositioning them one at a time after a yield could mix the fields of documents
+    // from different snapshots. They are reopened past '_lastSeenId' on the next call to work().
+    bool _cursorsOpen = false;
+
+    // The RecordId of the last document returned, or null if we have not returned anything yet.
+    RecordId _lastSeenId;
+
+    ColumnScanStats _specificStats;
+};
+
+}  // namespace mongo
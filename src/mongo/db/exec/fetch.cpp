@@ -31,7 +31,9 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -63,12 +65,23 @@ FetchStage::FetchStage(OperationContext* opCtx,
 
 FetchStage::~FetchStage() {}
 
+void FetchStage::setBatchSize(size_t batchSize, bool preserveOrder) {
+    _batchSize = batchSize;
+    _preserveOrder = preserveOrder;
+    _specificStats.batchSize = batchSize;
+}
+
 bool FetchStage::isEOF() {
     if (WorkingSet::INVALID_ID != _idRetrying) {
         // We have a working set member that we need to retry.
         return false;
     }
 
+    if (_numReturned < _batch.size()) {
+        // There are members of the current batch left to fetch or return.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -77,6 +90,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_batchSize > 0) {
+        return doWorkBatched(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -131,6 +148,113 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatched(WorkingSetID* out) {
+    if (BatchState::kReturning == _batchState && _numReturned == _batch.size()) {
+        _batch.clear();
+        _fetchOrder.clear();
+        _numFetched = 0;
+        _numReturned = 0;
+        _batchState = BatchState::kFilling;
+    }
+
+    if (BatchState::kFilling == _batchState) {
+        if (_batch.size() < _batchSize && !child()->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            StageState status = child()->work(&id);
+            if (PlanStage::ADVANCED == status) {
+                _batch.push_back(id);
+                if (_batch.size() < _batchSize) {
+                    return NEED_TIME;
+                }
+            } else if (PlanStage::IS_EOF != status) {
+                // The stage which produces a failure is responsible for allocating a working set
+                // member with error details.
+                invariant(PlanStage::FAILURE != status || WorkingSet::INVALID_ID != id);
+                if (PlanStage::FAILURE == status || PlanStage::NEED_YIELD == status) {
+                    *out = id;
+                }
+                return status;
+            }
+        }
+
+        if (_batch.empty()) {
+            return PlanStage::IS_EOF;
+        }
+        prepareBatchForFetching();
+        _batchState = BatchState::kFetching;
+        ++_specificStats.batches;
+    }
+
+    if (BatchState::kFetching == _batchState) {
+        for (; _numFetched < _fetchOrder.size(); ++_numFetched) {
+            WorkingSetID& id = _batch[_fetchOrder[_numFetched]];
+            WorkingSetMember* member = _ws->get(id);
+
+            // If there's an obj there, there is no fetching to perform.
+            if (member->hasObj()) {
+                ++_specificStats.alreadyHasObj;
+                continue;
+            }
+
+            // We need a valid RecordId to fetch from and this is the only state that has one.
+            verify(WorkingSetMember::RID_AND_IDX == member->getState());
+            verify(member->hasRecordId());
+
+            try {
+                if (!_cursor)
+                    _cursor = collection()->getCursor(getOpCtx());
+
+                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                    _ws->free(id);
+                    id = WorkingSet::INVALID_ID;
+                    continue;
+                }
+            } catch (const WriteConflictException&) {
+                // Fetching resumes from this member after the yield.
+                *out = WorkingSet::INVALID_ID;
+                return NEED_YIELD;
+            }
+
+            // The document must outlive the cursor's position, which moves on with the next fetch.
+            member->makeObjOwnedIfNeeded();
+        }
+        _batchState = BatchState::kReturning;
+    }
+
+    while (_numReturned < _batch.size()) {
+        const WorkingSetID id = _batch[_numReturned++];
+        if (WorkingSet::INVALID_ID != id) {
+            return returnIfMatches(_ws->get(id), id, out);
+        }
+    }
+    return NEED_TIME;
+}
+
+void FetchStage::prepareBatchForFetching() {
+    // Members which already have a document, and may have no RecordId, sort first. They need no
+    // fetching.
+    auto recordIdOf = [&](size_t pos) {
+        WorkingSetMember* member = _ws->get(_batch[pos]);
+        return member->hasRecordId() && !member->hasObj() ? member->recordId : RecordId();
+    };
+
+    _fetchOrder.resize(_batch.size());
+    std::iota(_fetchOrder.begin(), _fetchOrder.end(), 0);
+    std::stable_sort(_fetchOrder.begin(), _fetchOrder.end(), [&](size_t lhs, size_t rhs) {
+        return recordIdOf(lhs) < recordIdOf(rhs);
+    });
+
+    if (!_preserveOrder) {
+        std::vector<WorkingSetID> batch;
+        batch.reserve(_batch.size());
+        for (size_t pos : _fetchOrder) {
+            batch.push_back(_batch[pos]);
+        }
+        _batch.swap(batch);
+        std::iota(_fetchOrder.begin(), _fetchOrder.end(), 0);
+    }
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
     if (_cursor) {
         _cursor->saveUnpositioned();
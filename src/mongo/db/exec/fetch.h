@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
@@ -72,6 +73,15 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Makes this stage read up to 'batchSize' RecordIds ahead from its child and fetch their
+     * documents in RecordId order, which turns the random reads of an index-driven fetch into
+     * mostly sequential ones. If 'preserveOrder' is true, the documents are returned in the order
+     * the child returned their RecordIds, and otherwise in RecordId order. A 'batchSize' of 0
+     * fetches each RecordId as it arrives. Must be called before the first call to work().
+     */
+    void setBatchSize(size_t batchSize, bool preserveOrder);
+
     static const char* kStageType;
 
 protected:
@@ -86,6 +96,20 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * doWork() when fetching in batches: reads the next batch from the child, then fetches it in
+     * RecordId order, then returns it one member at a time.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Sorts the positions of the members of the batch by RecordId into '_fetchOrder', and
+     * reorders the batch itself to match if its order need not be preserved.
+     */
+    void prepareBatchForFetching();
+
+    enum class BatchState { kFilling, kFetching, kReturning };
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -98,6 +122,24 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // The maximum number of members fetched together, or 0 if they are fetched one at a time.
+    size_t _batchSize = 0;
+    bool _preserveOrder = true;
+
+    BatchState _batchState = BatchState::kFilling;
+
+    // The members of the current batch in the order they are to be returned. Members whose
+    // documents no longer exist are replaced by WorkingSet::INVALID_ID.
+    std::vector<WorkingSetID> _batch;
+
+    // The positions in '_batch' of its members in RecordId order.
+    std::vector<size_t> _fetchOrder;
+
+    // How many of the members of '_fetchOrder' have been fetched, and how many of '_batch' have
+    // been returned.
+    size_t _numFetched = 0;
+    size_t _numReturned = 0;
+
     // Stats
     FetchStats _specificStats;
 };
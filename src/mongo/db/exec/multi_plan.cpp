@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <math.h>
 #include <memory>
+#include <time.h>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
@@ -47,8 +48,13 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_worker_pool.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -57,6 +63,35 @@ using std::list;
 using std::unique_ptr;
 using std::vector;
 
+namespace {
+
+/**
+ * Returns the CPU time consumed by the calling thread so far, or 0 if it cannot be determined.
+ */
+long long threadCpuTimeMicros() {
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    // FILETIMEs count 100 nanosecond intervals.
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    return static_cast<long long>((kernel.QuadPart + user.QuadPart) / 10);
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(ts.tv_sec) * 1000 * 1000 + ts.tv_nsec / 1000;
+#endif
+}
+
+}  // namespace
+
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
@@ -76,10 +111,24 @@ MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
 void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
                              PlanStage* root,
                              WorkingSet* ws) {
+    invariant(!_ws || _ws == ws);
+    _ws = ws;
     _candidates.push_back(CandidatePlan(std::move(solution), root, ws));
     _children.emplace_back(root);
 }
 
+void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
+                             PlanStage* root,
+                             std::unique_ptr<WorkingSet> candidateWs,
+                             WorkingSet* sharedWs) {
+    invariant(!_ws || _ws == sharedWs);
+    invariant(candidateWs.get() != sharedWs);
+    _ws = sharedWs;
+    _candidates.push_back(CandidatePlan(std::move(solution), root, candidateWs.get()));
+    _candidateWorkingSets.push_back(std::move(candidateWs));
+    _children.emplace_back(root);
+}
+
 bool MultiPlanStage::isEOF() {
     if (_failure) {
         return true;
@@ -106,7 +155,7 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
 
     // Look for an already produced result that provides the data the caller wants.
     if (!bestPlan.results.empty()) {
-        *out = bestPlan.results.front();
+        *out = toSharedWorkingSet(bestPlan, bestPlan.results.front());
         bestPlan.results.pop();
         return PlanStage::ADVANCED;
     }
@@ -130,7 +179,12 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
         _bestPlanIdx = _backupPlanIdx;
         _backupPlanIdx = kNoSuchPlan;
 
-        return _candidates[_bestPlanIdx].root->work(out);
+        CandidatePlan& backupPlan = _candidates[_bestPlanIdx];
+        state = backupPlan.root->work(out);
+        if (PlanStage::ADVANCED == state || PlanStage::FAILURE == state) {
+            *out = toSharedWorkingSet(backupPlan, *out);
+        }
+        return state;
     }
 
     if (hasBackupPlan() && PlanStage::ADVANCED == state) {
@@ -138,9 +192,27 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
         _backupPlanIdx = kNoSuchPlan;
     }
 
+    if (PlanStage::ADVANCED == state || PlanStage::FAILURE == state) {
+        *out = toSharedWorkingSet(bestPlan, *out);
+    }
     return state;
 }
 
+void MultiPlanStage::doSaveStateRequiresCollection() {
+    // The PlanExecutor only prepares its own WorkingSet for a change of snapshot, so prepare the
+    // ones which belong to individual candidates here.
+    for (auto&& ws : _candidateWorkingSets) {
+        WorkingSetCommon::prepareForSnapshotChange(ws.get());
+    }
+}
+
+WorkingSetID MultiPlanStage::toSharedWorkingSet(const CandidatePlan& candidate, WorkingSetID id) {
+    if (candidate.ws == _ws || WorkingSet::INVALID_ID == id) {
+        return id;
+    }
+    return _ws->emplace(candidate.ws->extract(id));
+}
+
 Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
     // These are the conditions which can cause us to yield:
     //   1) The yield policy's timer elapsed, or
@@ -152,8 +224,7 @@ Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
 
         if (!yieldStatus.isOK()) {
             _failure = true;
-            _statusMemberId =
-                WorkingSetCommon::allocateStatusMember(_candidates[0].ws, yieldStatus);
+            _statusMemberId = WorkingSetCommon::allocateStatusMember(_ws, yieldStatus);
             return yieldStatus;
         }
     }
@@ -204,16 +275,20 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
-    for (size_t ix = 0; ix < numWorks; ++ix) {
-        bool moreToDo = workAllPlans(numResults, yieldPolicy);
-        if (!moreToDo) {
-            break;
+    if (canRaceAllPlans(yieldPolicy)) {
+        raceAllPlans(numWorks, numResults, yieldPolicy);
+    } else {
+        for (size_t ix = 0; ix < numWorks; ++ix) {
+            bool moreToDo = workAllPlans(numResults, yieldPolicy);
+            if (!moreToDo) {
+                break;
+            }
         }
     }
 
     if (_failure) {
         invariant(WorkingSet::INVALID_ID != _statusMemberId);
-        WorkingSetMember* member = _candidates[0].ws->get(_statusMemberId);
+        WorkingSetMember* member = _ws->get(_statusMemberId);
         return WorkingSetCommon::getMemberStatus(*member);
     }
 
@@ -398,7 +473,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
             // Propagate most recent seen failure to parent.
             invariant(state == PlanStage::FAILURE);
-            _statusMemberId = id;
+            _statusMemberId = toSharedWorkingSet(candidate, id);
 
 
             if (_failureCount == _candidates.size()) {
@@ -411,6 +486,183 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::canRaceAllPlans(PlanYieldPolicy* yieldPolicy) const {
+    if (!internalQueryEnableParallelPlanEvaluation.load() || _candidates.size() < 2) {
+        return false;
+    }
+
+    // The candidates read from other snapshots than this operation, which is only allowed if the
+    // operation may change snapshots anyway.
+    if (!yieldPolicy->canAutoYield()) {
+        return false;
+    }
+
+    return std::all_of(_candidates.begin(), _candidates.end(), [this](const auto& candidate) {
+        return candidate.ws != _ws;
+    });
+}
+
+bool MultiPlanStage::raceAllPlans(size_t numWorks,
+                                  size_t numResults,
+                                  PlanYieldPolicy* yieldPolicy) {
+    auto serviceContext = getOpCtx()->getServiceContext();
+
+    std::vector<std::unique_ptr<TrialWorker>> workers;
+    ON_BLOCK_EXIT([&] {
+        for (auto&& worker : workers) {
+            AlternativeClientRegion acr(worker->client);
+            worker->opCtx.reset();
+        }
+    });
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        auto worker = std::make_unique<TrialWorker>();
+        worker->client = serviceContext->makeClient(str::stream() << kStageType << "-" << ix);
+        {
+            AlternativeClientRegion acr(worker->client);
+            worker->opCtx =
+                QueryWorkerPool::makeWorkerOperationContext(getOpCtx(), worker->client.get());
+        }
+        workers.push_back(std::move(worker));
+    }
+
+    _specificStats.concurrentTrial = true;
+    _specificStats.candidates.assign(_candidates.size(), {});
+
+    AtomicWord<bool> stopTrial{false};
+    while (!stopTrial.load()) {
+        std::vector<size_t> racing;
+        for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+            if (!_candidates[ix].failed && workers[ix]->works < numWorks) {
+                racing.push_back(ix);
+            }
+        }
+        if (racing.empty()) {
+            break;
+        }
+
+        std::vector<QueryWorkerPool::Task> tasks;
+        for (auto ix : racing) {
+            CandidatePlan& candidate = _candidates[ix];
+            candidate.root->saveState();
+            WorkingSetCommon::prepareForSnapshotChange(candidate.ws);
+            candidate.root->detachFromOperationContext();
+
+            tasks.push_back(
+                [this, ix, worker = workers[ix].get(), numWorks, numResults, &stopTrial] {
+                    runTrialRound(ix, worker, numWorks, numResults, &stopTrial);
+                });
+        }
+        QueryWorkerPool::get(serviceContext)->runAll(std::move(tasks));
+
+        for (auto ix : racing) {
+            _candidates[ix].root->reattachToOperationContext(getOpCtx());
+            _candidates[ix].root->restoreState();
+        }
+
+        for (auto ix : racing) {
+            CandidatePlan& candidate = _candidates[ix];
+            TrialWorker* worker = workers[ix].get();
+            uassertStatusOK(worker->status);
+
+            if (worker->failed) {
+                // As in workAllPlans(), keep racing the other candidates.
+                candidate.failed = true;
+                ++_failureCount;
+                _statusMemberId = toSharedWorkingSet(candidate, worker->failureId);
+
+                if (_failureCount == _candidates.size()) {
+                    _failure = true;
+                    return false;
+                }
+            }
+        }
+
+        // The candidates do not notice if this operation is killed mid-round, so check for that
+        // here, in addition to whenever we yield.
+        auto interruptStatus = getOpCtx()->checkForInterruptNoAssert();
+        if (!interruptStatus.isOK()) {
+            _failure = true;
+            _statusMemberId = WorkingSetCommon::allocateStatusMember(_ws, interruptStatus);
+            return false;
+        }
+
+        if (!stopTrial.load() && !(tryYield(yieldPolicy)).isOK()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MultiPlanStage::runTrialRound(size_t candidateIdx,
+                                   TrialWorker* worker,
+                                   size_t numWorks,
+                                   size_t numResults,
+                                   AtomicWord<bool>* stopTrial) {
+    AlternativeClientRegion acr(worker->client);
+    OperationContext* opCtx = worker->opCtx.get();
+    CandidatePlan& candidate = _candidates[candidateIdx];
+    auto& stats = _specificStats.candidates[candidateIdx];
+
+    Timer timer;
+    const long long cpuTimeAtStart = threadCpuTimeMicros();
+    const long long roundMillis = internalQueryExecYieldPeriodMS.load();
+
+    candidate.root->reattachToOperationContext(opCtx);
+    try {
+        candidate.root->restoreState();
+
+        // Only this operation is killed, not the worker's, so check for that as well. Every round
+        // works the candidate at least once, so that the trial makes progress however short the
+        // yield period is.
+        while (worker->works < numWorks && !stopTrial->load() && !getOpCtx()->isKillPending()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = candidate.root->work(&id);
+            ++worker->works;
+
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = candidate.ws->get(id);
+                member->makeObjOwnedIfNeeded();
+                candidate.results.push(id);
+
+                // Once a plan returns enough results, stop working every plan.
+                if (candidate.results.size() >= numResults) {
+                    stopTrial->store(true);
+                }
+            } else if (PlanStage::IS_EOF == state) {
+                // First plan to hit EOF wins automatically.
+                stopTrial->store(true);
+            } else if (PlanStage::NEED_YIELD == state) {
+                // The snapshot is abandoned at the end of the round, so simply end it early.
+                invariant(id == WorkingSet::INVALID_ID);
+                break;
+            } else if (PlanStage::NEED_TIME != state) {
+                invariant(state == PlanStage::FAILURE);
+                worker->failed = true;
+                worker->failureId = id;
+                break;
+            }
+
+            if (timer.millis() >= roundMillis) {
+                break;
+            }
+        }
+    } catch (const WriteConflictException&) {
+        // Retry from the same position in the next round, using a new snapshot.
+    } catch (const DBException& ex) {
+        worker->status = ex.toStatus();
+    }
+
+    candidate.root->saveState();
+    WorkingSetCommon::prepareForSnapshotChange(candidate.ws);
+    candidate.root->detachFromOperationContext();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    ++stats.rounds;
+    stats.wallTimeMicros += timer.micros();
+    stats.cpuTimeMicros += threadCpuTimeMicros() - cpuTimeAtStart;
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
@@ -39,6 +39,8 @@
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -99,6 +101,19 @@ public:
      */
     void addPlan(std::unique_ptr<QuerySolution> solution, PlanStage* root, WorkingSet* sharedWs);
 
+    /**
+     * Takes ownership of PlanStage and of 'candidateWs', the WorkingSet used by the plan rooted at
+     * 'root' and by no other plan. Results of the plan are moved into 'sharedWs' as this stage
+     * returns them. Does not take ownership of 'sharedWs'.
+     *
+     * The candidates of a MultiPlanStage can only be trialed concurrently if every one of them was
+     * added this way. See pickBestPlan().
+     */
+    void addPlan(std::unique_ptr<QuerySolution> solution,
+                 PlanStage* root,
+                 std::unique_ptr<WorkingSet> candidateWs,
+                 WorkingSet* sharedWs);
+
     /**
      * Runs all plans added by addPlan, ranks them, and picks a best.
      * All further calls to work(...) will return results from the best plan.
@@ -107,6 +122,11 @@ public:
      * works of the candidate plans. By default, 'yieldPolicy' is NULL and no yielding will
      * take place.
      *
+     * If every candidate has its own WorkingSet, 'internalQueryEnableParallelPlanEvaluation' is
+     * set and 'yieldPolicy' allows the snapshot to change, the candidates are instead worked
+     * concurrently on the QueryWorkerPool, and the trial period ends as soon as any of them hits
+     * EOF or returns enough results.
+     *
      * Returns a non-OK status if query planning fails. In particular, this function returns
      * ErrorCodes::QueryPlanKilled if the query plan was killed during a yield.
      */
@@ -153,11 +173,27 @@ public:
     static const char* kStageType;
 
 protected:
-    void doSaveStateRequiresCollection() final {}
+    void doSaveStateRequiresCollection() final;
 
     void doRestoreStateRequiresCollection() final {}
 
 private:
+    // The resources with which raceAllPlans() works one of the candidate plans.
+    struct TrialWorker {
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+
+        // How many times the candidate has been worked over all rounds.
+        size_t works = 0;
+
+        // Set if the candidate failed in the last round, along with the id of its status member.
+        bool failed = false;
+        WorkingSetID failureId = WorkingSet::INVALID_ID;
+
+        // Set if working the candidate threw in the last round.
+        Status status = Status::OK();
+    };
+
     //
     // Have all our candidate plans do something.
     // If all our candidate plans fail, *objOut will contain
@@ -172,6 +208,46 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Works every candidate plan concurrently on the QueryWorkerPool until any plan hits EOF or
+     * returns 'numResults' results, or every plan has been worked 'numWorks' times or has failed.
+     *
+     * Each candidate is worked by its own OperationContext, which reads from its own snapshot and
+     * takes no locks of its own. Instead, the candidates are worked in rounds of at most
+     * 'internalQueryExecYieldPeriodMS', during which this operation waits for them while holding
+     * its locks, so the collection cannot be dropped or have its indexes changed under them.
+     *
+     * Between rounds the candidates are reattached to this operation, which then checks for
+     * interrupt and may yield through 'yieldPolicy' exactly as workAllPlans() does. Since the
+     * worker OperationContexts are not killed along with this operation, the candidates also stop
+     * working as soon as this operation is marked killed, and the interrupt is reported at the end
+     * of the round.
+     *
+     * Returns false if planning failed, in which case '_failure' is set.
+     */
+    bool raceAllPlans(size_t numWorks, size_t numResults, PlanYieldPolicy* yieldPolicy);
+
+    /**
+     * Returns whether the candidate plans can be trialed by raceAllPlans().
+     */
+    bool canRaceAllPlans(PlanYieldPolicy* yieldPolicy) const;
+
+    /**
+     * Works the candidate plan '_candidates[candidateIdx]' on the current thread for one round of
+     * raceAllPlans(), setting '*stopTrial' once the trial period should end.
+     */
+    void runTrialRound(size_t candidateIdx,
+                       TrialWorker* worker,
+                       size_t numWorks,
+                       size_t numResults,
+                       AtomicWord<bool>* stopTrial);
+
+    /**
+     * Moves the member 'id' produced by 'candidate' into the WorkingSet shared by all candidates,
+     * if the candidate has its own WorkingSet, and returns its id there.
+     */
+    WorkingSetID toSharedWorkingSet(const CandidatePlan& candidate, WorkingSetID id);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -195,6 +271,11 @@ private:
     // one-to-one with _candidates.
     std::vector<CandidatePlan> _candidates;
 
+    // The WorkingSet in which this stage returns results. Candidates either share it or have one
+    // of their own, in which case it is owned by '_candidateWorkingSets'.
+    WorkingSet* _ws = nullptr;
+    std::vector<std::unique_ptr<WorkingSet>> _candidateWorkingSets;
+
     // index into _candidates, of the winner of the plan competition
     // uses -1 / kNoSuchPlan when best plan is not (yet) known
     int _bestPlanIdx;
@@ -220,7 +301,7 @@ private:
     size_t _failureCount;
 
     // if pickBestPlan fails, this is set to the wsid of the statusMember
-    // returned by ::work()
+    // returned by ::work(), within '_ws'
     WorkingSetID _statusMemberId;
 
     // Stats
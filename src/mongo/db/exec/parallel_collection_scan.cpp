@@ -0,0 +1,291 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_worker_pool.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* opCtx,
+                                               const Collection* collection,
+                                               size_t numWorkers,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter)
+    : RequiresCollectionStage(kStageType, opCtx, collection),
+      _workingSet(workingSet),
+      _filter(filter),
+      _numWorkers(numWorkers) {
+    invariant(_numWorkers > 0);
+    invariant(collection->getRecordStore()->supportsSeekAtOrPast());
+}
+
+ParallelCollectionScan::~ParallelCollectionScan() {
+    destroyWorkers();
+}
+
+PlanStage::StageState ParallelCollectionScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_initialized) {
+        try {
+            if (!initWorkers()) {
+                _commonStats.isEOF = true;
+                return PlanStage::IS_EOF;
+            }
+        } catch (const WriteConflictException&) {
+            // Leave us in a state to try again next time.
+            destroyWorkers();
+            _specificStats.workers.clear();
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+        _initialized = true;
+        return PlanStage::NEED_TIME;
+    }
+
+    // Return the results buffered by the last round, if any remain.
+    for (; _currentWorker < _workers.size(); ++_currentWorker) {
+        Worker* worker = _workers[_currentWorker].get();
+        if (worker->nextResult < worker->results.size()) {
+            auto& result = worker->results[worker->nextResult++];
+
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->recordId = result.first;
+            // The document was read by the worker's RecoveryUnit, so it is not associated with any
+            // snapshot of this operation.
+            member->obj = {SnapshotId(), std::move(result.second)};
+            _workingSet->transitionToRecordIdAndObj(id);
+
+            *out = id;
+            return PlanStage::ADVANCED;
+        }
+    }
+
+    if (std::all_of(_workers.begin(), _workers.end(), [](auto&& worker) {
+            return worker->exhausted;
+        })) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    Status status = runRound();
+    _currentWorker = 0;
+    if (!status.isOK()) {
+        *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+        return PlanStage::FAILURE;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
+bool ParallelCollectionScan::initWorkers() {
+    const RecordStore* recordStore = collection()->getRecordStore();
+
+    // Find the lowest and highest RecordIds in the collection and split the range between them
+    // into one contiguous range of equal width per worker.
+    auto first = recordStore->getCursor(getOpCtx(), true)->next();
+    if (!first) {
+        return false;
+    }
+    auto last = recordStore->getCursor(getOpCtx(), false)->next();
+    invariant(last);
+
+    const int64_t lo = first->id.repr();
+    const int64_t hi = std::max(lo, last->id.repr());
+    const int64_t width = (hi - lo) / static_cast<int64_t>(_numWorkers) + 1;
+
+    auto serviceContext = getOpCtx()->getServiceContext();
+    for (int64_t start = lo; start <= hi && _workers.size() < _numWorkers; start += width) {
+        auto worker = std::make_unique<Worker>();
+        worker->start = RecordId(start);
+        if (hi - start >= width && _workers.size() + 1 < _numWorkers) {
+            worker->end = RecordId(start + width);
+        }
+
+        worker->client = serviceContext->makeClient(str::stream() << kStageType << "-"
+                                                                  << _workers.size());
+        {
+            // The worker borrows the locks held by this operation. See the class comment.
+            AlternativeClientRegion acr(worker->client);
+            worker->opCtx =
+                QueryWorkerPool::makeWorkerOperationContext(getOpCtx(), worker->client.get());
+        }
+
+        ParallelCollectionScanStats::WorkerStats workerStats;
+        workerStats.minRecord = worker->start;
+        workerStats.maxRecord = worker->end;
+        _specificStats.workers.push_back(workerStats);
+        _workers.push_back(std::move(worker));
+    }
+
+    return true;
+}
+
+Status ParallelCollectionScan::runRound() {
+    const RecordStore* recordStore = collection()->getRecordStore();
+    const size_t chunkSize = internalQueryParallelCollectionScanChunkSize.load();
+
+    std::vector<QueryWorkerPool::Task> tasks;
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        Worker* worker = _workers[i].get();
+        worker->results.clear();
+        worker->nextResult = 0;
+        if (worker->exhausted) {
+            continue;
+        }
+
+        auto workerStats = &_specificStats.workers[i];
+        tasks.push_back([this, worker, workerStats, recordStore, chunkSize] {
+            scanChunk(worker, workerStats, recordStore, chunkSize);
+        });
+    }
+    QueryWorkerPool::get(getOpCtx()->getServiceContext())->runAll(std::move(tasks));
+
+    _specificStats.docsTested = 0;
+    for (auto&& workerStats : _specificStats.workers) {
+        _specificStats.docsTested += workerStats.docsTested;
+    }
+
+    for (auto&& worker : _workers) {
+        if (!worker->status.isOK()) {
+            return worker->status;
+        }
+    }
+    return Status::OK();
+}
+
+void ParallelCollectionScan::scanChunk(Worker* worker,
+                                       ParallelCollectionScanStats::WorkerStats* stats,
+                                       const RecordStore* recordStore,
+                                       size_t chunkSize) {
+    AlternativeClientRegion acr(worker->client);
+    OperationContext* opCtx = worker->opCtx.get();
+    Timer timer;
+    ++stats->rounds;
+
+    try {
+        if (!worker->cursor) {
+            worker->cursor = recordStore->getCursor(opCtx, true);
+            worker->positioned = false;
+        } else {
+            // Positions which no longer exist are only lost in capped collections, which are never
+            // scanned in parallel.
+            invariant(worker->cursor->restore());
+        }
+
+        for (size_t numRead = 0; numRead < chunkSize; ++numRead) {
+            auto record = worker->positioned ? worker->cursor->next()
+                                             : worker->cursor->seekAtOrPast(worker->start);
+            worker->positioned = true;
+
+            if (!record || (!worker->end.isNull() && record->id >= worker->end)) {
+                worker->exhausted = true;
+                break;
+            }
+
+            ++stats->docsTested;
+            BSONObj obj = record->data.toBson();
+            if (!_filter || _filter->matchesBSON(obj)) {
+                worker->results.emplace_back(record->id, obj.getOwned());
+                ++stats->docsReturned;
+            }
+        }
+        worker->cursor->save();
+    } catch (const WriteConflictException&) {
+        // The cursor keeps its position, so simply retry from there in the next round, using a
+        // new snapshot.
+        if (worker->cursor) {
+            worker->cursor->save();
+        }
+    } catch (const DBException& ex) {
+        worker->status = ex.toStatus();
+    }
+
+    opCtx->recoveryUnit()->abandonSnapshot();
+    stats->executionTimeMillis += timer.millis();
+}
+
+void ParallelCollectionScan::destroyWorkers() {
+    for (auto&& worker : _workers) {
+        AlternativeClientRegion acr(worker->client);
+        worker->cursor.reset();
+        worker->opCtx.reset();
+    }
+    _workers.clear();
+}
+
+bool ParallelCollectionScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ParallelCollectionScan::doDispose() {
+    destroyWorkers();
+}
+
+std::unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (nullptr != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    ret->specific = std::make_unique<ParallelCollectionScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
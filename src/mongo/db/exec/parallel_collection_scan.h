@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+class RecordStore;
+class SeekableRecordCursor;
+class WorkingSet;
+
+/**
+ * Scans a collection by dividing its RecordId space into one contiguous range per worker and
+ * scanning the ranges concurrently on threads of the QueryWorkerPool. Results are returned in no
+ * particular order.
+ *
+ * The stage proceeds in rounds. In each round every worker which has not exhausted its range
+ * reads up to 'internalQueryParallelCollectionScanChunkSize' records, applies the filter, and
+ * buffers the matching documents. The documents buffered by a round are then returned one per
+ * call to work(), after which the next round is started. Between rounds, workers hold no storage
+ * engine snapshot, so the stage can be yielded like a regular collection scan.
+ *
+ * Workers read through their own Client and OperationContext, and therefore through their own
+ * RecoveryUnit. They do not acquire locks: a round only runs within a call to work(), during
+ * which the operation which owns this stage holds the collection lock on their behalf.
+ *
+ * Preconditions: the collection's RecordStore supports seekAtOrPast(), and 'filter' is safe to
+ * evaluate concurrently from several threads.
+ */
+class ParallelCollectionScan final : public RequiresCollectionStage {
+public:
+    static const char* kStageType;
+
+    ParallelCollectionScan(OperationContext* opCtx,
+                           const Collection* collection,
+                           size_t numWorkers,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter);
+
+    ~ParallelCollectionScan();
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    /**
+     * Returns the number of workers the collection is split into. Fewer may be started if the
+     * collection holds too few records to give each of them a range.
+     */
+    size_t getNumWorkers() const {
+        return _numWorkers;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+protected:
+    void doSaveStateRequiresCollection() final {}
+
+    void doRestoreStateRequiresCollection() final {}
+
+    void doDispose() final;
+
+private:
+    struct Worker {
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        std::unique_ptr<SeekableRecordCursor> cursor;
+
+        // The range of RecordIds scanned by this worker. The end of the range is exclusive, and a
+        // null 'end' means that the range extends to the end of the collection.
+        RecordId start;
+        RecordId end;
+
+        // Whether 'cursor' has been positioned within the range, and whether the whole range has
+        // been scanned.
+        bool positioned = false;
+        bool exhausted = false;
+
+        // Documents which passed the filter in the last round and have not yet been returned.
+        std::vector<std::pair<RecordId, BSONObj>> results;
+        size_t nextResult = 0;
+
+        // Set if the last round failed.
+        Status status = Status::OK();
+    };
+
+    /**
+     * Divides the RecordId space of the collection among the workers. Returns false if the
+     * collection is empty.
+     */
+    bool initWorkers();
+
+    /**
+     * Runs one round of scanning for every worker which has not exhausted its range. Returns the
+     * first error encountered by any worker, if any.
+     */
+    Status runRound();
+
+    /**
+     * Reads up to 'chunkSize' records from the range of 'worker' on the current thread.
+     */
+    void scanChunk(Worker* worker,
+                   ParallelCollectionScanStats::WorkerStats* stats,
+                   const RecordStore* recordStore,
+                   size_t chunkSize);
+
+    void destroyWorkers();
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    const size_t _numWorkers;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    bool _initialized = false;
+
+    // The worker whose results are currently being returned.
+    size_t _currentWorker = 0;
+
+    ParallelCollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
@@ -42,6 +42,61 @@ namespace mongo {
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return _workAndRecordStats(out);
+}
+
+PlanStage::StageState PlanStage::workBatch(WorkingSet* ws,
+                                           size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return doWorkBatch(ws, maxWorks, results, out);
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(WorkingSet* ws,
+                                             size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out) {
+    StageState state = NEED_TIME;
+    for (size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        state = _workAndRecordStats(&id);
+
+        if (ADVANCED == state) {
+            // The data backing an unowned result may be invalidated by the next unit of work, for
+            // instance when a storage engine cursor is advanced.
+            ws->get(id)->makeObjOwnedIfNeeded();
+            results->push_back(id);
+        } else if (NEED_TIME != state) {
+            *out = id;
+            break;
+        }
+    }
+    return state;
+}
+
+void PlanStage::recordPassThroughBatchStats(const CommonStats& childStatsBefore,
+                                            size_t numAdvanced,
+                                            StageState finalState) {
+    const CommonStats* childStats = child()->getCommonStats();
+    const size_t childAdvanced = childStats->advanced - childStatsBefore.advanced;
+    invariant(numAdvanced <= childAdvanced);
+
+    // Each unit of work performed by the child corresponds to one unit of work of this stage.
+    // Child results which were discarded by this stage would have been reported as NEED_TIME.
+    _commonStats.works += childStats->works - childStatsBefore.works;
+    _commonStats.advanced += numAdvanced;
+    _commonStats.needTime +=
+        (childStats->needTime - childStatsBefore.needTime) + (childAdvanced - numAdvanced);
+    _commonStats.needYield += childStats->needYield - childStatsBefore.needYield;
+    if (FAILURE == finalState) {
+        _commonStats.failed = true;
+    }
+}
+
+PlanStage::StageState PlanStage::_workAndRecordStats(WorkingSetID* out) {
     ++_commonStats.works;
 
     StageState workResult = doWork(out);
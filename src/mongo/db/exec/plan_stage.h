@@ -193,6 +193,27 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Perform up to 'maxWorks' units of work on the query, appending the id of every result
+     * produced to 'results'. 'ws' must be the WorkingSet shared by all stages of the tree. Results
+     * appended to 'results' are owned by the caller, who must free them from the working set when
+     * done with them. Any RID_AND_OBJ results are guaranteed to own their BSON, so they remain
+     * valid across subsequent calls to work() or workBatch().
+     *
+     * Returns the state of the last unit of work performed. ADVANCED or NEED_TIME indicate that
+     * the work budget was exhausted and that workBatch() may be called again; note that in the
+     * ADVANCED case the last result has already been appended to 'results' and is not reported
+     * through 'out'. Any other state ends the batch early and has the same meaning, and populates
+     * 'out' in the same way, as if it had been returned by work().
+     *
+     * Stages which do not override doWorkBatch() are driven through their per-result doWork()
+     * implementation, so every stage can be used in batch mode.
+     */
+    StageState workBatch(WorkingSet* ws,
+                         size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -341,6 +362,29 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work. See comment at workBatch() above.
+     *
+     * The default implementation calls doWork() in a loop, accounting for each unit of work in
+     * '_commonStats' exactly as work() would. Stages which can process a batch of their child's
+     * results more efficiently than one at a time may override this.
+     */
+    virtual StageState doWorkBatch(WorkingSet* ws,
+                                   size_t maxWorks,
+                                   std::vector<WorkingSetID>* results,
+                                   WorkingSetID* out);
+
+    /**
+     * Helper for stages which implement doWorkBatch() by pulling a batch from their only child and
+     * passing through or discarding each of its results. Credits this stage with the units of work
+     * performed by the child since 'childStatsBefore' was captured, of which 'numAdvanced'
+     * produced a result of this stage, so that the resulting stats are identical to those produced
+     * by the per-result path.
+     */
+    void recordPassThroughBatchStats(const CommonStats& childStatsBefore,
+                                     size_t numAdvanced,
+                                     StageState finalState);
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -385,6 +429,11 @@ protected:
     CommonStats _commonStats;
 
 private:
+    /**
+     * Performs one unit of work and updates '_commonStats' according to the resulting state.
+     */
+    StageState _workAndRecordStats(WorkingSetID* out);
+
     OperationContext* _opCtx;
 };
 
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
@@ -37,6 +38,7 @@
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/stage_types.h"
+#include "mongo/db/record_id.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -159,6 +161,12 @@ struct AndHashStats : public SpecificStats {
 
     // What's our memory limit?
     size_t memLimit = 0u;
+
+    // How many child results did the Bloom filter reject without probing the hash table?
+    size_t bloomFilterRejects = 0u;
+
+    // Did we exceed memLimit and fall back to intersecting record ids alone?
+    bool recordIdIntersection = false;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -207,6 +215,29 @@ struct CollectionScanStats : public SpecificStats {
     // document that does not pass the filter and has a "ts" Timestamp field greater than 'maxTs'.
     // Must only be set on forward oplog scans.
     boost::optional<Timestamp> maxTs;
+
+    // The RecordId bounds of a forward scan over a clustered collection, if any.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+};
+
+struct ColumnScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        ColumnScanStats* specific = new ColumnScanStats(*this);
+        // BSON objects have to be explicitly copied.
+        specific->keyPattern = keyPattern.getOwned();
+        return specific;
+    }
+
+    std::string indexName;
+
+    BSONObj keyPattern;
+
+    // The columns read by the scan, in the order they are appended to each returned document.
+    std::vector<std::string> fields;
+
+    // Number of entries read from the row column and the field columns.
+    size_t keysExamined = 0u;
 };
 
 struct CountStats : public SpecificStats {
@@ -346,6 +377,11 @@ struct FetchStats : public SpecificStats {
 
     // The total number of full documents touched by the fetch stage.
     size_t docsExamined = 0u;
+
+    // The most RecordIds fetched together in RecordId order, or 0 if they are fetched one at a
+    // time, and how many such batches were fetched.
+    size_t batchSize = 0u;
+    size_t batches = 0u;
 };
 
 struct IDHackStats : public SpecificStats {
@@ -426,6 +462,9 @@ struct IndexScanStats : public SpecificStats {
 
     // Number of times the index cursor is re-positioned during the execution of the scan.
     size_t seeks;
+
+    // The number of keys the planner expected the scan to examine, if the index has statistics.
+    boost::optional<double> estimatedKeysExamined;
 };
 
 struct LimitStats : public SpecificStats {
@@ -453,6 +492,22 @@ struct MultiPlanStats : public SpecificStats {
     SpecificStats* clone() const final {
         return new MultiPlanStats(*this);
     }
+
+    // Time spent by one candidate plan during a concurrent trial period, on its own thread.
+    struct CandidateTrialStats {
+        // How many times was this candidate scheduled?
+        size_t rounds = 0u;
+
+        long long wallTimeMicros = 0;
+        long long cpuTimeMicros = 0;
+    };
+
+    // True if the candidate plans were trialed concurrently on the query worker pool.
+    bool concurrentTrial = false;
+
+    // One entry per candidate plan, in the order in which the plans were added. Only populated if
+    // 'concurrentTrial' is true.
+    std::vector<CandidateTrialStats> candidates;
 };
 
 struct OrStats : public SpecificStats {
@@ -467,6 +522,36 @@ struct OrStats : public SpecificStats {
     size_t dupsDropped = 0u;
 };
 
+struct ParallelCollectionScanStats : public SpecificStats {
+    ParallelCollectionScanStats() = default;
+
+    SpecificStats* clone() const final {
+        ParallelCollectionScanStats* specific = new ParallelCollectionScanStats(*this);
+        return specific;
+    }
+
+    // Stats of one of the workers, each of which scans a range of RecordIds on its own thread.
+    struct WorkerStats {
+        // The range of RecordIds scanned by the worker. A null 'maxRecord' means that the range
+        // extends to the end of the collection.
+        RecordId minRecord;
+        RecordId maxRecord;
+
+        // How many documents did this worker check against the filter, and how many passed?
+        size_t docsTested = 0u;
+        size_t docsReturned = 0u;
+
+        // How many times was this worker scheduled, and how long did it spend scanning in total?
+        size_t rounds = 0u;
+        long long executionTimeMillis = 0;
+    };
+
+    // The sum of 'docsTested' over all of the workers.
+    size_t docsTested = 0u;
+
+    std::vector<WorkerStats> workers;
+};
+
 struct ProjectionStats : public SpecificStats {
     ProjectionStats() {}
 
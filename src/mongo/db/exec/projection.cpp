@@ -177,6 +177,37 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(WorkingSet* ws,
+                                                   size_t maxWorks,
+                                                   std::vector<WorkingSetID>* results,
+                                                   WorkingSetID* out) {
+    const CommonStats childStatsBefore = *child()->getCommonStats();
+    const size_t firstResult = results->size();
+    StageState status = child()->workBatch(ws, maxWorks, results, out);
+
+    for (size_t i = firstResult; i < results->size(); ++i) {
+        Status projStatus = transform(_ws.get((*results)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+
+            // Discard the results which have not been projected, including the one which failed.
+            for (size_t j = i; j < results->size(); ++j) {
+                _ws.free((*results)[j]);
+            }
+            if (PlanStage::FAILURE == status && WorkingSet::INVALID_ID != *out) {
+                _ws.free(*out);
+            }
+            results->resize(i);
+            *out = WorkingSetCommon::allocateStatusMember(&_ws, projStatus);
+            status = PlanStage::FAILURE;
+            break;
+        }
+    }
+
+    recordPassThroughBatchStats(childStatsBefore, results->size() - firstResult, status);
+    return status;
+}
+
 std::unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     auto ret = std::make_unique<PlanStageStats>(_commonStats, stageType());
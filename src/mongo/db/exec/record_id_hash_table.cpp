@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_hash_table.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+constexpr size_t kInitialSlots = 16;
+
+// Bits of filter per expected RecordId.
+constexpr size_t kBloomFilterBitsPerRecordId = 10;
+
+/**
+ * Mixes the bits of a RecordId, which are usually small and sequential, so that every bit of the
+ * result depends on every bit of the input.
+ */
+uint64_t mix(RecordId rid) {
+    uint64_t x = static_cast<uint64_t>(rid.repr());
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+}  // namespace
+
+RecordIdHashTable::RecordIdHashTable() : _slots(kInitialSlots) {}
+
+size_t RecordIdHashTable::_homeSlot(RecordId rid) const {
+    return mix(rid) & (_slots.size() - 1);
+}
+
+size_t RecordIdHashTable::_findSlot(RecordId rid) const {
+    const size_t mask = _slots.size() - 1;
+    size_t i = _homeSlot(rid);
+    while (_slots[i].id != WorkingSet::INVALID_ID && _slots[i].rid != rid) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+bool RecordIdHashTable::insert(RecordId rid, WorkingSetID id) {
+    invariant(id != WorkingSet::INVALID_ID);
+    if ((_size + 1) * 2 > _slots.size()) {
+        _grow();
+    }
+
+    Slot& slot = _slots[_findSlot(rid)];
+    if (slot.id != WorkingSet::INVALID_ID) {
+        return false;
+    }
+    slot.rid = rid;
+    slot.id = id;
+    slot.marked = false;
+    ++_size;
+    return true;
+}
+
+WorkingSetID RecordIdHashTable::find(RecordId rid) const {
+    return _slots[_findSlot(rid)].id;
+}
+
+WorkingSetID RecordIdHashTable::mark(RecordId rid) {
+    Slot& slot = _slots[_findSlot(rid)];
+    if (slot.id != WorkingSet::INVALID_ID) {
+        slot.marked = true;
+    }
+    return slot.id;
+}
+
+WorkingSetID RecordIdHashTable::erase(RecordId rid) {
+    const size_t mask = _slots.size() - 1;
+    size_t hole = _findSlot(rid);
+    const WorkingSetID id = _slots[hole].id;
+    if (id == WorkingSet::INVALID_ID) {
+        return id;
+    }
+
+    // Shift back any entries which were displaced past the erased one, so that lookups never need
+    // to skip over deleted slots.
+    for (size_t i = (hole + 1) & mask; _slots[i].id != WorkingSet::INVALID_ID; i = (i + 1) & mask) {
+        const size_t home = _homeSlot(_slots[i].rid);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            _slots[hole] = _slots[i];
+            hole = i;
+        }
+    }
+    _slots[hole] = Slot();
+    --_size;
+    return id;
+}
+
+void RecordIdHashTable::clear() {
+    _slots.assign(kInitialSlots, Slot());
+    _size = 0;
+}
+
+void RecordIdHashTable::_grow() {
+    std::vector<Slot> slots(_slots.size() * 2);
+    slots.swap(_slots);
+    _size = 0;
+    for (auto&& slot : slots) {
+        if (slot.id != WorkingSet::INVALID_ID) {
+            _slots[_findSlot(slot.rid)] = slot;
+            ++_size;
+        }
+    }
+}
+
+void RecordIdBloomFilter::reset(size_t expectedSize) {
+    const size_t bitsPerBlock = kWordsPerBlock * 64;
+    size_t numBlocks = 1;
+    while (numBlocks * bitsPerBlock < expectedSize * kBloomFilterBitsPerRecordId) {
+        numBlocks *= 2;
+    }
+    _words.assign(numBlocks * kWordsPerBlock, 0);
+    _blockMask = numBlocks - 1;
+}
+
+void RecordIdBloomFilter::add(RecordId rid) {
+    invariant(!_words.empty());
+    const uint64_t hash = mix(rid);
+    uint64_t* block = &_words[((hash >> 40) & _blockMask) * kWordsPerBlock];
+    // Take one six bit position within each word of the block from the low 48 bits of the hash.
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        block[i] |= 1ULL << ((hash >> (i * 6)) & 63);
+    }
+}
+
+bool RecordIdBloomFilter::mayContain(RecordId rid) const {
+    if (_words.empty()) {
+        return true;
+    }
+    const uint64_t hash = mix(rid);
+    const uint64_t* block = &_words[((hash >> 40) & _blockMask) * kWordsPerBlock];
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        if (!(block[i] & (1ULL << ((hash >> (i * 6)) & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A hash table from RecordIds to the WorkingSetIDs of the members holding them, used by the hashed
+ * AND stage. Entries live in a single array probed linearly, so that a lookup usually touches one
+ * cache line, rather than chasing a bucket's linked list as stdx::unordered_map does.
+ *
+ * Each entry also carries a mark, with which the AND records which entries the child it is
+ * currently reading has produced.
+ */
+class RecordIdHashTable {
+    RecordIdHashTable(const RecordIdHashTable&) = delete;
+    RecordIdHashTable& operator=(const RecordIdHashTable&) = delete;
+
+public:
+    RecordIdHashTable();
+
+    /**
+     * Maps 'rid' to 'id'. Returns false, leaving the table unchanged, if 'rid' is already present.
+     * 'id' must not be WorkingSet::INVALID_ID.
+     */
+    bool insert(RecordId rid, WorkingSetID id);
+
+    /**
+     * Returns the WorkingSetID mapped to 'rid', or WorkingSet::INVALID_ID if there is none.
+     */
+    WorkingSetID find(RecordId rid) const;
+
+    /**
+     * Marks the entry for 'rid'. Returns the WorkingSetID mapped to it, or WorkingSet::INVALID_ID
+     * if there is none.
+     */
+    WorkingSetID mark(RecordId rid);
+
+    /**
+     * Removes the entry for 'rid'. Returns the WorkingSetID it was mapped to, or
+     * WorkingSet::INVALID_ID if there was none.
+     */
+    WorkingSetID erase(RecordId rid);
+
+    /**
+     * Removes every entry which is not marked, calling 'onErase' with the WorkingSetID of each,
+     * then unmarks the remaining entries.
+     */
+    template <typename OnErase>
+    void eraseUnmarked(OnErase onErase) {
+        std::vector<Slot> slots;
+        slots.swap(_slots);
+        _slots.resize(slots.size());
+        _size = 0;
+        for (auto&& slot : slots) {
+            if (slot.id == WorkingSet::INVALID_ID) {
+                continue;
+            }
+            if (slot.marked) {
+                insert(slot.rid, slot.id);
+            } else {
+                onErase(slot.id);
+            }
+        }
+    }
+
+    /**
+     * Calls 'fn' with the RecordId, WorkingSetID and mark of each entry, in no particular order.
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (auto&& slot : _slots) {
+            if (slot.id != WorkingSet::INVALID_ID) {
+                fn(slot.rid, slot.id, slot.marked);
+            }
+        }
+    }
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+private:
+    struct Slot {
+        RecordId rid;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        bool marked = false;
+    };
+
+    size_t _homeSlot(RecordId rid) const;
+
+    // Returns the index of the slot holding 'rid', or of the empty slot where it would be inserted.
+    size_t _findSlot(RecordId rid) const;
+
+    void _grow();
+
+    // Always a power of two in size, and at most half full.
+    std::vector<Slot> _slots;
+    size_t _size = 0;
+};
+
+/**
+ * A Bloom filter over RecordIds. Each RecordId sets eight bits within a single 64 byte block, so
+ * that a lookup costs one cache miss. With the ten bits per expected RecordId allotted here, about
+ * one lookup in a hundred of a RecordId which was not added returns a false positive.
+ */
+class RecordIdBloomFilter {
+public:
+    /**
+     * Constructs an empty filter which rejects nothing until reset().
+     */
+    RecordIdBloomFilter() = default;
+
+    /**
+     * Empties the filter and sizes it for 'expectedSize' RecordIds.
+     */
+    void reset(size_t expectedSize);
+
+    void add(RecordId rid);
+
+    /**
+     * Returns false if 'rid' was certainly never added.
+     */
+    bool mayContain(RecordId rid) const;
+
+private:
+    static constexpr size_t kWordsPerBlock = 8;
+
+    std::vector<uint64_t> _words;
+    size_t _blockMask = 0;
+};
+
+}  // namespace mongo
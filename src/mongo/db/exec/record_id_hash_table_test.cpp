@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/db/exec/record_id_hash_table.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdHashTableTest, InsertFindAndErase) {
+    RecordIdHashTable table;
+    ASSERT(table.empty());
+
+    for (int i = 1; i <= 1000; ++i) {
+        ASSERT(table.insert(RecordId(i), i));
+    }
+    ASSERT_EQ(1000U, table.size());
+
+    // A second insert of the same RecordId must not replace the first.
+    ASSERT_FALSE(table.insert(RecordId(7), 12345));
+    ASSERT_EQ(7U, table.find(RecordId(7)));
+    ASSERT_EQ(WorkingSet::INVALID_ID, table.find(RecordId(1001)));
+
+    for (int i = 1; i <= 1000; i += 2) {
+        ASSERT_EQ(WorkingSetID(i), table.erase(RecordId(i)));
+    }
+    ASSERT_EQ(WorkingSet::INVALID_ID, table.erase(RecordId(1)));
+    ASSERT_EQ(500U, table.size());
+
+    // Erasing must not lose entries which were displaced past the erased ones.
+    for (int i = 1; i <= 1000; ++i) {
+        ASSERT_EQ(i % 2 ? WorkingSet::INVALID_ID : WorkingSetID(i), table.find(RecordId(i)));
+    }
+
+    table.clear();
+    ASSERT(table.empty());
+    ASSERT_EQ(WorkingSet::INVALID_ID, table.find(RecordId(2)));
+}
+
+TEST(RecordIdHashTableTest, EraseUnmarkedKeepsOnlyMarkedEntries) {
+    RecordIdHashTable table;
+    for (int i = 1; i <= 100; ++i) {
+        ASSERT(table.insert(RecordId(i), i));
+    }
+    for (int i = 10; i <= 100; i += 10) {
+        ASSERT_EQ(WorkingSetID(i), table.mark(RecordId(i)));
+    }
+    ASSERT_EQ(WorkingSet::INVALID_ID, table.mark(RecordId(200)));
+
+    std::set<WorkingSetID> erased;
+    table.eraseUnmarked([&](WorkingSetID id) { ASSERT(erased.insert(id).second); });
+    ASSERT_EQ(90U, erased.size());
+    ASSERT_EQ(10U, table.size());
+
+    // The surviving entries are no longer marked.
+    size_t visited = 0;
+    table.forEach([&](RecordId rid, WorkingSetID id, bool marked) {
+        ASSERT_EQ(0, rid.repr() % 10);
+        ASSERT_EQ(WorkingSetID(rid.repr()), id);
+        ASSERT_FALSE(marked);
+        ++visited;
+    });
+    ASSERT_EQ(10U, visited);
+}
+
+TEST(RecordIdBloomFilterTest, NoFalseNegatives) {
+    RecordIdBloomFilter filter;
+    ASSERT(filter.mayContain(RecordId(1)));
+
+    filter.reset(10000);
+    for (int i = 0; i < 10000; ++i) {
+        filter.add(RecordId(i * 3));
+    }
+    size_t falsePositives = 0;
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT(filter.mayContain(RecordId(i * 3)));
+        if (filter.mayContain(RecordId(i * 3 + 1))) {
+            ++falsePositives;
+        }
+    }
+    // The expected false positive rate is about 1%.
+    ASSERT_LT(falsePositives, 500U);
+}
+
+}  // namespace
+}  // namespace mongo
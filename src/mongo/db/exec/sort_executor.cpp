@@ -62,8 +62,8 @@ SortExecutor::SortExecutor(SortPattern sortPattern,
 
 int SortExecutor::Comparator::operator()(const DocumentSorter::Data& lhs,
                                          const DocumentSorter::Data& rhs) const {
-    Value lhsKey = lhs.first;
-    Value rhsKey = rhs.first;
+    const Value& lhsKey = lhs.first;
+    const Value& rhsKey = rhs.first;
     // DocumentSourceSort::populate() has already guaranteed that the sort key is non-empty.
     // However, the tricky part is deciding what to do if none of the sort keys are present. In that
     // case, consider the document "less".
@@ -93,6 +93,24 @@ void WorkingSet::clear() {
     _yieldSensitiveIds.clear();
 }
 
+WorkingSetMember WorkingSet::extract(WorkingSetID i) {
+    WorkingSetMember ret = std::move(*get(i));
+    free(i);
+    return ret;
+}
+
+WorkingSetID WorkingSet::emplace(WorkingSetMember&& holder) {
+    WorkingSetID id = allocate();
+    WorkingSetMember* member = get(id);
+    *member = std::move(holder);
+
+    // Members in the RID_AND_IDX state must be tracked by the working set which holds them.
+    if (member->getState() == WorkingSetMember::RID_AND_IDX) {
+        _yieldSensitiveIds.push_back(id);
+    }
+    return id;
+}
+
 void WorkingSet::transitionToRecordIdAndIdx(WorkingSetID id) {
     WorkingSetMember* member = get(id);
     member->_state = WorkingSetMember::RID_AND_IDX;
@@ -93,6 +93,17 @@ public:
      */
     void clear();
 
+    /**
+     * Removes the member with id 'i' from this working set and returns it, freeing 'i'.
+     */
+    WorkingSetMember extract(WorkingSetID i);
+
+    /**
+     * Allocates a new member holding the contents of 'holder' and returns its id. Together with
+     * extract(), allows moving a member from one working set to another.
+     */
+    WorkingSetID emplace(WorkingSetMember&& holder);
+
     //
     // WorkingSetMember state transitions
     //
@@ -198,6 +209,9 @@ public:
     WorkingSetMember();
     ~WorkingSetMember();
 
+    WorkingSetMember(WorkingSetMember&&) = default;
+    WorkingSetMember& operator=(WorkingSetMember&&) = default;
+
     /**
      * Reset to an "empty" state.
      */
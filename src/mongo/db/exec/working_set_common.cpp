@@ -89,7 +89,8 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
                                               IndexAccessMethod::GetKeysMode::kEnforceConstraints,
                                               &keys,
                                               multikeyMetadataKeys,
-                                              multikeyPaths);
+                                              multikeyPaths,
+                                              member->recordId);
             if (!keys.count(member->keyData[i].keyData)) {
                 // document would no longer be at this position in the index.
                 return false;
@@ -63,8 +63,19 @@ BtreeAccessMethod::BtreeAccessMethod(IndexCatalogEntry* btreeState,
 void BtreeAccessMethod::doGetKeys(const BSONObj& obj,
                                   BSONObjSet* keys,
                                   BSONObjSet* multikeyMetadataKeys,
-                                  MultikeyPaths* multikeyPaths) const {
+                                  MultikeyPaths* multikeyPaths,
+                                  boost::optional<RecordId> id) const {
     _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
+bool BtreeAccessMethod::doGetKeyStrings(const BSONObj& obj,
+                                        const RecordId& loc,
+                                        KeyStringArena* keys,
+                                        MultikeyPaths* multikeyPaths) const {
+    const SortedDataInterface* sdi = getSortedDataInterface();
+    _keyGenerator->getKeys(
+        obj, sdi->getKeyStringVersion(), sdi->getOrdering(), loc, keys, multikeyPaths);
+    return true;
+}
+
 }  // namespace mongo
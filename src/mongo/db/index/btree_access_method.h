@@ -51,7 +51,13 @@ private:
     void doGetKeys(const BSONObj& obj,
                    BSONObjSet* keys,
                    BSONObjSet* multikeyMetadataKeys,
-                   MultikeyPaths* multikeyPaths) const final;
+                   MultikeyPaths* multikeyPaths,
+                   boost::optional<RecordId> id) const final;
+
+    bool doGetKeyStrings(const BSONObj& obj,
+                         const RecordId& loc,
+                         KeyStringArena* keys,
+                         MultikeyPaths* multikeyPaths) const final;
 
     // Our keys differ for V0 and V1.
     std::unique_ptr<BtreeKeyGenerator> _keyGenerator;
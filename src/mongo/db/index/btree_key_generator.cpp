@@ -117,7 +117,7 @@ BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
 void BtreeKeyGenerator::_getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                                             std::vector<BSONElement>* fixed,
                                             const BSONElement& arrEntry,
-                                            BSONObjSet* keys,
+                                            KeyOutput* out,
                                             unsigned numNotFound,
                                             const BSONElement& arrObjElt,
                                             const std::set<size_t>& arrIdxs,
@@ -135,7 +135,7 @@ void BtreeKeyGenerator::_getKeysArrEltFixed(std::vector<const char*>* fieldNames
     _getKeysWithArray(*fieldNames,
                       *fixed,
                       arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
-                      keys,
+                      out,
                       numNotFound,
                       positionalInfo,
                       multikeyPaths);
@@ -144,23 +144,76 @@ void BtreeKeyGenerator::_getKeysArrEltFixed(std::vector<const char*>* fieldNames
 void BtreeKeyGenerator::getKeys(const BSONObj& obj,
                                 BSONObjSet* keys,
                                 MultikeyPaths* multikeyPaths) const {
+    KeyOutput out(keys);
+    _getKeys(obj, &out, multikeyPaths);
+}
+
+void BtreeKeyGenerator::getKeys(const BSONObj& obj,
+                                KeyString::Version version,
+                                Ordering ordering,
+                                const RecordId& loc,
+                                KeyStringArena* keys,
+                                MultikeyPaths* multikeyPaths) const {
+    invariant(keys->empty());
+    KeyOutput out(keys, version, ordering, loc);
+    _getKeys(obj, &out, multikeyPaths);
+    keys->sortAndDedup();
+}
+
+void BtreeKeyGenerator::_addKey(const std::vector<BSONElement>& fixed, KeyOutput* out) const {
+    if (out->keyStrings && !_collator) {
+        auto& keyString = out->keyStrings->next(out->version, out->ordering);
+        for (const auto& elt : fixed) {
+            keyString.appendBSONElement(elt);
+        }
+        keyString.appendRecordId(out->loc);
+        ++out->numKeys;
+        return;
+    }
+
+    BSONObjBuilder b(_sizeTracker);
+    for (const auto& elt : fixed) {
+        CollationIndexKey::collationAwareIndexKeyAppend(elt, _collator, &b);
+    }
+    _addKey(b.obj(), out);
+}
+
+void BtreeKeyGenerator::_addKey(const BSONObj& key, KeyOutput* out) const {
+    ++out->numKeys;
+    if (out->keys) {
+        out->keys->insert(key);
+    } else {
+        out->keyStrings->next(out->version, out->ordering)
+            .resetToKey(key, out->ordering, out->loc);
+    }
+}
+
+void BtreeKeyGenerator::_getKeys(const BSONObj& obj,
+                                 KeyOutput* out,
+                                 MultikeyPaths* multikeyPaths) const {
     if (_isIdIndex) {
         // we special case for speed
         BSONElement e = obj["_id"];
         if (e.eoo()) {
-            keys->insert(_nullKey);
+            _addKey(_nullKey, out);
         } else if (_collator) {
             BSONObjBuilder b;
             CollationIndexKey::collationAwareIndexKeyAppend(e, _collator, &b);
 
             // Insert a copy so its buffer size fits the object size.
-            keys->insert(b.obj().copy());
+            _addKey(b.obj().copy(), out);
+        } else if (out->keyStrings) {
+            auto& keyString = out->keyStrings->next(out->version, out->ordering);
+            keyString.appendBSONElement(e);
+            keyString.appendRecordId(out->loc);
+            ++out->numKeys;
         } else {
             int size = e.size() + 5 /* bson over head*/ - 3 /* remove _id string */;
             BSONObjBuilder b(size);
             b.appendAs(e, "");
-            keys->insert(b.obj());
-            invariant(keys->begin()->objsize() == size);
+            BSONObj key = b.obj();
+            invariant(key.objsize() == size);
+            _addKey(key, out);
         }
 
         // The {_id: 1} index can never be multikey because the _id field isn't allowed to be an
@@ -175,17 +228,17 @@ void BtreeKeyGenerator::getKeys(const BSONObj& obj,
         }
         // '_fieldNames' and '_fixed' are passed by value so that their copies can be mutated as
         // part of the _getKeysWithArray method.
-        _getKeysWithArray(_fieldNames, _fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+        _getKeysWithArray(_fieldNames, _fixed, obj, out, 0, _emptyPositionalInfo, multikeyPaths);
     }
-    if (keys->empty() && !_isSparse) {
-        keys->insert(_nullKey);
+    if (out->numKeys == 0 && !_isSparse) {
+        _addKey(_nullKey, out);
     }
 }
 
 void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
                                           std::vector<BSONElement> fixed,
                                           const BSONObj& obj,
-                                          BSONObjSet* keys,
+                                          KeyOutput* out,
                                           unsigned numNotFound,
                                           const std::vector<PositionalPathInfo>& positionalInfo,
                                           MultikeyPaths* multikeyPaths) const {
@@ -257,11 +310,7 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
         if (_isSparse && numNotFound == fieldNames.size()) {
             return;
         }
-        BSONObjBuilder b(_sizeTracker);
-        for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
-            CollationIndexKey::collationAwareIndexKeyAppend(*i, _collator, &b);
-        }
-        keys->insert(b.obj());
+        _addKey(fixed, out);
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // We've encountered an empty array.
         if (multikeyPaths && mayExpandArrayUnembedded) {
@@ -283,7 +332,7 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
         _getKeysArrEltFixed(&fieldNames,
                             &fixed,
                             undefinedElt,
-                            keys,
+                            out,
                             numNotFound,
                             arrElt,
                             arrIdxs,
@@ -365,7 +414,7 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
             _getKeysArrEltFixed(&fieldNames,
                                 &fixed,
                                 arrObjElem,
-                                keys,
+                                out,
                                 numNotFound,
                                 arrElt,
                                 arrIdxs,
@@ -35,8 +35,11 @@
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/key_string_arena.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 
@@ -68,7 +71,57 @@ public:
      */
     void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Like getKeys() above, but appends each key to 'keys' directly as a KeyString with the given
+     * version and ordering, followed by 'loc', without building a BSONObj for it. The KeyStrings
+     * are sorted and distinct on return.
+     */
+    void getKeys(const BSONObj& obj,
+                 KeyString::Version version,
+                 Ordering ordering,
+                 const RecordId& loc,
+                 KeyStringArena* keys,
+                 MultikeyPaths* multikeyPaths) const;
+
 private:
+    /**
+     * Where the generated keys go: BSONObjs into 'keys', or else KeyStrings ending in 'loc' into
+     * 'keyStrings'.
+     */
+    struct KeyOutput {
+        explicit KeyOutput(BSONObjSet* keys) : keys(keys), ordering(Ordering::make(BSONObj())) {}
+
+        KeyOutput(KeyStringArena* keyStrings,
+                  KeyString::Version version,
+                  Ordering ordering,
+                  const RecordId& loc)
+            : keyStrings(keyStrings), version(version), ordering(ordering), loc(loc) {}
+
+        BSONObjSet* keys = nullptr;
+        KeyStringArena* keyStrings = nullptr;
+        KeyString::Version version = KeyString::Version::kLatestVersion;
+        Ordering ordering;
+        RecordId loc;
+
+        // The number of keys generated so far.
+        size_t numKeys = 0;
+    };
+
+    /**
+     * Generates keys for 'obj' into 'out'. Shared by both forms of getKeys().
+     */
+    void _getKeys(const BSONObj& obj, KeyOutput* out, MultikeyPaths* multikeyPaths) const;
+
+    /**
+     * Adds the key made of the elements 'fixed' to 'out'.
+     */
+    void _addKey(const std::vector<BSONElement>& fixed, KeyOutput* out) const;
+
+    /**
+     * Adds the key 'key', which has no field names, to 'out'.
+     */
+    void _addKey(const BSONObj& key, KeyOutput* out) const;
+
     // These are used by getKeys below.
     std::vector<const char*> _fieldNames;
     bool _isIdIndex;
@@ -136,7 +189,7 @@ private:
     void _getKeysWithArray(std::vector<const char*> fieldNames,
                            std::vector<BSONElement> fixed,
                            const BSONObj& obj,
-                           BSONObjSet* keys,
+                           KeyOutput* out,
                            unsigned numNotFound,
                            const std::vector<PositionalPathInfo>& positionalInfo,
                            MultikeyPaths* multikeyPaths) const;
@@ -187,7 +240,7 @@ private:
     void _getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                              std::vector<BSONElement>* fixed,
                              const BSONElement& arrEntry,
-                             BSONObjSet* keys,
+                             KeyOutput* out,
                              unsigned numNotFound,
                              const BSONElement& arrObjElt,
                              const std::set<size_t>& arrIdxs,
@@ -143,6 +143,53 @@ bool testKeygen(const BSONObj& kp,
     if (!match) {
         log() << "Expected: " << dumpMultikeyPaths(expectedMultikeyPaths) << ", "
               << "Actual: " << dumpMultikeyPaths(actualMultikeyPaths);
+        return false;
+    }
+
+    //
+    // Step 4: generate the keys again as KeyStrings, and check that they are the expected keys
+    // encoded with the RecordId appended, in KeyString order.
+    //
+    const auto version = KeyString::Version::kLatestVersion;
+    const auto ordering = Ordering::make(kp);
+    const RecordId loc(17);
+
+    std::vector<std::unique_ptr<KeyString::Builder>> expectedKeyStrings;
+    for (const auto& key : expectedKeys) {
+        expectedKeyStrings.push_back(
+            std::make_unique<KeyString::Builder>(version, key, ordering, loc));
+    }
+    std::sort(expectedKeyStrings.begin(), expectedKeyStrings.end(), [](auto& lhs, auto& rhs) {
+        return lhs->compare(*rhs) < 0;
+    });
+
+    KeyStringArena actualKeyStrings;
+    MultikeyPaths actualKeyStringMultikeyPaths;
+    keyGen->getKeys(
+        obj, version, ordering, loc, &actualKeyStrings, &actualKeyStringMultikeyPaths);
+
+    match = (expectedKeyStrings.size() == actualKeyStrings.size());
+    for (size_t i = 0; match && i < actualKeyStrings.size(); ++i) {
+        match = (expectedKeyStrings[i]->compare(actualKeyStrings[i]) == 0);
+    }
+    if (!match) {
+        BSONObjSet actualKeysFromKeyStrings = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (size_t i = 0; i < actualKeyStrings.size(); ++i) {
+            actualKeysFromKeyStrings.insert(KeyString::toBson(actualKeyStrings[i].getBuffer(),
+                                                              actualKeyStrings[i].getSize(),
+                                                              ordering,
+                                                              actualKeyStrings[i].getTypeBits()));
+        }
+        log() << "Expected KeyStrings of: " << dumpKeyset(expectedKeys) << ", "
+              << "Actual: " << dumpKeyset(actualKeysFromKeyStrings);
+        return false;
+    }
+
+    match = (expectedMultikeyPaths == actualKeyStringMultikeyPaths);
+    if (!match) {
+        log() << "Expected KeyString multikey paths: " << dumpMultikeyPaths(expectedMultikeyPaths)
+              << ", "
+              << "Actual: " << dumpMultikeyPaths(actualKeyStringMultikeyPaths);
     }
 
     return match;
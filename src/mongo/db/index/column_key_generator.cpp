@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_key_generator.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+constexpr StringData ColumnKeyGenerator::kRowColumn;
+
+BSONObj ColumnKeyGenerator::makeKey(StringData column,
+                                    const RecordId& id,
+                                    const BSONElement& value) {
+    BSONObjBuilder bob;
+    bob.append("", column);
+    bob.append("", static_cast<long long>(id.repr()));
+    if (!value.eoo()) {
+        bob.appendAs(value, "");
+    }
+    return bob.obj();
+}
+
+BSONObj ColumnKeyGenerator::makeColumnPrefix(StringData column) {
+    return BSON("" << column);
+}
+
+BSONObj ColumnKeyGenerator::makeColumnPrefix(StringData column, const RecordId& id) {
+    return makeKey(column, id, BSONElement());
+}
+
+BSONElement ColumnKeyGenerator::extractValue(const BSONObj& key) {
+    BSONObjIterator it(key);
+    for (int i = 0; i < 2 && it.more(); ++i) {
+        it.next();
+    }
+    return it.more() ? it.next() : BSONElement();
+}
+
+ColumnKeyGenerator::ColumnKeyGenerator(const BSONObj& keyPattern) {
+    for (auto&& elem : keyPattern) {
+        _columns.push_back(elem.fieldName());
+    }
+}
+
+void ColumnKeyGenerator::generateKeys(const BSONObj& obj,
+                                      const RecordId& id,
+                                      BSONObjSet* keys) const {
+    for (auto&& column : _columns) {
+        BSONElement value = obj[column];
+        if (!value.eoo()) {
+            keys->insert(makeKey(column, id, value));
+        }
+    }
+    // Walk the document rather than the columns, so the row key records the stored field order.
+    BSONArrayBuilder storedOrder;
+    std::vector<StringData> seen;
+    for (auto&& elem : obj) {
+        StringData name = elem.fieldNameStringData();
+        if (std::find(_columns.begin(), _columns.end(), name) != _columns.end() &&
+            std::find(seen.begin(), seen.end(), name) == seen.end()) {
+            seen.push_back(name);
+            storedOrder.append(name);
+        }
+    }
+    BSONObj rowValue = BSON("" << storedOrder.arr());
+    keys->insert(makeKey(kRowColumn, id, rowValue.firstElement()));
+}
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * Generates the keys of a columnstore index, which stores each indexed top-level field as its own
+ * column. Every value of a column is a separate index key of the form
+ *      { '': <field name>, '': NumberLong(<RecordId>), '': <value> }
+ * so the keys for a column are clustered together and ordered by RecordId. Documents missing a
+ * field have no key in that field's column.
+ *
+ * Every document also has one key { '': '', '': NumberLong(<RecordId>), '': [<field name>, ...] }
+ * in the reserved row column, which enumerates the documents of the collection without reading any
+ * indexed field. Its value lists the indexed fields present in the document in the order they are
+ * stored, so that a document reassembled from the columns keeps the field order of the original.
+ * The empty string cannot be the name of an indexed field, so the row column never collides with
+ * one.
+ */
+class ColumnKeyGenerator {
+public:
+    /**
+     * The name of the reserved column holding one key per document.
+     */
+    static constexpr StringData kRowColumn = ""_sd;
+
+    /**
+     * Returns the key storing 'value' as the entry for 'id' in 'column'. 'value' is appended
+     * regardless of its field name. An EOO 'value' produces a key with no value, as in the row
+     * column.
+     */
+    static BSONObj makeKey(StringData column, const RecordId& id, const BSONElement& value);
+
+    /**
+     * Returns the key prefix shared by every key in 'column'.
+     */
+    static BSONObj makeColumnPrefix(StringData column);
+
+    /**
+     * Returns the key prefix shared by every key for 'id' in 'column'. Seeking exclusively past it
+     * positions a cursor on the first key in 'column' whose RecordId is greater than 'id'.
+     */
+    static BSONObj makeColumnPrefix(StringData column, const RecordId& id);
+
+    /**
+     * Returns the value stored by a columnstore index key. For a row column key this is the array
+     * of the document's indexed field names, in stored order.
+     */
+    static BSONElement extractValue(const BSONObj& key);
+
+    explicit ColumnKeyGenerator(const BSONObj& keyPattern);
+
+    /**
+     * Returns the names of the columns, in key pattern order.
+     */
+    const std::vector<std::string>& getColumns() const {
+        return _columns;
+    }
+
+    /**
+     * Adds the row column key for 'id' to 'keys', followed by one key for each column that is
+     * present in 'obj'. Only the first occurrence of a duplicated field name is indexed.
+     */
+    void generateKeys(const BSONObj& obj, const RecordId& id, BSONObjSet* keys) const;
+
+private:
+    std::vector<std::string> _columns;
+};
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/index/column_key_generator.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+BSONObjSet makeKeySet(std::initializer_list<BSONObj> init = {}) {
+    return SimpleBSONObjComparator::kInstance.makeBSONObjSet(std::move(init));
+}
+
+std::string dumpKeyset(const BSONObjSet& objs) {
+    std::stringstream ss;
+    ss << "[ ";
+    for (BSONObjSet::iterator i = objs.begin(); i != objs.end(); ++i) {
+        ss << i->toString() << " ";
+    }
+    ss << "]";
+
+    return ss.str();
+}
+
+bool assertKeysetsEqual(const BSONObjSet& expectedKeys, const BSONObjSet& actualKeys) {
+    if (expectedKeys.size() != actualKeys.size() ||
+        !std::equal(expectedKeys.begin(),
+                    expectedKeys.end(),
+                    actualKeys.begin(),
+                    SimpleBSONObjComparator::kInstance.makeEqualTo())) {
+        log() << "Expected: " << dumpKeyset(expectedKeys) << ", "
+              << "Actual: " << dumpKeyset(actualKeys);
+        return false;
+    }
+
+    return true;
+}
+
+TEST(ColumnKeyGeneratorTest, GeneratesRowKeyAndOneKeyPerColumn) {
+    ColumnKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    auto inputDoc = fromjson("{_id: 0, a: 1, b: 'two', c: 3}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': '', '': NumberLong(7), '': ['a', 'b']}"),
+                                    fromjson("{'': 'a', '': NumberLong(7), '': 1}"),
+                                    fromjson("{'': 'b', '': NumberLong(7), '': 'two'}")});
+
+    auto outputKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, RecordId(7), &outputKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+}
+
+TEST(ColumnKeyGeneratorTest, MissingFieldHasNoKey) {
+    ColumnKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    auto inputDoc = fromjson("{b: null}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': '', '': NumberLong(3), '': ['b']}"),
+                                    fromjson("{'': 'b', '': NumberLong(3), '': null}")});
+
+    auto outputKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, RecordId(3), &outputKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+}
+
+TEST(ColumnKeyGeneratorTest, ArraysAndObjectsAreStoredWhole) {
+    ColumnKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    auto inputDoc = fromjson("{a: [1, 2, {c: 3}], b: {d: [4]}}");
+
+    auto expectedKeys =
+        makeKeySet({fromjson("{'': '', '': NumberLong(1), '': ['a', 'b']}"),
+                    fromjson("{'': 'a', '': NumberLong(1), '': [1, 2, {c: 3}]}"),
+                    fromjson("{'': 'b', '': NumberLong(1), '': {d: [4]}}")});
+
+    auto outputKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, RecordId(1), &outputKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+}
+
+TEST(ColumnKeyGeneratorTest, RowKeyRecordsStoredFieldOrder) {
+    ColumnKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore', c: 'columnstore'}")};
+    auto inputDoc = fromjson("{c: 1, x: 2, a: 3, c: 4}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': '', '': NumberLong(2), '': ['c', 'a']}"),
+                                    fromjson("{'': 'a', '': NumberLong(2), '': 3}"),
+                                    fromjson("{'': 'c', '': NumberLong(2), '': 1}")});
+
+    auto outputKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, RecordId(2), &outputKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+}
+
+TEST(ColumnKeyGeneratorTest, ExtractValue) {
+    auto value = fromjson("{x: 'five'}");
+    auto key = ColumnKeyGenerator::makeKey("a", RecordId(5), value.firstElement());
+    ASSERT_BSONOBJ_EQ(key, fromjson("{'': 'a', '': NumberLong(5), '': 'five'}"));
+    ASSERT_EQ(ColumnKeyGenerator::extractValue(key).str(), "five");
+
+    auto rowKey = ColumnKeyGenerator::makeKey(ColumnKeyGenerator::kRowColumn, RecordId(5), {});
+    ASSERT(ColumnKeyGenerator::extractValue(rowKey).eoo());
+}
+
+TEST(ColumnKeyGeneratorTest, ColumnPrefixSortsBeforeEveryKeyInTheColumn) {
+    auto prefix = ColumnKeyGenerator::makeColumnPrefix("a");
+    auto first = ColumnKeyGenerator::makeColumnPrefix("a", RecordId(1));
+    auto second = ColumnKeyGenerator::makeKey("a", RecordId(2), BSON("" << MINKEY).firstElement());
+    auto otherColumn = ColumnKeyGenerator::makeColumnPrefix("b", RecordId(1));
+
+    ASSERT_LT(prefix.woCompare(first), 0);
+    ASSERT_LT(first.woCompare(second), 0);
+    ASSERT_LT(second.woCompare(otherColumn), 0);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,7 +42,8 @@ FTSAccessMethod::FTSAccessMethod(IndexCatalogEntry* btreeState,
 void FTSAccessMethod::doGetKeys(const BSONObj& obj,
                                 BSONObjSet* keys,
                                 BSONObjSet* multikeyMetadataKeys,
-                                MultikeyPaths* multikeyPaths) const {
+                                MultikeyPaths* multikeyPaths,
+                                boost::optional<RecordId> id) const {
     ExpressionKeysPrivate::getFTSKeys(obj, _ftsSpec, keys);
 }
 
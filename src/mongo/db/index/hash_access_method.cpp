@@ -58,7 +58,8 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState,
 void HashAccessMethod::doGetKeys(const BSONObj& obj,
                                  BSONObjSet* keys,
                                  BSONObjSet* multikeyMetadataKeys,
-                                 MultikeyPaths* multikeyPaths) const {
+                                 MultikeyPaths* multikeyPaths,
+                                 boost::optional<RecordId> id) const {
     ExpressionKeysPrivate::getHashKeys(
         obj, _hashedField, _seed, _hashVersion, _descriptor->isSparse(), _collator, keys);
 }
@@ -33,6 +33,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -47,6 +48,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
 #include "mongo/db/storage/durable_catalog.h"
@@ -84,6 +86,35 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
 std::vector<BSONObj> asVector(const BSONObjSet& objSet) {
     return {objSet.begin(), objSet.end()};
 }
+
+// Holds the KeyStrings generated for the document an operation is currently inserting, so that
+// their buffers are reused from one insert to the next.
+const auto getInsertKeyStrings = OperationContext::declareDecoration<KeyStringArena>();
+
+// The error codes thrown by key generation which may be suppressed when constraints are relaxed.
+const stdx::unordered_set<int> kSuppressibleGetKeysErrors{ErrorCodes::CannotBuildIndexKeys,
+                                                          // Btree
+                                                          ErrorCodes::CannotIndexParallelArrays,
+                                                          // FTS
+                                                          16732,
+                                                          16733,
+                                                          16675,
+                                                          17261,
+                                                          17262,
+                                                          // Hash
+                                                          16766,
+                                                          // Haystack
+                                                          16775,
+                                                          16776,
+                                                          // 2dsphere geo
+                                                          16755,
+                                                          16756,
+                                                          // 2d geo
+                                                          16804,
+                                                          13067,
+                                                          13068,
+                                                          13026,
+                                                          13027};
 }  // namespace
 
 class BtreeExternalSortComparison {
@@ -141,8 +172,15 @@ Status AbstractIndexAccessMethod::insert(OperationContext* opCtx,
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
+    // Index types which can generate their keys as KeyStrings skip building a BSONObj per key.
+    auto& keyStrings = getInsertKeyStrings(opCtx);
+    keyStrings.clear();
+    if (getKeyStrings(obj, options.getKeysMode, loc, &keyStrings, &multikeyPaths)) {
+        return insertKeyStrings(opCtx, keyStrings, multikeyPaths, loc, options, result);
+    }
+
     // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+    getKeys(obj, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths, loc);
 
     return insertKeys(opCtx,
                       {keys.begin(), keys.end()},
@@ -153,6 +191,47 @@ Status AbstractIndexAccessMethod::insert(OperationContext* opCtx,
                       result);
 }
 
+Status AbstractIndexAccessMethod::insertKeyStrings(OperationContext* opCtx,
+                                                   const KeyStringArena& keys,
+                                                   const MultikeyPaths& multikeyPaths,
+                                                   const RecordId& loc,
+                                                   const InsertDeleteOptions& options,
+                                                   InsertResult* result) {
+    const bool unique = _descriptor->unique();
+    const Ordering ordering = _newInterface->getOrdering();
+    auto toBson = [&](const KeyString::Builder& keyString) {
+        return KeyString::toBson(
+            keyString.getBuffer(), keyString.getSize(), ordering, keyString.getTypeBits());
+    };
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const auto& keyString = keys[i];
+        Status status = _newInterface->insert(opCtx, keyString, loc, !unique /* dupsAllowed */);
+
+        // Duplicates are handled as in insertKeys(). The key is only converted back to BSON on
+        // this path and the error path below, which are rare.
+        if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
+            invariant(unique);
+            status = _newInterface->insert(opCtx, keyString, loc, true /* dupsAllowed */);
+            if (status.isOK() && result) {
+                result->dupsInserted.push_back(toBson(keyString));
+            }
+        }
+        if (!status.isOK() && isFatalError(opCtx, status, toBson(keyString))) {
+            return status;
+        }
+    }
+
+    if (result) {
+        result->numInserted += keys.size();
+    }
+
+    if (keys.size() > 1 || isMultikeyFromPaths(multikeyPaths)) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+    return Status::OK();
+}
+
 Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
                                              const vector<BSONObj>& keys,
                                              const vector<BSONObj>& multikeyMetadataKeys,
@@ -249,7 +328,12 @@ Status AbstractIndexAccessMethod::touch(OperationContext* opCtx, const BSONObj&
     // multikey when paging a document's index entries into memory.
     BSONObjSet* multikeyMetadataKeys = nullptr;
     MultikeyPaths* multikeyPaths = nullptr;
-    getKeys(obj, GetKeysMode::kEnforceConstraints, &keys, multikeyMetadataKeys, multikeyPaths);
+    getKeys(obj,
+            GetKeysMode::kEnforceConstraints,
+            &keys,
+            multikeyMetadataKeys,
+            multikeyPaths,
+            boost::none);
 
     std::unique_ptr<SortedDataInterface::Cursor> cursor(_newInterface->newCursor(opCtx));
     for (const auto& key : keys) {
@@ -277,7 +361,8 @@ RecordId AbstractIndexAccessMethod::findSingle(OperationContext* opCtx,
                 GetKeysMode::kEnforceConstraints,
                 &keys,
                 multikeyMetadataKeys,
-                multikeyPaths);
+                multikeyPaths,
+                boost::none);
         invariant(keys.size() == 1);
         actualKey = *keys.begin();
     } else {
@@ -371,7 +456,7 @@ void AbstractIndexAccessMethod::prepareUpdate(OperationContext* opCtx,
         // There's no need to compute the prefixes of the indexed fields that possibly caused the
         // index to be multikey when the old version of the document was written since the index
         // metadata isn't updated when keys are deleted.
-        getKeys(from, getKeysMode, &ticket->oldKeys, nullptr, nullptr);
+        getKeys(from, getKeysMode, &ticket->oldKeys, nullptr, nullptr, record);
     }
 
     if (!indexFilter || indexFilter->matchesBSON(to)) {
@@ -379,7 +464,8 @@ void AbstractIndexAccessMethod::prepareUpdate(OperationContext* opCtx,
                 options.getKeysMode,
                 &ticket->newKeys,
                 &ticket->newMultikeyMetadataKeys,
-                &ticket->newMultikeyPaths);
+                &ticket->newMultikeyPaths,
+                record);
     }
 
     ticket->loc = record;
@@ -446,13 +532,19 @@ class AbstractIndexAccessMethod::BulkBuilderImpl : public IndexAccessMethod::Bul
 public:
     BulkBuilderImpl(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
-                    size_t maxMemoryUsageBytes);
+                    size_t maxMemoryUsageBytes,
+                    size_t numWorkers);
 
     Status insert(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    Status insertFromWorker(size_t worker,
+                            const BSONObj& obj,
+                            const RecordId& loc,
+                            const InsertDeleteOptions& options) final;
+
     const MultikeyPaths& getMultikeyPaths() const final;
 
     bool isMultikey() const final;
@@ -466,103 +558,164 @@ public:
     int64_t getKeysInserted() const final;
 
 private:
-    std::unique_ptr<Sorter> _sorter;
-    const IndexAccessMethod* _real;
-    int64_t _keysInserted = 0;
+    // The state of one thread generating keys. Only that thread touches it until done().
+    struct Worker {
+        std::unique_ptr<Sorter> sorter;
+        int64_t keysInserted = 0;
 
-    // Set to true if any document added to the BulkBuilder causes the index to become multikey.
-    bool _isMultiKey = false;
+        // Set to true if any document added by this worker causes the index to become multikey.
+        bool isMultiKey = false;
 
-    // Holds the path components that cause this index to be multikey. The '_indexMultikeyPaths'
-    // vector remains empty if this index doesn't support path-level multikey tracking.
-    MultikeyPaths _indexMultikeyPaths;
+        // Holds the path components that cause this index to be multikey. Remains empty if this
+        // index doesn't support path-level multikey tracking.
+        MultikeyPaths multikeyPaths;
 
-    // Caches the set of all multikey metadata keys generated during the bulk build process.
-    // These are inserted into the sorter after all normal data keys have been added, just
-    // before the bulk build is committed.
-    BSONObjSet _multikeyMetadataKeys{SimpleBSONObjComparator::kInstance.makeBSONObjSet()};
+        // Caches the set of all multikey metadata keys generated by this worker. These are
+        // inserted into the sorter after all normal data keys have been added, just before the
+        // bulk build is committed.
+        BSONObjSet multikeyMetadataKeys{SimpleBSONObjComparator::kInstance.makeBSONObjSet()};
+    };
+
+    const IndexAccessMethod* _real;
+    const BtreeExternalSortComparison _comparison;
+    std::vector<Worker> _workers;
+
+    // The union of the workers' multikey paths, gathered by getMultikeyPaths().
+    mutable MultikeyPaths _indexMultikeyPaths;
 };
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initiateBulk(
-    size_t maxMemoryUsageBytes) {
-    return std::make_unique<BulkBuilderImpl>(this, _descriptor, maxMemoryUsageBytes);
+    size_t maxMemoryUsageBytes, size_t numWorkers) {
+    return std::make_unique<BulkBuilderImpl>(this, _descriptor, maxMemoryUsageBytes, numWorkers);
 }
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexAccessMethod* index,
                                                             const IndexDescriptor* descriptor,
-                                                            size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+                                                            size_t maxMemoryUsageBytes,
+                                                            size_t numWorkers)
+    : _real(index),
+      _comparison(descriptor->keyPattern(), descriptor->version()),
+      _workers(numWorkers) {
+    invariant(numWorkers > 0);
+    for (auto&& worker : _workers) {
+        worker.sorter.reset(Sorter::make(SortOptions()
+                                             .TempDir(storageGlobalParams.dbpath + "/_tmp")
+                                             .ExtSortAllowed()
+                                             .MaxMemoryUsageBytes(maxMemoryUsageBytes / numWorkers),
+                                         _comparison));
+    }
+}
 
 Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCtx,
                                                           const BSONObj& obj,
                                                           const RecordId& loc,
                                                           const InsertDeleteOptions& options) {
+    return insertFromWorker(0, obj, loc, options);
+}
+
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insertFromWorker(
+    size_t workerId, const BSONObj& obj, const RecordId& loc, const InsertDeleteOptions& options) {
+    invariant(workerId < _workers.size());
+    Worker& worker = _workers[workerId];
+
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
     try {
-        _real->getKeys(obj, options.getKeysMode, &keys, &_multikeyMetadataKeys, &multikeyPaths);
+        _real->getKeys(
+            obj, options.getKeysMode, &keys, &worker.multikeyMetadataKeys, &multikeyPaths, loc);
     } catch (...) {
         return exceptionToStatus();
     }
 
     if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
+        if (worker.multikeyPaths.empty()) {
+            worker.multikeyPaths = multikeyPaths;
         } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+            invariant(worker.multikeyPaths.size() == multikeyPaths.size());
             for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+                worker.multikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
             }
         }
     }
 
     for (const auto& key : keys) {
-        _sorter->add(key, loc);
-        ++_keysInserted;
+        worker.sorter->add(key, loc);
+        ++worker.keysInserted;
     }
 
-    _isMultiKey = _isMultiKey ||
+    worker.isMultiKey = worker.isMultiKey ||
         _real->shouldMarkIndexAsMultikey(
             {keys.begin(), keys.end()},
-            {_multikeyMetadataKeys.begin(), _multikeyMetadataKeys.end()},
+            {worker.multikeyMetadataKeys.begin(), worker.multikeyMetadataKeys.end()},
             multikeyPaths);
 
     return Status::OK();
 }
 
 const MultikeyPaths& AbstractIndexAccessMethod::BulkBuilderImpl::getMultikeyPaths() const {
+    _indexMultikeyPaths.clear();
+    for (auto&& worker : _workers) {
+        if (worker.multikeyPaths.empty()) {
+            continue;
+        }
+        if (_indexMultikeyPaths.empty()) {
+            _indexMultikeyPaths = worker.multikeyPaths;
+            continue;
+        }
+        invariant(_indexMultikeyPaths.size() == worker.multikeyPaths.size());
+        for (size_t i = 0; i < worker.multikeyPaths.size(); ++i) {
+            _indexMultikeyPaths[i].insert(worker.multikeyPaths[i].begin(),
+                                          worker.multikeyPaths[i].end());
+        }
+    }
     return _indexMultikeyPaths;
 }
 
 bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
-    return _isMultiKey;
+    return std::any_of(
+        _workers.begin(), _workers.end(), [](const Worker& worker) { return worker.isMultiKey; });
 }
 
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
-    for (const auto& key : _multikeyMetadataKeys) {
-        _sorter->add(key, kMultikeyMetadataKeyId);
-        ++_keysInserted;
+    // Workers may have generated the same multikey metadata keys, which must be inserted once.
+    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (auto&& worker : _workers) {
+        multikeyMetadataKeys.insert(worker.multikeyMetadataKeys.begin(),
+                                    worker.multikeyMetadataKeys.end());
     }
-    return _sorter->done();
+    for (const auto& key : multikeyMetadataKeys) {
+        _workers[0].sorter->add(key, kMultikeyMetadataKeyId);
+        ++_workers[0].keysInserted;
+    }
+
+    if (_workers.size() == 1) {
+        return _workers[0].sorter->done();
+    }
+
+    // Each worker's iterator removes its own spill file, so the merge has none to remove.
+    std::vector<std::shared_ptr<Sorter::Iterator>> iters;
+    for (auto&& worker : _workers) {
+        iters.emplace_back(worker.sorter->done());
+    }
+    return Sorter::Iterator::merge(iters, "", SortOptions(), _comparison);
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
-    return _keysInserted;
+    int64_t keysInserted = 0;
+    for (auto&& worker : _workers) {
+        keysInserted += worker.keysInserted;
+    }
+    return keysInserted;
 }
 
 Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
                                              BulkBuilder* bulk,
                                              bool dupsAllowed,
                                              set<RecordId>* dupRecords,
-                                             std::vector<BSONObj>* dupKeysInserted) {
+                                             std::vector<BSONObj>* dupKeysInserted,
+                                             IndexStatisticsBuilder* statistics) {
     // Cannot simultaneously report uninserted duplicates 'dupRecords' and inserted duplicates
     // 'dupKeysInserted'.
     invariant(!(dupRecords && dupKeysInserted));
@@ -633,6 +786,10 @@ Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
             dupKeysInserted->push_back(data.first.getOwned());
         }
 
+        if (statistics && data.second != kMultikeyMetadataKeyId) {
+            statistics->addKey(data.first);
+        }
+
         // If we're here either it's a dup and we're cool with it or the addKey went just fine.
         pm.hit();
         wunit.commit();
@@ -657,32 +814,10 @@ void AbstractIndexAccessMethod::getKeys(const BSONObj& obj,
                                         GetKeysMode mode,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyMetadataKeys,
-                                        MultikeyPaths* multikeyPaths) const {
-    static stdx::unordered_set<int> whiteList{ErrorCodes::CannotBuildIndexKeys,
-                                              // Btree
-                                              ErrorCodes::CannotIndexParallelArrays,
-                                              // FTS
-                                              16732,
-                                              16733,
-                                              16675,
-                                              17261,
-                                              17262,
-                                              // Hash
-                                              16766,
-                                              // Haystack
-                                              16775,
-                                              16776,
-                                              // 2dsphere geo
-                                              16755,
-                                              16756,
-                                              // 2d geo
-                                              16804,
-                                              13067,
-                                              13068,
-                                              13026,
-                                              13027};
+                                        MultikeyPaths* multikeyPaths,
+                                        boost::optional<RecordId> id) const {
     try {
-        doGetKeys(obj, keys, multikeyMetadataKeys, multikeyPaths);
+        doGetKeys(obj, keys, multikeyMetadataKeys, multikeyPaths, id);
     } catch (const AssertionException& ex) {
         // Suppress all indexing errors when mode is kRelaxConstraints.
         if (mode == GetKeysMode::kEnforceConstraints) {
@@ -693,22 +828,48 @@ void AbstractIndexAccessMethod::getKeys(const BSONObj& obj,
         if (multikeyPaths) {
             multikeyPaths->clear();
         }
-        // Only suppress the errors in the whitelist.
-        if (whiteList.find(ex.code()) == whiteList.end()) {
+        suppressGetKeysError(ex, mode, obj);
+    }
+}
+
+bool AbstractIndexAccessMethod::getKeyStrings(const BSONObj& obj,
+                                              GetKeysMode mode,
+                                              const RecordId& loc,
+                                              KeyStringArena* keys,
+                                              MultikeyPaths* multikeyPaths) const {
+    try {
+        return doGetKeyStrings(obj, loc, keys, multikeyPaths);
+    } catch (const AssertionException& ex) {
+        if (mode == GetKeysMode::kEnforceConstraints) {
             throw;
         }
 
-        // If the document applies to the filter (which means that it should have never been
-        // indexed), do not supress the error.
-        const MatchExpression* filter = _btreeState->getFilterExpression();
-        if (mode == GetKeysMode::kRelaxConstraintsUnfiltered && filter &&
-            filter->matchesBSON(obj)) {
-            throw;
+        keys->clear();
+        if (multikeyPaths) {
+            multikeyPaths->clear();
         }
+        suppressGetKeysError(ex, mode, obj);
+        return true;
+    }
+}
 
-        LOG(1) << "Ignoring indexing error for idempotency reasons: " << redact(ex)
-               << " when getting index keys of " << redact(obj);
+void AbstractIndexAccessMethod::suppressGetKeysError(const AssertionException& ex,
+                                                     GetKeysMode mode,
+                                                     const BSONObj& obj) const {
+    // Only suppress the errors in the whitelist.
+    if (kSuppressibleGetKeysErrors.find(ex.code()) == kSuppressibleGetKeysErrors.end()) {
+        throw;
     }
+
+    // If the document applies to the filter (which means that it should have never been
+    // indexed), do not supress the error.
+    const MatchExpression* filter = _btreeState->getFilterExpression();
+    if (mode == GetKeysMode::kRelaxConstraintsUnfiltered && filter && filter->matchesBSON(obj)) {
+        throw;
+    }
+
+    LOG(1) << "Ignoring indexing error for idempotency reasons: " << redact(ex)
+           << " when getting index keys of " << redact(obj);
 }
 
 bool AbstractIndexAccessMethod::shouldMarkIndexAsMultikey(
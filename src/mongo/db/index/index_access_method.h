@@ -36,6 +36,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/key_string_arena.h"
 #include "mongo/db/index/multikey_metadata_access_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -46,6 +47,7 @@
 namespace mongo {
 
 class BSONObjBuilder;
+class IndexStatisticsBuilder;
 class MatchExpression;
 struct UpdateTicket;
 struct InsertResult;
@@ -223,13 +225,24 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        /**
+         * Like insert(), but generates keys into the sorter of the given worker. May be called
+         * concurrently from different threads as long as each passes a distinct 'worker', less
+         * than the number of workers the BulkBuilder was initiated with.
+         */
+        virtual Status insertFromWorker(size_t worker,
+                                        const BSONObj& obj,
+                                        const RecordId& loc,
+                                        const InsertDeleteOptions& options) = 0;
+
         virtual const MultikeyPaths& getMultikeyPaths() const = 0;
 
         virtual bool isMultikey() const = 0;
 
         /**
          * Inserts all multikey metadata keys cached during the BulkBuilder's lifetime into the
-         * underlying Sorter, finalizes it, and returns an iterator over the sorted dataset.
+         * underlying Sorter, finalizes it, and returns an iterator over the sorted dataset. When
+         * there are several workers, the iterator merges the sorted output of all of them.
          */
         virtual Sorter::Iterator* done() = 0;
 
@@ -247,9 +260,12 @@ public:
      * It is only legal to initiate bulk when the index is new and empty.
      *
      * maxMemoryUsageBytes: amount of memory consumed before the external sorter starts spilling to
-     *                      disk
+     *                      disk, shared evenly between the workers
+     * numWorkers: number of threads which may generate keys concurrently through
+     *             BulkBuilder::insertFromWorker(), each into its own sorter
      */
-    virtual std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes) = 0;
+    virtual std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes,
+                                                      size_t numWorkers) = 0;
 
     /**
      * Call this when you are ready to finish your bulk work.
@@ -265,6 +281,7 @@ public:
      * @param dupKeys - If not null and 'dupsAllowed' is true, is filled with the keys of inserted
      *                  duplicates.
      *                  If null, duplicates are inserted but not recorded.
+     * @param statistics - If not null, is fed every key inserted, in index order.
      *
      * It is invalid and contradictory to pass both 'dupRecords' and 'dupKeys'.
      */
@@ -273,7 +290,8 @@ public:
                               BulkBuilder* bulk,
                               bool dupsAllowed,
                               std::set<RecordId>* dupRecords,
-                              std::vector<BSONObj>* dupKeys) = 0;
+                              std::vector<BSONObj>* dupKeys,
+                              IndexStatisticsBuilder* statistics) = 0;
 
     /**
      * Specifies whether getKeys should relax the index constraints or not, in order of most
@@ -304,12 +322,16 @@ public:
      * BSONObjSet with any multikey metadata keys generated while processing the document. These
      * keys are not associated with the document itself, but instead represent multi-key path
      * information that must be stored in a reserved keyspace within the index.
+     *
+     * 'id' is the RecordId of 'obj', if it is known. Index types whose keys contain the RecordId,
+     * such as columnstore indexes, require it.
      */
     virtual void getKeys(const BSONObj& obj,
                          GetKeysMode mode,
                          BSONObjSet* keys,
                          BSONObjSet* multikeyMetadataKeys,
-                         MultikeyPaths* multikeyPaths) const = 0;
+                         MultikeyPaths* multikeyPaths,
+                         boost::optional<RecordId> id) const = 0;
 
     /**
      * Given the set of keys, multikeyMetadataKeys and multikeyPaths generated by a particular
@@ -509,19 +531,22 @@ public:
 
     void setIndexIsMultikey(OperationContext* opCtx, MultikeyPaths paths) final;
 
-    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes) final;
+    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes,
+                                              size_t numWorkers) final;
 
     Status commitBulk(OperationContext* opCtx,
                       BulkBuilder* bulk,
                       bool dupsAllowed,
                       std::set<RecordId>* dupRecords,
-                      std::vector<BSONObj>* dupKeys) final;
+                      std::vector<BSONObj>* dupKeys,
+                      IndexStatisticsBuilder* statistics) final;
 
     void getKeys(const BSONObj& obj,
                  GetKeysMode mode,
                  BSONObjSet* keys,
                  BSONObjSet* multikeyMetadataKeys,
-                 MultikeyPaths* multikeyPaths) const final;
+                 MultikeyPaths* multikeyPaths,
+                 boost::optional<RecordId> id) const final;
 
     bool shouldMarkIndexAsMultikey(const std::vector<BSONObj>& keys,
                                    const std::vector<BSONObj>& multikeyMetadataKeys,
@@ -543,11 +568,30 @@ protected:
      * BSONObjSet with any multikey metadata keys generated while processing the document. These
      * keys are not associated with the document itself, but instead represent multi-key path
      * information that must be stored in a reserved keyspace within the index.
+     *
+     * 'id' is the RecordId of 'obj', if it is known. See getKeys().
      */
     virtual void doGetKeys(const BSONObj& obj,
                            BSONObjSet* keys,
                            BSONObjSet* multikeyMetadataKeys,
-                           MultikeyPaths* multikeyPaths) const = 0;
+                           MultikeyPaths* multikeyPaths,
+                           boost::optional<RecordId> id) const = 0;
+
+    /**
+     * Fills 'keys' with the keys that should be generated for 'obj' on this index, encoded as
+     * sorted, deduplicated KeyStrings in this index's KeyString version and ordering which end in
+     * 'loc', and returns true. 'multikeyPaths' is filled as for doGetKeys().
+     *
+     * Index types which do not generate their keys as KeyStrings return false without touching
+     * 'keys', and insert() falls back to doGetKeys(). Index types which generate multikey metadata
+     * keys must not override this.
+     */
+    virtual bool doGetKeyStrings(const BSONObj& obj,
+                                 const RecordId& loc,
+                                 KeyStringArena* keys,
+                                 MultikeyPaths* multikeyPaths) const {
+        return false;
+    }
 
     IndexCatalogEntry* const _btreeState;  // owned by IndexCatalogEntry
     const IndexDescriptor* const _descriptor;
@@ -563,6 +607,34 @@ private:
      */
     bool isFatalError(OperationContext* opCtx, Status status, BSONObj key);
 
+    /**
+     * Called from the handler of an exception 'ex' thrown while generating the keys of 'obj'.
+     * Rethrows it unless 'mode' allows it to be suppressed, in which case it is logged.
+     */
+    void suppressGetKeysError(const AssertionException& ex,
+                              GetKeysMode mode,
+                              const BSONObj& obj) const;
+
+    /**
+     * Generates the keys of 'obj' with doGetKeyStrings(), suppressing errors according to 'mode'
+     * as getKeys() does. Returns false if this index type does not generate KeyStrings.
+     */
+    bool getKeyStrings(const BSONObj& obj,
+                       GetKeysMode mode,
+                       const RecordId& loc,
+                       KeyStringArena* keys,
+                       MultikeyPaths* multikeyPaths) const;
+
+    /**
+     * Inserts the KeyStrings generated by getKeyStrings() into the index. Used by insert() only.
+     */
+    Status insertKeyStrings(OperationContext* opCtx,
+                            const KeyStringArena& keys,
+                            const MultikeyPaths& multikeyPaths,
+                            const RecordId& loc,
+                            const InsertDeleteOptions& options,
+                            InsertResult* result);
+
     /**
      * Removes a single key from the index.
      *
@@ -0,0 +1,69 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/key_string_arena.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+KeyString::Builder& KeyStringArena::next(KeyString::Version version, Ordering ordering) {
+    if (_size == _builders.size()) {
+        _builders.push_back(std::make_unique<KeyString::Builder>(version, ordering));
+    } else if (_builders[_size]->version != version) {
+        _builders[_size] = std::make_unique<KeyString::Builder>(version, ordering);
+    } else {
+        _builders[_size]->resetToEmpty(ordering);
+    }
+    return *_builders[_size++];
+}
+
+void KeyStringArena::sortAndDedup() {
+    auto begin = _builders.begin();
+    auto end = begin + _size;
+    std::stable_sort(begin, end, [](const auto& lhs, const auto& rhs) {
+        return lhs->compare(*rhs) < 0;
+    });
+
+    // Move the duplicates past the end rather than destroying them, so that their buffers are
+    // reused.
+    size_t kept = 0;
+    for (size_t i = 0; i < _size; ++i) {
+        if (kept > 0 && _builders[kept - 1]->compare(*_builders[i]) == 0) {
+            continue;
+        }
+        std::swap(_builders[kept++], _builders[i]);
+    }
+    _size = kept;
+}
+
+}  // namespace mongo
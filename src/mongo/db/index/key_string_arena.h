@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+
+/**
+ * A reusable pool of KeyString builders holding the index keys generated for one document at a
+ * time. clear() keeps the builders and their buffers, so once an arena has grown to fit the
+ * largest set of keys it is asked to hold, generating keys into it does not allocate.
+ */
+class KeyStringArena {
+    KeyStringArena(const KeyStringArena&) = delete;
+    KeyStringArena& operator=(const KeyStringArena&) = delete;
+
+public:
+    KeyStringArena() = default;
+
+    /**
+     * Returns an empty builder with the given version and ordering, which stays valid until the
+     * next call to clear().
+     */
+    KeyString::Builder& next(KeyString::Version version, Ordering ordering);
+
+    /**
+     * Sorts the builders handed out since the last clear() and removes all but the first of each
+     * run of equal KeyStrings.
+     */
+    void sortAndDedup();
+
+    /**
+     * Makes every builder available again, without freeing any.
+     */
+    void clear() {
+        _size = 0;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const KeyString::Builder& operator[](size_t i) const {
+        return *_builders[i];
+    }
+
+private:
+    std::vector<std::unique_ptr<KeyString::Builder>> _builders;
+
+    // The number of builders handed out since the last clear(), which are the first '_size' in
+    // '_builders'.
+    size_t _size = 0;
+};
+
+}  // namespace mongo
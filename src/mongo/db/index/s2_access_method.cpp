@@ -127,7 +127,8 @@ StatusWith<BSONObj> S2AccessMethod::fixSpec(const BSONObj& specObj) {
 void S2AccessMethod::doGetKeys(const BSONObj& obj,
                                BSONObjSet* keys,
                                BSONObjSet* multikeyMetadataKeys,
-                               MultikeyPaths* multikeyPaths) const {
+                               MultikeyPaths* multikeyPaths,
+                               boost::optional<RecordId> id) const {
     ExpressionKeysPrivate::getS2Keys(obj, _descriptor->keyPattern(), _params, keys, multikeyPaths);
 }
 
@@ -53,7 +53,8 @@ bool WildcardAccessMethod::shouldMarkIndexAsMultikey(
 void WildcardAccessMethod::doGetKeys(const BSONObj& obj,
                                      BSONObjSet* keys,
                                      BSONObjSet* multikeyMetadataKeys,
-                                     MultikeyPaths* multikeyPaths) const {
+                                     MultikeyPaths* multikeyPaths,
+                                     boost::optional<RecordId> id) const {
     _keyGen.generateKeys(obj, keys, multikeyMetadataKeys);
 }
 
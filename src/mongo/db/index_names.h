@@ -48,6 +48,7 @@ enum IndexType {
     INDEX_TEXT,
     INDEX_HASHED,
     INDEX_WILDCARD,
+    INDEX_COLUMN,
 };
 
 /**
@@ -57,6 +58,7 @@ enum IndexType {
 class IndexNames {
 public:
     static const std::string BTREE;
+    static const std::string COLUMN;
     static const std::string GEO_2D;
     static const std::string GEO_2DSPHERE;
     static const std::string GEO_HAYSTACK;
@@ -471,6 +471,25 @@ void mapOver(MatchExpression* expr, NodeTraversalFunc func, std::string path) {
     func(expr, path);
 }
 
+bool canMatchConcurrently(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::WHERE:
+        case MatchExpression::EXPRESSION:
+        case MatchExpression::TEXT:
+        case MatchExpression::GEO_NEAR:
+            return false;
+        default:
+            break;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchConcurrently(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool isPathPrefixOf(StringData first, StringData second) {
     if (first.size() >= second.size()) {
         return false;
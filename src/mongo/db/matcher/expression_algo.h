@@ -104,6 +104,12 @@ bool isIndependentOf(const MatchExpression& expr, const std::set<std::string>& p
  */
 bool isPathPrefixOf(StringData first, StringData second);
 
+/**
+ * Returns true if 'expr' can be evaluated by several threads at once. Expressions which evaluate
+ * JavaScript or aggregation expressions carry per-evaluation state and cannot be.
+ */
+bool canMatchConcurrently(const MatchExpression* expr);
+
 /**
  * Applies 'func' to each node of 'expr', where the first argument is a pointer to that actual node
  * (not a copy), and the second argument is the path to that node. Callers should not depend on the
@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_refresh_index_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+
+namespace {
+
+bool isStale(const IndexStatistics* statistics, long long numRecords) {
+    if (!statistics) {
+        return true;
+    }
+    const double changed = std::abs(numRecords - statistics->getNumRecords());
+    return changed > internalQueryIndexStatisticsStaleRatio.load() *
+        std::max(statistics->getNumRecords(), 1LL);
+}
+
+/**
+ * Returns the statistics of the index 'entry' of 'collection', gathered from a random sample of its
+ * documents, or from all of them if there are no more than the sample size. Returns nullptr if the
+ * record store cannot sample.
+ */
+std::shared_ptr<const IndexStatistics> sampleIndexStatistics(OperationContext* opCtx,
+                                                             Collection* collection,
+                                                             const IndexCatalogEntry* entry,
+                                                             long long numRecords) {
+    const long long sampleSize = internalQueryIndexStatisticsSampleSize.load();
+    const bool scanAll = numRecords <= sampleSize;
+    auto cursor = scanAll ? collection->getCursor(opCtx)
+                          : collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return nullptr;
+    }
+
+    const IndexDescriptor* desc = entry->descriptor();
+    const MatchExpression* filter = entry->getFilterExpression();
+    const Ordering ordering = Ordering::make(desc->keyPattern());
+
+    std::vector<BSONObj> keys;
+    long long sampledRecords = 0;
+    while (scanAll || sampledRecords < sampleSize) {
+        opCtx->checkForInterrupt();
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        ++sampledRecords;
+
+        BSONObj doc = record->data.releaseToBson();
+        if (filter && !filter->matchesBSON(doc)) {
+            continue;
+        }
+
+        BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        entry->accessMethod()->getKeys(doc,
+                                       IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
+                                       &docKeys,
+                                       nullptr,
+                                       nullptr,
+                                       record->id);
+        for (auto&& key : docKeys) {
+            keys.push_back(key.getOwned());
+        }
+    }
+
+    std::sort(keys.begin(), keys.end(), [&ordering](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, ordering, false) < 0;
+    });
+
+    IndexStatisticsBuilder builder(desc->keyPattern(), keys.size());
+    for (auto&& key : keys) {
+        builder.addKey(key);
+    }
+    return builder.done(IndexStatistics::Source::kSample, numRecords, sampledRecords);
+}
+
+void refreshIndexStatistics(OperationContext* opCtx, const NamespaceString& nss, UUID uuid) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+    Collection* collection = autoColl.getCollection();
+    // The collection may have been renamed or dropped since its namespace was looked up.
+    if (!collection || collection->uuid() != uuid) {
+        return;
+    }
+
+    const long long numRecords = collection->numRecords(opCtx);
+    CollectionIndexStatistics* indexStatistics = collection->infoCache()->getIndexStatistics();
+
+    std::unique_ptr<IndexCatalog::IndexIterator> ii =
+        collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii->more()) {
+        const IndexCatalogEntry* entry = ii->next();
+        const IndexDescriptor* desc = entry->descriptor();
+        if (desc->getAccessMethodName() != IndexNames::BTREE) {
+            continue;
+        }
+
+        const auto indexName = desc->indexName();
+        if (!isStale(indexStatistics->get(indexName).get(), numRecords)) {
+            continue;
+        }
+
+        auto statistics = sampleIndexStatistics(opCtx, collection, entry, numRecords);
+        if (!statistics) {
+            return;
+        }
+        LOG(1) << "Refreshed statistics of index " << indexName << " on " << nss << ": "
+               << statistics->getNumKeys() << " keys, " << statistics->getDistinct()
+               << " distinct values of the leading field";
+        indexStatistics->set(indexName, std::move(statistics));
+    }
+}
+
+void refreshAllIndexStatistics(OperationContext* opCtx) {
+    if (!internalQueryPlannerEnableIndexStatistics.load()) {
+        return;
+    }
+
+    // Do not read from a member which is not readable, such as one in initial sync.
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet &&
+        !replCoord->getMemberState().readable()) {
+        return;
+    }
+
+    const auto& catalog = CollectionCatalog::get(opCtx);
+    for (auto&& dbName : catalog.getAllDbNames()) {
+        for (auto&& uuid : catalog.getAllCollectionUUIDsFromDb(dbName)) {
+            auto nss = catalog.lookupNSSByUUID(uuid);
+            if (!nss || nss->isSystem() || nss->isOnInternalDb()) {
+                continue;
+            }
+
+            try {
+                refreshIndexStatistics(opCtx, *nss, uuid);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                throw;
+            } catch (const DBException& ex) {
+                LOG(1) << "Failed to refresh index statistics on " << *nss << ": "
+                       << ex.toStatus();
+            }
+        }
+    }
+}
+
+}  // namespace
+
+auto PeriodicThreadToRefreshIndexStatistics::get(ServiceContext* serviceContext)
+    -> PeriodicThreadToRefreshIndexStatistics& {
+    auto& jobContainer = _serviceDecoration(serviceContext);
+    jobContainer._init(serviceContext);
+    return jobContainer;
+}
+
+auto PeriodicThreadToRefreshIndexStatistics::operator*() const noexcept -> PeriodicJobAnchor& {
+    stdx::lock_guard lk(_mutex);
+    return *_anchor;
+}
+
+auto PeriodicThreadToRefreshIndexStatistics::operator-> () const noexcept -> PeriodicJobAnchor* {
+    stdx::lock_guard lk(_mutex);
+    return _anchor.get();
+}
+
+void PeriodicThreadToRefreshIndexStatistics::_init(ServiceContext* serviceContext) {
+    stdx::lock_guard lk(_mutex);
+    if (_anchor) {
+        return;
+    }
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "startPeriodicThreadToRefreshIndexStatistics",
+        [](Client* client) {
+            try {
+                // The opCtx destructor handles unsetting itself from the Client.
+                // (The PeriodicRunner's Client must be reset before returning.)
+                auto opCtx = client->makeOperationContext();
+
+                refreshAllIndexStatistics(opCtx.get());
+            } catch (const DBException& ex) {
+                if (!ErrorCodes::isShutdownError(ex.toStatus().code())) {
+                    warning() << "Periodic task to refresh index statistics failed! Caused by: "
+                              << ex.toStatus();
+                }
+            }
+        },
+        Seconds(internalQueryIndexStatisticsRefreshPeriodSecs.load()));
+
+    _anchor = std::make_shared<PeriodicJobAnchor>(periodicRunner->makeJob(std::move(job)));
+}
+
+}  // namespace mongo
@@ -57,6 +57,7 @@ constexpr StringData AggregationRequest::kPipelineName;
 constexpr StringData AggregationRequest::kCollationName;
 constexpr StringData AggregationRequest::kExplainName;
 constexpr StringData AggregationRequest::kAllowDiskUseName;
+constexpr StringData AggregationRequest::kParallelismName;
 constexpr StringData AggregationRequest::kHintName;
 constexpr StringData AggregationRequest::kCommentName;
 constexpr StringData AggregationRequest::kExchangeName;
@@ -192,6 +193,20 @@ StatusWith<AggregationRequest> AggregationRequest::parseFromBSON(
                                       << typeName(elem.type())};
             }
             request.setAllowDiskUse(elem.Bool());
+        } else if (kParallelismName == fieldName) {
+            if (!elem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << kParallelismName << " must be a number, not a "
+                                      << typeName(elem.type())};
+            }
+            const long long parallelism = elem.numberLong();
+            if (parallelism < 1 || parallelism > QueryRequest::kMaxParallelism) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << kParallelismName << " must be between 1 and "
+                                      << QueryRequest::kMaxParallelism << ", but received: "
+                                      << parallelism};
+            }
+            request.setParallelism(parallelism);
         } else if (kExchangeName == fieldName) {
             try {
                 IDLParserErrorContext ctx("internalExchange");
@@ -297,6 +312,8 @@ Document AggregationRequest::serializeToCommandObj() const {
         {kPipelineName, _pipeline},
         // Only serialize booleans if different than their default.
         {kAllowDiskUseName, _allowDiskUse ? Value(true) : Value()},
+        // Only serialize parallelism if specified.
+        {kParallelismName, _parallelism ? Value(*_parallelism) : Value()},
         {kFromMongosName, _fromMongos ? Value(true) : Value()},
         {kNeedsMergeName, _needsMerge ? Value(true) : Value()},
         {bypassDocumentValidationCommandOption(),
@@ -60,6 +60,7 @@ public:
     static constexpr StringData kCollationName = "collation"_sd;
     static constexpr StringData kExplainName = "explain"_sd;
     static constexpr StringData kAllowDiskUseName = "allowDiskUse"_sd;
+    static constexpr StringData kParallelismName = "parallelism"_sd;
     static constexpr StringData kHintName = "hint"_sd;
     static constexpr StringData kCommentName = "comment"_sd;
     static constexpr StringData kExchangeName = "exchange"_sd;
@@ -178,6 +179,10 @@ public:
         return _bypassDocumentValidation;
     }
 
+    boost::optional<long long> getParallelism() const {
+        return _parallelism;
+    }
+
     /**
      * Returns an empty object if no collation was specified.
      */
@@ -253,6 +258,10 @@ public:
         _allowDiskUse = allowDiskUse;
     }
 
+    void setParallelism(boost::optional<long long> parallelism) {
+        _parallelism = parallelism;
+    }
+
     void setFromMongos(bool isFromMongos) {
         _fromMongos = isFromMongos;
     }
@@ -327,6 +336,10 @@ private:
     bool _needsMerge = false;
     bool _bypassDocumentValidation = false;
 
+    // The number of workers the aggregation may use to scan its collection and to aggregate the
+    // documents of a $group, or boost::none to use the defaults set by the server parameters.
+    boost::optional<long long> _parallelism;
+
     // A user-specified maxTimeMS limit, or a value of '0' if not specified.
     unsigned int _maxTimeMS = 0;
 
@@ -383,6 +383,38 @@ TEST(AggregationRequestTest, ShouldRejectNonBoolAllowDiskUse) {
     ASSERT_NOT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
 }
 
+TEST(AggregationRequestTest, ShouldParseAndSerializeParallelism) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson =
+        fromjson("{pipeline: [{$match: {a: 'abc'}}], cursor: {}, parallelism: 4}");
+    auto request = AggregationRequest::parseFromBSON(nss, inputBson);
+    ASSERT_OK(request.getStatus());
+    ASSERT(request.getValue().getParallelism());
+    ASSERT_EQ(4, *request.getValue().getParallelism());
+
+    auto serialized = request.getValue().serializeToCommandObj();
+    ASSERT_VALUE_EQ(serialized[AggregationRequest::kParallelismName], Value(4LL));
+}
+
+TEST(AggregationRequestTest, ShouldRejectNonNumericParallelism) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson =
+        fromjson("{pipeline: [{$match: {a: 'abc'}}], cursor: {}, parallelism: 'four'}");
+    ASSERT_EQ(ErrorCodes::TypeMismatch,
+              AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
+}
+
+TEST(AggregationRequestTest, ShouldRejectOutOfRangeParallelism) {
+    NamespaceString nss("a.collection");
+    for (auto parallelism : {0LL, -1LL, 65LL, 1LL << 32}) {
+        const BSONObj inputBson = BSON("pipeline" << BSON_ARRAY(BSON("$match" << BSON("a" << 1)))
+                                                  << "cursor" << BSONObj()
+                                                  << "parallelism" << parallelism);
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
+    }
+}
+
 TEST(AggregationRequestTest, ShouldRejectNoCursorNoExplain) {
     NamespaceString nss("a.collection");
     const BSONObj inputBson = fromjson("{pipeline: [{$match: {a: 'abc'}}]}");
@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <memory>
 
@@ -42,6 +43,8 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_worker_pool.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -155,30 +158,25 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
-    // We aren't streaming, and we have spilled to disk.
-    if (!_sorterIterator)
-        return GetNextResult::makeEOF();
+    // We aren't streaming, and the spilled partition being returned did not fit in memory, so its
+    // groups are merged from sorted runs on disk.
+    if (!_sorterIterator) {
+        // The sorted runs of the partition have been exhausted. Move on to the next partition.
+        _spilled = false;
+        return getNextStandard();
+    }
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergeAccumulatorStates(_firstPartOfNextGroup.second, &_currentAccumulators);
 
         if (!_sorterIterator->more()) {
-            dispose();
+            _sorterIterator.reset();
+            if (!haveSpilledPartitionsToLoad()) {
+                dispose();
+            }
             break;
         }
 
@@ -189,13 +187,20 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
-    // Not spilled, and not streaming.
-    if (_groups->empty())
-        return GetNextResult::makeEOF();
+    // Not streaming, and the groups being returned are in memory.
+    while (groupsIterator == _groups->end()) {
+        if (!loadNextSpilledPartition()) {
+            return GetNextResult::makeEOF();
+        }
+
+        if (_spilled) {
+            return getNextSpilled();
+        }
+    }
 
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++groupsIterator == _groups->end() && !haveSpilledPartitionsToLoad())
         dispose();
 
     return std::move(out);
@@ -205,6 +210,9 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _sortedFiles.clear();
+    _partitions.clear();
+    _pendingBatch.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -340,11 +348,16 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
     if (!pExpCtx->inMongos && (pExpCtx->allowDiskUse || kDebugBuild)) {
         // We spill to disk in debug mode, regardless of allowDiskUse, to stress the system.
         _fileName = pExpCtx->tempDir + "/" + nextFileName();
+        _partitions.resize(internalDocumentSourceGroupSpillPartitions.load());
     }
 }
 
 DocumentSourceGroup::~DocumentSourceGroup() {
-    if (_ownsFileDeletion) {
+    // Release the spilled runs before removing the file they were written to.
+    _sorterIterator.reset();
+    _sortedFiles.clear();
+    _partitions.clear();
+    if (!_fileName.empty()) {
         DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName));
     }
 }
@@ -468,7 +481,10 @@ private:
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
-    const size_t numAccumulators = _accumulatedFields.size();
+    if (!_numPartialAggregationWorkers) {
+        _numPartialAggregationWorkers = choosePartialAggregationWorkers();
+    }
+    const size_t batchSize = internalDocumentSourceGroupPartialAggregationBatchSize.load();
 
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
@@ -478,58 +494,21 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+            spillColdPartitions();
         }
 
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
         auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+        if (_numPartialAggregationWorkers > 1) {
+            _pendingBatch.push_back(std::move(rootDocument));
+            if (_pendingBatch.size() >= batchSize) {
+                processBatchInParallel();
             }
+            continue;
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(
-                _accumulatedFields[i].expression->evaluate(rootDocument, &pExpCtx->variables),
-                _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
-        }
-
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
-
-                _sortedFiles.push_back(spill());
-            }
-        }
+        processDocument(rootDocument, &pExpCtx->variables);
     }
 
     switch (input.getStatus()) {
@@ -541,34 +520,21 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
-                _spilled = true;
-                if (!_groups->empty()) {
-                    _sortedFiles.push_back(spill());
-                }
-
-                // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
-
-                _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles,
-                    _fileName,
-                    SortOptions(),
-                    SorterComparator(pExpCtx->getValueComparator())));
-                _ownsFileDeletion = false;
-
-                // prepare current to accumulate data
-                _currentAccumulators.reserve(numAccumulators);
-                for (auto&& accumulatedField : _accumulatedFields) {
-                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+            processBatchInParallel();
+
+            // Spill the remaining groups of the partitions which have been spilled before, so that
+            // each spilled partition can be aggregated from its runs alone. The groups of the
+            // other partitions are returned from memory first.
+            std::vector<size_t> partitionsToSpill;
+            for (size_t i = 0; i < _partitions.size(); ++i) {
+                if (!_partitions[i].spilledRuns.empty() && _partitions[i].memoryUsageBytes > 0) {
+                    partitionsToSpill.push_back(i);
                 }
-
-                verify(_sorterIterator->more());  // we put data in, we should get something out.
-                _firstPartOfNextGroup = _sorterIterator->next();
-            } else {
-                // start the group iterator
-                groupsIterator = _groups->begin();
             }
+            spillPartitions(partitionsToSpill);
+
+            // start the group iterator
+            groupsIterator = _groups->begin();
 
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
@@ -579,6 +545,406 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceGroup::processDocument(const Document& root, Variables* variables) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    Value id = computeId(root, variables);
+
+    bool inserted;
+    Partition* partition;
+    Accumulators& group = startGroupUpdate(id, &inserted, &partition);
+    if (inserted) {
+        group = makeAccumulators();
+    }
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(_accumulatedFields[i].expression->evaluate(root, variables), _doingMerge);
+    }
+
+    finishGroupUpdate(group, partition);
+
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&          // is a dup
+            partition &&          // can spill to disk
+            !_allowDiskUse &&     // don't change behavior when testing external sort
+            _numSpills < 20) {    // don't open too many FDs
+            spillPartitions({static_cast<size_t>(partition - _partitions.data())});
+        }
+    }
+}
+
+void DocumentSourceGroup::mergeGroup(const Value& id, const Value& accumulatorStates) {
+    bool inserted;
+    Partition* partition;
+    Accumulators& group = startGroupUpdate(id, &inserted, &partition);
+    if (inserted) {
+        group = makeAccumulators();
+    }
+
+    mergeAccumulatorStates(accumulatorStates, &group);
+    finishGroupUpdate(group, partition);
+}
+
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::startGroupUpdate(const Value& id,
+                                                                         bool* inserted,
+                                                                         Partition** partition) {
+    // Partitions are only tracked while the input is consumed. Afterwards, the groups of spilled
+    // partitions are loaded one partition at a time.
+    *partition = (_partitions.empty() || _initialized) ? nullptr : &_partitions[partitionOf(id)];
+
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    Accumulators& group = (*_groups)[id];
+    *inserted = _groups->size() != oldSize;
+
+    if (*inserted) {
+        const size_t idSize = id.getApproximateSize();
+        _memoryUsageBytes += idSize;
+        if (*partition) {
+            (*partition)->memoryUsageBytes += idSize;
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            const size_t accumSize = groupObj->memUsageForSorter();
+            _memoryUsageBytes -= accumSize;
+            if (*partition) {
+                (*partition)->memoryUsageBytes -= accumSize;
+            }
+        }
+    }
+
+    if (*partition) {
+        ++(*partition)->numRecentUpdates;
+    }
+    return group;
+}
+
+void DocumentSourceGroup::finishGroupUpdate(const Accumulators& group, Partition* partition) {
+    for (auto&& groupObj : group) {
+        const size_t accumSize = groupObj->memUsageForSorter();
+        _memoryUsageBytes += accumSize;
+        if (partition) {
+            partition->memoryUsageBytes += accumSize;
+        }
+    }
+}
+
+DocumentSourceGroup::Accumulators DocumentSourceGroup::makeAccumulators() const {
+    Accumulators accums;
+    accums.reserve(_accumulatedFields.size());
+    for (auto&& accumulatedField : _accumulatedFields) {
+        accums.push_back(accumulatedField.makeAccumulator(pExpCtx));
+    }
+    return accums;
+}
+
+Value DocumentSourceGroup::getAccumulatorStates(const Accumulators& accums) const {
+    switch (accums.size()) {  // mirrored in mergeAccumulatorStates()
+        case 0:               // no values, essentially a distinct
+            return Value();
+
+        case 1:  // just one value, use optimized serialization as single Value
+            return accums[0]->getValue(/*toBeMerged=*/true);
+
+        default: {  // multiple values, serialize as array-typed Value
+            vector<Value> states;
+            states.reserve(accums.size());
+            for (auto&& accum : accums) {
+                states.push_back(accum->getValue(/*toBeMerged=*/true));
+            }
+            return Value(std::move(states));
+        }
+    }
+}
+
+void DocumentSourceGroup::mergeAccumulatorStates(const Value& accumulatorStates,
+                                                 Accumulators* accums) const {
+    switch (accums->size()) {  // mirrors switch in getAccumulatorStates()
+        case 0:                // No accumulators so no Values.
+            break;
+
+        case 1:  // Single accumulators serialize as a single Value.
+            (*accums)[0]->process(accumulatorStates, true);
+            break;
+
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& states = accumulatorStates.getArray();
+            for (size_t i = 0; i < accums->size(); i++) {
+                (*accums)[i]->process(states[i], true);
+            }
+        }
+    }
+}
+
+size_t DocumentSourceGroup::partitionOf(const Value& id) const {
+    // '_groups' hashes its keys with the same function. Remix the hash, so that the keys of a
+    // partition are still spread evenly over the buckets of '_groups' when the partition is loaded.
+    uint64_t hash = pExpCtx->getValueComparator().hash(id);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash % _partitions.size();
+}
+
+void DocumentSourceGroup::spillColdPartitions() {
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < _partitions.size(); ++i) {
+        if (_partitions[i].memoryUsageBytes > 0) {
+            candidates.push_back(i);
+        }
+    }
+
+    // Spill the partitions which were updated least often since the last spill first, and among
+    // those the largest ones. Groups which are updated often stay in memory, where updating them is
+    // cheap.
+    std::sort(candidates.begin(), candidates.end(), [&](size_t lhs, size_t rhs) {
+        const Partition& lhsPartition = _partitions[lhs];
+        const Partition& rhsPartition = _partitions[rhs];
+        if (lhsPartition.numRecentUpdates != rhsPartition.numRecentUpdates) {
+            return lhsPartition.numRecentUpdates < rhsPartition.numRecentUpdates;
+        }
+        return lhsPartition.memoryUsageBytes > rhsPartition.memoryUsageBytes;
+    });
+
+    const size_t targetMemoryUsageBytes = _maxMemoryUsageBytes / 2;
+    size_t remainingMemoryUsageBytes = _memoryUsageBytes;
+    std::vector<size_t> partitionsToSpill;
+    for (auto&& partition : candidates) {
+        if (remainingMemoryUsageBytes <= targetMemoryUsageBytes) {
+            break;
+        }
+        partitionsToSpill.push_back(partition);
+        remainingMemoryUsageBytes -=
+            std::min(remainingMemoryUsageBytes, _partitions[partition].memoryUsageBytes);
+    }
+
+    spillPartitions(partitionsToSpill);
+
+    for (auto&& partition : _partitions) {
+        partition.numRecentUpdates = 0;
+    }
+}
+
+void DocumentSourceGroup::spillPartitions(const std::vector<size_t>& partitions) {
+    if (partitions.empty()) {
+        return;
+    }
+
+    _usedDisk = true;
+    ++_numSpills;
+
+    // Collect the groups of all of the partitions being spilled in a single pass over '_groups'.
+    std::vector<bool> isSpilling(_partitions.size(), false);
+    for (auto&& partition : partitions) {
+        isSpilling[partition] = true;
+    }
+    std::vector<std::vector<GroupsMap::iterator>> groupsToSpill(_partitions.size());
+    for (auto it = _groups->begin(); it != _groups->end(); ++it) {
+        const size_t partition = partitionOf(it->first);
+        if (isSpilling[partition]) {
+            groupsToSpill[partition].push_back(it);
+        }
+    }
+
+    for (auto&& partition : partitions) {
+        if (groupsToSpill[partition].empty()) {
+            continue;
+        }
+
+        // The groups of a run are in no particular order, since each spilled partition is
+        // aggregated again by hashing when it is loaded.
+        SortedFileWriter<Value, Value> writer(
+            SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        for (auto&& it : groupsToSpill[partition]) {
+            writer.addAlreadySorted(it->first, getAccumulatorStates(it->second));
+        }
+        _partitions[partition].spilledRuns.push_back(SpilledRun(writer.done()));
+        _nextSortedFileWriterOffset = writer.getFileEndOffset();
+
+        for (auto&& it : groupsToSpill[partition]) {
+            _groups->erase(it);
+        }
+        _memoryUsageBytes -= std::min(_memoryUsageBytes, _partitions[partition].memoryUsageBytes);
+        _partitions[partition].memoryUsageBytes = 0;
+    }
+}
+
+bool DocumentSourceGroup::haveSpilledPartitionsToLoad() {
+    while (_nextPartitionToLoad < _partitions.size() &&
+           _partitions[_nextPartitionToLoad].spilledRuns.empty()) {
+        ++_nextPartitionToLoad;
+    }
+    return _nextPartitionToLoad < _partitions.size();
+}
+
+bool DocumentSourceGroup::loadNextSpilledPartition() {
+    if (!haveSpilledPartitionsToLoad()) {
+        return false;
+    }
+
+    std::vector<SpilledRun> runs;
+    runs.swap(_partitions[_nextPartitionToLoad++].spilledRuns);
+
+    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _memoryUsageBytes = 0;
+
+    // Merge the runs in the order in which they were spilled, so that accumulators which depend on
+    // the order of their input, such as $first, see the partial states in input order.
+    for (auto&& run : runs) {
+        pExpCtx->checkForInterrupt();
+        run->openSource();
+        while (run->more()) {
+            if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                // This partition does not fit in memory on its own. Fall back to sorting its
+                // groups into runs on disk and merging them by key.
+                _sortedFiles.push_back(spill());
+                _memoryUsageBytes = 0;
+            }
+
+            auto next = run->next();
+            mergeGroup(next.first, next.second);
+        }
+        run->closeSource();
+    }
+
+    if (_sortedFiles.empty()) {
+        groupsIterator = _groups->begin();
+        return true;
+    }
+
+    if (!_groups->empty()) {
+        _sortedFiles.push_back(spill());
+    }
+
+    // We won't be using groups again for this partition so free its memory.
+    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    groupsIterator = _groups->end();
+    _memoryUsageBytes = 0;
+
+    // The spill file is still used by other partitions, so this stage remains responsible for
+    // deleting it.
+    _sorterIterator.reset(
+        Sorter<Value, Value>::Iterator::merge(_sortedFiles,
+                                              "",
+                                              SortOptions(),
+                                              SorterComparator(pExpCtx->getValueComparator())));
+    _sortedFiles.clear();
+
+    // prepare current to accumulate data
+    if (_currentAccumulators.size() != _accumulatedFields.size()) {
+        _currentAccumulators = makeAccumulators();
+    }
+
+    _spilled = true;
+    verify(_sorterIterator->more());  // we put data in, we should get something out.
+    _firstPartOfNextGroup = _sorterIterator->next();
+    return true;
+}
+
+size_t DocumentSourceGroup::choosePartialAggregationWorkers() const {
+    // Expressions are only evaluated concurrently without a collator, since collators are not
+    // guaranteed to be safe to use from several threads.
+    if (!_parallelPartialAggregationAllowed || pExpCtx->inMongos || !pExpCtx->opCtx ||
+        pExpCtx->getCollator()) {
+        return 1;
+    }
+
+    if (pExpCtx->parallelism) {
+        return static_cast<size_t>(*pExpCtx->parallelism);
+    }
+    return std::max(
+        static_cast<size_t>(internalDocumentSourceGroupPartialAggregationWorkers.load()),
+        _inputParallelism);
+}
+
+void DocumentSourceGroup::processBatchInParallel() {
+    if (_pendingBatch.empty()) {
+        return;
+    }
+
+    pExpCtx->checkForInterrupt();
+
+    const size_t numWorkers = std::min(_numPartialAggregationWorkers, _pendingBatch.size());
+    const size_t sliceSize = (_pendingBatch.size() + numWorkers - 1) / numWorkers;
+
+    struct Worker {
+        GroupsMap groups;
+        Status status;
+    };
+    std::vector<Worker> workers;
+    workers.reserve(numWorkers);
+
+    std::vector<QueryWorkerPool::Task> tasks;
+    tasks.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.push_back(
+            {pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>(), Status::OK()});
+
+        const size_t begin = i * sliceSize;
+        const size_t end = std::min(begin + sliceSize, _pendingBatch.size());
+        tasks.emplace_back([this, &worker = workers.back(), begin, end] {
+            try {
+                // Each worker evaluates expressions against its own copy of the variables, since
+                // some expressions, such as $let, assign to them.
+                Variables variables = pExpCtx->variables;
+                for (size_t j = begin; j < end; ++j) {
+                    const Document& root = _pendingBatch[j];
+                    Accumulators& group = worker.groups[computeId(root, &variables)];
+                    if (group.empty()) {
+                        group = makeAccumulators();
+                    }
+                    for (size_t k = 0; k < group.size(); ++k) {
+                        group[k]->process(
+                            _accumulatedFields[k].expression->evaluate(root, &variables),
+                            _doingMerge);
+                    }
+                }
+            } catch (...) {
+                worker.status = exceptionToStatus();
+            }
+        });
+    }
+
+    QueryWorkerPool::get(pExpCtx->opCtx->getServiceContext())->runAll(std::move(tasks));
+    _pendingBatch.clear();
+
+    for (auto&& worker : workers) {
+        uassertStatusOK(worker.status);
+    }
+
+    // Merge the partial groups of the workers in the order of their slices of the batch, so that
+    // accumulators which depend on the order of their input see it in input order.
+    for (auto&& worker : workers) {
+        for (auto&& partialGroup : worker.groups) {
+            if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                uassert(51256,
+                        "Exceeded memory limit for $group, but didn't allow external sort."
+                        " Pass allowDiskUse:true to opt in.",
+                        _allowDiskUse);
+                spillColdPartitions();
+            }
+
+            bool inserted;
+            Partition* partition;
+            Accumulators& group = startGroupUpdate(partialGroup.first, &inserted, &partition);
+            if (inserted) {
+                // The first partial state of a group can be adopted as is.
+                group = std::move(partialGroup.second);
+            } else {
+                mergeAccumulatorStates(getAccumulatorStates(partialGroup.second), &group);
+            }
+            finishGroupUpdate(group, partition);
+        }
+        worker.groups.clear();
+    }
+}
+
 bool DocumentSourceGroup::usedDisk() {
     return _usedDisk;
 }
@@ -595,29 +961,8 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     SortedFileWriter<Value, Value> writer(
         SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
-            }
-            break;
-
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
-            }
-            break;
-
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
-                }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
-            }
-            break;
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        writer.addAlreadySorted(ptrs[i]->first, getAccumulatorStates(ptrs[i]->second));
     }
 
     _groups->clear();
@@ -627,10 +972,10 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
-Value DocumentSourceGroup::computeId(const Document& root) {
+Value DocumentSourceGroup::computeId(const Document& root, Variables* variables) {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
-        Value retValue = _idExpressions[0]->evaluate(root, &pExpCtx->variables);
+        Value retValue = _idExpressions[0]->evaluate(root, variables);
         return retValue.missing() ? Value(BSONNULL) : std::move(retValue);
     }
 
@@ -638,7 +983,7 @@ Value DocumentSourceGroup::computeId(const Document& root) {
     vector<Value> vals;
     vals.reserve(_idExpressions.size());
     for (size_t i = 0; i < _idExpressions.size(); i++) {
-        vals.push_back(_idExpressions[i]->evaluate(root, &pExpCtx->variables));
+        vals.push_back(_idExpressions[i]->evaluate(root, variables));
     }
     return Value(std::move(vals));
 }
@@ -157,6 +157,22 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Allows this stage to aggregate batches of its input on several threads, as configured by
+     * the aggregation's 'parallelism' option or else by
+     * 'internalDocumentSourceGroupPartialAggregationWorkers'. Callers may only allow this when the
+     * documents produced by this stage's source share no storage with each other, since Documents
+     * lazily cache their fields and are not safe to read from several threads at once.
+     *
+     * 'inputParallelism' is the number of workers of the parallel collection scan which produces
+     * the input, if any. Without a 'parallelism' option the input is then aggregated by at least
+     * as many threads as it was scanned by.
+     */
+    void setParallelPartialAggregationAllowed(bool allowed, size_t inputParallelism = 1) {
+        _parallelPartialAggregationAllowed = allowed;
+        _inputParallelism = inputParallelism;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -182,6 +198,27 @@ protected:
     void doDispose() final;
 
 private:
+    using SpilledRun = std::shared_ptr<Sorter<Value, Value>::Iterator>;
+
+    /**
+     * The groups of an unsorted $group are divided into partitions by the hash of their key. When
+     * the groups no longer fit in memory, the groups of the least recently updated partitions are
+     * written to disk, and each spilled partition is aggregated again on its own once the input is
+     * exhausted.
+     */
+    struct Partition {
+        // Memory used by the groups of this partition which are currently held in '_groups'.
+        size_t memoryUsageBytes = 0;
+
+        // Number of input documents which were added to a group of this partition since the last
+        // time partitions were spilled. Partitions with the fewest are spilled first.
+        size_t numRecentUpdates = 0;
+
+        // Runs of groups spilled from this partition, in the order in which they were spilled. Each
+        // group key appears at most once per run.
+        std::vector<SpilledRun> spilledRuns;
+    };
+
     explicit DocumentSourceGroup(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                                  boost::optional<size_t> maxMemoryUsageBytes = boost::none);
 
@@ -214,12 +251,92 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Adds the document 'root' to its group, evaluating the group key and the accumulator inputs
+     * with 'variables'.
+     */
+    void processDocument(const Document& root, Variables* variables);
+
+    /**
+     * Merges the partial states 'accumulatorStates', as produced by getAccumulatorStates(), into
+     * the group with key 'id'.
+     */
+    void mergeGroup(const Value& id, const Value& accumulatorStates);
+
+    /**
+     * Returns the group with key 'id' in '_groups', creating it if necessary, and accounts for the
+     * memory it uses before an update. A group which was created has no accumulators, and the
+     * caller must add them. The caller must call finishGroupUpdate() once it has updated the
+     * group's accumulators. 'partition' is set to the partition of the group if partitions are
+     * being tracked, and to null otherwise.
+     */
+    Accumulators& startGroupUpdate(const Value& id, bool* inserted, Partition** partition);
+    void finishGroupUpdate(const Accumulators& group, Partition* partition);
+
+    /**
+     * Returns a new set of accumulators for a group.
+     */
+    Accumulators makeAccumulators() const;
+
+    /**
+     * Returns the partial states of 'accums' serialized as a single Value, to be written to disk or
+     * merged into another group.
+     */
+    Value getAccumulatorStates(const Accumulators& accums) const;
+
+    /**
+     * Merges the partial states 'accumulatorStates' into 'accums'.
+     */
+    void mergeAccumulatorStates(const Value& accumulatorStates, Accumulators* accums) const;
+
+    /**
+     * Spills the groups of the partitions which were least recently updated until the remaining
+     * groups use at most half of '_maxMemoryUsageBytes'.
+     */
+    void spillColdPartitions();
+
+    /**
+     * Writes the in-memory groups of each partition in 'partitions' to disk as a new run of that
+     * partition, and removes them from '_groups'.
+     */
+    void spillPartitions(const std::vector<size_t>& partitions);
+
+    /**
+     * Aggregates the runs of the next spilled partition which has not been returned yet into
+     * '_groups', or into '_sorterIterator' if the partition does not fit in memory. Returns false
+     * if all spilled partitions have been returned.
+     */
+    bool loadNextSpilledPartition();
+
+    /**
+     * Returns true if groups remain to be loaded from spilled partitions.
+     */
+    bool haveSpilledPartitionsToLoad();
+
+    /**
+     * Returns the index in '_partitions' of the partition of the group with key 'id'.
+     */
+    size_t partitionOf(const Value& id) const;
+
+    /**
+     * Returns the number of threads with which to aggregate the input, or 1 if it may not be
+     * aggregated on several threads; see setParallelPartialAggregationAllowed().
+     */
+    size_t choosePartialAggregationWorkers() const;
+
+    /**
+     * Aggregates the documents in '_pendingBatch' on several threads, each of which aggregates a
+     * contiguous slice of the batch into its own groups, and merges the partial groups into
+     * '_groups' in the order of the slices.
+     */
+    void processBatchInParallel();
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
      * Computes the internal representation of the group key.
      */
-    Value computeId(const Document& root);
+    Value computeId(const Document& root, Variables* variables);
 
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
@@ -239,8 +356,22 @@ private:
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
     std::string _fileName;
-    unsigned int _nextSortedFileWriterOffset = 0;
-    bool _ownsFileDeletion = true;  // unless a MergeIterator is made that takes over.
+    std::streampos _nextSortedFileWriterOffset = 0;
+
+    // Empty if this stage cannot spill to disk. Otherwise indexed by partitionOf() of a group key.
+    std::vector<Partition> _partitions;
+    size_t _numSpills = 0;
+    size_t _nextPartitionToLoad = 0;
+
+    bool _parallelPartialAggregationAllowed = false;
+    size_t _inputParallelism = 1;
+
+    // The number of threads aggregating the input, chosen when input is first consumed. Zero until
+    // then.
+    size_t _numPartialAggregationWorkers = 0;
+
+    // Input documents which have not been aggregated yet when aggregating on several threads.
+    std::vector<Document> _pendingBatch;
 
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
@@ -261,7 +392,8 @@ private:
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
-    // Only used when '_spilled' is true.
+    // Only used when '_spilled' is true, which is the case while returning the groups of a spilled
+    // partition which did not fit in memory.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _allowDiskUse;
 
@@ -49,11 +49,13 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -142,6 +144,146 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldMergeGroupsSpilledByPartitionAcrossManySpills) {
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 4 * 1024;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"total",
+                                       ExpressionFieldPath::parse(expCtx, "$x", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement firstStatement{"first",
+                                         ExpressionFieldPath::parse(expCtx, "$seq", vps),
+                                         AccumulationStatement::getFactory("$first")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {sumStatement, firstStatement}, maxMemoryUsageBytes);
+
+    // Visit every key several times, far more keys than fit in memory, so that most partitions are
+    // spilled more than once.
+    const int numKeys = 500;
+    const int numRounds = 4;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int round = 0; round < numRounds; ++round) {
+        for (int key = 0; key < numKeys; ++key) {
+            inputs.emplace_back(
+                Document{{"key", key}, {"x", 1}, {"seq", round * numKeys + key}});
+        }
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> keys;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        const int key = doc["_id"].coerceToInt();
+        ASSERT_EQ(doc["total"].coerceToInt(), numRounds);
+        ASSERT_EQ(doc["first"].coerceToInt(), key);
+        ASSERT_TRUE(keys.insert(key).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_TRUE(group->usedDisk());
+    ASSERT_EQ(keys.size(), static_cast<size_t>(numKeys));
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldSortSpilledPartitionWhichDoesNotFitInMemory) {
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    // With a single partition, every spill writes all groups to the same partition, which is then
+    // too large to be loaded back into memory at once.
+    const int originalPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(originalPartitions); });
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {pushStatement}, maxMemoryUsageBytes);
+
+    string largeStr(maxMemoryUsageBytes / 2, 'x');
+    const int numKeys = 10;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 2 * numKeys; ++i) {
+        inputs.emplace_back(Document{{"_id", i % numKeys}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["spaceHog"].getArrayLength(), 2UL);
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(numKeys));
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelPartialAggregationMatchesSequentialAggregation) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = false;
+
+    const int originalWorkers = internalDocumentSourceGroupPartialAggregationWorkers.load();
+    const int originalBatchSize = internalDocumentSourceGroupPartialAggregationBatchSize.load();
+    internalDocumentSourceGroupPartialAggregationWorkers.store(4);
+    internalDocumentSourceGroupPartialAggregationBatchSize.store(64);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceGroupPartialAggregationWorkers.store(originalWorkers);
+        internalDocumentSourceGroupPartialAggregationBatchSize.store(originalBatchSize);
+    });
+
+    auto runGroup = [&](bool parallel) {
+        VariablesParseState vps = expCtx->variablesParseState;
+        AccumulationStatement sumStatement{"total",
+                                           ExpressionFieldPath::parse(expCtx, "$x", vps),
+                                           AccumulationStatement::getFactory("$sum")};
+        AccumulationStatement firstStatement{"first",
+                                             ExpressionFieldPath::parse(expCtx, "$seq", vps),
+                                             AccumulationStatement::getFactory("$first")};
+        auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+        auto group =
+            DocumentSourceGroup::create(expCtx, groupByExpression, {sumStatement, firstStatement});
+        group->setParallelPartialAggregationAllowed(parallel);
+
+        std::deque<DocumentSource::GetNextResult> inputs;
+        for (int i = 0; i < 1000; ++i) {
+            inputs.emplace_back(Document{{"key", i % 37}, {"x", i}, {"seq", i}});
+        }
+        auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+        group->setSource(mock.get());
+
+        std::map<int, std::pair<long long, int>> results;
+        for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+            auto doc = result.releaseDocument();
+            results[doc["_id"].coerceToInt()] = {doc["total"].coerceToLong(),
+                                                 doc["first"].coerceToInt()};
+        }
+        return results;
+    };
+
+    auto sequentialResults = runGroup(false);
+    auto parallelResults = runGroup(true);
+    ASSERT_EQ(sequentialResults.size(), 37UL);
+    ASSERT(sequentialResults == parallelResults);
+    for (auto&& result : parallelResults) {
+        ASSERT_EQ(result.second.second, result.first);
+    }
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -63,6 +63,9 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+        if (!stats.statistics.isEmpty()) {
+            doc["statistics"] = Value(stats.statistics);
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <cmath>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -42,6 +43,8 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -50,6 +53,47 @@ using std::vector;
 
 constexpr size_t DocumentSourceLookUp::kMaxSubPipelineDepth;
 
+namespace {
+
+// Rough costs of the work done by each join strategy, relative to examining one document. Each
+// query of the foreign collection builds, plans and runs a pipeline, which is much more expensive
+// than probing a hash table.
+constexpr double kForeignQueryCost = 10;
+constexpr double kHashTableBuildCostPerDocument = 2;
+
+// The maximum size of the distinct join keys of a batch of the batched nested loop strategy, which
+// keeps the $in query of the batch well within the BSON size limit.
+constexpr size_t kBatchedNestedLoopMaxKeyBytes = 1024 * 1024;
+
+/**
+ * Queries treat numeric path components after the first as array positions as well as field names,
+ * which matching the values at a path outside of a query does not.
+ */
+bool hasPositionalPathComponent(const FieldPath& path) {
+    for (size_t i = 1; i < path.getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(path.getFieldName(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string nextHashJoinFileName() {
+    static AtomicWord<unsigned> lookupHashJoinFileCounter;
+    return "lookup-hash-join." + std::to_string(lookupHashJoinFileCounter.fetchAndAdd(1));
+}
+
+void assertLookupResultSizeWithinLimit(const NamespaceString& fromNs, long long totalBytes) {
+    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    uassert(4568,
+            str::stream() << "Total size of documents in " << fromNs.coll()
+                          << " matching pipeline's $lookup stage exceeds " << maxBytes << " bytes",
+
+            totalBytes <= maxBytes);
+}
+
+}  // namespace
+
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
                                            const boost::intrusive_ptr<ExpressionContext>& expCtx)
@@ -230,8 +274,13 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     pExpCtx->checkForInterrupt();
 
+    const bool isBatched = _joinStrategy != JoinStrategy::kNestedLoop;
     if (_unwindSrc) {
-        return unwindResult();
+        return isBatched ? unwindBatchedJoinResult() : unwindResult();
+    }
+
+    if (isBatched) {
+        return batchedJoinResult();
     }
 
     auto nextInput = pSource->getNext();
@@ -245,9 +294,19 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
+    auto results = queryForeignMatches(inputDoc);
+
+    MutableDocument output(std::move(inputDoc));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+std::vector<Value> DocumentSourceLookUp::queryForeignMatches(const Document& inputDoc) {
     if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+        auto matchStage = makeMatchStageFromInput(inputDoc,
+                                                  *_localField,
+                                                  _foreignField->fullPath(),
+                                                  _additionalFilter.value_or(BSONObj()));
         // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
         _resolvedPipeline.back() = matchStage;
     }
@@ -255,28 +314,293 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     auto pipeline = buildPipeline(inputDoc);
 
     std::vector<Value> results;
-    int objsize = 0;
-    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    long long objsize = 0;
     while (auto result = pipeline->getNext()) {
         objsize += result->getApproximateSize();
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline's $lookup stage exceeds " << maxBytes
-                              << " bytes",
-
-                objsize <= maxBytes);
+        assertLookupResultSizeWithinLimit(_fromNs, objsize);
         results.emplace_back(std::move(*result));
     }
     for (auto&& source : pipeline->getSources()) {
         if (source->usedDisk())
             _usedDisk = true;
     }
+    return results;
+}
 
-    MutableDocument output(std::move(inputDoc));
-    output.setNestedField(_as, Value(std::move(results)));
+void DocumentSourceLookUp::queryForeignMatchesBatched(
+    const std::vector<std::vector<Value>>& probes, const LookupProbeSet::MatchCallback& onMatch) {
+    invariant(!wasConstructedWithPipelineSyntax());
+
+    LookupProbeSet probeSet(_fromExpCtx->getValueComparator(), probes);
+
+    // {$match: {$and: [{<foreignField>: {$in: [<value>, ...]}}, <additionalFilter>]}}. None of the
+    // values is a regular expression, so $in compares them for equality only. Every batch has the
+    // same query shape, so the plan cache entry of the first batch is reused by the others.
+    BSONObjBuilder match;
+    {
+        BSONObjBuilder query(match.subobjStart("$match"));
+        BSONArrayBuilder andObj(query.subarrayStart("$and"));
+        {
+            BSONObjBuilder joiningObj(andObj.subobjStart());
+            BSONObjBuilder inObj(joiningObj.subobjStart(_foreignField->fullPath()));
+            BSONArrayBuilder inValues(inObj.subarrayStart("$in"));
+            for (auto&& value : probeSet.getDistinctValues()) {
+                value.addToBsonArray(&inValues);
+            }
+        }
+        andObj.append(_additionalFilter.value_or(BSONObj()));
+    }
+    // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+    _resolvedPipeline.back() = match.obj();
+
+    auto pipeline = buildPipeline(Document());
+    while (auto result = pipeline->getNext()) {
+        probeSet.match(*result, *_foreignField, onMatch);
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::batchedJoinResult() {
+    if (_joinBatch.empty()) {
+        if (auto notAdvanced = loadJoinBatch()) {
+            return std::move(*notAdvanced);
+        }
+    }
+
+    auto joined = std::move(_joinBatch.front());
+    _joinBatch.pop_front();
+
+    MutableDocument output(std::move(joined.first));
+    output.setNestedField(_as, Value(std::move(joined.second)));
     return output.freeze();
 }
 
+DocumentSource::GetNextResult DocumentSourceLookUp::unwindBatchedJoinResult() {
+    const boost::optional<FieldPath> indexPath(_unwindSrc->indexPath());
+
+    // Loop until we get a document that has at least one match. As in unwindResult(), we may
+    // return early if our source stage is exhausted or if the unwind source was asked to return
+    // empty arrays and we get a document without a match.
+    while (!_input) {
+        if (_joinBatch.empty()) {
+            if (auto notAdvanced = loadJoinBatch()) {
+                return std::move(*notAdvanced);
+            }
+        }
+
+        auto joined = std::move(_joinBatch.front());
+        _joinBatch.pop_front();
+
+        if (!joined.second.empty()) {
+            _input = std::move(joined.first);
+            _unwindMatches = std::move(joined.second);
+            _cursorIndex = 0;
+        } else if (_unwindSrc->preserveNullAndEmptyArrays()) {
+            MutableDocument output(std::move(joined.first));
+            output.setNestedField(_as, Value());
+            if (indexPath) {
+                output.setNestedField(*indexPath, Value(BSONNULL));
+            }
+            return output.freeze();
+        }
+    }
+
+    const bool isLastMatch = static_cast<size_t>(_cursorIndex + 1) == _unwindMatches.size();
+
+    // Move input document into output if this is the last result, otherwise perform a copy.
+    MutableDocument output(isLastMatch ? std::move(*_input) : *_input);
+    output.setNestedField(_as, std::move(_unwindMatches[_cursorIndex]));
+
+    if (indexPath) {
+        output.setNestedField(*indexPath, Value(_cursorIndex));
+    }
+
+    ++_cursorIndex;
+    if (isLastMatch) {
+        _input.reset();
+        _unwindMatches.clear();
+    }
+    return output.freeze();
+}
+
+boost::optional<DocumentSource::GetNextResult> DocumentSourceLookUp::loadJoinBatch() {
+    invariant(_joinBatch.empty());
+
+    if (_joinBatchPendingResult) {
+        auto pendingResult = std::move(*_joinBatchPendingResult);
+        _joinBatchPendingResult.reset();
+        return std::move(pendingResult);
+    }
+
+    // Once the input documents joined so far have cost as much to look up in the foreign
+    // collection as hashing it would, hash it for the remaining input documents.
+    if (_hashJoinInputThreshold && _numInputDocsJoined >= *_hashJoinInputThreshold) {
+        _hashJoinInputThreshold.reset();
+        _joinStrategy = JoinStrategy::kHashJoin;
+    }
+
+    // When the foreign side is hashed in memory, each input document is joined as soon as it
+    // arrives. Otherwise the input documents are joined in batches, with one pass over the spilled
+    // foreign side or one query of the foreign collection per batch. The foreign side is only
+    // hashed once there is an input document to probe it with.
+    auto batchSize = [&]() -> size_t {
+        if (_joinStrategy == JoinStrategy::kHashJoin && _hashTable) {
+            return _hashTable->isSpilled() ? internalLookupHashJoinSpilledProbeBatchSize.load()
+                                           : 1;
+        }
+        return internalLookupNestedLoopJoinBatchSize.load();
+    };
+
+    std::vector<std::vector<Value>> probes;
+    std::vector<size_t> probeOutputPositions;
+    size_t probeBytes = 0;
+    while (_joinBatch.size() < batchSize() && probeBytes < kBatchedNestedLoopMaxKeyBytes) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            if (_joinBatch.empty()) {
+                return std::move(nextInput);
+            }
+            if (nextInput.isPaused()) {
+                // Return the pause once the documents which preceded it have been returned. The
+                // source will report EOF again when it is next asked.
+                _joinBatchPendingResult = std::move(nextInput);
+            }
+            break;
+        }
+
+        auto inputDoc = nextInput.releaseDocument();
+        ++_numInputDocsJoined;
+
+        std::vector<Value> localValues;
+        bool canProbe = true;
+        document_path_support::visitAllValuesAtPath(
+            inputDoc, *_localField, [&](const Value& value) {
+                canProbe = canProbe && LookupHashTable::canProbeWith(value);
+                localValues.push_back(value);
+            });
+
+        // A missing local field matches foreign documents where the foreign field is null or
+        // missing, which can only be answered by a query of its own.
+        if (canProbe && !localValues.empty()) {
+            if (_joinStrategy == JoinStrategy::kHashJoin && !_hashTable) {
+                buildHashTable();
+            }
+            for (auto&& value : localValues) {
+                probeBytes += value.getApproximateSize();
+            }
+            probes.push_back(std::move(localValues));
+            probeOutputPositions.push_back(_joinBatch.size());
+            _joinBatch.emplace_back(std::move(inputDoc), std::vector<Value>());
+        } else {
+            auto matches = queryForeignMatches(inputDoc);
+            _joinBatch.emplace_back(std::move(inputDoc), std::move(matches));
+        }
+    }
+
+    if (probes.empty()) {
+        return boost::none;
+    }
+
+    std::vector<long long> matchBytes(probes.size(), 0);
+    auto onMatch = [&](size_t probeIndex, const Document& match) {
+        matchBytes[probeIndex] += match.getApproximateSize();
+        assertLookupResultSizeWithinLimit(_fromNs, matchBytes[probeIndex]);
+        _joinBatch[probeOutputPositions[probeIndex]].second.emplace_back(match);
+    };
+    if (_joinStrategy == JoinStrategy::kHashJoin) {
+        _hashTable->probeBatch(probes, onMatch);
+    } else {
+        queryForeignMatchesBatched(probes, onMatch);
+    }
+    return boost::none;
+}
+
+void DocumentSourceLookUp::buildHashTable() {
+    invariant(!wasConstructedWithPipelineSyntax());
+
+    std::string spillFileName;
+    if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+        spillFileName = pExpCtx->tempDir + "/" + nextHashJoinFileName();
+    }
+    _hashTable =
+        std::make_unique<LookupHashTable>(_fromExpCtx->getValueComparator(),
+                                          *_foreignField,
+                                          internalLookupHashJoinMaxMemoryBytes.load(),
+                                          std::move(spillFileName));
+
+    // The foreign side is read once, filtered only by the predicates of an absorbed $match.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipeline(Document());
+    while (auto result = pipeline->getNext()) {
+        if (!_hashTable->addBuildDocument(std::move(*result))) {
+            // The foreign side does not fit in memory. Query it for the input documents instead.
+            _hashTable.reset();
+            _joinStrategy = JoinStrategy::kBatchedNestedLoop;
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+
+    if (_hashTable) {
+        _hashTable->doneBuilding();
+        _usedDisk = _usedDisk || _hashTable->isSpilled();
+    }
+}
+
+DocumentSourceLookUp::JoinStrategy DocumentSourceLookUp::nestedLoopJoinStrategy() const {
+    if (wasConstructedWithPipelineSyntax() || internalLookupNestedLoopJoinBatchSize.load() <= 1 ||
+        hasPositionalPathComponent(*_foreignField)) {
+        return JoinStrategy::kNestedLoop;
+    }
+    return JoinStrategy::kBatchedNestedLoop;
+}
+
+boost::optional<long long> DocumentSourceLookUp::chooseHashJoinInputThreshold() const {
+    if (wasConstructedWithPipelineSyntax() || hasPositionalPathComponent(*_foreignField) ||
+        !internalQueryEnableLookupHashJoin.load() || pExpCtx->inMongos || !pExpCtx->opCtx ||
+        !pExpCtx->mongoProcessInterface) {
+        return boost::none;
+    }
+
+    const auto foreignStats = pExpCtx->mongoProcessInterface->getJoinStats(
+        _fromExpCtx, _resolvedNs, *_foreignField);
+    if (!foreignStats) {
+        return boost::none;
+    }
+
+    // Without allowDiskUse, a foreign side which does not fit in memory would only be read in vain
+    // before falling back to querying it for each input document.
+    if (!pExpCtx->allowDiskUse &&
+        foreignStats->dataSizeBytes > internalLookupHashJoinMaxMemoryBytes.load()) {
+        return boost::none;
+    }
+
+    // An index on a view cannot be used to answer queries on the fields the view computes. One
+    // placeholder $match is appended to '_resolvedPipeline' for the join predicate.
+    const bool isView = _resolvedPipeline.size() > 1;
+    const bool isIndexed = foreignStats->hasIndexOnJoinField && !isView;
+
+    // Each query of the foreign collection is shared by a batch of input documents.
+    const double foreignDocs = std::max(foreignStats->numRecords, 1LL);
+    const double queriesPerInputDoc = 1.0 / internalLookupNestedLoopJoinBatchSize.load();
+    const double probeCost = isIndexed
+        ? queriesPerInputDoc * kForeignQueryCost + std::log2(foreignDocs)
+        : queriesPerInputDoc * (kForeignQueryCost + foreignDocs);
+
+    // Probing a hash table costs about one unit per input document, so it can only pay off if
+    // querying the foreign collection costs more.
+    if (probeCost <= 1) {
+        return boost::none;
+    }
+
+    // How many input documents there are is not known until they have all been read. Switching to
+    // the hash join once the input documents joined so far have cost as much as building the hash
+    // table would bounds the cost of the join to about twice that of the better strategy, while a
+    // small input never pays for hashing a large foreign collection.
+    const double buildCost = foreignDocs * kHashTableBuildCostPerDocument;
+    return static_cast<long long>(std::ceil(buildCost / probeCost));
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -338,6 +662,15 @@ Pipeline::SourceContainer::iterator DocumentSourceLookUp::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
 
+    if (!_joinStrategyChosen) {
+        // A $lookup which may switch to the hash join starts out with the batched nested loop, so
+        // that the switch can happen between two batches.
+        _hashJoinInputThreshold = chooseHashJoinInputThreshold();
+        _joinStrategy = _hashJoinInputThreshold ? JoinStrategy::kBatchedNestedLoop
+                                                : nestedLoopJoinStrategy();
+        _joinStrategyChosen = true;
+    }
+
     if (std::next(itr) == container->end()) {
         return container->end();
     }
@@ -464,6 +797,9 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashTable.reset();
+    _joinBatch.clear();
+    _unwindMatches.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -699,6 +1035,13 @@ void DocumentSourceLookUp::serializeToArray(
             output[getSourceName()]["matching"] = Value(*_additionalFilter);
         }
 
+        if (_joinStrategy == JoinStrategy::kHashJoin) {
+            output[getSourceName()]["joinStrategy"] = Value("hashJoin"_sd);
+        } else if (_hashJoinInputThreshold) {
+            output[getSourceName()]["hashJoinAfterInputDocuments"] =
+                Value(*_hashJoinInputThreshold);
+        }
+
         array.push_back(Value(output.freeze()));
     } else {
         array.push_back(Value(output.freeze()));
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -37,6 +38,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -50,6 +52,14 @@ class DocumentSourceLookUp final : public DocumentSource {
 public:
     static constexpr size_t kMaxSubPipelineDepth = 20;
 
+    /**
+     * How a $lookup with localField/foreignField syntax finds the foreign documents matching an
+     * input document: by querying the foreign collection for each input document, by querying it
+     * once for the join keys of a batch of input documents, or by building a hash table of the
+     * foreign collection once and probing it.
+     */
+    enum class JoinStrategy { kNestedLoop, kBatchedNestedLoop, kHashJoin };
+
     struct LetVariable {
         LetVariable(std::string name, boost::intrusive_ptr<Expression> expression, Variables::Id id)
             : name(std::move(name)), expression(std::move(expression)), id(id) {}
@@ -192,6 +202,31 @@ public:
         return _letVariables;
     }
 
+    JoinStrategy getJoinStrategy() const {
+        return _joinStrategy;
+    }
+
+    /**
+     * Overrides the join strategy chosen during optimization. Only used for testing.
+     */
+    void setJoinStrategy_forTest(JoinStrategy joinStrategy) {
+        invariant(!wasConstructedWithPipelineSyntax());
+        _joinStrategy = joinStrategy;
+        _hashJoinInputThreshold.reset();
+        _joinStrategyChosen = true;
+    }
+
+    /**
+     * Starts the join with the batched nested loop strategy, and switches to the hash join once
+     * 'numInputDocs' input documents have been joined. Only used for testing.
+     */
+    void setHashJoinInputThreshold_forTest(long long numInputDocs) {
+        invariant(!wasConstructedWithPipelineSyntax());
+        _joinStrategy = JoinStrategy::kBatchedNestedLoop;
+        _hashJoinInputThreshold = numInputDocs;
+        _joinStrategyChosen = true;
+    }
+
     /**
      * Returns a non-executable pipeline which can be useful for introspection. In this pipeline,
      * all view definitions are resolved. This pipeline is present in both the sub-pipeline version
@@ -224,7 +259,7 @@ protected:
 
     /**
      * Attempts to combine with a subsequent $unwind stage, setting the internal '_unwindSrc'
-     * field.
+     * field. The first call also chooses the join strategy.
      */
     Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
                                                      Pipeline::SourceContainer* container) final;
@@ -267,6 +302,52 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Counterparts of getNext() and unwindResult() for the strategies which join input documents
+     * in batches.
+     */
+    GetNextResult batchedJoinResult();
+    GetNextResult unwindBatchedJoinResult();
+
+    /**
+     * Returns the number of input documents after which it becomes cheaper to hash the foreign
+     * collection than to keep querying it, judging by its size and whether it has an index on
+     * 'foreignField'. Returns boost::none if the hash join cannot be used or can never pay off.
+     */
+    boost::optional<long long> chooseHashJoinInputThreshold() const;
+
+    /**
+     * Returns the strategy to use when the foreign collection is queried rather than hashed:
+     * kBatchedNestedLoop unless batching is disabled or the join predicate cannot be checked
+     * outside of a query.
+     */
+    JoinStrategy nestedLoopJoinStrategy() const;
+
+    /**
+     * Reads the foreign side into '_hashTable'. Switches to the batched nested loop strategy if the
+     * foreign side does not fit in memory and cannot be spilled to disk.
+     */
+    void buildHashTable();
+
+    /**
+     * Pulls the next input documents and joins them with '_hashTable' or with a single query of the
+     * foreign collection, appending them with their matches to '_joinBatch'. Returns the result of
+     * the source instead if it has no more input documents for now.
+     */
+    boost::optional<GetNextResult> loadJoinBatch();
+
+    /**
+     * Runs the foreign pipeline for 'inputDoc' to completion and returns its results.
+     */
+    std::vector<Value> queryForeignMatches(const Document& inputDoc);
+
+    /**
+     * Runs the foreign pipeline once for the join keys in 'probes' and calls 'onMatch' with the
+     * index of every probe each foreign document matches.
+     */
+    void queryForeignMatchesBatched(const std::vector<std::vector<Value>>& probes,
+                                    const LookupProbeSet::MatchCallback& onMatch);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -349,6 +430,23 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // Chosen by the first call to doOptimizeAt(). A $lookup which is never optimized queries the
+    // foreign collection for each input document. If '_hashJoinInputThreshold' is set, the join
+    // switches to the hash join once '_numInputDocsJoined' reaches it.
+    JoinStrategy _joinStrategy = JoinStrategy::kNestedLoop;
+    bool _joinStrategyChosen = false;
+    boost::optional<long long> _hashJoinInputThreshold;
+    long long _numInputDocsJoined = 0;
+
+    // The following members are used by the batched join strategies. '_joinBatch' holds input
+    // documents which have been joined but not returned yet, with their matches, and
+    // '_joinBatchPendingResult' a pause of the source which ended the batch of these documents.
+    // While unwinding, '_unwindMatches' holds the matches of '_input'.
+    std::unique_ptr<LookupHashTable> _hashTable;
+    std::deque<std::pair<Document, std::vector<Value>>> _joinBatch;
+    boost::optional<GetNextResult> _joinBatchPendingResult;
+    std::vector<Value> _unwindMatches;
 };
 
 }  // namespace mongo
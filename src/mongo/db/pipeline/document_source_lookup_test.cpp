@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/intrusive_ptr.hpp>
+#include <cmath>
 #include <deque>
 #include <vector>
 
@@ -48,6 +49,8 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -496,10 +499,17 @@ public:
         return false;
     }
 
+    boost::optional<JoinStats> getJoinStats(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            const NamespaceString& nss,
+                                            const FieldPath& joinField) const final {
+        return joinStats;
+    }
+
     std::unique_ptr<Pipeline, PipelineDeleter> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++numPipelinesMade;
         auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, expCtx));
 
         if (opts.optimize) {
@@ -530,6 +540,12 @@ public:
         return pipeline;
     }
 
+    // The statistics returned for every collection.
+    boost::optional<JoinStats> joinStats;
+
+    // The number of pipelines made on the foreign collection.
+    size_t numPipelinesMade = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
@@ -1115,5 +1131,331 @@ TEST_F(DocumentSourceLookUpTest, ShouldNotCacheIfCorrelatedStageIsAbsorbedIntoPl
     ASSERT_VALUE_EQ(Value(subPipeline->writeExplainOps(kExplain)), Value(BSONArray(expectedPipe)));
 }
 
+/**
+ * Returns a $lookup on "a" of the collection "test.foreign", which is read through
+ * 'mongoInterface'.
+ */
+boost::intrusive_ptr<DocumentSourceLookUp> makeLookUpOnA(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::shared_ptr<MongoProcessInterface> mongoInterface) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface = std::move(mongoInterface);
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "a"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    return static_cast<DocumentSourceLookUp*>(parsed.get());
+}
+
+/**
+ * Joins 'localDocs' with 'lookup', optionally unwinding the matches, and returns the results.
+ */
+std::vector<Document> runLookUp(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                DocumentSourceLookUp* lookup,
+                                deque<DocumentSource::GetNextResult> localDocs,
+                                bool unwind) {
+    if (unwind) {
+        const bool preserveNullAndEmptyArrays = true;
+        const boost::optional<std::string> includeArrayIndex = std::string("index");
+        lookup->setUnwindStage(DocumentSourceUnwind::create(
+            expCtx, "joined", preserveNullAndEmptyArrays, includeArrayIndex));
+    }
+
+    auto mockLocalSource = DocumentSourceMock::createForTest(std::move(localDocs));
+    lookup->setSource(mockLocalSource.get());
+
+    std::vector<Document> results;
+    for (auto next = lookup->getNext(); !next.isEOF(); next = lookup->getNext()) {
+        if (next.isAdvanced()) {
+            results.push_back(next.releaseDocument());
+        }
+    }
+    lookup->dispose();
+    return results;
+}
+
+/**
+ * Runs a $lookup of 'localDocs' against 'foreignDocs' on "a" with the given join strategy, and
+ * returns its results.
+ */
+std::vector<Document> runLookUpWithJoinStrategy(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    deque<DocumentSource::GetNextResult> localDocs,
+    deque<DocumentSource::GetNextResult> foreignDocs,
+    DocumentSourceLookUp::JoinStrategy joinStrategy,
+    bool unwind) {
+    auto lookup =
+        makeLookUpOnA(expCtx, std::make_shared<MockMongoInterface>(std::move(foreignDocs)));
+    lookup->setJoinStrategy_forTest(joinStrategy);
+    return runLookUp(expCtx, lookup.get(), std::move(localDocs), unwind);
+}
+
+deque<DocumentSource::GetNextResult> makeHashJoinLocalDocs() {
+    return {Document{{"_id", 0}, {"a", 1}},
+            DocumentSource::GetNextResult::makePauseExecution(),
+            Document{{"_id", 1}, {"a", DOC_ARRAY(1 << 2)}},
+            Document{{"_id", 2}},
+            Document{{"_id", 3}, {"a", 5}},
+            DocumentSource::GetNextResult::makePauseExecution(),
+            Document{{"_id", 4}, {"a", 2.0}}};
+}
+
+deque<DocumentSource::GetNextResult> makeHashJoinForeignDocs() {
+    return {Document{{"_id", 0}, {"a", 1}},
+            Document{{"_id", 1}, {"a", DOC_ARRAY(1 << 2 << 3)}},
+            Document{{"_id", 2}, {"a", BSONNULL}},
+            Document{{"_id", 3}},
+            Document{{"_id", 4}, {"a", 2}}};
+}
+
+void assertSameResults(const std::vector<Document>& expected, const std::vector<Document>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(expected[i], actual[i]);
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldProduceSameResultsAsNestedLoopJoin) {
+    auto nestedLoopResults =
+        runLookUpWithJoinStrategy(getExpCtx(),
+                                  makeHashJoinLocalDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                  false);
+    auto hashJoinResults = runLookUpWithJoinStrategy(getExpCtx(),
+                                                     makeHashJoinLocalDocs(),
+                                                     makeHashJoinForeignDocs(),
+                                                     DocumentSourceLookUp::JoinStrategy::kHashJoin,
+                                                     false);
+    ASSERT_EQ(nestedLoopResults.size(), 5UL);
+    assertSameResults(nestedLoopResults, hashJoinResults);
+
+    // The document without a local field is joined with the foreign documents without a value.
+    ASSERT_EQ(hashJoinResults[2]["joined"].getArrayLength(), 2UL);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldProduceSameResultsAsNestedLoopJoinWhileUnwinding) {
+    auto nestedLoopResults =
+        runLookUpWithJoinStrategy(getExpCtx(),
+                                  makeHashJoinLocalDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                  true);
+    auto hashJoinResults = runLookUpWithJoinStrategy(getExpCtx(),
+                                                     makeHashJoinLocalDocs(),
+                                                     makeHashJoinForeignDocs(),
+                                                     DocumentSourceLookUp::JoinStrategy::kHashJoin,
+                                                     true);
+    assertSameResults(nestedLoopResults, hashJoinResults);
+}
+
+TEST_F(DocumentSourceLookUpTest, SpilledHashJoinShouldProduceSameResultsAsNestedLoopJoin) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const long long originalMaxMemory = internalLookupHashJoinMaxMemoryBytes.load();
+    const int originalBatchSize = internalLookupHashJoinSpilledProbeBatchSize.load();
+    internalLookupHashJoinMaxMemoryBytes.store(100);
+    internalLookupHashJoinSpilledProbeBatchSize.store(2);
+    ON_BLOCK_EXIT([&] {
+        internalLookupHashJoinMaxMemoryBytes.store(originalMaxMemory);
+        internalLookupHashJoinSpilledProbeBatchSize.store(originalBatchSize);
+    });
+
+    auto nestedLoopResults =
+        runLookUpWithJoinStrategy(expCtx,
+                                  makeHashJoinLocalDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                  false);
+    auto hashJoinResults = runLookUpWithJoinStrategy(expCtx,
+                                                     makeHashJoinLocalDocs(),
+                                                     makeHashJoinForeignDocs(),
+                                                     DocumentSourceLookUp::JoinStrategy::kHashJoin,
+                                                     false);
+    assertSameResults(nestedLoopResults, hashJoinResults);
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedNestedLoopJoinShouldProduceSameResultsAsNestedLoopJoin) {
+    const int originalBatchSize = internalLookupNestedLoopJoinBatchSize.load();
+    internalLookupNestedLoopJoinBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { internalLookupNestedLoopJoinBatchSize.store(originalBatchSize); });
+
+    for (bool unwind : {false, true}) {
+        auto nestedLoopResults =
+            runLookUpWithJoinStrategy(getExpCtx(),
+                                      makeHashJoinLocalDocs(),
+                                      makeHashJoinForeignDocs(),
+                                      DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                      unwind);
+        auto batchedResults =
+            runLookUpWithJoinStrategy(getExpCtx(),
+                                      makeHashJoinLocalDocs(),
+                                      makeHashJoinForeignDocs(),
+                                      DocumentSourceLookUp::JoinStrategy::kBatchedNestedLoop,
+                                      unwind);
+        assertSameResults(nestedLoopResults, batchedResults);
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedNestedLoopJoinShouldJoinDuplicateKeysAcrossBatch) {
+    auto localDocs = [] {
+        return deque<DocumentSource::GetNextResult>{Document{{"_id", 0}, {"a", 1}},
+                                                    Document{{"_id", 1}, {"a", DOC_ARRAY(1 << 1)}},
+                                                    Document{{"_id", 2}, {"a", 1.0}},
+                                                    Document{{"_id", 3}, {"a", 2}}};
+    };
+
+    auto nestedLoopResults =
+        runLookUpWithJoinStrategy(getExpCtx(),
+                                  localDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                  false);
+    auto batchedResults =
+        runLookUpWithJoinStrategy(getExpCtx(),
+                                  localDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kBatchedNestedLoop,
+                                  false);
+    ASSERT_EQ(batchedResults.size(), 4UL);
+    assertSameResults(nestedLoopResults, batchedResults);
+
+    // A value repeated within a local document still matches each foreign document once.
+    ASSERT_EQ(batchedResults[1]["joined"].getArrayLength(), 2UL);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldFallBackToNestedLoopJoinIfItCannotSpill) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+
+    const long long originalMaxMemory = internalLookupHashJoinMaxMemoryBytes.load();
+    internalLookupHashJoinMaxMemoryBytes.store(100);
+    ON_BLOCK_EXIT([&] { internalLookupHashJoinMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto nestedLoopResults =
+        runLookUpWithJoinStrategy(expCtx,
+                                  makeHashJoinLocalDocs(),
+                                  makeHashJoinForeignDocs(),
+                                  DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                  false);
+    auto hashJoinResults = runLookUpWithJoinStrategy(expCtx,
+                                                     makeHashJoinLocalDocs(),
+                                                     makeHashJoinForeignDocs(),
+                                                     DocumentSourceLookUp::JoinStrategy::kHashJoin,
+                                                     false);
+    assertSameResults(nestedLoopResults, hashJoinResults);
+}
+
+TEST_F(DocumentSourceLookUpTest, JoinShouldSwitchToHashJoinOnceThresholdIsReached) {
+    const int originalBatchSize = internalLookupNestedLoopJoinBatchSize.load();
+    internalLookupNestedLoopJoinBatchSize.store(1);
+    ON_BLOCK_EXIT([&] { internalLookupNestedLoopJoinBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    auto mongoInterface = std::make_shared<MockMongoInterface>(makeHashJoinForeignDocs());
+    auto lookup = makeLookUpOnA(expCtx, mongoInterface);
+    lookup->setHashJoinInputThreshold_forTest(2);
+
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({Document{{"_id", 0}, {"a", 1}},
+                                           Document{{"_id", 1}, {"a", 2}},
+                                           Document{{"_id", 2}, {"a", 3}},
+                                           Document{{"_id", 3}, {"a", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    // The first two input documents are each joined with a query of the foreign collection.
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    ASSERT(DocumentSourceLookUp::JoinStrategy::kBatchedNestedLoop == lookup->getJoinStrategy());
+    ASSERT_EQ(2UL, mongoInterface->numPipelinesMade);
+
+    // The foreign collection is then read once more to hash it, and the hash table joins the rest.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(next.getDocument()["joined"].getArrayLength(), 1UL);
+    ASSERT(DocumentSourceLookUp::JoinStrategy::kHashJoin == lookup->getJoinStrategy());
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(next.getDocument()["joined"].getArrayLength(), 2UL);
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(3UL, mongoInterface->numPipelinesMade);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, JoinSwitchingToHashJoinShouldProduceSameResultsAsNestedLoopJoin) {
+    for (bool unwind : {false, true}) {
+        auto nestedLoopResults =
+            runLookUpWithJoinStrategy(getExpCtx(),
+                                      makeHashJoinLocalDocs(),
+                                      makeHashJoinForeignDocs(),
+                                      DocumentSourceLookUp::JoinStrategy::kNestedLoop,
+                                      unwind);
+
+        auto expCtx = getExpCtx();
+        auto lookup =
+            makeLookUpOnA(expCtx, std::make_shared<MockMongoInterface>(makeHashJoinForeignDocs()));
+        lookup->setHashJoinInputThreshold_forTest(2);
+        auto switchingResults = runLookUp(expCtx, lookup.get(), makeHashJoinLocalDocs(), unwind);
+        ASSERT(DocumentSourceLookUp::JoinStrategy::kHashJoin == lookup->getJoinStrategy());
+        assertSameResults(nestedLoopResults, switchingResults);
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldNotReadForeignCollectionWithoutInput) {
+    auto expCtx = getExpCtx();
+    auto mongoInterface = std::make_shared<MockMongoInterface>(makeHashJoinForeignDocs());
+    auto lookup = makeLookUpOnA(expCtx, mongoInterface);
+    lookup->setJoinStrategy_forTest(DocumentSourceLookUp::JoinStrategy::kHashJoin);
+
+    auto results = runLookUp(expCtx, lookup.get(), {}, false);
+    ASSERT_TRUE(results.empty());
+    ASSERT_EQ(0UL, mongoInterface->numPipelinesMade);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldChooseHashJoinThresholdFromForeignCollectionSize) {
+    auto expCtx = getExpCtx();
+    auto mongoInterface = std::make_shared<MockMongoInterface>(makeHashJoinForeignDocs());
+    mongoInterface->joinStats.emplace();
+    mongoInterface->joinStats->numRecords = 1000;
+    mongoInterface->joinStats->dataSizeBytes = 1000;
+    auto lookup = makeLookUpOnA(expCtx, mongoInterface);
+
+    Pipeline::SourceContainer container{lookup};
+    lookup->optimizeAt(container.begin(), &container);
+
+    // Each batch of 128 input documents runs a query which examines the 1000 foreign documents,
+    // while hashing them costs about twice as much as examining them.
+    ASSERT(DocumentSourceLookUp::JoinStrategy::kBatchedNestedLoop == lookup->getJoinStrategy());
+    vector<Value> explain;
+    lookup->serializeToArray(explain, kExplain);
+    ASSERT_EQ(explain.size(), 1UL);
+    const double probeCost = (10.0 + 1000) / 128;
+    ASSERT_VALUE_EQ(explain[0]["$lookup"]["hashJoinAfterInputDocuments"],
+                    Value(static_cast<long long>(std::ceil(2000 / probeCost))));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotSwitchToHashJoinWithoutForeignCollectionStatistics) {
+    auto expCtx = getExpCtx();
+    auto lookup =
+        makeLookUpOnA(expCtx, std::make_shared<MockMongoInterface>(makeHashJoinForeignDocs()));
+
+    Pipeline::SourceContainer container{lookup};
+    lookup->optimizeAt(container.begin(), &container);
+
+    vector<Value> explain;
+    lookup->serializeToArray(explain, kExplain);
+    ASSERT_EQ(explain.size(), 1UL);
+    ASSERT_TRUE(explain[0]["$lookup"]["hashJoinAfterInputDocuments"].missing());
+}
+
 }  // namespace
 }  // namespace mongo
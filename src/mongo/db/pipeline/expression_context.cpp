@@ -54,6 +54,7 @@ ExpressionContext::ExpressionContext(OperationContext* opCtx,
     fromMongos = request.isFromMongos();
     needsMerge = request.needsMerge();
     allowDiskUse = request.shouldAllowDiskUse();
+    parallelism = request.getParallelism();
     bypassDocumentValidation = request.shouldBypassDocumentValidation();
     ns = request.getNamespaceString();
     mongoProcessInterface = std::move(processInterface);
@@ -210,6 +210,10 @@ public:
     bool bypassDocumentValidation = false;
     bool inMultiDocumentTransaction = false;
 
+    // The number of workers requested by the user for this aggregation, or boost::none if the
+    // defaults set by the server parameters apply. Not inherited by sub-pipelines.
+    boost::optional<long long> parallelism;
+
     NamespaceString ns;
 
     // If known, the UUID of the execution namespace for this aggregation command.
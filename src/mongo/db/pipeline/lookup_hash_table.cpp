@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/pipeline/document_path_support.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/shared_buffer.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Size of the buffer through which the spilled build side is written and read back.
+constexpr size_t kSpillFileBufferBytes = 1024 * 1024;
+
+// Approximate overhead of an entry of the hash table, on top of the size of its key.
+constexpr size_t kTableEntryOverheadBytes = sizeof(Value) + sizeof(std::vector<size_t>);
+
+}  // namespace
+
+LookupProbeSet::LookupProbeSet(const ValueComparator& comparator,
+                               const std::vector<std::vector<Value>>& probes)
+    : _probesByValue(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {
+    for (size_t i = 0; i < probes.size(); ++i) {
+        for (auto&& value : probes[i]) {
+            auto& probeIndexes = _probesByValue[value];
+            if (probeIndexes.empty()) {
+                _distinctValues.push_back(value);
+            }
+            if (probeIndexes.empty() || probeIndexes.back() != i) {
+                probeIndexes.push_back(i);
+            }
+        }
+    }
+}
+
+void LookupProbeSet::match(const Document& doc,
+                           const FieldPath& joinField,
+                           const MatchCallback& onMatch) const {
+    std::vector<size_t> matchingProbes;
+    document_path_support::visitAllValuesAtPath(doc, joinField, [&](const Value& value) {
+        auto it = _probesByValue.find(value);
+        if (it != _probesByValue.end()) {
+            matchingProbes.insert(matchingProbes.end(), it->second.begin(), it->second.end());
+        }
+    });
+
+    std::sort(matchingProbes.begin(), matchingProbes.end());
+    matchingProbes.erase(std::unique(matchingProbes.begin(), matchingProbes.end()),
+                         matchingProbes.end());
+    for (auto&& probeIndex : matchingProbes) {
+        onMatch(probeIndex, doc);
+    }
+}
+
+LookupHashTable::LookupHashTable(const ValueComparator& comparator,
+                                 FieldPath joinField,
+                                 size_t maxMemoryUsageBytes,
+                                 std::string spillFileName)
+    : _comparator(comparator),
+      _joinField(std::move(joinField)),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _spillFileName(std::move(spillFileName)),
+      _table(_comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+LookupHashTable::~LookupHashTable() {
+    if (_spilled) {
+        _spillFile.close();
+        DESTRUCTOR_GUARD(boost::filesystem::remove(_spillFileName));
+    }
+}
+
+bool LookupHashTable::canProbeWith(const Value& value) {
+    switch (value.getType()) {
+        case BSONType::EOO:
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::Array:
+        case BSONType::RegEx:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void LookupHashTable::visitJoinValues(const Document& doc,
+                                      const std::function<void(const Value&)>& callback) const {
+    // A value may appear several times at the join field of a document, for instance in an array,
+    // but the document must only be matched once.
+    std::vector<Value> values;
+    document_path_support::visitAllValuesAtPath(
+        doc, _joinField, [&](const Value& value) { values.push_back(value); });
+    for (size_t i = 0; i < values.size(); ++i) {
+        const bool isDuplicate =
+            std::any_of(values.begin(), values.begin() + i, [&](const Value& previous) {
+                return _comparator.evaluate(previous == values[i]);
+            });
+        if (!isDuplicate) {
+            callback(values[i]);
+        }
+    }
+}
+
+bool LookupHashTable::addBuildDocument(Document doc) {
+    invariant(!_doneBuilding);
+
+    if (_spilled) {
+        writeToSpillFile(doc);
+        return true;
+    }
+
+    const size_t position = _documents.size();
+    _memoryUsageBytes += doc.getApproximateSize();
+    visitJoinValues(doc, [&](const Value& value) {
+        auto& positions = _table[value];
+        if (positions.empty()) {
+            _memoryUsageBytes += value.getApproximateSize() + kTableEntryOverheadBytes;
+        }
+        positions.push_back(position);
+        _memoryUsageBytes += sizeof(size_t);
+    });
+    _documents.push_back(std::move(doc));
+
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        if (_spillFileName.empty()) {
+            return false;
+        }
+        spill();
+    }
+    return true;
+}
+
+void LookupHashTable::doneBuilding() {
+    invariant(!_doneBuilding);
+    _doneBuilding = true;
+
+    if (_spilled) {
+        _spillFile.close();
+        uassert(51249,
+                str::stream() << "error writing file \"" << _spillFileName
+                              << "\": " << errnoWithDescription(),
+                !_spillFile.fail());
+        _spillFileBuffer.reset();
+    }
+}
+
+void LookupHashTable::spill() {
+    invariant(!_spilled);
+
+    _spillFileBuffer.reset(new char[kSpillFileBufferBytes]);
+    _spillFile.rdbuf()->pubsetbuf(_spillFileBuffer.get(), kSpillFileBufferBytes);
+    _spillFile.open(_spillFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    uassert(51250,
+            str::stream() << "error opening file \"" << _spillFileName
+                          << "\": " << errnoWithDescription(),
+            _spillFile.good());
+    _spilled = true;
+
+    for (auto&& doc : _documents) {
+        writeToSpillFile(doc);
+    }
+
+    // Free the memory used by the build side.
+    _documents = std::vector<Document>();
+    _table = _comparator.makeUnorderedValueMap<std::vector<size_t>>();
+    _memoryUsageBytes = 0;
+}
+
+void LookupHashTable::writeToSpillFile(const Document& doc) {
+    const BSONObj obj = doc.toBson();
+    _spillFile.write(obj.objdata(), obj.objsize());
+    uassert(51251,
+            str::stream() << "error writing file \"" << _spillFileName
+                          << "\": " << errnoWithDescription(),
+            _spillFile.good());
+}
+
+void LookupHashTable::probe(const std::vector<Value>& values, const MatchCallback& onMatch) const {
+    invariant(_doneBuilding && !_spilled);
+
+    // Collect the positions of the matching documents first, so that each of them is reported once
+    // and in the order in which it was added.
+    std::vector<size_t> positions;
+    for (auto&& value : values) {
+        auto it = _table.find(value);
+        if (it != _table.end()) {
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    if (values.size() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    for (auto&& position : positions) {
+        onMatch(0, _documents[position]);
+    }
+}
+
+void LookupHashTable::probeBatch(const std::vector<std::vector<Value>>& probes,
+                                 const MatchCallback& onMatch) {
+    invariant(_doneBuilding);
+
+    if (!_spilled) {
+        for (size_t i = 0; i < probes.size(); ++i) {
+            probe(probes[i], [&](size_t, const Document& match) { onMatch(i, match); });
+        }
+        return;
+    }
+
+    // Index the probes by their values, so that the build side can be streamed through them.
+    const LookupProbeSet probeSet(_comparator, probes);
+
+    std::unique_ptr<char[]> readBuffer(new char[kSpillFileBufferBytes]);
+    std::ifstream file;
+    file.rdbuf()->pubsetbuf(readBuffer.get(), kSpillFileBufferBytes);
+    file.open(_spillFileName.c_str(), std::ios::in | std::ios::binary);
+    uassert(51252,
+            str::stream() << "error opening file \"" << _spillFileName
+                          << "\": " << errnoWithDescription(),
+            file.good());
+
+    int32_t size;
+    while (file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        uassert(51253,
+                str::stream() << "corrupt document in file \"" << _spillFileName << "\"",
+                size >= BSONObj::kMinBSONLength && size <= BSONObjMaxInternalSize);
+        auto buffer = SharedBuffer::allocate(size);
+        std::memcpy(buffer.get(), &size, sizeof(size));
+        file.read(buffer.get() + sizeof(size), size - sizeof(size));
+        uassert(51254,
+                str::stream() << "error reading file \"" << _spillFileName
+                              << "\": " << errnoWithDescription(),
+                file.good());
+        probeSet.match(Document(BSONObj(std::move(buffer))), _joinField, onMatch);
+    }
+    uassert(51255,
+            str::stream() << "error reading file \"" << _spillFileName
+                          << "\": " << errnoWithDescription(),
+            file.eof());
+}
+
+}  // namespace mongo
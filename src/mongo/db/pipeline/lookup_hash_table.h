@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * The local values of a batch of $lookup input documents, indexed so that documents of the foreign
+ * side can be streamed through them and matched with every input document at once.
+ */
+class LookupProbeSet {
+public:
+    using MatchCallback = std::function<void(size_t probeIndex, const Document& match)>;
+
+    LookupProbeSet(const ValueComparator& comparator,
+                   const std::vector<std::vector<Value>>& probes);
+
+    /**
+     * Returns each value of the probes once, in the order in which they first appear.
+     */
+    const std::vector<Value>& getDistinctValues() const {
+        return _distinctValues;
+    }
+
+    /**
+     * Calls 'onMatch' once for each probe with a value equal to any of the values at 'joinField'
+     * of the foreign document 'doc', in the order of the probes.
+     */
+    void match(const Document& doc, const FieldPath& joinField, const MatchCallback& onMatch) const;
+
+private:
+    ValueUnorderedMap<std::vector<size_t>> _probesByValue;
+    std::vector<Value> _distinctValues;
+};
+
+/**
+ * The build side of a hash join for $lookup with localField/foreignField syntax. Documents of the
+ * foreign side are added once, indexed by each of the values at the join field, and are then
+ * probed with the values at the local field of each local document.
+ *
+ * Matching follows the semantics of the equality query which $lookup would otherwise run against
+ * the foreign collection for a local value accepted by canProbeWith(): a foreign document matches
+ * if any of the values at its join field, with arrays expanded, is equal to a probed value.
+ *
+ * If the build side does not fit in 'maxMemoryUsageBytes', its documents are written to
+ * 'spillFileName' and each batch of probes reads them back sequentially; if no spill file is given,
+ * the build fails instead and the caller must fall back to querying the foreign side directly.
+ */
+class LookupHashTable {
+    LookupHashTable(const LookupHashTable&) = delete;
+    LookupHashTable& operator=(const LookupHashTable&) = delete;
+
+public:
+    using MatchCallback = LookupProbeSet::MatchCallback;
+
+    LookupHashTable(const ValueComparator& comparator,
+                    FieldPath joinField,
+                    size_t maxMemoryUsageBytes,
+                    std::string spillFileName);
+
+    ~LookupHashTable();
+
+    /**
+     * Returns true if the hash table can answer a probe with the local value 'value'. Local values
+     * which are missing or null also match foreign documents without the join field, and arrays
+     * and regular expressions have their own query semantics, so documents with such values must be
+     * joined by querying the foreign side instead.
+     */
+    static bool canProbeWith(const Value& value);
+
+    /**
+     * Adds a document of the foreign side. Returns false if the build side has exceeded its memory
+     * limit and cannot be spilled, in which case the hash table must not be used.
+     */
+    bool addBuildDocument(Document doc);
+
+    /**
+     * Must be called after the last call to addBuildDocument() and before probing.
+     */
+    void doneBuilding();
+
+    /**
+     * Returns true if the build side has been written to disk, in which case probes must be made in
+     * batches through probeBatch().
+     */
+    bool isSpilled() const {
+        return _spilled;
+    }
+
+    /**
+     * Calls 'onMatch' with index 0 for each document of the build side which matches any of
+     * 'values', in the order in which they were added. Each document is reported at most once. May
+     * only be called if the build side was not spilled.
+     */
+    void probe(const std::vector<Value>& values, const MatchCallback& onMatch) const;
+
+    /**
+     * Calls 'onMatch' for each pair of an entry of 'probes' and a document of the build side which
+     * matches any of the values of that entry. Matches are reported in the order in which the build
+     * documents were added, and each document is reported at most once per probe. If the build
+     * side was spilled, it is read from disk once for the whole batch, through a LookupProbeSet.
+     */
+    void probeBatch(const std::vector<std::vector<Value>>& probes, const MatchCallback& onMatch);
+
+    size_t getMemoryUsageBytes() const {
+        return _memoryUsageBytes;
+    }
+
+private:
+    /**
+     * Calls 'callback' with each distinct value at the join field of 'doc'.
+     */
+    void visitJoinValues(const Document& doc,
+                         const std::function<void(const Value&)>& callback) const;
+
+    /**
+     * Writes the documents held in memory to the spill file and frees the hash table.
+     */
+    void spill();
+
+    void writeToSpillFile(const Document& doc);
+
+    const ValueComparator _comparator;
+    const FieldPath _joinField;
+    const size_t _maxMemoryUsageBytes;
+    const std::string _spillFileName;
+
+    // The documents of the build side, in the order in which they were added, and an index from
+    // each value at their join field to the positions of the documents with that value.
+    std::vector<Document> _documents;
+    ValueUnorderedMap<std::vector<size_t>> _table;
+    size_t _memoryUsageBytes = 0;
+
+    bool _spilled = false;
+    bool _doneBuilding = false;
+    std::unique_ptr<char[]> _spillFileBuffer;
+    std::ofstream _spillFile;
+};
+
+}  // namespace mongo
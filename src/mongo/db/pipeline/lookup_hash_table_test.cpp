@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator defaultComparator{nullptr};
+
+std::vector<Document> probe(const LookupHashTable& table, std::vector<Value> values) {
+    std::vector<Document> matches;
+    table.probe(values, [&](size_t, const Document& match) { matches.push_back(match); });
+    return matches;
+}
+
+TEST(LookupHashTableTest, ProbeReturnsMatchesInBuildOrder) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), 1024 * 1024, "");
+    ASSERT_TRUE(table.addBuildDocument(Document{{"_id", 0}, {"a", 1}}));
+    ASSERT_TRUE(table.addBuildDocument(Document{{"_id", 1}, {"a", 2}}));
+    ASSERT_TRUE(table.addBuildDocument(Document{{"_id", 2}, {"a", 1.0}}));
+    ASSERT_TRUE(table.addBuildDocument(Document{{"_id", 3}}));
+    table.doneBuilding();
+
+    auto matches = probe(table, {Value(1)});
+    ASSERT_EQ(matches.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(matches[0], (Document{{"_id", 0}, {"a", 1}}));
+    ASSERT_DOCUMENT_EQ(matches[1], (Document{{"_id", 2}, {"a", 1.0}}));
+
+    ASSERT_EQ(probe(table, {Value(3)}).size(), 0UL);
+}
+
+TEST(LookupHashTableTest, ArraysAtJoinFieldAreExpanded) {
+    LookupHashTable table(defaultComparator, FieldPath("a.b"), 1024 * 1024, "");
+    ASSERT_TRUE(table.addBuildDocument(
+        Document{{"_id", 0}, {"a", DOC_ARRAY(DOC("b" << 1) << DOC("b" << 2))}}));
+    ASSERT_TRUE(
+        table.addBuildDocument(Document{{"_id", 1}, {"a", DOC("b" << DOC_ARRAY(2 << 2 << 3))}}));
+    table.doneBuilding();
+
+    ASSERT_EQ(probe(table, {Value(1)}).size(), 1UL);
+    ASSERT_EQ(probe(table, {Value(3)}).size(), 1UL);
+
+    // Each document is returned once, even if it matches several times.
+    auto matches = probe(table, {Value(2), Value(1)});
+    ASSERT_EQ(matches.size(), 2UL);
+    ASSERT_VALUE_EQ(matches[0]["_id"], Value(0));
+    ASSERT_VALUE_EQ(matches[1]["_id"], Value(1));
+}
+
+TEST(LookupHashTableTest, ProbesRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    LookupHashTable table(ValueComparator(&collator), FieldPath("a"), 1024 * 1024, "");
+    ASSERT_TRUE(table.addBuildDocument(Document{{"a", "foo"_sd}}));
+    table.doneBuilding();
+
+    ASSERT_EQ(probe(table, {Value("bar"_sd)}).size(), 1UL);
+}
+
+TEST(LookupHashTableTest, CannotProbeWithValuesWithSpecialQuerySemantics) {
+    ASSERT_FALSE(LookupHashTable::canProbeWith(Value()));
+    ASSERT_FALSE(LookupHashTable::canProbeWith(Value(BSONNULL)));
+    ASSERT_FALSE(LookupHashTable::canProbeWith(Value(BSONUndefined)));
+    ASSERT_FALSE(LookupHashTable::canProbeWith(Value(BSONArray())));
+    ASSERT_FALSE(LookupHashTable::canProbeWith(Value(BSONRegEx("^a"))));
+    ASSERT_TRUE(LookupHashTable::canProbeWith(Value(1)));
+    ASSERT_TRUE(LookupHashTable::canProbeWith(Value(Document{{"b", 1}})));
+}
+
+TEST(LookupHashTableTest, BuildFailsWhenOverMemoryLimitWithoutSpillFile) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), 100, "");
+    const std::string largeStr(200, 'x');
+    ASSERT_FALSE(table.addBuildDocument(Document{{"a", 1}, {"str", largeStr}}));
+}
+
+TEST(LookupHashTableTest, SpilledBuildSideIsProbedInBatches) {
+    unittest::TempDir tempDir("LookupHashTableTest");
+    LookupHashTable table(defaultComparator, FieldPath("a"), 1000, tempDir.path() + "/spill");
+
+    const std::string str(100, 'x');
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(table.addBuildDocument(Document{{"a", i % 10}, {"i", i}, {"str", str}}));
+    }
+    table.doneBuilding();
+    ASSERT_TRUE(table.isSpilled());
+
+    std::vector<std::vector<Value>> probes{{Value(3)}, {Value(4), Value(3)}, {Value(42)}};
+    std::vector<std::vector<int>> matches(probes.size());
+    table.probeBatch(probes, [&](size_t probeIndex, const Document& match) {
+        matches[probeIndex].push_back(match["i"].getInt());
+    });
+
+    ASSERT_EQ(matches[0].size(), 10UL);
+    ASSERT_EQ(matches[1].size(), 20UL);
+    ASSERT_EQ(matches[2].size(), 0UL);
+    for (int j = 0; j < 10; ++j) {
+        ASSERT_EQ(matches[0][j], 10 * j + 3);
+        ASSERT_EQ(matches[1][2 * j], 10 * j + 3);
+        ASSERT_EQ(matches[1][2 * j + 1], 10 * j + 4);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
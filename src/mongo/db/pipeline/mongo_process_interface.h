@@ -370,6 +370,27 @@ public:
         const NamespaceString& nss,
         const std::set<FieldPath>& fieldPaths) const = 0;
 
+    /**
+     * Statistics about a collection which $lookup uses to choose how to join with it.
+     */
+    struct JoinStats {
+        long long numRecords = 0;
+        long long dataSizeBytes = 0;
+
+        // True if there is an index on the join field which can answer equality predicates under
+        // the operation's collation.
+        bool hasIndexOnJoinField = false;
+    };
+
+    /**
+     * Returns statistics about the collection 'nss' for a join on 'joinField', or boost::none if
+     * they are not available on this node, for instance because 'nss' does not exist.
+     */
+    virtual boost::optional<JoinStats> getJoinStats(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        const FieldPath& joinField) const = 0;
+
     /**
      * Refreshes the CatalogCache entry for the namespace 'nss', and returns the epoch associated
      * with that namespace, if any. Note that this refresh will not necessarily force a new
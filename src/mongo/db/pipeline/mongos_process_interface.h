@@ -223,6 +223,15 @@ public:
                                          const NamespaceString&,
                                          const std::set<FieldPath>& fieldPaths) const;
 
+    /**
+     * The collections of a $lookup run on mongos are not local, so no statistics are available.
+     */
+    boost::optional<JoinStats> getJoinStats(const boost::intrusive_ptr<ExpressionContext>&,
+                                            const NamespaceString&,
+                                            const FieldPath&) const final {
+        return boost::none;
+    }
+
     void checkRoutingInfoEpochOrThrow(const boost::intrusive_ptr<ExpressionContext>&,
                                       const NamespaceString&,
                                       ChunkVersion) const final {
@@ -33,6 +33,7 @@
 
 #include "mongo/db/pipeline/pipeline_d.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -44,8 +45,10 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/column_scan.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/multi_iterator.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/trial_stage.h"
@@ -69,7 +72,9 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/pipeline_shape_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -163,17 +168,14 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         opCtx, std::move(ws), std::move(root), coll, PlanExecutor::YIELD_AUTO);
 }
 
-StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExecutor(
+StatusWith<std::unique_ptr<CanonicalQuery>> canonicalizeCursorQuery(
     OperationContext* opCtx,
-    Collection* collection,
     const NamespaceString& nss,
     const intrusive_ptr<ExpressionContext>& pExpCtx,
     BSONObj queryObj,
     BSONObj projectionObj,
     BSONObj sortObj,
-    boost::optional<std::string> groupIdForDistinctScan,
     const AggregationRequest* aggRequest,
-    const size_t plannerOpts,
     const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
     auto qr = std::make_unique<QueryRequest>(nss);
     qr->setTailableMode(pExpCtx->tailableMode);
@@ -183,6 +185,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     if (aggRequest) {
         qr->setExplain(static_cast<bool>(aggRequest->getExplain()));
         qr->setHint(aggRequest->getHint());
+        qr->setParallelism(aggRequest->getParallelism());
     }
 
     // If the pipeline has a non-null collator, set the collation option to the result of
@@ -197,8 +200,24 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
 
     const ExtensionsCallbackReal extensionsCallback(pExpCtx->opCtx, &nss);
 
-    auto cq = CanonicalQuery::canonicalize(
+    return CanonicalQuery::canonicalize(
         opCtx, std::move(qr), pExpCtx, extensionsCallback, matcherFeatures);
+}
+
+StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExecutor(
+    OperationContext* opCtx,
+    Collection* collection,
+    const NamespaceString& nss,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    BSONObj queryObj,
+    BSONObj projectionObj,
+    BSONObj sortObj,
+    boost::optional<std::string> groupIdForDistinctScan,
+    const AggregationRequest* aggRequest,
+    const size_t plannerOpts,
+    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
+    auto cq = canonicalizeCursorQuery(
+        opCtx, nss, pExpCtx, queryObj, projectionObj, sortObj, aggRequest, matcherFeatures);
 
     if (!cq.isOK()) {
         // Return an error instead of uasserting, since there are cases where the combination of
@@ -243,6 +262,142 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     return getExecutorFind(opCtx, collection, std::move(cq.getValue()), permitYield, plannerOpts);
 }
 
+/**
+ * Returns the key of the PipelineShapeCache entry for the pipelines whose $cursor stage is prepared
+ * from the same shape of 'queryObj', 'projectionObj' and 'sortObj' with the same options, or
+ * boost::none if the query cannot be canonicalized.
+ */
+boost::optional<std::string> computePipelineShapeKey(
+    OperationContext* opCtx,
+    Collection* collection,
+    const NamespaceString& nss,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    const BSONObj& queryObj,
+    const BSONObj& projectionObj,
+    const BSONObj& sortObj,
+    const boost::optional<std::string>& groupIdForDistinctScan,
+    const AggregationRequest* aggRequest,
+    const size_t plannerOpts,
+    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
+    auto cq = canonicalizeCursorQuery(
+        opCtx, nss, pExpCtx, queryObj, projectionObj, sortObj, aggRequest, matcherFeatures);
+    if (!cq.isOK()) {
+        return boost::none;
+    }
+
+    // The plan cache key also discriminates between queries of the same shape which could use
+    // different indexes, such as partial indexes.
+    StringBuilder key;
+    key << collection->infoCache()->getPlanCache()->computeKey(*cq.getValue()).stringData();
+    key << "|o" << static_cast<unsigned long long>(plannerOpts);
+    key << "|m" << (pExpCtx->needsMerge ? 1 : 0);
+    if (aggRequest && !aggRequest->getHint().isEmpty()) {
+        key << "|h" << aggRequest->getHint().toString();
+    }
+    if (groupIdForDistinctScan) {
+        key << "|g" << *groupIdForDistinctScan;
+    }
+    return key.str();
+}
+
+/**
+ * Returns a PlanExecutor which answers 'queryObj' with a COLUMN_SCAN over a columnstore index, so
+ * that only the columns needed by the query and by the rest of the pipeline are read. Returns {} if
+ * the pipeline needs whole documents or metadata, if no ready columnstore index covers every
+ * top-level field it depends on, or if the query planner would answer 'queryObj' with anything but
+ * a plain collection scan.
+ *
+ * The caller must not need the query system to provide a sort.
+ */
+StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createColumnScanExecutor(
+    OperationContext* opCtx,
+    Collection* collection,
+    const NamespaceString& nss,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    const BSONObj& queryObj,
+    const DepsTracker& deps,
+    const AggregationRequest* aggRequest,
+    size_t plannerOpts,
+    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
+    if (!collection || deps.needWholeDocument || deps.getNeedsAnyMetadata() ||
+        pExpCtx->tailableMode != TailableModeEnum::kNormal ||
+        (aggRequest && !aggRequest->getHint().isEmpty())) {
+        return {nullptr};
+    }
+
+    std::vector<const IndexDescriptor*> columnIndexes;
+    collection->getIndexCatalog()->findIndexByType(opCtx, IndexNames::COLUMN, columnIndexes);
+    if (columnIndexes.empty()) {
+        return {nullptr};
+    }
+
+    auto cq = canonicalizeCursorQuery(
+        opCtx, nss, pExpCtx, queryObj, BSONObj(), BSONObj(), aggRequest, matcherFeatures);
+    if (!cq.isOK()) {
+        return cq.getStatus();
+    }
+
+    DepsTracker queryDeps;
+    cq.getValue()->root()->addDependencies(&queryDeps);
+    if (queryDeps.needWholeDocument) {
+        return {nullptr};
+    }
+
+    // Only replace a collection scan, which is what the query system would fall back to for this
+    // query. The column scan cannot filter out orphans, so it is never used with a shard filter.
+    QueryPlannerParams plannerParams;
+    plannerParams.options = plannerOpts;
+    if (OperationShardingState::isOperationVersioned(opCtx)) {
+        plannerParams.options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    }
+    fillOutPlannerParams(opCtx, collection, cq.getValue().get(), &plannerParams);
+    if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        return {nullptr};
+    }
+    auto swSolutions = QueryPlanner::plan(*cq.getValue(), plannerParams);
+    if (!swSolutions.isOK() || swSolutions.getValue().size() != 1 ||
+        swSolutions.getValue()[0]->root->getType() != STAGE_COLLSCAN) {
+        return {nullptr};
+    }
+
+    // Each column holds the entire value of a top-level field, so a dotted path is answered by the
+    // column of its first component.
+    std::set<std::string> fields;
+    for (auto&& path : deps.fields) {
+        fields.insert(str::before(path, '.').toString());
+    }
+    for (auto&& path : queryDeps.fields) {
+        fields.insert(str::before(path, '.').toString());
+    }
+
+    for (auto&& desc : columnIndexes) {
+        const BSONObj& keyPattern = desc->keyPattern();
+        if (!std::all_of(fields.begin(), fields.end(), [&](const std::string& field) {
+                return keyPattern.hasField(field);
+            })) {
+            continue;
+        }
+
+        auto ws = std::make_unique<WorkingSet>();
+        const MatchExpression* filter = queryObj.isEmpty() ? nullptr : cq.getValue()->root();
+        auto root = std::make_unique<ColumnScan>(
+            opCtx, desc, std::vector<std::string>(fields.begin(), fields.end()), ws.get(), filter);
+        return PlanExecutor::make(opCtx,
+                                  std::move(ws),
+                                  std::move(root),
+                                  std::move(cq.getValue()),
+                                  collection,
+                                  PlanExecutor::YIELD_AUTO);
+    }
+
+    return {nullptr};
+}
+
+StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> skippedAttempt() {
+    return {ErrorCodes::OperationFailed,
+            "Skipped getting an executor which failed for the same pipeline shape before"};
+}
+
 BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     if (!projectionObj[Document::metaFieldSortKey]) {
         return projectionObj;
@@ -428,6 +583,22 @@ getSortAndGroupStagesFromPipeline(const Pipeline::SourceContainer& sources) {
     return std::make_pair(sortStage, groupStage);
 }
 
+/**
+ * Returns the number of workers of the parallel collection scan in the plan rooted at 'root', or 1
+ * if the plan does not scan a collection in parallel.
+ */
+size_t getCollectionScanParallelism(PlanStage* root) {
+    if (root->stageType() == STAGE_PARALLEL_COLLSCAN) {
+        return static_cast<ParallelCollectionScan*>(root)->getNumWorkers();
+    }
+
+    size_t parallelism = 1;
+    for (auto&& child : root->getChildren()) {
+        parallelism = std::max(parallelism, getCollectionScanParallelism(child.get()));
+    }
+    return parallelism;
+}
+
 }  // namespace
 
 std::pair<PipelineD::AttachExecutorCallback, std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>>
@@ -511,10 +682,16 @@ PipelineD::buildInnerQueryExecutorGeneric(Collection* collection,
                                       Collection* collection,
                                       std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec,
                                       Pipeline* pipeline) {
+        const size_t scanParallelism = getCollectionScanParallelism(exec->getRootStage());
         auto cursor = DocumentSourceCursor::create(
             collection, std::move(exec), pipeline->getContext(), trackOplogTS);
-        addCursorSource(
-            pipeline, std::move(cursor), std::move(deps), queryObj, sortObj, projForQuery);
+        addCursorSource(pipeline,
+                        std::move(cursor),
+                        std::move(deps),
+                        queryObj,
+                        sortObj,
+                        projForQuery,
+                        scanParallelism);
     };
     return std::make_pair(std::move(attachExecutorCallback), std::move(exec));
 }
@@ -632,7 +809,46 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     }
 
-    if (rewrittenGroupStage) {
+    // Skip the attempts below which failed the last time a pipeline of the same shape ran against
+    // this collection. If an attempt which succeeded then fails now, the rest are made as usual.
+    PipelineShapeCache* shapeCache = nullptr;
+    boost::optional<std::string> shapeKey;
+    boost::optional<PipelineShapeCache::Entry> cachedShape;
+    if (collection && internalQueryEnablePipelineShapeCache.load()) {
+        shapeCache = collection->infoCache()->getPipelineShapeCache();
+        shapeKey = computePipelineShapeKey(
+            opCtx,
+            collection,
+            nss,
+            expCtx,
+            queryObj,
+            *projectionObj,
+            *sortObj,
+            rewrittenGroupStage ? boost::make_optional(rewrittenGroupStage->groupId())
+                                : boost::none,
+            aggRequest,
+            plannerOpts,
+            matcherFeatures);
+        if (shapeKey) {
+            cachedShape = shapeCache->get(*shapeKey);
+        }
+    }
+    auto recordShape = [&](bool groupByDistinctScan, bool sort, bool projection) {
+        if (!shapeKey) {
+            return;
+        }
+        if (cachedShape && cachedShape->groupByDistinctScan == groupByDistinctScan &&
+            cachedShape->sort == sort && cachedShape->projection == projection) {
+            return;
+        }
+        PipelineShapeCache::Entry entry;
+        entry.groupByDistinctScan = groupByDistinctScan;
+        entry.sort = sort;
+        entry.projection = projection;
+        shapeCache->set(*shapeKey, entry);
+    };
+
+    if (rewrittenGroupStage && (!cachedShape || cachedShape->groupByDistinctScan)) {
         BSONObj emptySort;
 
         // See if the query system can handle the $group and $sort stage using a DISTINCT_SCAN
@@ -671,6 +887,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                     false /* independentOfAnyCollection */));
             pipeline->addInitialSource(groupTransform);
 
+            recordShape(true, false, false);
             return swExecutorGrouped;
         } else if (swExecutorGrouped == ErrorCodes::QueryPlanKilled) {
             return {ErrorCodes::OperationFailed,
@@ -678,6 +895,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                                      "DISTINCT_SCAN grouping: "
                                   << swExecutorGrouped.getStatus().toString()};
         }
+        cachedShape.reset();
     }
 
     const BSONObj emptyProjection;
@@ -692,7 +910,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
     }
 
-    if (sortStage) {
+    if (sortStage && (!cachedShape || cachedShape->sort)) {
         // See if the query system can provide a non-blocking sort.
         auto swExecutorSort =
             attemptToGetExecutor(opCtx,
@@ -709,18 +927,19 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
 
         if (swExecutorSort.isOK()) {
             // Success! Now see if the query system can also cover the projection.
-            auto swExecutorSortAndProj =
-                attemptToGetExecutor(opCtx,
-                                     collection,
-                                     nss,
-                                     expCtx,
-                                     queryObj,
-                                     *projectionObj,
-                                     *sortObj,
-                                     boost::none, /* groupIdForDistinctScan */
-                                     aggRequest,
-                                     plannerOpts,
-                                     matcherFeatures);
+            auto swExecutorSortAndProj = (cachedShape && !cachedShape->projection)
+                ? skippedAttempt()
+                : attemptToGetExecutor(opCtx,
+                                       collection,
+                                       nss,
+                                       expCtx,
+                                       queryObj,
+                                       *projectionObj,
+                                       *sortObj,
+                                       boost::none, /* groupIdForDistinctScan */
+                                       aggRequest,
+                                       plannerOpts,
+                                       matcherFeatures);
 
             std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
             if (swExecutorSortAndProj.isOK()) {
@@ -745,6 +964,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                 pipeline->_sources.push_front(
                     DocumentSourceLimit::create(expCtx, sortStage->getLimit()));
             }
+            recordShape(false, true, !projectionObj->isEmpty());
             return std::move(exec);
         } else if (swExecutorSort == ErrorCodes::QueryPlanKilled) {
             return {
@@ -753,6 +973,10 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                     << "Failed to determine whether query system can provide a non-blocking sort: "
                     << swExecutorSort.getStatus().toString()};
         }
+        cachedShape.reset();
+    }
+
+    if (sortStage) {
         // The query system can't provide a non-blocking sort.
         *sortObj = BSONObj();
     }
@@ -771,20 +995,39 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
     }
 
+    // A columnstore index can stand in for a collection scan by reading only the fields the
+    // pipeline depends on. This is tried before the projection, which would otherwise be pushed
+    // down to a collection scan and make the column scan unreachable.
+    auto swColumnExecutor = createColumnScanExecutor(
+        opCtx, collection, nss, expCtx, queryObj, deps, aggRequest, plannerOpts, matcherFeatures);
+    if (!swColumnExecutor.isOK()) {
+        return swColumnExecutor.getStatus();
+    }
+    if (swColumnExecutor.getValue()) {
+        // The column scan produces only the fields the pipeline depends on, so it needs no
+        // projection of its own.
+        *projectionObj = BSONObj();
+        recordShape(false, false, false);
+        return std::move(swColumnExecutor.getValue());
+    }
+
     // See if the query system can cover the projection.
-    auto swExecutorProj = attemptToGetExecutor(opCtx,
-                                               collection,
-                                               nss,
-                                               expCtx,
-                                               queryObj,
-                                               *projectionObj,
-                                               *sortObj,
-                                               boost::none, /* groupIdForDistinctScan */
-                                               aggRequest,
-                                               plannerOpts,
-                                               matcherFeatures);
+    auto swExecutorProj = (cachedShape && !cachedShape->projection)
+        ? skippedAttempt()
+        : attemptToGetExecutor(opCtx,
+                               collection,
+                               nss,
+                               expCtx,
+                               queryObj,
+                               *projectionObj,
+                               *sortObj,
+                               boost::none, /* groupIdForDistinctScan */
+                               aggRequest,
+                               plannerOpts,
+                               matcherFeatures);
     if (swExecutorProj.isOK()) {
         // Success! We have a covered projection.
+        recordShape(false, false, true);
         return std::move(swExecutorProj.getValue());
     } else if (swExecutorProj == ErrorCodes::QueryPlanKilled) {
         return {ErrorCodes::OperationFailed,
@@ -796,17 +1039,22 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
     // The query system couldn't provide a covered or simple uncovered projection.
     *projectionObj = BSONObj();
     // If this doesn't work, nothing will.
-    return attemptToGetExecutor(opCtx,
-                                collection,
-                                nss,
-                                expCtx,
-                                queryObj,
-                                *projectionObj,
-                                *sortObj,
-                                boost::none, /* groupIdForDistinctScan */
-                                aggRequest,
-                                plannerOpts,
-                                matcherFeatures);
+    auto swExecutor = attemptToGetExecutor(opCtx,
+                                           collection,
+                                           nss,
+                                           expCtx,
+                                           queryObj,
+                                           *projectionObj,
+                                           *sortObj,
+                                           boost::none, /* groupIdForDistinctScan */
+                                           aggRequest,
+                                           plannerOpts,
+                                           matcherFeatures);
+    if (!swExecutor.isOK()) {
+        return swExecutor;
+    }
+    recordShape(false, false, false);
+    return swExecutor;
 }
 
 void PipelineD::addCursorSource(Pipeline* pipeline,
@@ -814,7 +1062,8 @@ void PipelineD::addCursorSource(Pipeline* pipeline,
                                 DepsTracker deps,
                                 const BSONObj& queryObj,
                                 const BSONObj& sortObj,
-                                const BSONObj& projectionObj) {
+                                const BSONObj& projectionObj,
+                                size_t scanParallelism) {
     // Add the cursor to the pipeline first so that it's correctly disposed of as part of the
     // pipeline if an exception is thrown during this method.
     pipeline->addInitialSource(cursor);
@@ -837,6 +1086,19 @@ void PipelineD::addCursorSource(Pipeline* pipeline,
 
         cursor->setProjection(deps.toProjection(), deps.toParsedDeps(), deps.getNeedsAnyMetadata());
     }
+
+    // The documents produced by the $cursor stage share no storage with one another, so a $group
+    // which consumes them, possibly through $match stages, may read them from several threads.
+    // If they are scanned in parallel, they are aggregated in parallel as well.
+    for (auto it = std::next(pipeline->_sources.begin()); it != pipeline->_sources.end(); ++it) {
+        if (auto group = dynamic_cast<DocumentSourceGroup*>(it->get())) {
+            group->setParallelPartialAggregationAllowed(true, scanParallelism);
+            break;
+        }
+        if (!dynamic_cast<DocumentSourceMatch*>(it->get())) {
+            break;
+        }
+    }
 }
 
 Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
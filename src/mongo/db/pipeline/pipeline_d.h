@@ -178,14 +178,16 @@ private:
     /**
      * Adds 'cursor' to the front of 'pipeline', using 'deps' to inform the cursor of its
      * dependencies. If specified, 'queryObj', 'sortObj' and 'projectionObj' are passed to the
-     * cursor for explain reporting.
+     * cursor for explain reporting. 'scanParallelism' is the number of workers of the parallel
+     * collection scan feeding 'cursor', if any.
      */
     static void addCursorSource(Pipeline* pipeline,
                                 boost::intrusive_ptr<DocumentSourceCursor> cursor,
                                 DepsTracker deps,
                                 const BSONObj& queryObj = BSONObj(),
                                 const BSONObj& sortObj = BSONObj(),
-                                const BSONObj& projectionObj = BSONObj());
+                                const BSONObj& projectionObj = BSONObj(),
+                                size_t scanParallelism = 1);
 };
 
 }  // namespace mongo
@@ -566,6 +566,41 @@ bool MongoInterfaceStandalone::fieldsHaveSupportingUniqueIndex(
     return false;
 }
 
+boost::optional<MongoProcessInterface::JoinStats> MongoInterfaceStandalone::getJoinStats(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    const FieldPath& joinField) const {
+    auto* opCtx = expCtx->opCtx;
+    // As above, we only need to protect against concurrent modifications to the catalog.
+    Lock::DBLock dbLock(opCtx, nss.db(), MODE_IS);
+    Lock::CollectionLock collLock(opCtx, nss, MODE_IS);
+    auto databaseHolder = DatabaseHolder::get(opCtx);
+    auto db = databaseHolder->getDb(opCtx, nss.db());
+    auto collection = db ? db->getCollection(opCtx, nss) : nullptr;
+    if (!collection) {
+        return boost::none;
+    }
+
+    JoinStats stats;
+    stats.numRecords = collection->numRecords(opCtx);
+    stats.dataSizeBytes = collection->dataSize(opCtx);
+
+    auto indexIterator = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (indexIterator->more()) {
+        const IndexCatalogEntry* entry = indexIterator->next();
+        const IndexDescriptor* desc = entry->descriptor();
+        const auto& accessMethod = desc->getAccessMethodName();
+        if ((accessMethod == IndexNames::BTREE || accessMethod == IndexNames::HASHED) &&
+            !desc->isPartial() &&
+            desc->keyPattern().firstElementFieldName() == joinField.fullPath() &&
+            CollatorInterface::collatorsMatch(entry->getCollator(), expCtx->getCollator())) {
+            stats.hasIndexOnJoinField = true;
+            break;
+        }
+    }
+    return stats;
+}
+
 BSONObj MongoInterfaceStandalone::_reportCurrentOpForClient(
     OperationContext* opCtx,
     Client* client,
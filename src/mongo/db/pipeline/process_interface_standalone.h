@@ -139,6 +139,10 @@ public:
                                          const NamespaceString& nss,
                                          const std::set<FieldPath>& fieldPaths) const;
 
+    boost::optional<JoinStats> getJoinStats(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            const NamespaceString& nss,
+                                            const FieldPath& joinField) const final;
+
     virtual void checkRoutingInfoEpochOrThrow(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               const NamespaceString& nss,
                                               ChunkVersion targetCollectionVersion) const override {
@@ -210,6 +210,12 @@ public:
         return true;
     }
 
+    boost::optional<JoinStats> getJoinStats(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            const NamespaceString& nss,
+                                            const FieldPath& joinField) const override {
+        return boost::none;
+    }
+
     boost::optional<ChunkVersion> refreshAndGetCollectionVersion(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const NamespaceString& nss) const override {
@@ -35,6 +35,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/column_scan.h"
 #include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/distinct_scan.h"
 #include "mongo/db/exec/idhack.h"
@@ -123,6 +124,24 @@ MultiPlanStage* getMultiPlanStage(PlanStage* root) {
     return static_cast<MultiPlanStage*>(ps);
 }
 
+/**
+ * Appends to 'out' the time which the candidate plan 'candidateIdx' of 'mps' spent on its own
+ * thread during the trial period, if the candidates were trialed concurrently.
+ */
+void appendCandidateTrialTimes(const MultiPlanStage* mps,
+                               size_t candidateIdx,
+                               BSONObjBuilder* out) {
+    auto stats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+    if (!stats->concurrentTrial) {
+        return;
+    }
+
+    const auto& candidateStats = stats->candidates[candidateIdx];
+    out->appendNumber("trialRounds", candidateStats.rounds);
+    out->appendNumber("trialWallTimeMicros", candidateStats.wallTimeMicros);
+    out->appendNumber("trialCpuTimeMicros", candidateStats.cpuTimeMicros);
+}
+
 /**
  * Gets a pointer to the PipelineProxyStage if it is the root of the tree. Returns nullptr if
  * there is no PPS that is root.
@@ -155,6 +174,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_COUNT_SCAN == type) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->keysExamined;
     } else if (STAGE_DISTINCT_SCAN == type) {
         const DistinctScanStats* spec = static_cast<const DistinctScanStats*>(specific);
         return spec->keysExamined;
@@ -176,6 +198,10 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_PARALLEL_COLLSCAN == type) {
+        const ParallelCollectionScanStats* spec =
+            static_cast<const ParallelCollectionScanStats*>(specific);
+        return spec->docsTested;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -200,7 +226,11 @@ void addStageSummaryStr(const PlanStage* stage, StringBuilder& sb) {
 
     // Some leaf nodes also provide info about the index they used.
     const SpecificStats* specific = stage->getSpecificStats();
-    if (STAGE_COUNT_SCAN == stage->stageType()) {
+    if (STAGE_COLUMN_SCAN == stage->stageType()) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        const KeyPattern keyPattern{spec->keyPattern};
+        sb << " " << keyPattern;
+    } else if (STAGE_COUNT_SCAN == stage->stageType()) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         const KeyPattern keyPattern{spec->keyPattern};
         sb << " " << keyPattern;
@@ -344,6 +374,8 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("bloomFilterRejects", spec->bloomFilterRejects);
+            bob->appendBool("recordIdIntersection", spec->recordIdIntersection);
 
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
@@ -367,9 +399,45 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (spec->maxTs) {
             bob->append("maxTs", *(spec->maxTs));
         }
+        if (spec->minRecord) {
+            bob->append("minRecord", spec->minRecord->repr());
+        }
+        if (spec->maxRecord) {
+            bob->append("maxRecord", spec->maxRecord->repr());
+        }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
+    } else if (STAGE_COLUMN_SCAN == stats.stageType) {
+        ColumnScanStats* spec = static_cast<ColumnScanStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
+        }
+
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("indexName", spec->indexName);
+        bob->append("fields", spec->fields);
+    } else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+        ParallelCollectionScanStats* spec =
+            static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("docsExamined", spec->docsTested);
+
+            BSONArrayBuilder workersBob(bob->subarrayStart("workers"));
+            for (auto&& worker : spec->workers) {
+                BSONObjBuilder workerBob(workersBob.subobjStart());
+                workerBob.append("minRecord", worker.minRecord.repr());
+                if (!worker.maxRecord.isNull()) {
+                    workerBob.append("maxRecord", worker.maxRecord.repr());
+                }
+                workerBob.appendNumber("docsExamined", worker.docsTested);
+                workerBob.appendNumber("nReturned", worker.docsReturned);
+                workerBob.appendNumber("rounds", worker.rounds);
+                workerBob.appendNumber("executionTimeMillisEstimate",
+                                       worker.executionTimeMillis);
+            }
+        }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
@@ -434,6 +502,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->append("indexBounds", spec->indexBounds);
         }
 
+        if (spec->estimatedKeysExamined) {
+            bob->append("estimatedKeysExamined", *spec->estimatedKeysExamined);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("keysExamined", spec->keysExamined);
         }
@@ -448,6 +520,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsExamined);
             bob->appendNumber("alreadyHasObj", spec->alreadyHasObj);
+            if (spec->batchSize > 0) {
+                bob->appendNumber("batchSize", spec->batchSize);
+                bob->appendNumber("batches", spec->batches);
+            }
         }
     } else if (STAGE_GEO_NEAR_2D == stats.stageType || STAGE_GEO_NEAR_2DSPHERE == stats.stageType) {
         NearStats* spec = static_cast<NearStats*>(stats.specific.get());
@@ -815,11 +891,15 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
         // all rejected plans' stats collected during the trial period.
 
         BSONArrayBuilder allPlansBob(execBob.subarrayStart("allPlansExecution"));
+        const MultiPlanStage* mps = getMultiPlanStage(exec->getRootStage());
 
         if (winningPlanTrialStats) {
             BSONObjBuilder planBob(allPlansBob.subobjStart());
             generateSinglePlanExecutionInfo(
                 winningPlanTrialStats, verbosity, boost::none, &planBob);
+            if (mps) {
+                appendCandidateTrialTimes(mps, mps->bestPlanIdx(), &planBob);
+            }
             planBob.doneFast();
         }
 
@@ -828,6 +908,11 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
             BSONObjBuilder planBob(allPlansBob.subobjStart());
             generateSinglePlanExecutionInfo(
                 rejectedStats[i].get(), verbosity, boost::none, &planBob);
+            if (mps) {
+                // The rejected plans are the candidates other than the winner, in their order.
+                const size_t bestPlanIdx = mps->bestPlanIdx();
+                appendCandidateTrialTimes(mps, i < bestPlanIdx ? i : i + 1, &planBob);
+            }
             planBob.doneFast();
         }
 
@@ -986,6 +1071,11 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IndexScanStats* ixscanStats =
                 static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
             statsOut->indexesUsed.insert(ixscanStats->indexName);
+        } else if (STAGE_COLUMN_SCAN == stages[i]->stageType()) {
+            const ColumnScan* columnScan = static_cast<const ColumnScan*>(stages[i]);
+            const ColumnScanStats* columnScanStats =
+                static_cast<const ColumnScanStats*>(columnScan->getSpecificStats());
+            statsOut->indexesUsed.insert(columnScanStats->indexName);
         } else if (STAGE_COUNT_SCAN == stages[i]->stageType()) {
             const CountScan* countScan = static_cast<const CountScan*>(stages[i]);
             const CountScanStats* countScanStats =
@@ -1026,6 +1116,9 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
                 static_cast<const CollectionScanStats*>(collScan->getSpecificStats());
             if (!collScanStats->tailable)
                 statsOut->collectionScansNonTailable++;
+        } else if (STAGE_PARALLEL_COLLSCAN == stages[i]->stageType()) {
+            statsOut->collectionScans++;
+            statsOut->collectionScansNonTailable++;
         }
     }
 }
@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/get_executor.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <limits>
 #include <memory>
@@ -56,6 +57,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/wildcard_access_method.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/query/canonical_query.h"
@@ -76,6 +78,7 @@
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -255,6 +258,11 @@ void fillOutPlannerParams(OperationContext* opCtx,
         collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii->more()) {
         const IndexCatalogEntry* ice = ii->next();
+        // Columnstore indexes cannot answer point or range predicates. They are only used for the
+        // column scans chosen by aggregation, so the planner never sees them.
+        if (ice->descriptor()->getIndexType() == IndexType::INDEX_COLUMN) {
+            continue;
+        }
         plannerParams->indices.push_back(
             indexEntryFromIndexCatalogEntry(opCtx, *ice, canonicalQuery));
     }
@@ -263,6 +271,16 @@ void fillOutPlannerParams(OperationContext* opCtx,
     // Ignore index filters when it is possible to use the id-hack.
     applyIndexFilters(collection, *canonicalQuery, plannerParams);
 
+    if (internalQueryPlannerEnableIndexStatistics.load()) {
+        auto indexStatistics = collection->infoCache()->getIndexStatistics();
+        for (auto&& index : plannerParams->indices) {
+            if (auto statistics = indexStatistics->get(index.identifier.catalogName)) {
+                plannerParams->indexStatistics[index.identifier.catalogName] =
+                    std::move(statistics);
+            }
+        }
+    }
+
     // We will not output collection scans unless there are no indexed solutions. NO_TABLE_SCAN
     // overrides this behavior by not outputting a collscan even if there are no indexed
     // solutions.
@@ -299,6 +317,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
 
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
+    if (collection->isClustered()) {
+        plannerParams->options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    }
+
     if (shouldWaitForOplogVisibility(
             opCtx, collection, canonicalQuery->getQueryRequest().isTailable())) {
         plannerParams->options |= QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
@@ -348,6 +370,69 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Returns true if the stages built for 'node' and its descendants may be worked on another thread
+ * than the one which built them, and concurrently with other plans for the same query.
+ */
+bool canWorkConcurrently(const QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_COLLSCAN:
+        case STAGE_FETCH:
+        case STAGE_IXSCAN:
+        case STAGE_LIMIT:
+        case STAGE_OR:
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_SIMPLE:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SKIP:
+        case STAGE_SORT:
+        case STAGE_SORT_KEY_GENERATOR:
+        case STAGE_SORT_MERGE:
+            break;
+        default:
+            return false;
+    }
+
+    if (node->filter && !expression::canMatchConcurrently(node->filter.get())) {
+        return false;
+    }
+
+    return std::all_of(node->children.begin(), node->children.end(), [](auto&& child) {
+        return canWorkConcurrently(child);
+    });
+}
+
+/**
+ * Returns true if the candidate plans built from 'solutions' may be trialed concurrently by a
+ * MultiPlanStage, in which case each of them needs its own WorkingSet.
+ *
+ * Each candidate then reads from its own snapshot, so this is only done for operations which may
+ * observe several snapshots over their lifetime anyway.
+ */
+bool canTrialPlansConcurrently(OperationContext* opCtx,
+                               const std::vector<std::unique_ptr<QuerySolution>>& solutions) {
+    if (!internalQueryEnableParallelPlanEvaluation.load() || solutions.size() < 2) {
+        return false;
+    }
+
+    // Multi-document transactions and other operations running inside a write unit of work must
+    // read from a single snapshot.
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        return false;
+    }
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return false;
+    }
+
+    return std::all_of(solutions.begin(), solutions.end(), [](auto&& solution) {
+        return canWorkConcurrently(solution->root.get());
+    });
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -554,15 +639,33 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             std::move(canonicalQuery), std::move(solutions[0]), std::move(root));
     } else {
         // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
-        // and so on. The working set will be shared by all candidate plans.
+        // and so on. The working set will be shared by all candidate plans, unless they can be
+        // trialed concurrently, in which case each gets its own.
         auto multiPlanStage =
             std::make_unique<MultiPlanStage>(opCtx, collection, canonicalQuery.get());
+        const bool trialConcurrently = canTrialPlansConcurrently(opCtx, solutions);
 
         for (size_t ix = 0; ix < solutions.size(); ++ix) {
             if (solutions[ix]->cacheData.get()) {
                 solutions[ix]->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
             }
 
+            if (trialConcurrently) {
+                auto candidateWs = std::make_unique<WorkingSet>();
+                PlanStage* nextPlanRoot;
+                verify(StageBuilder::build(opCtx,
+                                           collection,
+                                           *canonicalQuery,
+                                           *solutions[ix],
+                                           candidateWs.get(),
+                                           &nextPlanRoot));
+
+                // Takes ownership of 'nextPlanRoot' and 'candidateWs'.
+                multiPlanStage->addPlan(
+                    std::move(solutions[ix]), nextPlanRoot, std::move(candidateWs), ws);
+                continue;
+            }
+
             // version of StageBuild::build when WorkingSet is shared
             PlanStage* nextPlanRoot;
             verify(StageBuilder::build(
@@ -1370,6 +1473,9 @@ QueryPlannerParams fillOutPlannerParamsForDistinct(OperationContext* opCtx,
     while (ii->more()) {
         const IndexCatalogEntry* ice = ii->next();
         const IndexDescriptor* desc = ice->descriptor();
+        if (desc->getIndexType() == IndexType::INDEX_COLUMN) {
+            continue;
+        }
         if (desc->keyPattern().hasField(parsedDistinct.getKey())) {
             if (!mayUnwindArrays &&
                 isAnyComponentOfPathMultikey(desc->keyPattern(),
@@ -0,0 +1,302 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Returns the value of 'elem' on a scale on which values can be interpolated, if it has one.
+ */
+boost::optional<double> toInterpolationScale(const BSONElement& elem) {
+    if (elem.isNumber()) {
+        return elem.numberDouble();
+    }
+    if (elem.type() == BSONType::Date) {
+        return static_cast<double>(elem.date().toMillisSinceEpoch());
+    }
+    return boost::none;
+}
+
+/**
+ * Returns the fraction of the values in 'bucket' which are estimated to fall in [lo, hi], a range
+ * within the bucket.
+ */
+double estimateFraction(const IndexStatistics::Bucket& bucket,
+                        const BSONElement& lo,
+                        const BSONElement& hi) {
+    auto bucketMin = toInterpolationScale(bucket.min.firstElement());
+    auto bucketMax = toInterpolationScale(bucket.max.firstElement());
+    auto rangeLo = toInterpolationScale(lo);
+    auto rangeHi = toInterpolationScale(hi);
+    if (!bucketMin || !bucketMax || !rangeLo || !rangeHi || !(*bucketMax > *bucketMin)) {
+        // Without a scale to interpolate on, assume that the range covers half the bucket.
+        return 0.5;
+    }
+
+    double fraction = (*rangeHi - *rangeLo) / (*bucketMax - *bucketMin);
+    if (!std::isfinite(fraction)) {
+        return 0.5;
+    }
+    return std::min(1.0, std::max(0.0, fraction));
+}
+
+const char* sourceToString(IndexStatistics::Source source) {
+    switch (source) {
+        case IndexStatistics::Source::kIndexBuild:
+            return "indexBuild";
+        case IndexStatistics::Source::kSample:
+            return "sample";
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace
+
+IndexStatistics::IndexStatistics(Source source,
+                                 Date_t lastUpdated,
+                                 long long numRecords,
+                                 double numKeys,
+                                 double distinct,
+                                 std::vector<Bucket> buckets)
+    : _source(source),
+      _lastUpdated(lastUpdated),
+      _numRecords(numRecords),
+      _numKeys(numKeys),
+      _distinct(distinct),
+      _buckets(std::move(buckets)) {}
+
+double IndexStatistics::estimateKeys(const OrderedIntervalList& oil) const {
+    double keys = 0;
+    for (auto&& interval : oil.intervals) {
+        keys += estimateKeys(interval);
+    }
+    return std::min(keys, _numKeys);
+}
+
+double IndexStatistics::estimateKeys(const Interval& interval) const {
+    if (interval.getDirection() == Interval::Direction::kDirectionDescending) {
+        return estimateKeys(interval.reverseClone());
+    }
+
+    double keys = 0;
+    for (auto&& bucket : _buckets) {
+        const BSONElement min = bucket.min.firstElement();
+        const BSONElement max = bucket.max.firstElement();
+
+        const int endToMin = compareValues(interval.end, min);
+        if (endToMin < 0 || (endToMin == 0 && !interval.endInclusive)) {
+            // The buckets are in ascending order, so none of the remaining ones overlap either.
+            break;
+        }
+        const int startToMax = compareValues(interval.start, max);
+        if (startToMax > 0 || (startToMax == 0 && !interval.startInclusive)) {
+            continue;
+        }
+
+        const int startToMin = compareValues(interval.start, min);
+        const int endToMax = compareValues(interval.end, max);
+        const bool coversMin = startToMin < 0 || (startToMin == 0 && interval.startInclusive);
+        const bool coversMax = endToMax > 0 || (endToMax == 0 && interval.endInclusive);
+        if (coversMin && coversMax) {
+            keys += bucket.count;
+        } else if (interval.isPoint()) {
+            keys += bucket.count / std::max(bucket.distinct, 1.0);
+        } else {
+            keys += bucket.count *
+                estimateFraction(bucket,
+                                 coversMin ? min : interval.start,
+                                 coversMax ? max : interval.end);
+        }
+    }
+    return keys;
+}
+
+BSONObj IndexStatistics::toBSON() const {
+    BSONObjBuilder bob;
+    bob.append("source", sourceToString(_source));
+    bob.append("lastUpdated", _lastUpdated);
+    bob.appendNumber("numRecords", _numRecords);
+    bob.append("numKeys", _numKeys);
+    bob.append("distinct", _distinct);
+
+    BSONArrayBuilder histogram(bob.subarrayStart("histogram"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBob(histogram.subobjStart());
+        bucketBob.appendAs(bucket.min.firstElement(), "min");
+        bucketBob.appendAs(bucket.max.firstElement(), "max");
+        bucketBob.append("count", bucket.count);
+        bucketBob.append("distinct", bucket.distinct);
+    }
+    histogram.doneFast();
+    return bob.obj();
+}
+
+IndexStatisticsBuilder::IndexStatisticsBuilder(const BSONObj& keyPattern, long long expectedKeys)
+    : IndexStatisticsBuilder(
+          keyPattern, expectedKeys, internalQueryIndexStatisticsHistogramBuckets.load()) {}
+
+IndexStatisticsBuilder::IndexStatisticsBuilder(const BSONObj& keyPattern,
+                                               long long expectedKeys,
+                                               size_t numBuckets)
+    : _descending(keyPattern.firstElement().number() < 0),
+      _bucketDepth(std::max(1LL,
+                            static_cast<long long>(std::ceil(static_cast<double>(expectedKeys) /
+                                                             std::max<size_t>(numBuckets, 1))))) {}
+
+void IndexStatisticsBuilder::addKey(const BSONObj& key) {
+    const BSONElement value = key.firstElement();
+    ++_numKeys;
+    if (_runLength > 0 && compareValues(value, _runValue.firstElement()) == 0) {
+        ++_runLength;
+        return;
+    }
+
+    if (_runLength > 0) {
+        _endRun();
+    }
+    _runValue = value.wrap("");
+    _runLength = 1;
+}
+
+void IndexStatisticsBuilder::_endRun() {
+    const bool singleton = _runLength == 1;
+    ++_distinct;
+    _singletons += singleton ? 1 : 0;
+
+    if (_runLength >= _bucketDepth) {
+        // A value this frequent gets a bucket of its own.
+        if (_pending.count > 0) {
+            _closeBucket(_bucketFirst, _bucketLast, _pending);
+        }
+        _closeBucket(_runValue, _runValue, {_runLength, 1, singleton ? 1 : 0});
+    } else {
+        if (_pending.count == 0) {
+            _bucketFirst = _runValue;
+        }
+        _bucketLast = _runValue;
+        _pending.count += _runLength;
+        ++_pending.distinct;
+        _pending.singletons += singleton ? 1 : 0;
+        if (_pending.count >= _bucketDepth) {
+            _closeBucket(_bucketFirst, _bucketLast, _pending);
+        }
+    }
+    _runLength = 0;
+}
+
+void IndexStatisticsBuilder::_closeBucket(const BSONObj& first,
+                                          const BSONObj& last,
+                                          const PendingCounts& counts) {
+    _buckets.push_back({first, last, counts});
+    _pending = PendingCounts();
+}
+
+std::shared_ptr<const IndexStatistics> IndexStatisticsBuilder::done(
+    IndexStatistics::Source source, long long numRecords, long long sampledRecords) {
+    if (_runLength > 0) {
+        _endRun();
+    }
+    if (_pending.count > 0) {
+        _closeBucket(_bucketFirst, _bucketLast, _pending);
+    }
+
+    const double scale = (source == IndexStatistics::Source::kSample && sampledRecords > 0)
+        ? std::max(1.0, static_cast<double>(numRecords) / sampledRecords)
+        : 1.0;
+
+    // Scales up the number of distinct values seen in a sample with the GEE estimator: values seen
+    // more than once are assumed to have been seen already, while each value seen once stands for
+    // sqrt(scale) values in the collection.
+    auto estimateDistinct = [scale](long long count, long long distinct, long long singletons) {
+        double estimate = std::sqrt(scale) * singletons + (distinct - singletons);
+        return std::min(estimate, count * scale);
+    };
+
+    std::vector<IndexStatistics::Bucket> buckets;
+    buckets.reserve(_buckets.size());
+    for (auto&& raw : _buckets) {
+        IndexStatistics::Bucket bucket;
+        bucket.min = _descending ? raw.last : raw.first;
+        bucket.max = _descending ? raw.first : raw.last;
+        bucket.count = raw.counts.count * scale;
+        bucket.distinct =
+            estimateDistinct(raw.counts.count, raw.counts.distinct, raw.counts.singletons);
+        buckets.push_back(std::move(bucket));
+    }
+    if (_descending) {
+        std::reverse(buckets.begin(), buckets.end());
+    }
+
+    return std::make_shared<IndexStatistics>(source,
+                                             Date_t::now(),
+                                             numRecords,
+                                             _numKeys * scale,
+                                             estimateDistinct(_numKeys, _distinct, _singletons),
+                                             std::move(buckets));
+}
+
+std::shared_ptr<const IndexStatistics> CollectionIndexStatistics::get(StringData indexName) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _statistics.find(indexName);
+    if (it == _statistics.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void CollectionIndexStatistics::set(StringData indexName,
+                                    std::shared_ptr<const IndexStatistics> statistics) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statistics[indexName] = std::move(statistics);
+}
+
+void CollectionIndexStatistics::remove(StringData indexName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statistics.erase(indexName);
+}
+
+}  // namespace mongo
@@ -0,0 +1,248 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * A summary of the values of the leading field of an index, used by the query planner to estimate
+ * how many keys an index scan will examine.
+ *
+ * The summary consists of the number of keys in the index, an estimate of the number of distinct
+ * values of the leading field and an equi-depth histogram over those values. Each bucket of the
+ * histogram holds roughly the same number of keys and never splits the keys of a single value
+ * across buckets. A value which accounts for at least a bucket's worth of keys gets a bucket of
+ * its own, so that the estimates for frequent values are exact.
+ *
+ * Values are compared as index keys, so for an index with a collation they are collation keys,
+ * just like the index bounds the statistics are applied to.
+ *
+ * Instances are immutable once built and are shared between the planner and the collection's
+ * CollectionIndexStatistics.
+ */
+class IndexStatistics {
+public:
+    /**
+     * Where the statistics came from.
+     */
+    enum class Source {
+        // Every key of the index, seen while the index was built.
+        kIndexBuild,
+        // Keys generated from a random sample of the collection's documents.
+        kSample,
+    };
+
+    /**
+     * A histogram bucket, covering the leading field values in [min, max].
+     */
+    struct Bucket {
+        // Single field objects with an empty field name holding the smallest and largest value.
+        BSONObj min;
+        BSONObj max;
+
+        // The number of keys whose leading field value falls in [min, max].
+        double count = 0;
+
+        // The number of distinct leading field values in [min, max].
+        double distinct = 0;
+    };
+
+    IndexStatistics(Source source,
+                    Date_t lastUpdated,
+                    long long numRecords,
+                    double numKeys,
+                    double distinct,
+                    std::vector<Bucket> buckets);
+
+    /**
+     * Returns the estimated number of keys whose leading field falls within 'oil', the bounds on
+     * the leading field of the index. The intervals may be in either direction.
+     */
+    double estimateKeys(const OrderedIntervalList& oil) const;
+
+    /**
+     * Returns the estimated number of keys whose leading field falls within 'interval'.
+     */
+    double estimateKeys(const Interval& interval) const;
+
+    /**
+     * Returns the document reported for the index by $indexStats.
+     */
+    BSONObj toBSON() const;
+
+    Source getSource() const {
+        return _source;
+    }
+
+    Date_t getLastUpdated() const {
+        return _lastUpdated;
+    }
+
+    /**
+     * The number of records in the collection when the statistics were gathered.
+     */
+    long long getNumRecords() const {
+        return _numRecords;
+    }
+
+    double getNumKeys() const {
+        return _numKeys;
+    }
+
+    double getDistinct() const {
+        return _distinct;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+private:
+    Source _source;
+    Date_t _lastUpdated;
+    long long _numRecords;
+    double _numKeys;
+    double _distinct;
+
+    // In ascending order of leading field value, without overlap.
+    std::vector<Bucket> _buckets;
+};
+
+/**
+ * Builds IndexStatistics from a stream of index keys in index order, as produced by the external
+ * sorter while bulk building an index, or by sorting the keys of a sample of documents.
+ */
+class IndexStatisticsBuilder {
+    IndexStatisticsBuilder(const IndexStatisticsBuilder&) = delete;
+    IndexStatisticsBuilder& operator=(const IndexStatisticsBuilder&) = delete;
+
+public:
+    /**
+     * 'expectedKeys' is the number of keys which will be added, used to size the buckets. The
+     * number of buckets is 'internalQueryIndexStatisticsHistogramBuckets'.
+     */
+    IndexStatisticsBuilder(const BSONObj& keyPattern, long long expectedKeys);
+
+    IndexStatisticsBuilder(const BSONObj& keyPattern, long long expectedKeys, size_t numBuckets);
+
+    /**
+     * Adds an index key. Keys must be added in the order of the index's key pattern.
+     */
+    void addKey(const BSONObj& key);
+
+    /**
+     * Returns the statistics for the keys added. 'numRecords' is the number of records in the
+     * collection. For a kSample source, the keys are assumed to come from a uniform sample of
+     * 'sampledRecords' of those records, and all counts are scaled up accordingly.
+     */
+    std::shared_ptr<const IndexStatistics> done(IndexStatistics::Source source,
+                                                long long numRecords,
+                                                long long sampledRecords);
+
+private:
+    // Counts for the bucket being built, taken before the run of the current value started.
+    struct PendingCounts {
+        long long count = 0;
+        long long distinct = 0;
+        long long singletons = 0;
+    };
+
+    void _endRun();
+    void _closeBucket(const BSONObj& first, const BSONObj& last, const PendingCounts& counts);
+
+    bool _descending;
+    long long _bucketDepth;
+
+    long long _numKeys = 0;
+    long long _distinct = 0;
+    long long _singletons = 0;
+
+    // The value of the current run of equal values, and its length.
+    BSONObj _runValue;
+    long long _runLength = 0;
+
+    // The first and last values of the bucket being built, excluding the current run.
+    BSONObj _bucketFirst;
+    BSONObj _bucketLast;
+    PendingCounts _pending;
+
+    struct RawBucket {
+        BSONObj first;
+        BSONObj last;
+        PendingCounts counts;
+    };
+    std::vector<RawBucket> _buckets;
+};
+
+/**
+ * The statistics of each index of a collection, by index name. Owned by the collection's
+ * CollectionInfoCache. Safe to use concurrently.
+ */
+class CollectionIndexStatistics {
+    CollectionIndexStatistics(const CollectionIndexStatistics&) = delete;
+    CollectionIndexStatistics& operator=(const CollectionIndexStatistics&) = delete;
+
+public:
+    CollectionIndexStatistics() = default;
+
+    /**
+     * Returns the statistics for index 'indexName', or nullptr if there are none.
+     */
+    std::shared_ptr<const IndexStatistics> get(StringData indexName) const;
+
+    /**
+     * Replaces the statistics for index 'indexName'.
+     */
+    void set(StringData indexName, std::shared_ptr<const IndexStatistics> statistics);
+
+    /**
+     * Drops the statistics for index 'indexName', if any.
+     */
+    void remove(StringData indexName);
+
+private:
+    mutable stdx::mutex _mutex;
+    StringMap<std::shared_ptr<const IndexStatistics>> _statistics;
+};
+
+}  // namespace mongo
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::shared_ptr<const IndexStatistics> buildFromValues(const BSONObj& keyPattern,
+                                                       const std::vector<int>& values,
+                                                       size_t numBuckets) {
+    IndexStatisticsBuilder builder(keyPattern, values.size(), numBuckets);
+    for (int value : values) {
+        builder.addKey(BSON("" << value));
+    }
+    return builder.done(IndexStatistics::Source::kIndexBuild, values.size(), values.size());
+}
+
+OrderedIntervalList makeOIL(std::vector<Interval> intervals) {
+    OrderedIntervalList oil("a");
+    oil.intervals = std::move(intervals);
+    return oil;
+}
+
+std::vector<int> range(int from, int to) {
+    std::vector<int> values;
+    for (int i = from; i < to; ++i) {
+        values.push_back(i);
+    }
+    return values;
+}
+
+TEST(IndexStatisticsTest, BuildsEquiDepthHistogram) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 100), 10);
+    ASSERT_EQ(stats->getNumKeys(), 100);
+    ASSERT_EQ(stats->getDistinct(), 100);
+    ASSERT_EQ(stats->getBuckets().size(), 10U);
+    for (auto&& bucket : stats->getBuckets()) {
+        ASSERT_EQ(bucket.count, 10);
+        ASSERT_EQ(bucket.distinct, 10);
+    }
+    ASSERT_BSONOBJ_EQ(stats->getBuckets().front().min, BSON("" << 0));
+    ASSERT_BSONOBJ_EQ(stats->getBuckets().back().max, BSON("" << 99));
+}
+
+TEST(IndexStatisticsTest, EstimatesRangeCoveringWholeBuckets) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 100), 10);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 10 << "" << 29), true, true)), 20);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true)), 100);
+}
+
+TEST(IndexStatisticsTest, InterpolatesNumericRangeWithinBucket) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 100), 10);
+    // [10, 19] holds 10 keys, of which the range covers 4/9ths of the width.
+    ASSERT_APPROX_EQUAL(
+        stats->estimateKeys(Interval(BSON("" << 10 << "" << 14), true, true)), 40.0 / 9, 1e-9);
+}
+
+TEST(IndexStatisticsTest, ExcludesBucketBoundsOutsideOpenInterval) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 100), 10);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 9 << "" << 10), false, false)), 0);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 100 << "" << 200), true, true)), 0);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << -10 << "" << -1), true, true)), 0);
+}
+
+TEST(IndexStatisticsTest, EstimatesPointFromBucketDensity) {
+    std::vector<int> values;
+    for (int i = 0; i < 10; ++i) {
+        values.push_back(i);
+        values.push_back(i);
+    }
+    auto stats = buildFromValues(BSON("a" << 1), values, 2);
+    ASSERT_EQ(stats->getDistinct(), 10);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 3 << "" << 3), true, true)), 2);
+}
+
+TEST(IndexStatisticsTest, FrequentValueGetsItsOwnBucket) {
+    std::vector<int> values = range(0, 50);
+    values.insert(values.begin() + 25, 50, 25);
+    auto stats = buildFromValues(BSON("a" << 1), values, 10);
+    ASSERT_EQ(stats->getNumKeys(), 100);
+    ASSERT_EQ(stats->getDistinct(), 50);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 25 << "" << 25), true, true)), 51);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 24 << "" << 24), true, true)), 1);
+}
+
+TEST(IndexStatisticsTest, DescendingIndexBuildsAscendingHistogram) {
+    std::vector<int> values = range(0, 100);
+    std::reverse(values.begin(), values.end());
+    auto stats = buildFromValues(BSON("a" << -1), values, 10);
+    ASSERT_EQ(stats->getBuckets().size(), 10U);
+    ASSERT_BSONOBJ_EQ(stats->getBuckets().front().min, BSON("" << 0));
+    ASSERT_BSONOBJ_EQ(stats->getBuckets().front().max, BSON("" << 9));
+    ASSERT_BSONOBJ_EQ(stats->getBuckets().back().max, BSON("" << 99));
+
+    // Bounds on a descending index are descending too.
+    auto oil = makeOIL({Interval(BSON("" << 29 << "" << 10), true, true)});
+    ASSERT_EQ(stats->estimateKeys(oil), 20);
+}
+
+TEST(IndexStatisticsTest, SumsEstimatesOverIntervals) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 100), 10);
+    auto oil = makeOIL({Interval(BSON("" << 0 << "" << 9), true, true),
+                        Interval(BSON("" << 50 << "" << 59), true, true)});
+    ASSERT_EQ(stats->estimateKeys(oil), 20);
+}
+
+TEST(IndexStatisticsTest, ScalesSampleToCollection) {
+    IndexStatisticsBuilder builder(BSON("a" << 1), 100, 10);
+    for (int i = 0; i < 100; ++i) {
+        builder.addKey(BSON("" << i));
+    }
+    auto stats = builder.done(IndexStatistics::Source::kSample, 400, 100);
+    ASSERT_EQ(stats->getNumKeys(), 400);
+    // Every value was seen once, so each stands for sqrt(4) values.
+    ASSERT_EQ(stats->getDistinct(), 200);
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 10 << "" << 19), true, true)), 40);
+}
+
+TEST(IndexStatisticsTest, SerializesToBSON) {
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 4), 2);
+    BSONObj obj = stats->toBSON();
+    ASSERT_EQ(obj["source"].String(), "indexBuild");
+    ASSERT_EQ(obj["numRecords"].numberLong(), 4);
+    ASSERT_EQ(obj["numKeys"].numberDouble(), 4);
+    ASSERT_EQ(obj["distinct"].numberDouble(), 4);
+    ASSERT_BSONOBJ_EQ(obj["histogram"].Obj(),
+                      BSON_ARRAY(BSON("min" << 0 << "max" << 1 << "count" << 2.0 << "distinct"
+                                            << 2.0)
+                                 << BSON("min" << 2 << "max" << 3 << "count" << 2.0 << "distinct"
+                                               << 2.0)));
+}
+
+TEST(CollectionIndexStatisticsTest, SetGetAndRemove) {
+    CollectionIndexStatistics registry;
+    ASSERT_FALSE(registry.get("a_1"));
+
+    auto stats = buildFromValues(BSON("a" << 1), range(0, 10), 2);
+    registry.set("a_1", stats);
+    ASSERT_EQ(registry.get("a_1"), stats);
+
+    registry.remove("a_1");
+    ASSERT_FALSE(registry.get("a_1"));
+}
+
+}  // namespace
+}  // namespace mongo
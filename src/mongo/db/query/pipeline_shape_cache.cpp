@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/pipeline_shape_cache.h"
+
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+
+PipelineShapeCache::PipelineShapeCache() : PipelineShapeCache(internalQueryCacheSize.load()) {}
+
+PipelineShapeCache::PipelineShapeCache(size_t size) : _cache(size) {}
+
+boost::optional<PipelineShapeCache::Entry> PipelineShapeCache::get(const std::string& key) const {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Entry* entry;
+    if (!_cache.get(key, &entry).isOK()) {
+        return boost::none;
+    }
+    return *entry;
+}
+
+void PipelineShapeCache::set(const std::string& key, const Entry& entry) {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _cache.add(key, new Entry(entry));
+}
+
+void PipelineShapeCache::remove(const std::string& key) {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _cache.remove(key).ignore();
+}
+
+void PipelineShapeCache::clear() {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _cache.clear();
+}
+
+size_t PipelineShapeCache::size() const {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    return _cache.size();
+}
+
+}  // namespace mongo
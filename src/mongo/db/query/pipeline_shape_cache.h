@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Remembers, for each shape of aggregation pipeline run against a collection, which parts of the
+ * pipeline the query system took over the last time. Finding that out otherwise means trying to
+ * get executors for a DISTINCT_SCAN $group, a non-blocking $sort and a covered projection in turn,
+ * each of which canonicalizes and plans the query again, and discarding the ones that fail.
+ *
+ * Each collection's CollectionInfoCache owns one, which is cleared along with the collection's
+ * PlanCache, including whenever its indexes change.
+ */
+class PipelineShapeCache {
+    PipelineShapeCache(const PipelineShapeCache&) = delete;
+    PipelineShapeCache& operator=(const PipelineShapeCache&) = delete;
+
+public:
+    /**
+     * The parts of a pipeline which the query system provided.
+     */
+    struct Entry {
+        bool groupByDistinctScan = false;
+        bool sort = false;
+        bool projection = false;
+    };
+
+    /**
+     * Holds as many entries as the plan cache, 'internalQueryCacheSize'.
+     */
+    PipelineShapeCache();
+
+    explicit PipelineShapeCache(size_t size);
+
+    /**
+     * Returns the entry for the pipeline shape 'key', if any.
+     */
+    boost::optional<Entry> get(const std::string& key) const;
+
+    /**
+     * Records 'entry' for the pipeline shape 'key', evicting the least recently used entry if the
+     * cache is full.
+     */
+    void set(const std::string& key, const Entry& entry);
+
+    void remove(const std::string& key);
+
+    /**
+     * Removes all entries.
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    LRUKeyValue<std::string, Entry> _cache;
+
+    // Protects '_cache'.
+    mutable stdx::mutex _cacheMutex;
+};
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/pipeline_shape_cache.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(PipelineShapeCacheTest, ShouldReturnEntryWhichWasSet) {
+    PipelineShapeCache cache(10);
+    ASSERT_FALSE(cache.get("shape"));
+
+    PipelineShapeCache::Entry entry;
+    entry.sort = true;
+    cache.set("shape", entry);
+
+    auto cached = cache.get("shape");
+    ASSERT_TRUE(cached);
+    ASSERT_FALSE(cached->groupByDistinctScan);
+    ASSERT_TRUE(cached->sort);
+    ASSERT_FALSE(cached->projection);
+}
+
+TEST(PipelineShapeCacheTest, SetShouldReplaceExistingEntry) {
+    PipelineShapeCache cache(10);
+    PipelineShapeCache::Entry entry;
+    entry.projection = true;
+    cache.set("shape", entry);
+    cache.set("shape", PipelineShapeCache::Entry());
+
+    auto cached = cache.get("shape");
+    ASSERT_TRUE(cached);
+    ASSERT_FALSE(cached->projection);
+    ASSERT_EQ(cache.size(), 1UL);
+}
+
+TEST(PipelineShapeCacheTest, ShouldEvictLeastRecentlyUsedEntry) {
+    PipelineShapeCache cache(2);
+    cache.set("a", PipelineShapeCache::Entry());
+    cache.set("b", PipelineShapeCache::Entry());
+    ASSERT_TRUE(cache.get("a"));
+
+    cache.set("c", PipelineShapeCache::Entry());
+    ASSERT_TRUE(cache.get("a"));
+    ASSERT_FALSE(cache.get("b"));
+    ASSERT_TRUE(cache.get("c"));
+}
+
+TEST(PipelineShapeCacheTest, RemoveAndClearShouldDropEntries) {
+    PipelineShapeCache cache(10);
+    cache.set("a", PipelineShapeCache::Entry());
+    cache.set("b", PipelineShapeCache::Entry());
+
+    cache.remove("a");
+    cache.remove("missing");
+    ASSERT_FALSE(cache.get("a"));
+    ASSERT_EQ(cache.size(), 1UL);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0UL);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -54,6 +54,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/fail_point_service.h"
@@ -232,6 +233,12 @@ PlanExecutorImpl::PlanExecutorImpl(OperationContext* opCtx,
       _nss(std::move(nss)),
       // There's no point in yielding if the collection doesn't exist.
       _yieldPolicy(makeYieldPolicy(this, collection ? yieldPolicy : NO_YIELD)) {
+    // Only read-only plans are worked in batches. Update and delete plans must apply each write
+    // before the next document is produced, so they keep working one result at a time.
+    _canWorkInBatches = _cq && !_cq->getQueryRequest().isTailable() &&
+        _yieldPolicy->getPolicy() == YIELD_AUTO && !getStageByType(_root.get(), STAGE_UPDATE) &&
+        !getStageByType(_root.get(), STAGE_DELETE);
+
     // We may still need to initialize _nss from either collection or _cq.
     if (!_nss.isEmpty()) {
         return;  // We already have an _nss set, so there's nothing more to do.
@@ -470,6 +477,48 @@ PlanExecutor::ExecState PlanExecutorImpl::_waitForInserts(CappedInsertNotifierDa
     return FAILURE;
 }
 
+PlanStage::StageState PlanExecutorImpl::_workRoot(WorkingSetID* out) {
+    if (_nextBatchedResult < _batchedResults.size()) {
+        *out = _batchedResults[_nextBatchedResult++];
+        return PlanStage::ADVANCED;
+    }
+
+    if (_pendingBatchState) {
+        auto state = _pendingBatchState->first;
+        *out = _pendingBatchState->second;
+        _pendingBatchState = boost::none;
+        return state;
+    }
+
+    const int batchSize = internalQueryExecWorkBatchSize.load();
+    if (!_canWorkInBatches || batchSize <= 1 || _nss.isOplog()) {
+        return _root->work(out);
+    }
+
+    _batchedResults.clear();
+    _nextBatchedResult = 0;
+    WorkingSetID terminalId = WorkingSet::INVALID_ID;
+    PlanStage::StageState state =
+        _root->workBatch(_workingSet.get(), batchSize, &_batchedResults, &terminalId);
+
+    if (PlanStage::ADVANCED != state && PlanStage::NEED_TIME != state) {
+        _pendingBatchState = std::make_pair(state, terminalId);
+    }
+
+    if (_nextBatchedResult < _batchedResults.size()) {
+        *out = _batchedResults[_nextBatchedResult++];
+        return PlanStage::ADVANCED;
+    }
+
+    // The batch produced no results, so report its final state directly.
+    if (_pendingBatchState) {
+        _pendingBatchState = boost::none;
+        *out = terminalId;
+        return state;
+    }
+    return PlanStage::NEED_TIME;
+}
+
 PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<BSONObj>* objOut,
                                                        RecordId* dlOut) {
     if (MONGO_FAIL_POINT(planExecutorAlwaysFails)) {
@@ -526,7 +575,7 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<BSONObj>* obj
         }
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = _workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -616,7 +665,9 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<BSONObj>* obj
 
 bool PlanExecutorImpl::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _nextBatchedResult == _batchedResults.size() && !_pendingBatchState &&
+         _root->isEOF());
 }
 
 void PlanExecutorImpl::markAsKilled(Status killStatus) {
@@ -32,6 +32,7 @@
 #include <boost/optional.hpp>
 #include <queue>
 
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/plan_executor.h"
 
 namespace mongo {
@@ -142,6 +143,13 @@ private:
     ExecState _waitForInserts(CappedInsertNotifierData* notifierData,
                               Snapshotted<BSONObj>* errorObj);
 
+    /**
+     * Returns the next result or state of the plan to _getNextImpl(), with the same semantics as
+     * PlanStage::work(). When working the plan in batches is permitted, results are requested
+     * from the root stage through PlanStage::workBatch() and buffered until consumed.
+     */
+    PlanStage::StageState _workRoot(WorkingSetID* out);
+
     /**
      * Common implementation for getNext() and getNextSnapshotted().
      */
@@ -173,6 +181,20 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // True if this plan may be worked in batches. This is only the case for read-only plans which
+    // serve a find or aggregate over a regular collection, since batching reads ahead of the
+    // results returned to the caller.
+    bool _canWorkInBatches = false;
+
+    // Results produced by the last call to PlanStage::workBatch() on the root stage. The ones at
+    // and after '_nextBatchedResult' have yet to be returned by _workRoot().
+    std::vector<WorkingSetID> _batchedResults;
+    size_t _nextBatchedResult = 0;
+
+    // The state which ended the last batch, if it was neither ADVANCED nor NEED_TIME. It is
+    // reported by _workRoot() once all of the results from that batch have been consumed.
+    boost::optional<std::pair<PlanStage::StageState, WorkingSetID>> _pendingBatchState;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     bool _everDetachedFromOperationContext = false;
@@ -50,6 +50,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/util/log.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
 
@@ -196,6 +197,61 @@ std::pair<boost::optional<Timestamp>, boost::optional<Timestamp>> extractTsRange
     }
 }
 
+/**
+ * Extracts the RecordId bounds of a clustered collection from the comparisons of _id against a
+ * 32 or 64-bit integer in 'me', at the top level or inside a top-level $and. The bounds are
+ * inclusive, so the filter must still be applied to the documents within them.
+ */
+std::pair<boost::optional<RecordId>, boost::optional<RecordId>> extractClusteredIdRange(
+    const MatchExpression* me, bool topLevel = true) {
+    boost::optional<RecordId> min;
+    boost::optional<RecordId> max;
+
+    if (me->matchType() == MatchExpression::AND && topLevel) {
+        for (size_t i = 0; i < me->numChildren(); ++i) {
+            boost::optional<RecordId> childMin;
+            boost::optional<RecordId> childMax;
+            std::tie(childMin, childMax) = extractClusteredIdRange(me->getChild(i), false);
+            if (childMin && (!min || childMin.get() > min.get())) {
+                min = childMin;
+            }
+            if (childMax && (!max || childMax.get() < max.get())) {
+                max = childMax;
+            }
+        }
+        return {min, max};
+    }
+
+    if (!ComparisonMatchExpression::isComparisonMatchExpression(me) || me->path() != "_id") {
+        return {min, max};
+    }
+
+    // Values that cannot be a clustered _id, such as zero or negative numbers, leave that side
+    // of the range open.
+    auto rawElem = static_cast<const ComparisonMatchExpression*>(me)->getData();
+    auto swKey = clustered_id::keyForId(rawElem);
+    if (!swKey.isOK()) {
+        return {min, max};
+    }
+
+    switch (me->matchType()) {
+        case MatchExpression::EQ:
+            min = swKey.getValue();
+            max = swKey.getValue();
+            return {min, max};
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            min = swKey.getValue();
+            return {min, max};
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+            max = swKey.getValue();
+            return {min, max};
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
 /**
  * Returns true if 'me' is a GTE or GE predicate over the "ts" field.
  */
@@ -254,6 +310,11 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         }
     }
 
+    if ((params.options & QueryPlannerParams::CLUSTERED_COLLECTION) && csn->direction == 1 &&
+        !tailable) {
+        std::tie(csn->minRecord, csn->maxRecord) = extractClusteredIdRange(query.root());
+    }
+
     return std::move(csn);
 }
 
@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/query_planner.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -135,6 +136,9 @@ string optionString(size_t options) {
             case QueryPlannerParams::STRICT_DISTINCT_ONLY:
                 ss << "STRICT_DISTINCT_ONLY ";
                 break;
+            case QueryPlannerParams::CLUSTERED_COLLECTION:
+                ss << "CLUSTERED_COLLECTION ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -294,6 +298,83 @@ bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
 
+/**
+ * Records on each index scan in the tree rooted at 'node' the number of keys it is expected to
+ * examine, according to the statistics in 'params'. Only the bounds on the leading field of the
+ * index are taken into account, so for compound indexes this is an upper bound.
+ *
+ * Returns the total for the tree, or boost::none if any of its leaves is not an index scan with
+ * statistics.
+ */
+static boost::optional<double> estimateKeysExamined(QuerySolutionNode* node,
+                                                    const QueryPlannerParams& params) {
+    if (STAGE_IXSCAN == node->getType()) {
+        IndexScanNode* ixn = static_cast<IndexScanNode*>(node);
+        auto it = params.indexStatistics.find(ixn->index.identifier.catalogName);
+        if (it == params.indexStatistics.end() || ixn->bounds.isSimpleRange ||
+            ixn->bounds.fields.empty()) {
+            return boost::none;
+        }
+        ixn->estimatedKeysExamined = it->second->estimateKeys(ixn->bounds.fields[0]);
+        return ixn->estimatedKeysExamined;
+    }
+
+    if (node->children.empty()) {
+        return boost::none;
+    }
+
+    boost::optional<double> keys = 0.0;
+    for (auto&& child : node->children) {
+        auto childKeys = estimateKeysExamined(child, params);
+        if (keys && childKeys) {
+            *keys += *childKeys;
+        } else {
+            keys = boost::none;
+        }
+    }
+    return keys;
+}
+
+/**
+ * Orders the indexed solutions in 'out' by the number of keys they are expected to examine,
+ * cheapest first, so that the multi-planner breaks ties between equally productive candidates in
+ * favour of the one the statistics expect to be cheaper. No solution is dropped, since the
+ * estimates only take the leading field of each index into account. Solutions are only reordered
+ * when all of them can be costed, and when the query has no sort or limit, which could let a
+ * solution stop long before it has examined the keys within its bounds.
+ */
+static void orderByIndexStatistics(const CanonicalQuery& query,
+                                   const QueryPlannerParams& params,
+                                   std::vector<std::unique_ptr<QuerySolution>>* out) {
+    if (params.indexStatistics.empty() || out->empty()) {
+        return;
+    }
+
+    std::vector<std::pair<double, std::unique_ptr<QuerySolution>>> costed;
+    bool allCosted = true;
+    for (auto&& soln : *out) {
+        auto keys = estimateKeysExamined(soln->root.get(), params);
+        allCosted = allCosted && keys;
+        costed.emplace_back(keys.value_or(0.0), nullptr);
+    }
+
+    const auto& qr = query.getQueryRequest();
+    if (out->size() < 2 || !qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn() ||
+        !allCosted) {
+        return;
+    }
+
+    for (size_t i = 0; i < out->size(); ++i) {
+        costed[i].second = std::move((*out)[i]);
+    }
+    std::stable_sort(costed.begin(), costed.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+    for (size_t i = 0; i < out->size(); ++i) {
+        (*out)[i] = std::move(costed[i].second);
+    }
+}
+
 // static
 const int QueryPlanner::kPlannerVersion = 1;
 
@@ -986,6 +1067,8 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
+    orderByIndexStatistics(query, params, &out);
+
     // geoNear and text queries *require* an index.
     // Also, if a hint is specified it indicates that we MUST use it.
     bool possibleToCollscan =
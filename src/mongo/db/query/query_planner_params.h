@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_entry.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -98,6 +101,10 @@ struct QueryPlannerParams {
         // return exactly one document per value of the distinct field. See the comments above the
         // declaration of getExecutorDistinct() for more detail.
         STRICT_DISTINCT_ONLY = 1 << 11,
+
+        // Set this if the collection is clustered, so that forward collection scans can be bounded
+        // by the RecordIds derived from predicates on _id.
+        CLUSTERED_COLLECTION = 1 << 12,
     };
 
     // See Options enum above.
@@ -106,6 +113,10 @@ struct QueryPlannerParams {
     // What indices are available for planning?
     std::vector<IndexEntry> indices;
 
+    // The statistics of the indices which have any, by index name. If every indexed solution can
+    // be costed with them, the solutions are output from cheapest to most expensive.
+    StringMap<std::shared_ptr<const IndexStatistics>> indexStatistics;
+
     // What's our shard key?  If INCLUDE_SHARD_FILTER is set we will create a shard filtering
     // stage.  If we know the shard key, we can perform covering analysis instead of always
     // forcing a fetch.
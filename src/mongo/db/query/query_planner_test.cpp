@@ -37,8 +37,10 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_always_boolean.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/db/query/query_planner_test_lib.h"
 
 namespace {
 
@@ -62,6 +64,23 @@ IndexEntry buildSimpleIndexEntry(const BSONObj& kp, const std::string& indexName
             nullptr};
 }
 
+/**
+ * Make the statistics of an index on a single field with 'numValues' distinct values, each with
+ * 'keysPerValue' keys.
+ */
+std::shared_ptr<const IndexStatistics> buildIndexStatistics(const BSONObj& kp,
+                                                            int numValues,
+                                                            int keysPerValue) {
+    IndexStatisticsBuilder builder(kp, numValues * keysPerValue);
+    for (int value = 0; value < numValues; ++value) {
+        for (int i = 0; i < keysPerValue; ++i) {
+            builder.addKey(BSON("" << value));
+        }
+    }
+    const long long numKeys = numValues * keysPerValue;
+    return builder.done(IndexStatistics::Source::kIndexBuild, numKeys, numKeys);
+}
+
 TEST_F(QueryPlannerTest, PlannerUsesCoveredIxscanForCountWhenIndexSatisfiesQuery) {
     params.options = QueryPlannerParams::IS_COUNT;
     addIndex(BSON("x" << 1));
@@ -5983,4 +6002,124 @@ TEST_F(QueryPlannerTest, FetchAfterSortWhenOnlyProjectNeedsDocuments) {
         "{sortKeyGen:{node: {ixscan: "
         "{pattern: {a: 1, b: 1}}}}}}}}}}}");
 }
+TEST_F(QueryPlannerTest, IndexStatisticsOrderSolutionsByEstimatedKeysExamined) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1), nullptr, "a_1"_sd);
+    addIndex(BSON("b" << 1), nullptr, "b_1"_sd);
+    params.indexStatistics["a_1"] = buildIndexStatistics(BSON("a" << 1), 1, 10000);
+    params.indexStatistics["b_1"] = buildIndexStatistics(BSON("b" << 1), 10000, 1);
+
+    runQuery(fromjson("{a: 0, b: 5}"));
+
+    assertNumSolutions(2U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {a: 0}, node: {ixscan: {pattern: {b: 1}}}}}", solns[0]->root.get()));
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1}}}}}", solns[1]->root.get()));
+}
+
+TEST_F(QueryPlannerTest, IndexStatisticsOrderSolutionsWhenLeadingIndexIsCheaper) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1), nullptr, "a_1"_sd);
+    addIndex(BSON("b" << 1), nullptr, "b_1"_sd);
+    params.indexStatistics["a_1"] = buildIndexStatistics(BSON("a" << 1), 10000, 1);
+    params.indexStatistics["b_1"] = buildIndexStatistics(BSON("b" << 1), 1, 10000);
+
+    runQuery(fromjson("{a: 5, b: 0}"));
+
+    assertNumSolutions(2U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {b: 0}, node: {ixscan: {pattern: {a: 1}}}}}", solns[0]->root.get()));
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}", solns[1]->root.get()));
+}
+
+TEST_F(QueryPlannerTest, IndexStatisticsNeverDropSolutions) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1), nullptr, "a_1"_sd);
+    addIndex(BSON("b" << 1), nullptr, "b_1"_sd);
+    params.indexStatistics["a_1"] = buildIndexStatistics(BSON("a" << 1), 10000, 1);
+    params.indexStatistics["b_1"] = buildIndexStatistics(BSON("b" << 1), 1, 10000);
+
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {a: 5, b: 0}, sort: {b: 1}}"));
+    assertNumSolutions(2U);
+
+    runQuery(fromjson("{a: 5, b: 0}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{fetch: {filter: {b: 0}, node: {ixscan: {pattern: {a: 1}}}}}");
+    assertSolutionExists("{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, IndexStatisticsKeepAllSolutionsWhenAnIndexHasNone) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1), nullptr, "a_1"_sd);
+    addIndex(BSON("b" << 1), nullptr, "b_1"_sd);
+    params.indexStatistics["b_1"] = buildIndexStatistics(BSON("b" << 1), 1, 10000);
+
+    runQuery(fromjson("{a: 5, b: 0}"));
+
+    assertNumSolutions(2U);
+}
+
+//
+// Clustered collections
+//
+
+const CollectionScanNode* getOnlyCollscan(
+    const std::vector<std::unique_ptr<QuerySolution>>& solns) {
+    ASSERT_EQ(1U, solns.size());
+    ASSERT_EQ(STAGE_COLLSCAN, solns[0]->root->getType());
+    return static_cast<const CollectionScanNode*>(solns[0]->root.get());
+}
+
+TEST_F(QueryPlannerTest, ClusteredCollectionScanBoundedByIdEquality) {
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    runQuery(fromjson("{_id: 5}"));
+
+    auto csn = getOnlyCollscan(solns);
+    ASSERT(csn->minRecord);
+    ASSERT(csn->maxRecord);
+    ASSERT_EQ(RecordId(5), *csn->minRecord);
+    ASSERT_EQ(RecordId(5), *csn->maxRecord);
+    assertSolutionExists("{cscan: {dir: 1, filter: {_id: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, ClusteredCollectionScanBoundedByIdRange) {
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    runQuery(fromjson("{_id: {$gt: 5, $lte: NumberLong(20)}, a: 1}"));
+
+    auto csn = getOnlyCollscan(solns);
+    ASSERT(csn->minRecord);
+    ASSERT(csn->maxRecord);
+    ASSERT_EQ(RecordId(5), *csn->minRecord);
+    ASSERT_EQ(RecordId(20), *csn->maxRecord);
+}
+
+TEST_F(QueryPlannerTest, ClusteredCollectionScanNotBoundedByNonIntegerId) {
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    runQuery(fromjson("{_id: {$gte: 0, $lt: 'a'}}"));
+
+    auto csn = getOnlyCollscan(solns);
+    ASSERT_FALSE(csn->minRecord);
+    ASSERT_FALSE(csn->maxRecord);
+}
+
+TEST_F(QueryPlannerTest, CollectionScanNotBoundedByIdUnlessClustered) {
+    runQuery(fromjson("{_id: 5}"));
+
+    auto csn = getOnlyCollscan(solns);
+    ASSERT_FALSE(csn->minRecord);
+    ASSERT_FALSE(csn->maxRecord);
+}
+
+TEST_F(QueryPlannerTest, BackwardClusteredCollectionScanNotBounded) {
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    runQuerySortProj(fromjson("{_id: 5}"), fromjson("{$natural: -1}"), BSONObj());
+
+    auto csn = getOnlyCollscan(solns);
+    ASSERT_EQ(-1, csn->direction);
+    ASSERT_FALSE(csn->minRecord);
+    ASSERT_FALSE(csn->maxRecord);
+}
+
 }  // namespace
@@ -64,6 +64,8 @@ const string QueryRequest::metaSortKey("sortKey");
 const string QueryRequest::metaTextScore("textScore");
 
 const string QueryRequest::kAllowDiskUseField("allowDiskUse");
+const string QueryRequest::kParallelismField("parallelism");
+constexpr int QueryRequest::kMaxParallelism;
 
 const long long QueryRequest::kDefaultBatchSize = 101;
 
@@ -248,6 +250,15 @@ StatusWith<unique_ptr<QueryRequest>> QueryRequest::parseFromFindCommand(unique_p
             }
 
             qr->_batchSize = el.numberLong();
+        } else if (fieldName == kParallelismField) {
+            if (!el.isNumber()) {
+                str::stream ss;
+                ss << "Failed to parse: " << cmdObj.toString() << ". "
+                   << "'parallelism' field must be numeric.";
+                return Status(ErrorCodes::FailedToParse, ss);
+            }
+
+            qr->_parallelism = el.numberLong();
         } else if (fieldName == kNToReturnField) {
             if (!el.isNumber()) {
                 str::stream ss;
@@ -510,6 +521,10 @@ void QueryRequest::asFindCommandInternal(BSONObjBuilder* cmdBuilder) const {
         cmdBuilder->append(kAllowDiskUseField, true);
     }
 
+    if (_parallelism) {
+        cmdBuilder->append(kParallelismField, *_parallelism);
+    }
+
     if (_batchSize) {
         cmdBuilder->append(kBatchSizeField, *_batchSize);
     }
@@ -671,6 +686,12 @@ Status QueryRequest::validate() const {
                           << "BatchSize value must be non-negative, but received: " << *_batchSize);
     }
 
+    if (_parallelism && (*_parallelism < 1 || *_parallelism > kMaxParallelism)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Parallelism value must be between 1 and "
+                                    << kMaxParallelism << ", but received: " << *_parallelism);
+    }
+
     if (_ntoreturn && *_ntoreturn < 0) {
         return Status(ErrorCodes::BadValue,
                       str::stream()
@@ -1150,6 +1171,9 @@ StatusWith<BSONObj> QueryRequest::asAggregationCommand() const {
     if (_allowDiskUse) {
         aggregationBuilder.append(QueryRequest::kAllowDiskUseField, _allowDiskUse);
     }
+    if (_parallelism) {
+        aggregationBuilder.append(QueryRequest::kParallelismField, *_parallelism);
+    }
     if (_runtimeConstants) {
         BSONObjBuilder rtcBuilder(aggregationBuilder.subobjStart(kRuntimeConstantsField));
         _runtimeConstants->serialize(&rtcBuilder);
@@ -143,6 +143,11 @@ public:
     // Allow using disk during the find command.
     static const std::string kAllowDiskUseField;
 
+    // The number of workers the query may use to scan a collection, overriding the default set by
+    // 'internalQueryParallelCollectionScanWorkers'.
+    static const std::string kParallelismField;
+    static constexpr int kMaxParallelism = 64;
+
     const NamespaceString& nss() const {
         invariant(!_nss.isEmpty());
         return _nss;
@@ -252,6 +257,14 @@ public:
         _allowDiskUse = allowDiskUse;
     }
 
+    boost::optional<long long> getParallelism() const {
+        return _parallelism;
+    }
+
+    void setParallelism(boost::optional<long long> parallelism) {
+        _parallelism = parallelism;
+    }
+
     bool isExplain() const {
         return _explain;
     }
@@ -517,6 +530,10 @@ private:
 
     bool _allowDiskUse = false;
 
+    // Must be either unset or between 1 and 'kMaxParallelism'. A parallelism of 1 keeps the query
+    // on the thread of its operation.
+    boost::optional<long long> _parallelism;
+
     // Set only when parsed from an OP_QUERY find message. The value is computed by driver or shell
     // and is set to be a min of batchSize and limit provided by user. QR can have set either
     // ntoreturn or batchSize / limit.
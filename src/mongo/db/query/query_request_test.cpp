@@ -897,6 +897,41 @@ TEST(QueryRequestTest, ParseFromCommandBatchSizeZero) {
     ASSERT(!qr->getLimit());
 }
 
+TEST(QueryRequestTest, ParseFromCommandParallelism) {
+    BSONObj cmdObj = fromjson("{find: 'testns', parallelism: 4}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    unique_ptr<QueryRequest> qr(
+        assertGet(QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain)));
+
+    ASSERT(qr->getParallelism());
+    ASSERT_EQ(4, *qr->getParallelism());
+
+    BSONObjBuilder bob;
+    qr->asFindCommand(&bob);
+    ASSERT_BSONOBJ_EQ(cmdObj, bob.obj());
+}
+
+TEST(QueryRequestTest, ParseFromCommandParallelismOutOfRangeError) {
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    for (auto parallelism : {0LL, -1LL, 65LL, 1LL << 32}) {
+        BSONObj cmdObj = BSON("find"
+                              << "testns"
+                              << "parallelism" << parallelism);
+        auto result = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+        ASSERT_EQ(ErrorCodes::BadValue, result.getStatus());
+    }
+}
+
+TEST(QueryRequestTest, ParseFromCommandNonNumericParallelismError) {
+    BSONObj cmdObj = fromjson("{find: 'testns', parallelism: 'four'}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    auto result = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+    ASSERT_EQ(ErrorCodes::FailedToParse, result.getStatus());
+}
+
 TEST(QueryRequestTest, ParseFromCommandDefaultBatchSize) {
     BSONObj cmdObj = fromjson("{find: 'testns'}");
     const NamespaceString nss("test.testns");
@@ -1441,6 +1476,18 @@ TEST(QueryRequestTest, ConvertToAggregationWithAllowDiskUseTrueSucceeds) {
     ASSERT_EQ(true, ar.getValue().shouldAllowDiskUse());
 }
 
+TEST(QueryRequestTest, ConvertToAggregationWithParallelismSucceeds) {
+    QueryRequest qr(testns);
+    qr.setParallelism(8);
+    const auto aggCmd = qr.asAggregationCommand();
+    ASSERT_OK(aggCmd.getStatus());
+
+    auto ar = AggregationRequest::parseFromBSON(testns, aggCmd.getValue());
+    ASSERT_OK(ar.getStatus());
+    ASSERT(ar.getValue().getParallelism());
+    ASSERT_EQ(8, *ar.getValue().getParallelism());
+}
+
 TEST(QueryRequestTest, ConvertToAggregationWithAllowDiskUseFalseSucceeds) {
     QueryRequest qr(testns);
     qr.setAllowDiskUse(false);
@@ -233,6 +233,11 @@ void CollectionScanNode::appendToString(str::stream* ss, int indent) const {
     *ss << "COLLSCAN\n";
     addIndent(ss, indent + 1);
     *ss << "ns = " << name << '\n';
+    if (minRecord || maxRecord) {
+        addIndent(ss, indent + 1);
+        *ss << "recordBounds = [" << (minRecord ? minRecord->toString() : "MinKey") << ", "
+            << (maxRecord ? maxRecord->toString() : "MaxKey") << "]\n";
+    }
     if (nullptr != filter) {
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->debugString();
@@ -250,6 +255,8 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->direction = this->direction;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->minRecord = this->minRecord;
+    copy->maxRecord = this->maxRecord;
 
     return copy;
 }
@@ -537,6 +544,10 @@ void IndexScanNode::appendToString(str::stream* ss, int indent) const {
     *ss << "direction = " << direction << '\n';
     addIndent(ss, indent + 1);
     *ss << "bounds = " << bounds.toString() << '\n';
+    if (estimatedKeysExamined) {
+        addIndent(ss, indent + 1);
+        *ss << "estimatedKeysExamined = " << *estimatedKeysExamined << '\n';
+    }
     addCommon(ss, indent);
 }
 
@@ -823,6 +834,7 @@ QuerySolutionNode* IndexScanNode::clone() const {
     copy->addKeyMetadata = this->addKeyMetadata;
     copy->bounds = this->bounds;
     copy->queryCollator = this->queryCollator;
+    copy->estimatedKeysExamined = this->estimatedKeysExamined;
 
     return copy;
 }
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 
 #include "mongo/base/string_data.h"
@@ -328,6 +329,11 @@ struct CollectionScanNode : public QuerySolutionNode {
     // forward oplog scans.
     boost::optional<Timestamp> maxTs;
 
+    // If present, the collection scan is bounded to this range of RecordIds. Should only be set on
+    // forward scans of clustered collections.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+
     // Should we make a tailable cursor?
     bool tailable;
 
@@ -533,6 +539,10 @@ struct IndexScanNode : public QuerySolutionNode {
 
     const CollatorInterface* queryCollator;
 
+    // The number of keys the scan is expected to examine, according to the index's statistics.
+    // Not set if the index has no statistics.
+    boost::optional<double> estimatedKeysExamined;
+
     // The set of paths in the index key pattern which have at least one multikey path component, or
     // empty if the index either is not multikey or does not have path-level multikeyness metadata.
     //
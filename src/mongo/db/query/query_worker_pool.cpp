@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_worker_pool.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker_noop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace {
+
+// Set on the threads of every QueryWorkerPool.
+thread_local bool isQueryWorkerThread = false;
+
+const auto getQueryWorkerPool =
+    ServiceContext::declareDecoration<std::unique_ptr<QueryWorkerPool>>();
+
+ServiceContext::ConstructorActionRegisterer queryWorkerPoolRegisterer{
+    "QueryWorkerPool",
+    [](ServiceContext* service) {
+        getQueryWorkerPool(service) = std::make_unique<QueryWorkerPool>();
+    },
+    [](ServiceContext* service) {
+        if (auto& pool = getQueryWorkerPool(service)) {
+            pool->shutdown();
+        }
+    }};
+
+ThreadPool::Options makeThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "QueryWorkerPool";
+    options.threadNamePrefix = "QueryWorker-";
+    options.minThreads = 0;
+    options.maxThreads = static_cast<size_t>(internalQueryWorkerPoolMaxThreads);
+    options.onCreateThread = [](const std::string&) { isQueryWorkerThread = true; };
+    return options;
+}
+
+}  // namespace
+
+QueryWorkerPool::QueryWorkerPool() : _pool(makeThreadPoolOptions()) {
+    _pool.startup();
+}
+
+QueryWorkerPool* QueryWorkerPool::get(ServiceContext* serviceContext) {
+    return getQueryWorkerPool(serviceContext).get();
+}
+
+ServiceContext::UniqueOperationContext QueryWorkerPool::makeWorkerOperationContext(
+    OperationContext* opCtx, Client* workerClient) {
+    auto workerOpCtx = workerClient->makeOperationContext();
+    workerOpCtx->swapLockState(std::make_unique<LockerNoop>());
+
+    auto recoveryUnit = opCtx->recoveryUnit();
+    auto workerRecoveryUnit = workerOpCtx->recoveryUnit();
+    const auto readSource = recoveryUnit->getTimestampReadSource();
+    if (readSource == RecoveryUnit::ReadSource::kProvided) {
+        workerRecoveryUnit->setTimestampReadSource(readSource,
+                                                   recoveryUnit->getPointInTimeReadTimestamp());
+    } else if (readSource != RecoveryUnit::ReadSource::kUnset) {
+        workerRecoveryUnit->setTimestampReadSource(readSource);
+    }
+    workerRecoveryUnit->setPrepareConflictBehavior(recoveryUnit->getPrepareConflictBehavior());
+    return workerOpCtx;
+}
+
+void QueryWorkerPool::runAll(std::vector<Task> tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+
+    if (isQueryWorkerThread) {
+        for (auto&& task : tasks) {
+            task();
+        }
+        return;
+    }
+
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t numPending = tasks.size() - 1;
+
+    for (size_t i = 1; i < tasks.size(); ++i) {
+        _pool.schedule([&, task = std::move(tasks[i])](Status status) mutable {
+            // The pool only rejects tasks once it has been shut down, in which case we still run
+            // the task on the pool's behalf so that the caller observes every task as completed.
+            task();
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (--numPending == 0) {
+                allDone.notify_one();
+            }
+        });
+    }
+
+    tasks[0]();
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    allDone.wait(lk, [&] { return numPending == 0; });
+}
+
+void QueryWorkerPool::shutdown() {
+    _pool.shutdown();
+    _pool.join();
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/functional.h"
+
+namespace mongo {
+
+/**
+ * A process-wide pool of threads used to execute parts of a single query concurrently, such as the
+ * workers of a parallel collection scan. The pool is shared by all queries and is bounded by the
+ * 'internalQueryWorkerPoolMaxThreads' server parameter; when all of its threads are busy, tasks
+ * queue until a thread becomes available.
+ *
+ * Threads of the pool do not have a Client. Tasks which need one, for instance to create an
+ * OperationContext, must bind their own using an AlternativeClientRegion.
+ */
+class QueryWorkerPool {
+    QueryWorkerPool(const QueryWorkerPool&) = delete;
+    QueryWorkerPool& operator=(const QueryWorkerPool&) = delete;
+
+public:
+    using Task = unique_function<void()>;
+
+    QueryWorkerPool();
+
+    static QueryWorkerPool* get(ServiceContext* serviceContext);
+
+    /**
+     * Makes an OperationContext on 'workerClient' for a task which works on behalf of 'opCtx'. It
+     * takes no locks, borrowing those of 'opCtx' instead, which must hold them for as long as the
+     * task runs. It reads from the same point in time as 'opCtx' if that reads at a timestamp.
+     * The worker shows up in serverStatus as an inactive client and is left out of lockInfo.
+     */
+    static ServiceContext::UniqueOperationContext makeWorkerOperationContext(
+        OperationContext* opCtx, Client* workerClient);
+
+    /**
+     * Runs every task in 'tasks' and blocks until all of them have completed. The first task is
+     * run on the calling thread and the rest on threads of the pool. Tasks must not throw.
+     *
+     * When called from a thread of the pool, runs every task on the calling thread instead, so that
+     * tasks waiting for other tasks cannot occupy every thread of the pool.
+     */
+    void runAll(std::vector<Task> tasks);
+
+    /**
+     * Shuts down the pool, waiting for any tasks which are running to complete.
+     */
+    void shutdown();
+
+private:
+    ThreadPool _pool;
+};
+
+}  // namespace mongo
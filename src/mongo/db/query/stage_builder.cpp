@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/stage_builder.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/merge_sort.h"
 #include "mongo/db/exec/or.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/skip.h"
@@ -58,7 +60,10 @@
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/util/log.h"
@@ -67,6 +72,68 @@ namespace mongo {
 
 using std::unique_ptr;
 
+namespace {
+
+/**
+ * Returns the number of workers with which the collection scan described by 'csn' should be
+ * executed, or 1 if it should be executed by a regular CollectionScan. The query's 'parallelism'
+ * option, if any, takes the place of 'internalQueryParallelCollectionScanWorkers'.
+ *
+ * A parallel scan returns documents in no particular order and reads each range of the collection
+ * in its own snapshot, so it is only used for forward scans whose order does not matter, by
+ * operations which may observe several snapshots over their lifetime anyway.
+ */
+size_t chooseCollectionScanParallelism(OperationContext* opCtx,
+                                       const Collection* collection,
+                                       const CanonicalQuery& cq,
+                                       const CollectionScanNode* csn) {
+    const auto& qr = cq.getQueryRequest();
+    const size_t numWorkers =
+        qr.getParallelism().value_or(internalQueryParallelCollectionScanWorkers.load());
+    if (numWorkers <= 1 || !collection) {
+        return 1;
+    }
+
+    if (csn->tailable || csn->direction != 1 || csn->minTs || csn->maxTs || csn->minRecord ||
+        csn->maxRecord || csn->shouldTrackLatestOplogTimestamp ||
+        csn->shouldWaitForOplogVisibility || csn->stopApplyingFilterAfterFirstMatch) {
+        return 1;
+    }
+
+    if (qr.getSort().hasField("$natural") || qr.getHint().hasField("$natural") ||
+        qr.getLimit() || qr.getNToReturn() || qr.isOplogReplay()) {
+        return 1;
+    }
+
+    if (collection->isCapped() || collection->ns().isOplog() ||
+        !collection->getRecordStore()->supportsSeekAtOrPast()) {
+        return 1;
+    }
+
+    // Multi-document transactions and other operations running inside a write unit of work must
+    // read from a single snapshot.
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        return 1;
+    }
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return 1;
+    }
+
+    if (csn->filter && !expression::canMatchConcurrently(csn->filter.get())) {
+        return 1;
+    }
+
+    if (collection->numRecords(opCtx) < internalQueryParallelCollectionScanMinRecords.load()) {
+        return 1;
+    }
+
+    return numWorkers;
+}
+
+}  // namespace
+
 PlanStage* buildStages(OperationContext* opCtx,
                        const Collection* collection,
                        const CanonicalQuery& cq,
@@ -76,6 +143,13 @@ PlanStage* buildStages(OperationContext* opCtx,
     switch (root->getType()) {
         case STAGE_COLLSCAN: {
             const CollectionScanNode* csn = static_cast<const CollectionScanNode*>(root);
+            const size_t parallelism =
+                chooseCollectionScanParallelism(opCtx, collection, cq, csn);
+            if (parallelism > 1) {
+                return new ParallelCollectionScan(
+                    opCtx, collection, parallelism, ws, csn->filter.get());
+            }
+
             CollectionScanParams params;
             params.tailable = csn->tailable;
             params.shouldTrackLatestOplogTimestamp = csn->shouldTrackLatestOplogTimestamp;
@@ -84,6 +158,8 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
             params.minTs = csn->minTs;
             params.maxTs = csn->maxTs;
+            params.minRecord = csn->minRecord;
+            params.maxRecord = csn->maxRecord;
             params.stopApplyingFilterAfterFirstMatch = csn->stopApplyingFilterAfterFirstMatch;
             return new CollectionScan(opCtx, collection, params, ws, csn->filter.get());
         }
@@ -113,6 +189,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = ixn->direction;
             params.addKeyMetadata = ixn->addKeyMetadata;
             params.shouldDedup = ixn->shouldDedup;
+            params.estimatedKeysExamined = ixn->estimatedKeysExamined;
             return new IndexScan(opCtx, std::move(params), ws, ixn->filter.get());
         }
         case STAGE_FETCH: {
@@ -121,7 +198,25 @@ PlanStage* buildStages(OperationContext* opCtx,
             if (nullptr == childStage) {
                 return nullptr;
             }
-            return new FetchStage(opCtx, ws, childStage, fn->filter.get(), collection);
+            if (STAGE_AND_HASH == childStage->stageType()) {
+                // The fetch needs only the record ids of the intersection.
+                static_cast<AndHashStage*>(childStage)->allowRecordIdIntersection();
+            }
+            auto fetchStage = new FetchStage(opCtx, ws, childStage, fn->filter.get(), collection);
+            if (STAGE_IXSCAN == childStage->stageType()) {
+                size_t batchSize = internalQueryFetchBatchSize.load();
+
+                // Don't read further ahead in the index than a limited query can return.
+                const auto& qr = cq.getQueryRequest();
+                if (qr.getLimit()) {
+                    batchSize = std::min(
+                        batchSize, static_cast<size_t>(*qr.getLimit() + qr.getSkip().value_or(0)));
+                }
+                if (batchSize > 1) {
+                    fetchStage->setBatchSize(batchSize, !qr.getSort().isEmpty());
+                }
+            }
+            return fetchStage;
         }
         case STAGE_SORT: {
             const SortNode* sn = static_cast<const SortNode*>(root);
@@ -376,6 +471,7 @@ PlanStage* buildStages(OperationContext* opCtx,
         }
         case STAGE_CACHED_PLAN:
         case STAGE_CHANGE_STREAM_PROXY:
+        case STAGE_COLUMN_SCAN:
         case STAGE_COUNT:
         case STAGE_DELETE:
         case STAGE_EOF:
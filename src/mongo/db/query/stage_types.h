@@ -40,6 +40,10 @@ enum StageType {
     STAGE_CACHED_PLAN,
     STAGE_COLLSCAN,
 
+    // Reassembles documents from the columns of a columnstore index, reading only the columns
+    // needed by an aggregation.
+    STAGE_COLUMN_SCAN,
+
     // This stage sits at the root of the query tree and counts up the number of results
     // returned by its child.
     STAGE_COUNT,
@@ -76,6 +80,9 @@ enum StageType {
     STAGE_MULTI_PLAN,
     STAGE_OR,
 
+    // Scans ranges of a collection concurrently on several threads.
+    STAGE_PARALLEL_COLLSCAN,
+
     // Projection has three alternate implementations.
     STAGE_PROJECTION_DEFAULT,
     STAGE_PROJECTION_COVERED,
@@ -37,12 +37,21 @@
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -74,12 +83,21 @@ AbstractOplogFetcher::AbstractOplogFetcher(executor::TaskExecutor* executor,
       _nss(nss),
       _maxFetcherRestarts(maxFetcherRestarts),
       _onShutdownCallbackFn(onShutdownCallbackFn),
-      _lastFetched(lastFetched) {
+      _lastFetched(lastFetched),
+      _createClientFn([] { return std::make_unique<DBClientConnection>(); }) {
 
     invariant(!_lastFetched.isNull());
     invariant(onShutdownCallbackFn);
 }
 
+AbstractOplogFetcher::~AbstractOplogFetcher() {
+    // The stream thread calls _finishCallback() as its last action, so joining here only waits for
+    // it to return.
+    if (_streamThread.joinable()) {
+        _streamThread.join();
+    }
+}
+
 Milliseconds AbstractOplogFetcher::_getInitialFindMaxTime() const {
     return Milliseconds(oplogInitialFindMaxSeconds.load() * 1000);
 }
@@ -92,6 +110,10 @@ Milliseconds AbstractOplogFetcher::_getGetMoreMaxTime() const {
     return kDefaultOplogGetMoreMaxMS;
 }
 
+bool AbstractOplogFetcher::_usesExhaust() const {
+    return false;
+}
+
 std::string AbstractOplogFetcher::toString() const {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     str::stream msg;
@@ -112,6 +134,12 @@ void AbstractOplogFetcher::_makeAndScheduleFetcherCallback(
         return;
     }
 
+    if (_usesExhaust()) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _streamThread = stdx::thread([this] { _runStream(); });
+        return;
+    }
+
     BSONObj findCommandObj =
         _makeFindCommandObject(_nss, _getLastOpTimeFetched(), _getInitialFindMaxTime());
     BSONObj metadataObj = _makeMetadataObject();
@@ -142,6 +170,9 @@ void AbstractOplogFetcher::_doShutdown_inlock() noexcept {
     if (_fetcher) {
         _fetcher->shutdown();
     }
+    if (_streamConn) {
+        _streamConn->shutdownAndDisallowReconnect();
+    }
 }
 
 stdx::mutex* AbstractOplogFetcher::_getMutex() noexcept {
@@ -157,6 +188,11 @@ OpTime AbstractOplogFetcher::getLastOpTimeFetched_forTest() const {
     return _getLastOpTimeFetched();
 }
 
+void AbstractOplogFetcher::setCreateClientFn_forTest(const CreateClientFn& createClientFn) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _createClientFn = createClientFn;
+}
+
 OpTime AbstractOplogFetcher::_getLastOpTimeFetched() const {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     return _lastFetched;
@@ -228,22 +264,7 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
         return;
     }
 
-    // Reset fetcher restart counter on successful response.
-    {
-        stdx::lock_guard<stdx::mutex> lock(_mutex);
-        invariant(_isActive_inlock());
-        _fetcherRestarts = 0;
-    }
-
-    if (_isShuttingDown()) {
-        _finishCallback(
-            Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down"));
-        return;
-    }
-
-    // At this point we have a successful batch and can call the subclass's _onSuccessfulBatch.
-    const auto& queryResponse = result.getValue();
-    auto batchResult = _onSuccessfulBatch(queryResponse);
+    auto batchResult = _processSuccessfulBatch(result.getValue(), !getMoreBob);
     if (!batchResult.isOK()) {
         // The stopReplProducer fail point expects this to return successfully. If another fail
         // point wants this to return unsuccessfully, it should use a different error code.
@@ -261,6 +282,29 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
         return;
     }
 
+    // The _onSuccessfulBatch function returns the `getMore` command we want to send.
+    getMoreBob->appendElements(batchResult.getValue());
+}
+
+StatusWith<BSONObj> AbstractOplogFetcher::_processSuccessfulBatch(
+    const Fetcher::QueryResponse& queryResponse, bool lastBatch) {
+    // Reset fetcher restart counter on successful response.
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_isActive_inlock());
+        _fetcherRestarts = 0;
+    }
+
+    if (_isShuttingDown()) {
+        return Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+    }
+
+    // At this point we have a successful batch and can call the subclass's _onSuccessfulBatch.
+    auto batchResult = _onSuccessfulBatch(queryResponse);
+    if (!batchResult.isOK() || lastBatch) {
+        return batchResult;
+    }
+
     // We have now processed the batch and should move forward our view of _lastFetched. Note that
     // the _lastFetched value will not be updated until the _onSuccessfulBatch function is
     // completed.
@@ -268,8 +312,7 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     if (documents.size() > 0) {
         auto lastDocRes = OpTime::parseFromOplogEntry(documents.back());
         if (!lastDocRes.isOK()) {
-            _finishCallback(lastDocRes.getStatus());
-            return;
+            return lastDocRes.getStatus();
         }
         auto lastDoc = lastDocRes.getValue();
         LOG(3) << _getComponentName()
@@ -281,13 +324,156 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
 
     // Check for shutdown to save an unnecessary `getMore` request.
     if (_isShuttingDown()) {
-        _finishCallback(
-            Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down"));
+        return Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+    }
+
+    return batchResult;
+}
+
+void AbstractOplogFetcher::_runStream() {
+    Client::initThread(_getComponentName());
+    AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+    auto findMaxTime = _getInitialFindMaxTime();
+    while (true) {
+        auto streamStatus = _streamOplog(findMaxTime);
+        if (streamStatus.isOK()) {
+            return;
+        }
+
+        if (_isShuttingDown()) {
+            LOG(1) << _getComponentName() << " oplog stream cancelled to " << _getSource() << ": "
+                   << redact(streamStatus);
+            _finishCallback(
+                Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down"));
+            return;
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            if (_fetcherRestarts == _maxFetcherRestarts) {
+                log() << "Error returned from oplog stream (no more query restarts left): "
+                      << redact(streamStatus);
+            } else {
+                log() << "Restarting oplog stream due to error: " << redact(streamStatus)
+                      << ". Last fetched optime: " << _lastFetched
+                      << ". Restarts remaining: " << (_maxFetcherRestarts - _fetcherRestarts);
+                _fetcherRestarts++;
+                // Use the retry 'find' timeout for the new stream.
+                findMaxTime = _getRetriedFindMaxTime();
+                continue;
+            }
+        }
+        _finishCallback(streamStatus);
         return;
     }
+}
 
-    // The _onSuccessfulBatch function returns the `getMore` command we want to send.
-    getMoreBob->appendElements(batchResult.getValue());
+Status AbstractOplogFetcher::_streamOplog(Milliseconds findMaxTime) {
+    auto toSocketTimeout = [](Milliseconds maxTime) {
+        return durationCount<Milliseconds>(maxTime + kNetworkTimeoutBufferMS) / 1000.0;
+    };
+
+    std::shared_ptr<DBClientConnection> conn = _createClientFn();
+    conn->setSoTimeout(toSocketTimeout(findMaxTime));
+    auto connectStatus = conn->connect(_source, StringData());
+    if (!connectStatus.isOK()) {
+        return connectStatus;
+    }
+    if (!replAuthenticate(conn.get())) {
+        return Status(ErrorCodes::AuthenticationFailed,
+                      str::stream() << "Failed to authenticate to sync source " << _source);
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_isShuttingDown_inlock()) {
+            return Status(ErrorCodes::CallbackCanceled, _getComponentName() + " shutting down");
+        }
+        _streamConn = conn;
+    }
+    ON_BLOCK_EXIT([this] {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _streamConn.reset();
+    });
+
+    readersCreatedStats.increment();
+    const BSONObj metadataObj = _makeMetadataObject();
+    boost::optional<Status> finalStatus;
+    try {
+        Message request = OpMsgRequest::fromDBAndBody(
+                              _nss.db(),
+                              _makeFindCommandObject(_nss, _getLastOpTimeFetched(), findMaxTime),
+                              metadataObj)
+                              .serialize();
+        Message reply;
+        Timer timer;
+        conn->call(request, reply, true, nullptr);
+        conn->setSoTimeout(toSocketTimeout(_getGetMoreMaxTime()));
+
+        bool first = true;
+        while (true) {
+            Fetcher::QueryResponse queryResponse;
+            queryResponse.first = first;
+            queryResponse.elapsedMillis = Milliseconds(timer.millis());
+            queryResponse.otherFields.metadata = OpMsg::parseOwned(reply).body;
+
+            const auto& body = queryResponse.otherFields.metadata;
+            auto commandStatus = getStatusFromCommandResult(body);
+            if (!commandStatus.isOK()) {
+                return commandStatus;
+            }
+            auto cursorResponse = CursorResponse::parseFromBSON(body);
+            if (!cursorResponse.isOK()) {
+                return cursorResponse.getStatus();
+            }
+            queryResponse.cursorId = cursorResponse.getValue().getCursorId();
+            queryResponse.nss = cursorResponse.getValue().getNSS();
+            queryResponse.documents = cursorResponse.getValue().releaseBatch();
+
+            const bool lastBatch = queryResponse.cursorId == 0;
+            auto batchResult = _processSuccessfulBatch(queryResponse, lastBatch);
+            if (!batchResult.isOK()) {
+                // The stopReplProducer fail point expects this to return successfully.
+                finalStatus = batchResult.getStatus() == ErrorCodes::FailPointEnabled
+                    ? Status::OK()
+                    : batchResult.getStatus();
+                break;
+            }
+            if (lastBatch) {
+                finalStatus = Status::OK();
+                break;
+            }
+
+            first = false;
+            timer.reset();
+            if (OpMsg::isFlagSet(reply, OpMsg::kMoreToCome)) {
+                // The sync source keeps running our `getMore` and sends the next batch as soon as
+                // it is ready. Blocking here while the batch above waits for space in the oplog
+                // buffer stops reading from the socket, which in turn holds back the sync source.
+                const auto lastReplyId = reply.header().getId();
+                if (!conn->recv(reply, lastReplyId)) {
+                    return Status(ErrorCodes::HostUnreachable,
+                                  str::stream() << "Oplog stream from " << _source
+                                                << " was interrupted");
+                }
+                continue;
+            }
+
+            // The sync source ended the exhaust stream without closing the cursor, or has not
+            // started one yet. Ask for the next batch with an exhaust `getMore`.
+            request =
+                OpMsgRequest::fromDBAndBody(_nss.db(), batchResult.getValue(), metadataObj)
+                    .serialize();
+            OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+            conn->call(request, reply, true, nullptr);
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    _finishCallback(*finalStatus);
+    return Status::OK();
 }
 
 void AbstractOplogFetcher::_finishCallback(Status status) {
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include "mongo/base/status_with.h"
 #include "mongo/client/fetcher.h"
@@ -37,8 +38,12 @@
 #include "mongo/db/repl/abstract_async_component.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
+
+class DBClientConnection;
+
 namespace repl {
 
 /**
@@ -49,6 +54,12 @@ namespace repl {
  *
  * The `find` command and metadata are provided by oplog fetchers that subclass the abstract oplog
  * fetcher. Subclasses also provide a callback to run on successful batches.
+ *
+ * Subclasses may instead ask for the oplog to be streamed. In that mode the abstract oplog fetcher
+ * runs the `find` on its own connection from a dedicated thread and then issues a single exhaust
+ * `getMore`, after which the sync source pushes each batch as soon as it is available without
+ * waiting for another request. Batches are handed to the same callback and the same restart
+ * policy applies.
  */
 class AbstractOplogFetcher : public AbstractAsyncComponent {
     AbstractOplogFetcher(const AbstractOplogFetcher&) = delete;
@@ -67,6 +78,11 @@ public:
      */
     using OnShutdownCallbackFn = std::function<void(const Status& shutdownStatus)>;
 
+    /**
+     * Type of function to create a database client for streaming the oplog.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
     /**
      * Invariants if validation fails on any of the provided arguments.
      */
@@ -78,7 +94,7 @@ public:
                          OnShutdownCallbackFn onShutdownCallbackFn,
                          const std::string& componentName);
 
-    virtual ~AbstractOplogFetcher() = default;
+    virtual ~AbstractOplogFetcher();
 
     std::string toString() const;
 
@@ -101,6 +117,12 @@ public:
      */
     OpTime getLastOpTimeFetched_forTest() const;
 
+    /**
+     * Allows a different client class to be injected for streaming the oplog. Must be called
+     * before startup.
+     */
+    void setCreateClientFn_forTest(const CreateClientFn& createClientFn);
+
 protected:
     /**
      * Returns how long the `find` command should wait before timing out.
@@ -120,6 +142,12 @@ protected:
      */
     virtual Milliseconds _getGetMoreMaxTime() const;
 
+    /**
+     * Returns true if batches should be streamed from the sync source over an exhaust cursor
+     * instead of being requested one `getMore` at a time through the task executor.
+     */
+    virtual bool _usesExhaust() const;
+
     /**
      * Returns the sync source from which this oplog fetcher is fetching.
      */
@@ -143,7 +171,7 @@ protected:
     virtual Status _doStartup_inlock() noexcept override;
 
     /**
-     * Shuts down the Fetcher.
+     * Shuts down the Fetcher, or interrupts the oplog stream.
      */
     virtual void _doShutdown_inlock() noexcept override;
 
@@ -198,6 +226,30 @@ private:
      */
     void _callback(const Fetcher::QueryResponseStatus& result, BSONObjBuilder* getMoreBob);
 
+    /**
+     * Passes a successful batch to the subclass's _onSuccessfulBatch and then moves _lastFetched
+     * forward past it, unless 'lastBatch' is set.
+     *
+     * Returns the `getMore` command to send next, or a status that the caller should finish with.
+     */
+    StatusWith<BSONObj> _processSuccessfulBatch(const Fetcher::QueryResponse& queryResponse,
+                                                bool lastBatch);
+
+    /**
+     * Body of the thread streaming batches from the sync source. Restarts the stream on query and
+     * network errors and calls "_finishCallback" once the stream cannot continue.
+     */
+    void _runStream();
+
+    /**
+     * Runs a `find` on a new connection to the sync source and then streams the remaining batches
+     * with an exhaust `getMore`, passing every batch to "_processSuccessfulBatch".
+     *
+     * Returns the query or network error that interrupted the stream, which the caller may retry.
+     * Returns Status::OK() once processing has finished and "_finishCallback" has been called.
+     */
+    Status _streamOplog(Milliseconds findMaxTime);
+
     /**
      * Notifies caller that the oplog fetcher has completed processing operations from
      * the remote oplog using the "_onShutdownCallbackFn".
@@ -222,6 +274,9 @@ private:
     // Used to keep track of the last oplog entry read and processed from the sync source.
     OpTime _lastFetched;
 
+    // Function for creating the database client the oplog is streamed over.
+    CreateClientFn _createClientFn;
+
     // Fetcher restarts since the last successful oplog query response.
     std::size_t _fetcherRestarts = 0;
 
@@ -230,6 +285,12 @@ private:
 
     // Handle to currently scheduled _makeAndScheduleFetcherCallback task.
     executor::TaskExecutor::CallbackHandle _makeAndScheduleFetcherHandle;
+
+    // Thread streaming batches from the sync source, when exhaust is used.
+    stdx::thread _streamThread;
+
+    // Connection the stream is currently reading from. Shut down to interrupt the stream.
+    std::shared_ptr<DBClientConnection> _streamConn;
 };
 
 }  // namespace repl
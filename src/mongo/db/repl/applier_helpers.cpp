@@ -36,12 +36,16 @@
 #include <algorithm>
 #include <iterator>
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace repl {
@@ -54,6 +58,64 @@ const auto kInsertGroupMaxBatchSize = write_ops::insertVectorMaxBytes;
 // Limit number of ops in a single group.
 constexpr auto kInsertGroupMaxBatchCount = 64;
 
+// Number of update oplog entries which were folded into the write of an earlier entry.
+Counter64 opsCoalescedStats;
+ServerStatusMetricField<Counter64> displayOpsCoalesced("repl.apply.coalescedOps",
+                                                       &opsCoalescedStats);
+
+/**
+ * The parts of an update oplog entry that coalescing looks at. Only set for updates that consist
+ * solely of $set and $unset modifiers.
+ */
+struct ModifierUpdate {
+    BSONElement id;
+    BSONElement version;
+    BSONObj setFields;
+    BSONObj unsetFields;
+};
+
+bool containsArray(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        if (elem.type() == Array || (elem.type() == Object && containsArray(elem.Obj()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+boost::optional<ModifierUpdate> parseModifierUpdate(const OplogEntry& entry) {
+    if (entry.getOpType() != OpTypeEnum::kUpdate || entry.isForCappedCollection ||
+        entry.getNss().isSystem() || !entry.getObject2()) {
+        return boost::none;
+    }
+
+    ModifierUpdate update;
+    update.id = (*entry.getObject2())["_id"];
+    if (update.id.eoo()) {
+        return boost::none;
+    }
+
+    for (auto&& elem : entry.getObject()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$v"_sd) {
+            update.version = elem;
+        } else if (fieldName == "$set"_sd && elem.type() == Object) {
+            update.setFields = elem.Obj();
+        } else if (fieldName == "$unset"_sd && elem.type() == Object) {
+            update.unsetFields = elem.Obj();
+        } else {
+            // A replacement or a modifier whose effect depends on the current document.
+            return boost::none;
+        }
+    }
+
+    // Setting an array value may make an index multikey, which must not be skipped over.
+    if (containsArray(update.setFields)) {
+        return boost::none;
+    }
+    return update;
+}
+
 }  // namespace
 
 // static
@@ -169,5 +231,132 @@ StatusWith<InsertGroup::ConstIterator> InsertGroup::groupAndApplyInserts(ConstIt
     MONGO_UNREACHABLE;
 }
 
+using UpdateGroup = ApplierHelpers::UpdateGroup;
+
+UpdateGroup::UpdateGroup(ApplierHelpers::OperationPtrs* ops,
+                         OperationContext* opCtx,
+                         UpdateGroup::Mode mode)
+    : _doNotGroupBeforePoint(ops->cbegin()), _end(ops->cend()), _opCtx(opCtx), _mode(mode) {}
+
+StatusWith<UpdateGroup::ConstIterator> UpdateGroup::groupAndApplyUpdates(ConstIterator it) {
+    const auto& entry = **it;
+
+    // The following conditions must be met before attempting to coalesce the oplog entries
+    // starting at 'oplogEntriesIterator':
+    // 1) Coalescing must be enabled, and we must not be in initial sync, where a missing document
+    //    is fetched from the sync source for the individual update that failed to apply;
+    // 2) The CRUD operation must be an update consisting only of $set and $unset modifiers;
+    // 3) We have not attempted to coalesce this update during a previous call to this function.
+    if (!replCoalesceUpdatesInBatch.load() || Mode::kInitialSync == _mode) {
+        return Status(ErrorCodes::IllegalOperation, "Update coalescing is disabled.");
+    }
+    auto first = parseModifierUpdate(entry);
+    if (!first) {
+        return Status(ErrorCodes::TypeMismatch, "Can only coalesce $set and $unset updates.");
+    }
+    if (it < _doNotGroupBeforePoint) {
+        return Status(ErrorCodes::InvalidPath,
+                      "Cannot coalesce an update operation that we previously attempted to group.");
+    }
+
+    // The latest value of every field set by the first update, in the order the first update sets
+    // them. Later updates may only overwrite these fields, or unset fields that the first update
+    // unsets, so that applying the coalesced update produces the same document as applying the
+    // updates one at a time.
+    std::vector<StringData> setPaths;
+    StringMap<BSONElement> latestValues;
+    for (auto&& elem : first->setFields) {
+        setPaths.push_back(elem.fieldNameStringData());
+        latestValues[elem.fieldName()] = elem;
+    }
+
+    auto endOfGroupableOpsIterator =
+        std::find_if(it + 1, _end, [&](const OplogEntry* nextEntry) -> bool {
+            if (nextEntry->getNss() != entry.getNss()) {
+                return true;
+            }
+            auto next = parseModifierUpdate(*nextEntry);
+            if (!next || !next->id.binaryEqualValues(first->id) ||
+                next->version.eoo() != first->version.eoo() ||
+                (!next->version.eoo() && !next->version.binaryEqualValues(first->version))) {
+                return true;
+            }
+            for (auto&& elem : next->setFields) {
+                if (latestValues.find(elem.fieldNameStringData()) == latestValues.end()) {
+                    return true;
+                }
+            }
+            for (auto&& elem : next->unsetFields) {
+                if (!first->unsetFields.hasField(elem.fieldNameStringData())) {
+                    return true;
+                }
+            }
+
+            for (auto&& elem : next->setFields) {
+                latestValues[elem.fieldName()] = elem;
+            }
+            return false;
+        });
+
+    // See if we were able to create a group that contains more than a single op.
+    const auto groupSize = std::distance(it, endOfGroupableOpsIterator);
+    if (groupSize == 1) {
+        return Status(ErrorCodes::NoSuchKey,
+                      "Not able to create a group with more than a single update operation");
+    }
+
+    // Build the coalesced update from the first update's modifiers and the latest values.
+    BSONObjBuilder updateBuilder;
+    for (auto&& elem : entry.getObject()) {
+        if (elem.fieldNameStringData() != "$set"_sd) {
+            updateBuilder.append(elem);
+            continue;
+        }
+        BSONObjBuilder setBuilder(updateBuilder.subobjStart("$set"));
+        for (auto path : setPaths) {
+            setBuilder.appendAs(latestValues.find(path)->second, path);
+        }
+    }
+    const BSONObj coalescedObject = updateBuilder.obj();
+
+    // The coalesced update takes the optime of the last update in the group, and upserts if the
+    // first update in the group would have.
+    const auto& lastEntry = **(endOfGroupableOpsIterator - 1);
+    BSONObjBuilder entryBuilder;
+    for (auto&& elem : lastEntry.getRaw()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == OplogEntryBase::kObjectFieldName) {
+            entryBuilder.append(OplogEntryBase::kObjectFieldName, coalescedObject);
+        } else if (fieldName != OplogEntryBase::kUpsertFieldName) {
+            entryBuilder.append(elem);
+        }
+    }
+    if (auto upsert = entry.getUpsert()) {
+        entryBuilder.append(OplogEntryBase::kUpsertFieldName, *upsert);
+    }
+    OplogEntry coalescedUpdate(entryBuilder.obj());
+
+    try {
+        uassertStatusOK(SyncTail::syncApply(_opCtx, &coalescedUpdate, _mode, boost::none));
+        opsCoalescedStats.increment(groupSize - 1);
+        return endOfGroupableOpsIterator - 1;
+    } catch (...) {
+        // The coalesced update failed, log an error and fall through to the application of an
+        // individual op.
+        auto status = exceptionToStatus().withContext(
+            str::stream() << "Error applying coalesced update: "
+                          << redact(coalescedUpdate.toBSON())
+                          << ". Trying first update as a lone update: " << redact(entry.getRaw()));
+        error() << status;
+
+        // Avoid quadratic run time from a failed group by not retrying until we are beyond it.
+        _doNotGroupBeforePoint = endOfGroupableOpsIterator;
+
+        return status;
+    }
+
+    MONGO_UNREACHABLE;
+}
+
 }  // namespace repl
 }  // namespace mongo
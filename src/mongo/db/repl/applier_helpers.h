@@ -51,6 +51,7 @@ public:
     static void stableSortByNamespace(OperationPtrs* oplogEntryPointers);
 
     class InsertGroup;
+    class UpdateGroup;
 };
 
 /**
@@ -89,5 +90,44 @@ private:
     Mode _mode;
 };
 
+/**
+ * Coalesces consecutive $set/$unset updates to the same document into a single update that writes
+ * the last value of every field, and applies it in place of the individual oplog entries.
+ * Only updates which touch no field paths beyond those of the first update in the group, and which
+ * set no array values, are coalesced, so that the resulting document (including its field order)
+ * and the multikey state of its indexes match those of applying the entries one at a time.
+ * Advances the MultiApplier::OperationPtrs iterator if the coalesced update is applied
+ * successfully.
+ */
+class ApplierHelpers::UpdateGroup {
+    UpdateGroup(const UpdateGroup&) = delete;
+    UpdateGroup& operator=(const UpdateGroup&) = delete;
+
+public:
+    using ConstIterator = OperationPtrs::const_iterator;
+    using Mode = OplogApplication::Mode;
+
+    UpdateGroup(OperationPtrs* ops, OperationContext* opCtx, Mode mode);
+
+    /**
+     * Attempts to coalesce update operations starting at 'iter'.
+     * If the coalesced update is applied successfully, returns the iterator to the last update
+     * operation included in it.
+     */
+    StatusWith<ConstIterator> groupAndApplyUpdates(ConstIterator oplogEntriesIterator);
+
+private:
+    // Updates before _doNotGroupBeforePoint are not coalesced again after a coalesced update that
+    // contained them failed to apply.
+    ConstIterator _doNotGroupBeforePoint;
+
+    // Used for constructing search bounds when coalescing updates.
+    ConstIterator _end;
+
+    // Passed to _syncApply when applying coalesced updates.
+    OperationContext* _opCtx;
+    Mode _mode;
+};
+
 }  // namespace repl
 }  // namespace mongo
@@ -33,9 +33,11 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/client/remote_command_retry_scheduler.h"
@@ -66,6 +68,9 @@ constexpr auto kCountResponseDocumentCountFieldName = "n"_sd;
 const int kProgressMeterSecondsBetween = 60;
 const int kProgressMeterCheckInterval = 128;
 
+// Number of `_id`s to sample for each partition of a collection cloned with concurrent queries.
+const int kSampledIdsPerPartition = 10;
+
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -257,7 +262,9 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     }
     if (_queryState == QueryState::kRunning) {
         _queryState = QueryState::kCanceling;
-        _clientConnection->shutdownAndDisallowReconnect();
+        for (auto&& clientConnection : _clientConnections) {
+            clientConnection->shutdownAndDisallowReconnect();
+        }
     } else {
         _queryState = QueryState::kFinished;
     }
@@ -475,14 +482,14 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
                 {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _queryState = QueryState::kFinished;
-                    _clientConnection.reset();
+                    _clientConnections.clear();
                 }
                 _condition.notify_all();
                 _finishCallback(status);
             };
             auto onCompletionGuard =
                 std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
-            _runQuery(callbackData, onCompletionGuard);
+            _runQueries(callbackData, onCompletionGuard);
         });
     if (!runQueryCallback.isOK()) {
         _finishCallback(runQueryCallback.getStatus());
@@ -490,25 +497,23 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
     }
 }
 
-void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& callbackData,
-                                 std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+void CollectionCloner::_runQueries(const executor::TaskExecutor::CallbackArgs& callbackData,
+                                   std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
     if (!callbackData.status.isOK()) {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, callbackData.status);
         return;
     }
-    bool queryStateOK = false;
+    DBClientConnection* clientConnection = nullptr;
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
-        queryStateOK = _queryState == QueryState::kNotStarted;
-        if (queryStateOK) {
-            _queryState = QueryState::kRunning;
-            _clientConnection = _createClientFn();
-        } else {
+        if (_queryState != QueryState::kNotStarted) {
             onCompletionGuard->setResultAndCancelRemainingWork_inlock(
                 lock, {ErrorCodes::CallbackCanceled, "Collection cloning cancelled."});
             return;
         }
+        _queryState = QueryState::kRunning;
+        clientConnection = _addClientConnection_inlock();
     }
 
     MONGO_FAIL_POINT_BLOCK(initialSyncHangBeforeCollectionClone, options) {
@@ -522,28 +527,192 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
         }
     }
 
-    Status clientConnectionStatus = _clientConnection->connect(_source, StringData());
+    if (!_connectClient(clientConnection, onCompletionGuard)) {
+        return;
+    }
+
+    const auto numPartitions = _makePartitions(clientConnection);
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _partitionsRemaining = numPartitions;
+    }
+
+    for (size_t partitionIndex = 1; partitionIndex < numPartitions; ++partitionIndex) {
+        auto scheduleResult = _executor->scheduleWork(
+            [this, partitionIndex, onCompletionGuard](
+                const executor::TaskExecutor::CallbackArgs& callbackData) {
+                DBClientConnection* clientConnection = nullptr;
+                {
+                    stdx::lock_guard<stdx::mutex> lock(_mutex);
+                    if (!callbackData.status.isOK()) {
+                        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+                            lock, callbackData.status);
+                        return;
+                    }
+                    if (_queryState != QueryState::kRunning) {
+                        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+                            lock, {ErrorCodes::CallbackCanceled, "Collection cloning cancelled."});
+                        return;
+                    }
+                    clientConnection = _addClientConnection_inlock();
+                }
+                if (_connectClient(clientConnection, onCompletionGuard)) {
+                    _runQuery(onCompletionGuard, clientConnection, partitionIndex);
+                }
+            });
+        if (!scheduleResult.isOK()) {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock,
+                                                                      scheduleResult.getStatus());
+            return;
+        }
+    }
+
+    _runQuery(onCompletionGuard, clientConnection, 0);
+}
+
+DBClientConnection* CollectionCloner::_addClientConnection_inlock() {
+    _clientConnections.push_back(_createClientFn());
+    return _clientConnections.back().get();
+}
+
+bool CollectionCloner::_connectClient(DBClientConnection* conn,
+                                      const std::shared_ptr<OnCompletionGuard>& onCompletionGuard) {
+    Status clientConnectionStatus = conn->connect(_source, StringData());
     if (!clientConnectionStatus.isOK()) {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, clientConnectionStatus);
-        return;
+        return false;
     }
-    if (!replAuthenticate(_clientConnection.get())) {
+    if (!replAuthenticate(conn)) {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         onCompletionGuard->setResultAndCancelRemainingWork_inlock(
             lock,
             {ErrorCodes::AuthenticationFailed,
              str::stream() << "Failed to authenticate to " << _source});
-        return;
+        return false;
+    }
+    return true;
+}
+
+size_t CollectionCloner::_makePartitions(DBClientConnection* conn) {
+    // Partitions are `_id` ranges scanned through the `_id` index, which only orders documents the
+    // same way as the sampled `_id`s under the simple collation. Capped collections must keep
+    // their insertion order, so they are always cloned with a single query.
+    size_t numPartitions = 1;
+    {
+        LockGuard lk(_mutex);
+        if (!_options.capped && _options.collation.isEmpty() && !_idIndexSpec.isEmpty()) {
+            const auto minDocumentsPerPartition =
+                std::max(collectionClonerMinDocumentsPerPartition.load(), 1);
+            numPartitions = std::min(_stats.documentToCopy / size_t(minDocumentsPerPartition),
+                                     size_t(std::max(collectionClonerMaxPartitions.load(), 1)));
+            numPartitions = std::max(numPartitions, size_t(1));
+        }
+    }
+
+    std::vector<BSONObj> boundaries;
+    if (numPartitions > 1) {
+        const long long sampleSize =
+            static_cast<long long>(numPartitions) * kSampledIdsPerPartition;
+        BSONObj cmdObj =
+            BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                             << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                           << BSON("$project" << BSON("_id" << 1)))
+                             << "cursor" << BSON("batchSize" << sampleSize));
+        Status sampleStatus = Status::OK();
+        try {
+            BSONObj result;
+            conn->runCommand(_sourceNss.db().toString(), cmdObj, result, QueryOption_SlaveOk);
+            auto cursorResponse = CursorResponse::parseFromBSON(result);
+            if (cursorResponse.isOK()) {
+                boundaries = makePartitionBoundaries(cursorResponse.getValue().releaseBatch(),
+                                                     numPartitions);
+            } else {
+                sampleStatus = cursorResponse.getStatus();
+            }
+        } catch (const DBException& e) {
+            sampleStatus = e.toStatus();
+        }
+        if (!sampleStatus.isOK()) {
+            log() << "CollectionCloner ns: " << _sourceNss
+                  << " failed to sample _ids, cloning with a single query: "
+                  << redact(sampleStatus);
+        }
+    }
+
+    LockGuard lk(_mutex);
+    _stats.partitions.clear();
+    BSONObj min;
+    for (auto&& boundary : boundaries) {
+        Stats::PartitionStats partition;
+        partition.min = min;
+        partition.max = boundary;
+        _stats.partitions.push_back(partition);
+        min = boundary;
+    }
+    Stats::PartitionStats lastPartition;
+    lastPartition.min = min;
+    _stats.partitions.push_back(lastPartition);
+
+    if (_stats.partitions.size() > 1) {
+        log() << "CollectionCloner ns: " << _sourceNss << " cloning with "
+              << _stats.partitions.size() << " concurrent queries";
+    }
+    return _stats.partitions.size();
+}
+
+std::vector<BSONObj> CollectionCloner::makePartitionBoundaries(std::vector<BSONObj> sampledIds,
+                                                               size_t numPartitions) {
+    std::vector<BSONObj> ids;
+    ids.reserve(sampledIds.size());
+    for (auto&& doc : sampledIds) {
+        if (auto idElem = doc["_id"]) {
+            ids.push_back(idElem.wrap());
+        }
+    }
+    std::sort(ids.begin(), ids.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    std::vector<BSONObj> boundaries;
+    if (ids.empty()) {
+        return boundaries;
+    }
+    for (size_t i = 1; i < numPartitions; ++i) {
+        const auto& id = ids[i * ids.size() / numPartitions];
+        if (boundaries.empty() ||
+            SimpleBSONObjComparator::kInstance.evaluate(boundaries.back() < id)) {
+            boundaries.push_back(id);
+        }
+    }
+    return boundaries;
+}
+
+void CollectionCloner::_runQuery(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
+                                 DBClientConnection* conn,
+                                 size_t partitionIndex) {
+    Query query = QUERY("query" << BSONObj() << "$readOnce" << true);
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        auto& partition = _stats.partitions[partitionIndex];
+        partition.start = _executor->now();
+        if (_stats.partitions.size() > 1) {
+            query.hint(BSON("_id" << 1));
+            if (!partition.min.isEmpty()) {
+                query.minKey(partition.min);
+            }
+            if (!partition.max.isEmpty()) {
+                query.maxKey(partition.max);
+            }
+        }
     }
 
     try {
-        _clientConnection->query(
-            [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
-                _handleNextBatch(onCompletionGuard, iter);
+        conn->query(
+            [this, onCompletionGuard, partitionIndex](DBClientCursorBatchIterator& iter) {
+                _handleNextBatch(onCompletionGuard, partitionIndex, iter);
             },
             NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            QUERY("query" << BSONObj() << "$readOnce" << true),
+            query,
             nullptr /* fieldsToReturn */,
             QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
                 (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
@@ -572,20 +741,28 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     }
     waitForDbWorker();
     stdx::lock_guard<stdx::mutex> lock(_mutex);
-    onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
+    _stats.partitions[partitionIndex].end = _executor->now();
+    // The collection is cloned once the queries for all partitions have finished.
+    if (--_partitionsRemaining == 0) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
+    }
 }
 
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
+                                        size_t partitionIndex,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
+        auto& partition = _stats.partitions[partitionIndex];
+        partition.receivedBatches++;
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
         while (iter.moreInCurrentBatch()) {
             BSONObj o = iter.nextSafe();
             _documentsToInsert.emplace_back(std::move(o));
+            partition.documentsFetched++;
         }
     }
 
@@ -793,6 +970,30 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", receivedBatches);
+    if (partitions.size() > 1) {
+        BSONArrayBuilder partitionsBuilder(builder->subarrayStart("partitions"));
+        for (auto&& partition : partitions) {
+            BSONObjBuilder partitionBuilder(partitionsBuilder.subobjStart());
+            partition.append(&partitionBuilder);
+        }
+    }
+}
+
+void CollectionCloner::Stats::PartitionStats::append(BSONObjBuilder* builder) const {
+    if (!min.isEmpty()) {
+        builder->append("min", min);
+    }
+    if (!max.isEmpty()) {
+        builder->append("max", max);
+    }
+    builder->appendNumber("documentsFetched", documentsFetched);
+    builder->appendNumber("receivedBatches", receivedBatches);
+    if (start != Date_t()) {
+        builder->appendDate("start", start);
+        if (end != Date_t()) {
+            builder->appendDate("end", end);
+        }
+    }
 }
 }  // namespace repl
 }  // namespace mongo
@@ -74,6 +74,21 @@ public:
         static constexpr StringData kDocumentsToCopyFieldName = "documentsToCopy"_sd;
         static constexpr StringData kDocumentsCopiedFieldName = "documentsCopied"_sd;
 
+        /**
+         * Progress of the query cloning one `_id` range of the collection. An empty 'min' or 'max'
+         * leaves the range unbounded on that side.
+         */
+        struct PartitionStats {
+            BSONObj min;
+            BSONObj max;
+            Date_t start;
+            Date_t end;
+            size_t documentsFetched{0};
+            size_t receivedBatches{0};
+
+            void append(BSONObjBuilder* builder) const;
+        };
+
         std::string ns;
         Date_t start;
         Date_t end;
@@ -82,6 +97,7 @@ public:
         size_t indexes{0};
         size_t fetchedBatches{0};  // This is actually inserted batches.
         size_t receivedBatches{0};
+        std::vector<PartitionStats> partitions;
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -122,6 +138,14 @@ public:
 
     virtual ~CollectionCloner();
 
+    /**
+     * Picks up to 'numPartitions' - 1 boundaries from a sample of `_id`s of a collection, so that
+     * the ranges between them each hold about the same number of sampled documents. Returns the
+     * boundaries in ascending order, each as an {_id: <value>} object.
+     */
+    static std::vector<BSONObj> makePartitionBoundaries(std::vector<BSONObj> sampledIds,
+                                                        size_t numPartitions);
+
     const NamespaceString& getSourceNamespace() const;
 
     bool isActive() const override;
@@ -212,18 +236,48 @@ private:
     void _beginCollectionCallback(const executor::TaskExecutor::CallbackArgs& callbackData);
 
     /**
-     * Using a DBClientConnection, executes a query to retrieve all documents in the collection.
-     * For each batch returned by the upstream node, _handleNextBatch will be called with the data.
-     * This method will return when the entire query is finished or failed.
+     * Splits the collection into `_id` ranges and runs a query for each of them. The queries for
+     * all but the first range are scheduled on the executor, so that they run concurrently over
+     * separate connections; the first one runs on the calling thread.
      */
-    void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData,
-                   std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+    void _runQueries(const executor::TaskExecutor::CallbackArgs& callbackData,
+                     std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Creates a client connection for a query and keeps it in '_clientConnections' so that it can
+     * be shut down on cancellation.
+     */
+    DBClientConnection* _addClientConnection_inlock();
+
+    /**
+     * Connects and authenticates 'conn' to the sync source. On failure, sets the result in
+     * 'onCompletionGuard' and returns false.
+     */
+    bool _connectClient(DBClientConnection* conn,
+                        const std::shared_ptr<OnCompletionGuard>& onCompletionGuard);
+
+    /**
+     * Decides how the collection is partitioned, sampling `_id`s over 'conn' if the collection is
+     * large enough to be split. Sets up the partitions in '_stats' and returns how many there are.
+     * Falls back to a single partition covering the whole collection if sampling fails.
+     */
+    size_t _makePartitions(DBClientConnection* conn);
+
+    /**
+     * Using a DBClientConnection, executes a query to retrieve all documents in a partition of the
+     * collection. For each batch returned by the upstream node, _handleNextBatch will be called
+     * with the data. This method will return when the entire query is finished or failed.
+     */
+    void _runQuery(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
+                   DBClientConnection* conn,
+                   size_t partitionIndex);
 
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
      */
     void _handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
+                          size_t partitionIndex,
                           DBClientCursorBatchIterator& iter);
 
     /**
@@ -296,11 +350,14 @@ private:
         kFinished
     } _queryState = QueryState::kNotStarted;
 
-    // (M) Client connection used for query. The '_clientConnection' is owned by the '_runQuery'
-    // thread and may only be set by that thread, and only when holding '_mutex'. The '_runQuery'
-    // thread may read this pointer without holding '_mutex'. It is exposed to other threads to
-    // allow cancellation, and those other threads may access it only when holding '_mutex'.
-    std::unique_ptr<DBClientConnection> _clientConnection;
+    // (M) Client connections used for the queries, one per partition. Each connection is used by
+    // the '_runQuery' thread for its partition, which may use it without holding '_mutex'. Other
+    // threads may only access the connections to cancel them, and only when holding '_mutex'.
+    // Connections are added when holding '_mutex' and not removed until all queries finished.
+    std::vector<std::unique_ptr<DBClientConnection>> _clientConnections;
+
+    // (M) Number of partition queries that have not finished yet.
+    size_t _partitionsRemaining = 0;
 
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
@@ -28,6 +28,7 @@
  */
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/base_cloner_test_fixture.h"
 #include "mongo/db/repl/collection_cloner.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
@@ -93,6 +95,9 @@ public:
         });
         {
             stdx::unique_lock<stdx::mutex> lk(_mutex);
+            if (_queries) {
+                _queries->push_back(query.obj.getOwned());
+            }
             _waiting = _paused;
             _cond.notify_all();
             while (_paused) {
@@ -116,6 +121,12 @@ public:
         _failureForQuery = failure;
     }
 
+    // Records the query object of every query run over this connection in 'queries'.
+    void setQueriesRecorder(std::vector<BSONObj>* queries) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _queries = queries;
+    }
+
     void pause() {
         {
             stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -161,6 +172,7 @@ private:
     int _resumedQueryCount = 0;
     Status _failureForConnect = Status::OK();
     Status _failureForQuery = Status::OK();
+    std::vector<BSONObj>* _queries = nullptr;
 
     void _resume(stdx::unique_lock<stdx::mutex>* lk) {
         invariant(lk->owns_lock());
@@ -1459,4 +1471,225 @@ TEST_F(CollectionClonerRenamedBeforeStartTest,
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+/**
+ * Clones a collection of six documents in three `_id` ranges, [MinKey, 3), [3, 5) and [5, MaxKey),
+ * each copied over its own connection. The executor of the fixture has a single thread, so the
+ * queries for the partitions scheduled on it run one after another, in any order.
+ */
+class CollectionClonerPartitionedTest : public CollectionClonerTest {
+protected:
+    static constexpr int kNumDocuments = 6;
+    static constexpr size_t kNumPartitions = 3;
+
+    void setUp() override {
+        CollectionClonerTest::setUp();
+        _maxPartitions = collectionClonerMaxPartitions.load();
+        _minDocumentsPerPartition = collectionClonerMinDocumentsPerPartition.load();
+        collectionClonerMaxPartitions.store(kNumPartitions);
+        collectionClonerMinDocumentsPerPartition.store(1);
+
+        BSONArrayBuilder sampledIds;
+        for (int i = 1; i <= kNumDocuments; ++i) {
+            _server->insert(nss.ns(), BSON("_id" << i));
+            sampledIds.append(BSON("_id" << i));
+        }
+        _server->setCommandReply("aggregate",
+                                 createCursorResponse(0, nss.ns(), sampledIds.arr(), "firstBatch"));
+
+        // The first connection, which also samples the `_id`s, is '_client'. The connections are
+        // handed out in order, so every connection but the first queries a later partition.
+        _clients.push_back(_client);
+        for (size_t i = 1; i < kNumPartitions; ++i) {
+            _clients.push_back(new FailableMockDBClientConnection(_server.get(), getNet()));
+        }
+        for (auto client : _clients) {
+            client->setQueriesRecorder(&_queries);
+        }
+        collectionCloner->setCreateClientFn_forTest([this]() {
+            invariant(_numClientsCreated < _clients.size());
+            _clientCreated = true;
+            return std::unique_ptr<DBClientConnection>(_clients[_numClientsCreated++]);
+        });
+    }
+
+    void tearDown() override {
+        CollectionClonerTest::tearDown();
+        // '_client' is deleted by CollectionClonerTest if it was not handed out.
+        for (size_t i = std::max(_numClientsCreated, size_t(1)); i < _clients.size(); ++i) {
+            delete _clients[i];
+        }
+        _clients.clear();
+        _numClientsCreated = 0;
+        _queries.clear();
+        collectionClonerMaxPartitions.store(_maxPartitions);
+        collectionClonerMinDocumentsPerPartition.store(_minDocumentsPerPartition);
+    }
+
+    void startCloning() {
+        ASSERT_OK(collectionCloner->startup());
+        {
+            executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+            processNetworkResponse(createCountResponse(kNumDocuments));
+            processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+        }
+    }
+
+    // Connections for the queries, owned by the CollectionCloner once created.
+    std::vector<FailableMockDBClientConnection*> _clients;
+    size_t _numClientsCreated = 0;
+    std::vector<BSONObj> _queries;
+
+private:
+    int _maxPartitions = 0;
+    int _minDocumentsPerPartition = 0;
+};
+
+TEST_F(CollectionClonerPartitionedTest, ClonesEachIdRangeOverItsOwnConnection) {
+    startCloning();
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_EQUALS(kNumDocuments, collectionStats->insertCount);
+    ASSERT_TRUE(collectionStats->commitCalled);
+
+    // Every partition is queried through the `_id` index over a connection of its own. The first
+    // connection queries the lowest range.
+    ASSERT_EQUALS(kNumPartitions, _numClientsCreated);
+    ASSERT_EQUALS(kNumPartitions, _queries.size());
+    for (auto&& query : _queries) {
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 1), query.getObjectField("$hint"));
+    }
+    ASSERT_FALSE(_queries[0].hasField("$min"));
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), _queries[0].getObjectField("$max"));
+
+    auto stats = collectionCloner->getStats();
+    ASSERT_EQUALS(kNumPartitions, stats.partitions.size());
+    ASSERT_BSONOBJ_EQ(BSONObj(), stats.partitions[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), stats.partitions[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), stats.partitions[1].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 5), stats.partitions[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 5), stats.partitions[2].min);
+    ASSERT_BSONOBJ_EQ(BSONObj(), stats.partitions[2].max);
+    for (auto&& partition : stats.partitions) {
+        ASSERT_EQUALS(2U, partition.documentsFetched);
+        ASSERT_EQUALS(1U, partition.receivedBatches);
+        ASSERT_NOT_EQUALS(Date_t(), partition.end);
+    }
+    ASSERT_EQUALS(kNumPartitions, stats.receivedBatches);
+}
+
+TEST_F(CollectionClonerPartitionedTest, CompletesOnlyAfterTheQueriesForAllPartitionsFinish) {
+    // The last connection is created for the query which runs last.
+    MockClientPauser pauser(_clients.back());
+    startCloning();
+
+    _clients.back()->waitForPausedQuery();
+    ASSERT_TRUE(collectionCloner->isActive());
+    ASSERT_EQUALS(getDetectableErrorStatus(), getStatus());
+    ASSERT_EQUALS(4, collectionStats->insertCount);
+    ASSERT_FALSE(collectionStats->commitCalled);
+
+    pauser.resume();
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_EQUALS(kNumDocuments, collectionStats->insertCount);
+    ASSERT_TRUE(collectionStats->commitCalled);
+}
+
+TEST_F(CollectionClonerPartitionedTest, FailsIfTheQueryForAnyPartitionFails) {
+    _clients[1]->setFailureForQuery({ErrorCodes::UnknownError, "partition query failed"});
+    startCloning();
+
+    collectionCloner->join();
+    ASSERT_EQUALS(ErrorCodes::UnknownError, getStatus().code());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_FALSE(collectionStats->commitCalled);
+}
+
+TEST_F(CollectionClonerPartitionedTest, ShutdownDuringAPartitionQueryCancelsTheOtherPartitions) {
+    MockClientPauser pauser(_clients[1]);
+    startCloning();
+
+    _clients[1]->waitForPausedQuery();
+    collectionCloner->shutdown();
+    pauser.resume();
+
+    collectionCloner->join();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, getStatus().code());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_FALSE(collectionStats->commitCalled);
+
+    // The partition whose query had not started yet never opened its connection.
+    ASSERT_EQUALS(2U, _numClientsCreated);
+}
+
+TEST_F(CollectionClonerPartitionedTest,
+       CloningIsSuccessfulIfCollectionWasDroppedWhileCopyingALaterPartition) {
+    _clients.back()->setFailureForQuery(
+        {ErrorCodes::QueryPlanKilled, "collection dropped while copying documents"});
+    startCloning();
+    collectionCloner->waitForDbWorker();
+
+    // The CollectionCloner runs a find command on the collection's UUID. A drop-pending namespace
+    // in the response means the collection was dropped.
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        ASSERT_TRUE(guard->hasReadyRequests());
+        auto noi = guard->getNextReadyRequest();
+        const auto firstElement = noi->getRequest().cmdObj.firstElement();
+        ASSERT_EQUALS("find"_sd, firstElement.fieldNameStringData());
+        ASSERT_EQUALS(*options.uuid, unittest::assertGet(UUID::parse(firstElement)));
+
+        repl::OpTime dropOpTime(Timestamp(Seconds(100), 0), 1LL);
+        auto dpns = nss.makeDropPendingNamespace(dropOpTime);
+        scheduleNetworkResponse(noi, createCursorResponse(0, dpns.ns(), BSONArray(), "firstBatch"));
+        finishProcessingNetworkResponse();
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_EQUALS(kNumPartitions, _numClientsCreated);
+}
+
+TEST(CollectionClonerPartitionTest, MakePartitionBoundariesSplitsSortedSampleEvenly) {
+    std::vector<BSONObj> sampledIds;
+    for (int i = 8; i > 0; --i) {
+        sampledIds.push_back(BSON("_id" << i));
+    }
+    auto boundaries = CollectionCloner::makePartitionBoundaries(sampledIds, 4);
+    ASSERT_EQUALS(3U, boundaries.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), boundaries[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 5), boundaries[1]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 7), boundaries[2]);
+}
+
+TEST(CollectionClonerPartitionTest, MakePartitionBoundariesSkipsDuplicateBoundaries) {
+    std::vector<BSONObj> sampledIds{
+        BSON("_id" << 1), BSON("_id" << 1), BSON("_id" << 1), BSON("_id" << 2)};
+    auto boundaries = CollectionCloner::makePartitionBoundaries(sampledIds, 4);
+    ASSERT_EQUALS(2U, boundaries.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), boundaries[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), boundaries[1]);
+}
+
+TEST(CollectionClonerPartitionTest, MakePartitionBoundariesOrdersIdsAcrossTypes) {
+    std::vector<BSONObj> sampledIds{BSON("_id"
+                                         << "b"),
+                                    BSON("_id" << 2),
+                                    BSON("_id"
+                                         << "a"),
+                                    BSON("_id" << 1)};
+    auto boundaries = CollectionCloner::makePartitionBoundaries(sampledIds, 2);
+    ASSERT_EQUALS(1U, boundaries.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id"
+                           << "a"),
+                      boundaries[0]);
+}
+
+TEST(CollectionClonerPartitionTest, MakePartitionBoundariesReturnsNoBoundariesForEmptySample) {
+    ASSERT_TRUE(CollectionCloner::makePartitionBoundaries({}, 4).empty());
+}
+
 }  // namespace
@@ -165,6 +165,8 @@ private:
 
     Milliseconds _getGetMoreMaxTime() const override;
 
+    bool _usesExhaust() const override;
+
     /**
      * This function is run by the AbstractOplogFetcher on a successful batch of oplog entries.
      */
@@ -29,14 +29,21 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
 #include <memory>
 
+#include "mongo/client/dbclient_connection.h"
 #include "mongo/db/repl/abstract_oplog_fetcher_test_fixture.h"
 #include "mongo/db/repl/data_replicator_external_state_mock.h"
 #include "mongo/db/repl/oplog_fetcher.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/service_context_test_fixture.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/task_executor_proxy.h"
@@ -1023,4 +1030,290 @@ TEST_F(OplogFetcherTest,
 
     ASSERT_EQUALS(OpTime(), info.lastDocument);
 }
+
+/**
+ * The sync source end of an oplog stream. Every connection made from it is handed the queued
+ * replies in order, and every request sent over one is recorded.
+ */
+class StreamingSyncSourceMock {
+public:
+    /**
+     * Queues a reply carrying 'body', with the moreToCome flag set if 'moreToCome' is true.
+     */
+    void addReply(BSONObj body, bool moreToCome = false) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _replies.push_back({body.getOwned(), moreToCome, false});
+        _cv.notify_all();
+    }
+
+    /**
+     * Queues a network error, which fails the read waiting for the next reply.
+     */
+    void addNetworkError() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _replies.push_back({BSONObj(), false, true});
+        _cv.notify_all();
+    }
+
+    void recordRequest(Message& request) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _requests.push_back({OpMsg::parseOwned(request).body,
+                             OpMsg::isFlagSet(request, OpMsg::kExhaustSupported)});
+    }
+
+    /**
+     * Waits for the next reply and stores it in 'reply'. Returns false on a network error or once
+     * 'conn' has been shut down.
+     */
+    bool nextReply(DBClientConnection* conn, Message* reply) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        ++_numWaiting;
+        _cv.notify_all();
+        ON_BLOCK_EXIT([&] { --_numWaiting; });
+        // Shutting down the connection does not notify us, so check for it periodically.
+        while (_replies.empty() && !conn->isFailed()) {
+            _cv.wait_for(lk, Milliseconds(10).toSystemDuration());
+        }
+        if (conn->isFailed()) {
+            return false;
+        }
+        auto next = _replies.front();
+        _replies.pop_front();
+        if (next.networkError) {
+            return false;
+        }
+        OpMsg msg;
+        msg.body = next.body;
+        *reply = msg.serialize();
+        if (next.moreToCome) {
+            OpMsg::setFlag(reply, OpMsg::kMoreToCome);
+        }
+        return true;
+    }
+
+    /**
+     * Blocks until every queued reply has been consumed and a connection is waiting for more.
+     */
+    void waitForBlockedRead() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return _replies.empty() && _numWaiting > 0; });
+    }
+
+    /**
+     * Returns the body of each request received and whether it was sent with exhaustSupported.
+     */
+    std::vector<std::pair<BSONObj, bool>> getRequests() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _requests;
+    }
+
+    int numConnections = 0;
+
+private:
+    struct Reply {
+        BSONObj body;
+        bool moreToCome;
+        bool networkError;
+    };
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::deque<Reply> _replies;
+    std::vector<std::pair<BSONObj, bool>> _requests;
+    int _numWaiting = 0;
+};
+
+/**
+ * A connection to a StreamingSyncSourceMock.
+ */
+class StreamingConnectionMock : public DBClientConnection {
+public:
+    explicit StreamingConnectionMock(StreamingSyncSourceMock* syncSource)
+        : _syncSource(syncSource) {}
+
+    Status connect(const HostAndPort& server, StringData applicationName) override {
+        return Status::OK();
+    }
+
+    bool call(Message& toSend,
+              Message& response,
+              bool assertOk,
+              std::string* actualServer) override {
+        _syncSource->recordRequest(toSend);
+        if (!recv(response, toSend.header().getId())) {
+            uasserted(ErrorCodes::HostUnreachable, "network error from mock sync source");
+        }
+        return true;
+    }
+
+    bool recv(Message& m, int lastRequestId) override {
+        return _syncSource->nextReply(this, &m);
+    }
+
+private:
+    StreamingSyncSourceMock* const _syncSource;
+};
+
+class OplogFetcherExhaustTest : public OplogFetcherTest, public ScopedGlobalServiceContextForTest {
+protected:
+    void setUp() override {
+        OplogFetcherTest::setUp();
+        oplogFetcherUsesExhaust.store(true);
+        enqueueDocumentsFn = [this](Fetcher::Documents::const_iterator begin,
+                                    Fetcher::Documents::const_iterator end,
+                                    const OplogFetcher::DocumentsInfo& info) -> Status {
+            stdx::lock_guard<stdx::mutex> lk(enqueuedMutex);
+            enqueued.insert(enqueued.end(), begin, end);
+            return Status::OK();
+        };
+    }
+
+    void tearDown() override {
+        oplogFetcherUsesExhaust.store(false);
+        OplogFetcherTest::tearDown();
+    }
+
+    std::unique_ptr<OplogFetcher> makeStreamingOplogFetcher(std::size_t maxFetcherRestarts) {
+        auto oplogFetcher = std::make_unique<OplogFetcher>(&getExecutor(),
+                                                           lastFetched,
+                                                           source,
+                                                           nss,
+                                                           _createConfig(),
+                                                           maxFetcherRestarts,
+                                                           rbid,
+                                                           false,
+                                                           dataReplicatorExternalState.get(),
+                                                           enqueueDocumentsFn,
+                                                           std::ref(shutdownState),
+                                                           defaultBatchSize);
+        oplogFetcher->setCreateClientFn_forTest([this] {
+            ++syncSource.numConnections;
+            return std::make_unique<StreamingConnectionMock>(&syncSource);
+        });
+        return oplogFetcher;
+    }
+
+    StreamingSyncSourceMock syncSource;
+    ShutdownState shutdownState;
+    stdx::mutex enqueuedMutex;
+    Fetcher::Documents enqueued;
+};
+
+TEST_F(OplogFetcherExhaustTest, StreamSendsOneExhaustGetMoreAndProcessesEveryPushedBatch) {
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(lastFetched)}));
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(Seconds(124))}, false), true);
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(Seconds(125))}, false), true);
+    syncSource.addReply(makeCursorResponse(0, {makeNoopOplogEntry(Seconds(126))}, false));
+
+    auto oplogFetcher = makeStreamingOplogFetcher(0);
+    ASSERT_OK(oplogFetcher->startup());
+    oplogFetcher->join();
+
+    ASSERT_OK(shutdownState.getStatus());
+    auto requests = syncSource.getRequests();
+    ASSERT_EQUALS(2U, requests.size());
+    ASSERT_EQUALS(std::string("find"), requests[0].first.firstElementFieldName());
+    ASSERT_FALSE(requests[0].second);
+    ASSERT_EQUALS(std::string("getMore"), requests[1].first.firstElementFieldName());
+    ASSERT_TRUE(requests[1].second);
+
+    ASSERT_EQUALS(3U, enqueued.size());
+    ASSERT_BSONOBJ_EQ(makeNoopOplogEntry(Seconds(126)), enqueued.back());
+}
+
+TEST_F(OplogFetcherExhaustTest, StreamSendsAnotherExhaustGetMoreAfterAReplyWithoutMoreToCome) {
+    // A sync source which ignores the exhaust flag answers each getMore with a single batch.
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(lastFetched)}));
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(Seconds(124))}, false));
+    syncSource.addReply(makeCursorResponse(0, {makeNoopOplogEntry(Seconds(125))}, false));
+
+    auto oplogFetcher = makeStreamingOplogFetcher(0);
+    ASSERT_OK(oplogFetcher->startup());
+    oplogFetcher->join();
+
+    ASSERT_OK(shutdownState.getStatus());
+    auto requests = syncSource.getRequests();
+    ASSERT_EQUALS(3U, requests.size());
+    for (size_t i = 1; i < requests.size(); ++i) {
+        ASSERT_EQUALS(std::string("getMore"), requests[i].first.firstElementFieldName());
+        ASSERT_EQUALS(1, requests[i].first["getMore"].numberLong());
+        ASSERT_TRUE(requests[i].second);
+    }
+    ASSERT_EQUALS(1, syncSource.numConnections);
+    ASSERT_EQUALS(2U, enqueued.size());
+}
+
+TEST_F(OplogFetcherExhaustTest, StreamRestartsFromLastFetchedOpTimeAfterNetworkError) {
+    syncSource.addReply(makeCursorResponse(
+        1, {makeNoopOplogEntry(lastFetched), makeNoopOplogEntry(Seconds(124))}));
+    syncSource.addNetworkError();
+    syncSource.addReply(makeCursorResponse(
+        0, {makeNoopOplogEntry(Seconds(124)), makeNoopOplogEntry(Seconds(125))}));
+
+    auto oplogFetcher = makeStreamingOplogFetcher(1);
+    ASSERT_OK(oplogFetcher->startup());
+    oplogFetcher->join();
+
+    ASSERT_OK(shutdownState.getStatus());
+    ASSERT_EQUALS(2, syncSource.numConnections);
+
+    // The new stream starts with a new `find` from the last optime fetched by the old one.
+    auto requests = syncSource.getRequests();
+    ASSERT_EQUALS(3U, requests.size());
+    ASSERT_EQUALS(std::string("find"), requests[2].first.firstElementFieldName());
+    ASSERT_BSONOBJ_EQ(BSON("ts" << BSON("$gte" << Timestamp(Seconds(124), 0))),
+                      requests[2].first["filter"].Obj());
+
+    // The document which the new stream starts from is not enqueued again.
+    ASSERT_EQUALS(2U, enqueued.size());
+    ASSERT_BSONOBJ_EQ(makeNoopOplogEntry(Seconds(124)), enqueued[0]);
+    ASSERT_BSONOBJ_EQ(makeNoopOplogEntry(Seconds(125)), enqueued[1]);
+}
+
+TEST_F(OplogFetcherExhaustTest, StreamRestartsAfterQueryError) {
+    syncSource.addReply(BSON("ok" << 0 << "code" << static_cast<int>(ErrorCodes::OperationFailed)
+                                  << "errmsg"
+                                  << "find failed"));
+    syncSource.addReply(makeCursorResponse(0, {makeNoopOplogEntry(lastFetched)}));
+
+    auto oplogFetcher = makeStreamingOplogFetcher(1);
+    ASSERT_OK(oplogFetcher->startup());
+    oplogFetcher->join();
+
+    ASSERT_OK(shutdownState.getStatus());
+    ASSERT_EQUALS(2, syncSource.numConnections);
+}
+
+TEST_F(OplogFetcherExhaustTest, StreamStopsWithTheErrorOnceNoRestartsAreLeft) {
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(lastFetched)}));
+    syncSource.addNetworkError();
+
+    auto oplogFetcher = makeStreamingOplogFetcher(0);
+    ASSERT_OK(oplogFetcher->startup());
+    oplogFetcher->join();
+
+    ASSERT_EQUALS(ErrorCodes::HostUnreachable, shutdownState.getStatus());
+    ASSERT_EQUALS(1, syncSource.numConnections);
+}
+
+TEST_F(OplogFetcherExhaustTest, ShutdownInterruptsTheStreamWhileItWaitsForABatch) {
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(lastFetched)}));
+    syncSource.addReply(makeCursorResponse(1, {makeNoopOplogEntry(Seconds(124))}, false), true);
+
+    auto oplogFetcher = makeStreamingOplogFetcher(1);
+    ASSERT_OK(oplogFetcher->startup());
+
+    // The sync source has nothing more to push, so the stream is blocked reading from it.
+    syncSource.waitForBlockedRead();
+    ASSERT_TRUE(oplogFetcher->isActive());
+
+    oplogFetcher->shutdown();
+    oplogFetcher->join();
+
+    // The interrupted read is not treated as an error to restart from.
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, shutdownState.getStatus());
+    ASSERT_EQUALS(1, syncSource.numConnections);
+    ASSERT_EQUALS(1U, enqueued.size());
+}
+
 }  // namespace
@@ -111,6 +111,17 @@ Counter64 userOpsRunning;
 ServerStatusMetricField<Counter64> displayUserOpsRunning("repl.stepDown.userOperationsRunning",
                                                          &userOpsRunning);
 
+// Tracks the work done to wake replication and opTime waiters whenever they may be done waiting.
+Counter64 waiterSignalPasses;
+ServerStatusMetricField<Counter64> displayWaiterSignalPasses("repl.waiters.signalPasses",
+                                                             &waiterSignalPasses);
+Counter64 waitersExamined;
+ServerStatusMetricField<Counter64> displayWaitersExamined("repl.waiters.examined",
+                                                          &waitersExamined);
+Counter64 waitersSignaled;
+ServerStatusMetricField<Counter64> displayWaitersSignaled("repl.waiters.signaled",
+                                                          &waitersSignaled);
+
 using CallbackArgs = executor::TaskExecutor::CallbackArgs;
 using CallbackFn = executor::TaskExecutor::CallbackFn;
 using CallbackHandle = executor::TaskExecutor::CallbackHandle;
@@ -246,40 +257,69 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::GroupKey
+ReplicationCoordinatorImpl::WaiterList::_makeGroupKey(WaiterType waiter) {
+    if (!waiter->writeConcern) {
+        return GroupKey();
+    }
+    return GroupKey(waiter->writeConcern->wMode,
+                    waiter->writeConcern->wNumNodes,
+                    static_cast<int>(waiter->writeConcern->syncMode));
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    auto& group = _groups[_makeGroupKey(waiter)];
+    if (waiter->opTime.getTerm() == OpTime::kUninitializedTerm) {
+        group.byTimestamp.emplace(waiter->opTime.getTimestamp(), waiter);
+    } else {
+        group.byOpTime.emplace(waiter->opTime, waiter);
+    }
 }
 
-void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(std::function<bool(WaiterType)> func) {
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
-            // This element doesn't match, so we advance the iterator to the next one.
-            ++it;
-            continue;
+template <typename Key>
+void ReplicationCoordinatorImpl::WaiterList::_signalIf_inlock(
+    std::multimap<Key, WaiterType>* waiters,
+    const std::function<bool(WaiterType)>& func,
+    std::vector<WaiterType>* waitersToNotify) {
+    for (auto it = waiters->begin(); it != waiters->end();) {
+        waitersExamined.increment();
+        if (!func(it->second)) {
+            // Every later waiter waits for a later opTime, so none of them can match either.
+            break;
         }
 
-        if (!(*it)->runs_once()) {
-            (*it)->notify_inlock();
-            // Keep the waiter on the list and let the guard remove it instead. Advance the
-            // iterator since we are skipping the removal.
+        waitersToNotify->push_back(it->second);
+        if (!it->second->runs_once()) {
+            // Keep the waiter on the list and let the guard remove it instead.
             ++it;
             continue;
         }
 
         // Remove the waiter from the list if it was only meant to be notified once.
-        WaiterType waiter = std::move(*it);
+        it = waiters->erase(it);
+    }
+}
+
+void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(std::function<bool(WaiterType)> func) {
+    waiterSignalPasses.increment();
+
+    std::vector<WaiterType> waitersToNotify;
+    for (auto groupIt = _groups.begin(); groupIt != _groups.end();) {
+        auto& group = groupIt->second;
+        _signalIf_inlock(&group.byOpTime, func, &waitersToNotify);
+        _signalIf_inlock(&group.byTimestamp, func, &waitersToNotify);
 
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+        if (group.empty()) {
+            groupIt = _groups.erase(groupIt);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++groupIt;
         }
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+    }
+
+    // It's important to call notify() after the waiters have been removed from the list and we
+    // are done iterating over it, since notify() might add or remove waiters.
+    waitersSignaled.increment(waitersToNotify.size());
+    for (auto&& waiter : waitersToNotify) {
         waiter->notify_inlock();
     }
 }
@@ -289,16 +329,43 @@ void ReplicationCoordinatorImpl::WaiterList::signalAll_inlock() {
     this->signalIf_inlock([](Waiter* waiter) { return true; });
 }
 
-bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+size_t ReplicationCoordinatorImpl::WaiterList::size_inlock() const {
+    size_t size = 0;
+    for (auto&& group : _groups) {
+        size += group.second.byOpTime.size() + group.second.byTimestamp.size();
+    }
+    return size;
+}
+
+template <typename Key>
+bool ReplicationCoordinatorImpl::WaiterList::_remove_inlock(std::multimap<Key, WaiterType>* waiters,
+                                                            const Key& key,
+                                                            WaiterType waiter) {
+    auto range = waiters->equal_range(key);
+    auto it = std::find_if(
+        range.first, range.second, [waiter](const auto& entry) { return entry.second == waiter; });
+    if (it == range.second) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+    waiters->erase(it);
     return true;
 }
 
+bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
+    auto groupIt = _groups.find(_makeGroupKey(waiter));
+    if (groupIt == _groups.end()) {
+        return false;
+    }
+    auto& group = groupIt->second;
+    const bool removed = waiter->opTime.getTerm() == OpTime::kUninitializedTerm
+        ? _remove_inlock(&group.byTimestamp, waiter->opTime.getTimestamp(), waiter)
+        : _remove_inlock(&group.byOpTime, waiter->opTime, waiter);
+    if (group.empty()) {
+        _groups.erase(groupIt);
+    }
+    return removed;
+}
+
 namespace {
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
@@ -3547,6 +3614,11 @@ std::set<OpTimeAndWallTime> ReplicationCoordinatorImpl::getStableOpTimeCandidate
     return _stableOpTimeCandidates;
 }
 
+size_t ReplicationCoordinatorImpl::getNumOpTimeWaiters_forTest() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _opTimeWaiterList.size_inlock();
+}
+
 void ReplicationCoordinatorImpl::attemptToAdvanceStableTimestamp() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     _setStableTimestampForStorage(lk);
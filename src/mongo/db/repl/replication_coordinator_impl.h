@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -395,6 +398,12 @@ public:
                                                OpTimeAndWallTime stableOpTime);
     std::set<OpTimeAndWallTime> getStableOpTimeCandidates_forTest();
 
+    /**
+     * Returns the number of waiters for an opTime, such as reads with a local afterOpTime or
+     * afterClusterTime, which have not yet been removed from the list of opTime waiters.
+     */
+    size_t getNumOpTimeWaiters_forTest();
+
     /**
      * Non-blocking version of updateTerm.
      * Returns event handle that we can use to wait for the operation to complete.
@@ -625,6 +634,14 @@ private:
 
     class WaiterGuard;
 
+    // Waiters are grouped by the parts of their write concern that decide when they are done
+    // waiting, and ordered by opTime within each group. Since a waiter that is done implies that
+    // every waiter in its group with an earlier opTime is done too, signaling only has to look at
+    // the prefix of each group that is done, plus the first waiter that is not.
+    //
+    // An opTime with an uninitialized term, such as one waited for by an afterClusterTime read,
+    // compares with any other opTime by timestamp alone. Mixed with opTimes that have a term, this
+    // is not a strict weak ordering, so such waiters are kept apart and ordered by timestamp.
     class WaiterList {
     public:
         using WaiterType = Waiter*;
@@ -633,13 +650,47 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals all waiters that satisfy the condition.
+        // Signals all waiters that satisfy the condition. The condition must hold for every waiter
+        // with an earlier opTime in the same group as a waiter it holds for, and for every waiter
+        // with an uninitialized term and an earlier timestamp in that group.
         void signalIf_inlock(std::function<bool(WaiterType)> fun);
         // Signals all waiters from the list.
         void signalAll_inlock();
+        // Returns the number of waiters in the list.
+        size_t size_inlock() const;
 
     private:
-        std::vector<WaiterType> _list;
+        // The 'w' mode, 'w' number of nodes and sync mode of a waiter's write concern. Waiters
+        // without a write concern share a single group.
+        using GroupKey = std::tuple<std::string, int, int>;
+
+        struct Group {
+            bool empty() const {
+                return byOpTime.empty() && byTimestamp.empty();
+            }
+
+            // Waiters for an opTime with a term.
+            std::multimap<OpTime, WaiterType> byOpTime;
+            // Waiters for an opTime with an uninitialized term.
+            std::multimap<Timestamp, WaiterType> byTimestamp;
+        };
+
+        static GroupKey _makeGroupKey(WaiterType waiter);
+
+        // Signals the waiters in 'waiters' up to the first one which does not satisfy 'func',
+        // removing those that run once and appending all of them to 'waitersToNotify'.
+        template <typename Key>
+        static void _signalIf_inlock(std::multimap<Key, WaiterType>* waiters,
+                                     const std::function<bool(WaiterType)>& func,
+                                     std::vector<WaiterType>* waitersToNotify);
+
+        // Removes 'waiter' from 'waiters', in which it is keyed by 'key'.
+        template <typename Key>
+        static bool _remove_inlock(std::multimap<Key, WaiterType>* waiters,
+                                   const Key& key,
+                                   WaiterType waiter);
+
+        std::map<GroupKey, Group> _groups;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
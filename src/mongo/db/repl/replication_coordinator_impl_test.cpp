@@ -1099,6 +1099,61 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesWaitersWithDifferentWriteConcernsAndOpTimes) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version" << 2 << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id" << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id" << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id" << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    replCoordSetMyLastAppliedOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+    replCoordSetMyLastDurableOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+    replCoordSetMyLastAppliedOpTime(time2, Date_t() + Seconds(100));
+    replCoordSetMyLastDurableOpTime(time2, Date_t() + Seconds(100));
+
+    WriteConcernOptions twoNodes;
+    twoNodes.wTimeout = WriteConcernOptions::kNoTimeout;
+    twoNodes.wNumNodes = 2;
+    WriteConcernOptions threeNodes = twoNodes;
+    threeNodes.wNumNodes = 3;
+
+    // Waiters with the same write concern at different optimes, and a waiter with a stricter
+    // write concern at the earlier optime.
+    ReplicationAwaiter awaiterTwoNodesTime1(getReplCoord(), getServiceContext());
+    awaiterTwoNodesTime1.setOpTime(time1);
+    awaiterTwoNodesTime1.setWriteConcern(twoNodes);
+    ReplicationAwaiter awaiterTwoNodesTime2(getReplCoord(), getServiceContext());
+    awaiterTwoNodesTime2.setOpTime(time2);
+    awaiterTwoNodesTime2.setWriteConcern(twoNodes);
+    ReplicationAwaiter awaiterThreeNodesTime1(getReplCoord(), getServiceContext());
+    awaiterThreeNodesTime1.setOpTime(time1);
+    awaiterThreeNodesTime1.setWriteConcern(threeNodes);
+    awaiterTwoNodesTime2.start();
+    awaiterThreeNodesTime1.start();
+    awaiterTwoNodesTime1.start();
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(awaiterTwoNodesTime1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(awaiterThreeNodesTime1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiterTwoNodesTime2.getResult().status);
+}
+
 TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBeforeBeingSatisified) {
     assertStartSuccess(BSON("_id"
                             << "mySet"
@@ -4469,6 +4524,52 @@ TEST_F(ReplCoordTest, ReadAfterCommittedDeferredEqualOpTime) {
     pseudoLogOp.get();
 }
 
+TEST_F(ReplCoordTest, NodeWakesAfterClusterTimeAndAfterOpTimeReadsWaitingTogether) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version" << 2 << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id" << 0))),
+                       HostAndPort("node1", 12345));
+    replCoordSetMyLastAppliedOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+    replCoordSetMyLastDurableOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+
+    // The opTime waited for by an afterClusterTime read has no term, so it compares with the
+    // others by timestamp only. Ordered by opTime alone, the first three targets would form a
+    // cycle: {ts: 300, t: 1} < {ts: 200, t: 2} < {ts: 250} < {ts: 300, t: 1}.
+    const std::vector<ReadConcernArgs> readConcerns{
+        ReadConcernArgs(OpTime(Timestamp(300, 1), 1), ReadConcernLevel::kLocalReadConcern),
+        ReadConcernArgs(OpTime(Timestamp(200, 1), 2), ReadConcernLevel::kLocalReadConcern),
+        ReadConcernArgs(LogicalTime(Timestamp(250, 1)), ReadConcernLevel::kLocalReadConcern),
+        ReadConcernArgs(LogicalTime(Timestamp(350, 1)), ReadConcernLevel::kLocalReadConcern)};
+
+    std::vector<ServiceContext::UniqueClient> clients;
+    std::vector<ServiceContext::UniqueOperationContext> opCtxs;
+    std::vector<stdx::future<Status>> reads;
+    for (auto&& readConcern : readConcerns) {
+        clients.push_back(getServiceContext()->makeClient("reader"));
+        opCtxs.push_back(clients.back()->makeOperationContext());
+        auto opCtx = opCtxs.back().get();
+        reads.push_back(stdx::async(stdx::launch::async, [this, opCtx, readConcern] {
+            return getReplCoord()->waitUntilOpTimeForRead(opCtx, readConcern);
+        }));
+    }
+    while (getReplCoord()->getNumOpTimeWaiters_forTest() < reads.size()) {
+        sleepmillis(10);
+    }
+
+    replCoordSetMyLastAppliedOpTime(OpTime(Timestamp(260, 1), 2), Date_t() + Seconds(100));
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_OK(reads[i].get());
+    }
+    ASSERT_EQUALS(1U, getReplCoord()->getNumOpTimeWaiters_forTest());
+
+    replCoordSetMyLastAppliedOpTime(OpTime(Timestamp(400, 1), 2), Date_t() + Seconds(100));
+    ASSERT_OK(reads[3].get());
+    ASSERT_EQUALS(0U, getReplCoord()->getNumOpTimeWaiters_forTest());
+}
+
 
 TEST_F(ReplCoordTest, WaitUntilOpTimeforReadRejectsUnsupportedMajorityReadConcern) {
     assertStartSuccess(BSON("_id"
@@ -67,6 +67,7 @@
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -703,6 +704,24 @@ void SyncTail::oplogApplication(OplogBuffer* oplogBuffer,
     _oplogApplication(replCoord, &batcher);
 }
 
+namespace {
+
+/**
+ * Returns whether the next batch may be prepared while 'ops' is being applied. Partitioning a batch
+ * depends on the collection catalog, so only batches which cannot change it are overlapped with the
+ * preparation of their successor.
+ */
+bool canPrepareNextBatchDuring(const MultiApplier::Operations& ops) {
+    if (!replPipelineBatchApplication.load() || MONGO_FAIL_POINT(rsSyncApplyStop)) {
+        return false;
+    }
+    return std::all_of(ops.cbegin(), ops.cend(), [](const OplogEntry& op) {
+        return op.isCrudOpType() || op.getOpType() == OpTypeEnum::kNoop;
+    });
+}
+
+}  // namespace
+
 void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
                                  OpQueueBatcher* batcher) noexcept {
     std::unique_ptr<ApplyBatchFinalizer> finalizer{
@@ -713,7 +732,18 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
     // Get replication consistency markers.
     OpTime minValid;
 
+    // A batch that was written to the oplog and partitioned while the previous batch was being
+    // applied. It is applied before anything else is taken from the batcher.
+    std::unique_ptr<PreparedBatch> preparedBatch;
+
+    // Set if the batcher signaled shutdown while we were preparing the next batch.
+    bool mustShutdown = false;
+
     while (true) {  // Exits on message from OpQueueBatcher.
+        if (mustShutdown && !preparedBatch) {
+            return;
+        }
+
         // Use a new operation context each iteration, as otherwise we may appear to use a single
         // collection name to refer to collections with different UUIDs.
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
@@ -745,24 +775,34 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
         // Transition to SECONDARY state, if possible.
         tryToGoLiveAsASecondary(&opCtx, replCoord, minValid);
 
-        long long termWhenBufferIsEmpty = replCoord->getTerm();
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher->getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
-                // Shut down and exit oplog application loop.
-                return;
-            }
-            if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
-                continue;
+        const bool isPrepared = bool(preparedBatch);
+        if (!isPrepared) {
+            long long termWhenBufferIsEmpty = replCoord->getTerm();
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't
+            // become ready in time, we'll loop again so we can do the above checks periodically.
+            OpQueue ops = batcher->getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    // Shut down and exit oplog application loop.
+                    return;
+                }
+                if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+                    continue;
+                }
+                // Signal drain complete if we're in Draining state and the buffer is empty.
+                replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
+                continue;  // Try again.
             }
-            // Signal drain complete if we're in Draining state and the buffer is empty.
-            replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
-            continue;  // Try again.
+
+            preparedBatch = std::make_unique<PreparedBatch>();
+            preparedBatch->ops = ops.releaseBatch();
         }
 
-        // Extract some info from ops that we'll need after releasing the batch below.
+        // Take ownership of the batch so that the next one can be prepared in its place.
+        auto batch = std::move(preparedBatch);
+        const auto& ops = batch->ops;
+
+        // Extract some info from ops that we'll need after applying the batch below.
         const auto firstOpTimeInBatch = ops.front().getOpTime();
         const auto lastOpInBatch = ops.back();
         const auto lastOpTimeInBatch = lastOpInBatch.getOpTime();
@@ -782,10 +822,28 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
-        // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
+        // While this batch is being applied, write the next batch to the oplog and partition it
+        // among the writer threads. Its consistency markers are only reset once this batch has
+        // been finalized, so a crash in the meantime truncates its oplog entries and replays
+        // this batch alone.
+        PrepareNextBatchFn prepareNextBatch;
+        if (canPrepareNextBatchDuring(ops)) {
+            prepareNextBatch = [&](OperationContext* applyOpCtx) {
+                OpQueue nextOps = batcher->getNextBatch(Seconds(0));
+                if (nextOps.empty()) {
+                    mustShutdown = nextOps.mustShutdown();
+                    return;
+                }
+                preparedBatch = std::make_unique<PreparedBatch>();
+                preparedBatch->ops = nextOps.releaseBatch();
+                _prepareBatch(applyOpCtx, preparedBatch.get());
+            };
+        }
+
+        // Apply the operations in this batch. '_multiApply' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
-        auto lastOpTimeAppliedInBatch =
-            fassertNoTrace(34437, multiApply(&opCtx, ops.releaseBatch()));
+        auto lastOpTimeAppliedInBatch = fassertNoTrace(
+            34437, _multiApply(&opCtx, batch.get(), isPrepared, prepareNextBatch));
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
         // In order to provide resilience in the event of a crash in the middle of batch
@@ -1029,6 +1087,7 @@ Status multiSyncApply(OperationContext* opCtx,
     const auto oplogApplicationMode = st->getOptions().mode;
 
     ApplierHelpers::InsertGroup insertGroup(ops, opCtx, oplogApplicationMode);
+    ApplierHelpers::UpdateGroup updateGroup(ops, opCtx, oplogApplicationMode);
 
     {  // Ensure that the MultikeyPathTracker stops tracking paths.
         ON_BLOCK_EXIT([opCtx] { MultikeyPathTracker::get(opCtx).stopTrackingMultikeyPathInfo(); });
@@ -1045,6 +1104,15 @@ Status multiSyncApply(OperationContext* opCtx,
                 continue;
             }
 
+            // Likewise for runs of updates to the same document. The updates folded into the
+            // coalesced update count as applied.
+            auto updateGroupResult = updateGroup.groupAndApplyUpdates(it);
+            if (updateGroupResult.isOK()) {
+                opsAppliedStats.increment(std::distance(it, updateGroupResult.getValue()));
+                it = updateGroupResult.getValue();
+                continue;
+            }
+
             // If we didn't create a group, try to apply the op individually.
             try {
                 auto stableTimestampForRecovery = st->getOptions().stableTimestampForRecovery;
@@ -1297,7 +1365,55 @@ void SyncTail::_applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors
     }
 }
 
+void SyncTail::_prepareBatch(OperationContext* opCtx, PreparedBatch* batch) {
+    auto& ops = batch->ops;
+    invariant(!ops.empty());
+
+    // Write batch of ops into oplog.
+    if (!_options.skipWritesToOplog) {
+        _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
+        scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
+    }
+
+    // Holds 'pseudo operations' generated by secondaries to aid in replication.
+    // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
+    // Pseudo operations include:
+    // - applyOps operations expanded to individual ops.
+    // - ops to update config.transactions. Normal writes to config.transactions in the
+    //   primary don't create an oplog entry, so extract info from writes with transactions
+    //   and create a pseudo oplog.
+    batch->writerVectors.resize(_writerPool->getStats().numThreads);
+    fillWriterVectors(opCtx, &ops, &batch->writerVectors, &batch->derivedOps);
+}
+
+void SyncTail::_finishPreparingBatch(OperationContext* opCtx, const PreparedBatch& batch) {
+    // Use this fail point to hold the PBWM lock after we have written the oplog entries but
+    // before we have applied them.
+    if (MONGO_FAIL_POINT(pauseBatchApplicationAfterWritingOplogEntries)) {
+        log() << "pauseBatchApplicationAfterWritingOplogEntries fail point enabled. Blocking "
+                 "until fail point is disabled.";
+        MONGO_FAIL_POINT_PAUSE_WHILE_SET_OR_INTERRUPTED(
+            opCtx, pauseBatchApplicationAfterWritingOplogEntries);
+    }
+
+    // Reset consistency markers in case the node fails while applying ops.
+    if (!_options.skipWritesToOplog) {
+        _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+        _consistencyMarkers->setMinValidToAtLeast(opCtx, batch.ops.back().getOpTime());
+    }
+}
+
 StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
+    PreparedBatch batch;
+    batch.ops = std::move(ops);
+    return _multiApply(opCtx, &batch, false /* isPrepared */, PrepareNextBatchFn());
+}
+
+StatusWith<OpTime> SyncTail::_multiApply(OperationContext* opCtx,
+                                         PreparedBatch* batch,
+                                         bool isPrepared,
+                                         const PrepareNextBatchFn& prepareNextBatch) {
+    const auto& ops = batch->ops;
     invariant(!ops.empty());
 
     LOG(2) << "replication batch size is " << ops.size();
@@ -1325,45 +1441,26 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         // because the spawned threads refer to objects on the stack
         ON_BLOCK_EXIT([&] { _writerPool->waitForIdle(); });
 
-        // Write batch of ops into oplog.
-        if (!_options.skipWritesToOplog) {
-            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
-            scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
-        }
+        if (!isPrepared) {
+            _prepareBatch(opCtx, batch);
 
-        // Holds 'pseudo operations' generated by secondaries to aid in replication.
-        // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
-        // Pseudo operations include:
-        // - applyOps operations expanded to individual ops.
-        // - ops to update config.transactions. Normal writes to config.transactions in the
-        //   primary don't create an oplog entry, so extract info from writes with transactions
-        //   and create a pseudo oplog.
-        std::vector<MultiApplier::Operations> derivedOps;
-
-        std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
-        fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
-
-        // Wait for writes to finish before applying ops.
-        _writerPool->waitForIdle();
-
-        // Use this fail point to hold the PBWM lock after we have written the oplog entries but
-        // before we have applied them.
-        if (MONGO_FAIL_POINT(pauseBatchApplicationAfterWritingOplogEntries)) {
-            log() << "pauseBatchApplicationAfterWritingOplogEntries fail point enabled. Blocking "
-                     "until fail point is disabled.";
-            MONGO_FAIL_POINT_PAUSE_WHILE_SET_OR_INTERRUPTED(
-                opCtx, pauseBatchApplicationAfterWritingOplogEntries);
+            // Wait for writes to finish before applying ops.
+            _writerPool->waitForIdle();
         }
 
-        // Reset consistency markers in case the node fails while applying ops.
-        if (!_options.skipWritesToOplog) {
-            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
-            _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
-        }
+        _finishPreparingBatch(opCtx, *batch);
 
         {
             std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
-            _applyOps(writerVectors, &statusVector, &multikeyVector);
+            _applyOps(batch->writerVectors, &statusVector, &multikeyVector);
+
+            // Overlap preparing the next batch with applying this one. Its oplog writes are queued
+            // behind this batch's writer tasks, so they run on threads that finish their share of
+            // this batch early.
+            if (prepareNextBatch) {
+                prepareNextBatch(opCtx);
+            }
+
             _writerPool->waitForIdle();
 
             // If any of the statuses is not ok, return error.
@@ -232,8 +232,49 @@ public:
 private:
     class OpQueueBatcher;
 
+    /**
+     * A batch that has been written to the oplog and partitioned among the writer threads, but not
+     * yet applied. 'writerVectors' points into 'ops' and 'derivedOps', so a PreparedBatch must not
+     * be moved once it has been filled in.
+     */
+    struct PreparedBatch {
+        MultiApplier::Operations ops;
+        std::vector<MultiApplier::Operations> derivedOps;
+        std::vector<MultiApplier::OperationPtrs> writerVectors;
+    };
+
+    /**
+     * Called by _multiApply() while the writer threads are applying the current batch. Prepares the
+     * next batch, if one is available, so that it does not have to wait for the current batch.
+     */
+    using PrepareNextBatchFn = std::function<void(OperationContext* opCtx)>;
+
     void _oplogApplication(ReplicationCoordinator* replCoord, OpQueueBatcher* batcher) noexcept;
 
+    /**
+     * Sets the oplog truncate point, schedules the writes of 'batch->ops' to the oplog on the
+     * writer pool and fills in the writer vectors. The caller must wait for the writer pool to go
+     * idle before the oplog writes can be relied upon.
+     */
+    void _prepareBatch(OperationContext* opCtx, PreparedBatch* batch);
+
+    /**
+     * Must be called after the oplog writes scheduled by _prepareBatch() have completed and before
+     * the batch is applied. Resets the consistency markers so that a crash while applying the batch
+     * is recovered by replaying it.
+     */
+    void _finishPreparingBatch(OperationContext* opCtx, const PreparedBatch& batch);
+
+    /**
+     * Implements multiApply(). If 'isPrepared' is true, _prepareBatch() has already been called on
+     * 'batch' and its oplog writes have completed. If 'prepareNextBatch' is set, it is run on this
+     * thread, under the PBWM lock, while the writer threads apply 'batch'.
+     */
+    StatusWith<OpTime> _multiApply(OperationContext* opCtx,
+                                   PreparedBatch* batch,
+                                   bool isPrepared,
+                                   const PrepareNextBatchFn& prepareNextBatch);
+
     void _fillWriterVectors(OperationContext* opCtx,
                             MultiApplier::Operations* ops,
                             std::vector<MultiApplier::OperationPtrs>* writerVectors,
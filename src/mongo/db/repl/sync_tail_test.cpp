@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <algorithm>
+#include <deque>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -56,6 +57,7 @@
 #include "mongo/db/repl/idempotency_test_fixture.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/replication_process.h"
@@ -1768,6 +1770,63 @@ TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingInsertsIndividuallyWhenGro
     ASSERT_EQUALS(1U, numFailedGroupedInserts);
 }
 
+class SyncTailUpdateCoalescingTest : public SyncTailTest {
+protected:
+    /**
+     * Applies 'updates' to the document {_id: 0, a: 0, b: 0} in a new collection, and returns the
+     * number of update writes that were made along with the resulting document.
+     */
+    std::pair<std::size_t, BSONObj> applyUpdatesToNewDocument(const std::vector<BSONObj>& updates) {
+        NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+        int seconds = 1;
+        MultiApplier::Operations ops;
+        ops.push_back(
+            makeCreateCollectionOplogEntry({Timestamp(Seconds(seconds++), 0), 1LL}, nss));
+        ops.push_back(makeInsertDocumentOplogEntry({Timestamp(Seconds(seconds++), 0), 1LL},
+                                                   nss,
+                                                   BSON("_id" << 0 << "a" << 0 << "b" << 0)));
+        for (const auto& update : updates) {
+            ops.push_back(makeUpdateDocumentOplogEntry(
+                {Timestamp(Seconds(seconds++), 0), 1LL}, nss, BSON("_id" << 0), update));
+        }
+
+        std::size_t numUpdates = 0;
+        _opObserver->onUpdateFn = [&](OperationContext*, const OplogUpdateEntryArgs&) {
+            numUpdates++;
+        };
+        ASSERT_OK(runOpsSteadyState(ops));
+
+        CollectionReader collectionReader(_opCtx.get(), nss);
+        return {numUpdates, unittest::assertGet(collectionReader.next())};
+    }
+};
+
+TEST_F(SyncTailUpdateCoalescingTest, MultiSyncApplyCoalescesUpdatesToTheSameDocument) {
+    auto result = applyUpdatesToNewDocument({BSON("$set" << BSON("a" << 1 << "b" << 1)),
+                                             BSON("$set" << BSON("a" << 2)),
+                                             BSON("$set" << BSON("b" << 3))});
+    ASSERT_EQUALS(1U, result.first);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 0 << "a" << 2 << "b" << 3), result.second);
+}
+
+TEST_F(SyncTailUpdateCoalescingTest, MultiSyncApplyDoesNotCoalesceUpdatesThatTouchNewFields) {
+    auto result = applyUpdatesToNewDocument({BSON("$set" << BSON("d" << 1)),
+                                             BSON("$set" << BSON("c" << 1)),
+                                             BSON("$unset" << BSON("c" << true)),
+                                             BSON("$set" << BSON("c" << 2))});
+    ASSERT_EQUALS(4U, result.first);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 0 << "a" << 0 << "b" << 0 << "d" << 1 << "c" << 2),
+                      result.second);
+}
+
+TEST_F(SyncTailUpdateCoalescingTest, MultiSyncApplyDoesNotCoalesceUpdatesThatSetArrays) {
+    auto result = applyUpdatesToNewDocument({BSON("$set" << BSON("a" << 1)),
+                                             BSON("$set" << BSON("a" << BSON_ARRAY(1))),
+                                             BSON("$set" << BSON("a" << 2))});
+    ASSERT_EQUALS(3U, result.first);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 0 << "a" << 2 << "b" << 0), result.second);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyIgnoresUpdateOperationIfDocumentIsMissingFromSyncSource) {
     BSONObj emptyDoc;
     SyncTailWithLocalDocumentFetcher syncTail(emptyDoc);
@@ -1915,6 +1974,85 @@ DEATH_TEST_F(SyncTailTest,
     syncTail.oplogApplication(oplogBuffer.get(), getNextApplierBatchFn, &replCoord);
 }
 
+TEST_F(SyncTailTest, OplogApplicationAppliesEveryBatchWhenPreparingNextBatchDuringApplication) {
+    ASSERT_TRUE(replPipelineBatchApplication.load());
+    ASSERT_OK(
+        ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_SECONDARY));
+
+    NamespaceString nss("test.t");
+    std::deque<OplogApplier::Operations> batches;
+    std::vector<OpTime> expectedOpTimes;
+    for (int i = 0; i < 3; i++) {
+        OplogApplier::Operations batch;
+        for (int j = 0; j < 4; j++) {
+            batch.push_back(
+                makeInsertDocumentOplogEntry(nextOpTime(), nss, BSON("_id" << i * 4 + j)));
+            expectedOpTimes.push_back(batch.back().getOpTime());
+        }
+        batches.push_back(std::move(batch));
+    }
+
+    stdx::mutex mutex;
+    std::vector<OpTime> appliedOpTimes;
+    auto applyOperationFn = [&](OperationContext*,
+                                MultiApplier::OperationPtrs* ops,
+                                SyncTail*,
+                                WorkerMultikeyPathInfo*) {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        for (auto&& op : *ops) {
+            appliedOpTimes.push_back(op->getOpTime());
+        }
+        return Status::OK();
+    };
+    auto writerPool = OplogApplier::makeWriterPool();
+    OplogApplier::Options options(OplogApplication::Mode::kSecondary);
+    SyncTail syncTail(nullptr,  // observer. not required by oplogApplication().
+                      _consistencyMarkers.get(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get(),
+                      options);
+
+    // Hand out the batches one at a time and shut down once they have all been taken, so that the
+    // final batch may be prepared while its predecessor is being applied.
+    auto getNextApplierBatchFn =
+        [&](OperationContext* opCtx,
+            const OplogApplier::BatchLimits& batchLimits) -> StatusWith<OplogApplier::Operations> {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        if (batches.empty()) {
+            syncTail.shutdown();
+            return OplogApplier::Operations();
+        }
+        auto batch = std::move(batches.front());
+        batches.pop_front();
+        return batch;
+    };
+
+    // SyncTail::oplogApplication() creates its own OperationContext in the current thread context.
+    _opCtx = {};
+    OplogBufferBlockingQueue oplogBuffer;
+    syncTail.oplogApplication(
+        &oplogBuffer, getNextApplierBatchFn, ReplicationCoordinator::get(getServiceContext()));
+    _opCtx = cc().makeOperationContext();
+
+    std::sort(appliedOpTimes.begin(), appliedOpTimes.end());
+    ASSERT_EQUALS(expectedOpTimes.size(), appliedOpTimes.size());
+    for (size_t i = 0; i < expectedOpTimes.size(); i++) {
+        ASSERT_EQUALS(expectedOpTimes[i], appliedOpTimes[i]);
+    }
+
+    // Every batch was written to the oplog and the consistency markers describe the last one.
+    CollectionReader oplogReader(_opCtx.get(), NamespaceString::kRsOplogNamespace);
+    for (const auto& opTime : expectedOpTimes) {
+        auto oplogEntry = unittest::assertGet(oplogReader.next());
+        ASSERT_EQUALS(opTime.getTimestamp(), oplogEntry["ts"].timestamp());
+    }
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogReader.next().getStatus());
+    ASSERT_EQUALS(Timestamp(), _consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+    ASSERT_EQUALS(expectedOpTimes.back(), _consistencyMarkers->getMinValid(_opCtx.get()));
+    ASSERT_EQUALS(expectedOpTimes.back(), _consistencyMarkers->getAppliedThrough(_opCtx.get()));
+}
+
 TEST_F(IdempotencyTest, Geo2dsphereIndexFailedOnUpdate) {
     ASSERT_OK(
         ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_RECOVERING));
@@ -66,6 +66,13 @@ void SyncTailOpObserver::onInserts(OperationContext* opCtx,
     onInsertsFn(opCtx, nss, docs);
 }
 
+void SyncTailOpObserver::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) {
+    if (!onUpdateFn) {
+        return;
+    }
+    onUpdateFn(opCtx, args);
+}
+
 void SyncTailOpObserver::onDelete(OperationContext* opCtx,
                                   const NamespaceString& nss,
                                   OptionalCollectionUUID uuid,
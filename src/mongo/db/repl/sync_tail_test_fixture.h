@@ -61,6 +61,11 @@ public:
                    std::vector<InsertStatement>::const_iterator end,
                    bool fromMigrate) override;
 
+    /**
+     * This function is called whenever SyncTail updates a document in a collection.
+     */
+    void onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) override;
+
     /**
      * This function is called whenever SyncTail deletes a document from a collection.
      */
@@ -86,6 +91,8 @@ public:
     std::function<void(OperationContext*, const NamespaceString&, const std::vector<BSONObj>&)>
         onInsertsFn;
 
+    std::function<void(OperationContext*, const OplogUpdateEntryArgs&)> onUpdateFn;
+
     std::function<void(OperationContext*,
                        const NamespaceString&,
                        OptionalCollectionUUID,
@@ -1039,6 +1039,30 @@ DbResponse receivedCommands(OperationContext* opCtx,
         if (responseObj.getField("ok").trueValue() && !cursorObj.isEmpty()) {
             dbResponse.exhaustNS = cursorObj.getField("ns").String();
             dbResponse.exhaustCursorId = cursorObj.getField("id").numberLong();
+
+            // An oplog fetcher streaming over an exhaust cursor reports the commit point it has
+            // learned in 'lastKnownCommittedOpTime'. Advance it in the next synthetic getMore to
+            // the commit point just sent to the client, or awaitData would return immediately
+            // forever once the commit point moves.
+            const auto lastKnownCommittedOpTimeElem = request.body["lastKnownCommittedOpTime"];
+            if (request.getCommandName() == "getMore"_sd && lastKnownCommittedOpTimeElem) {
+                auto swOplogQueryMetadata = rpc::OplogQueryMetadata::readFromMetadata(responseObj);
+                if (swOplogQueryMetadata.isOK()) {
+                    const auto lastOpCommitted =
+                        swOplogQueryMetadata.getValue().getLastOpCommitted().opTime;
+                    BSONObjBuilder nextInvocationBuilder;
+                    for (const auto& elem : request.body) {
+                        if (elem.fieldNameStringData() ==
+                            lastKnownCommittedOpTimeElem.fieldNameStringData()) {
+                            lastOpCommitted.append(&nextInvocationBuilder,
+                                                   elem.fieldNameStringData().toString());
+                        } else {
+                            nextInvocationBuilder.append(elem);
+                        }
+                    }
+                    dbResponse.nextInvocation = nextInvocationBuilder.obj();
+                }
+            }
         }
     }
 
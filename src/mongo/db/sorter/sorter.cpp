@@ -48,6 +48,7 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
 #include <vector>
@@ -81,6 +82,20 @@ uint32_t addDataToChecksum(const void* startOfData, size_t sizeOfData, uint32_t
     return newChecksum;
 }
 
+// Bounds on the size of the blocks in which sorted data is written to and read back from disk.
+const size_t kMinSpillBlockSizeBytes = 64 * 1024;
+const size_t kMaxSpillBlockSizeBytes = 1024 * 1024;
+
+/**
+ * Returns the size of the blocks in which sorted data should be spilled. Larger blocks mean fewer
+ * and more sequential reads and writes, but the FileIterator of each range being merged holds a
+ * block in memory, so the blocks of 'opts.maxMergeFanIn' ranges should fit in the memory limit.
+ */
+size_t spillBlockSize(const SortOptions& opts) {
+    const size_t perRangeBytes = opts.maxMemoryUsageBytes / std::max<size_t>(opts.maxMergeFanIn, 1);
+    return std::max(kMinSpillBlockSizeBytes, std::min(kMaxSpillBlockSizeBytes, perRangeBytes));
+}
+
 }  // namespace
 
 namespace sorter {
@@ -143,7 +158,7 @@ public:
         return !_data.empty();
     }
     Data next() {
-        Data out = _data.front();
+        Data out = std::move(_data.front());
         _data.pop_front();
         return out;
     }
@@ -173,12 +188,14 @@ public:
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
                  const Settings& settings,
-                 const uint32_t checksum)
+                 const uint32_t checksum,
+                 size_t readAheadBytes)
         : _settings(settings),
           _done(false),
           _fileName(fileName),
           _fileStartOffset(fileStartOffset),
           _fileEndOffset(fileEndOffset),
+          _readAheadBytes(readAheadBytes),
           _originalChecksum(checksum) {
         uassert(16815,
                 str::stream() << "unexpected empty file: " << _fileName,
@@ -186,6 +203,10 @@ public:
     }
 
     void openSource() {
+        // Read the file through a buffer the size of a spilled block, so that the block headers
+        // and the blocks themselves are read with a few large sequential reads.
+        _readAheadBuffer.reset(new char[_readAheadBytes]);
+        _file.rdbuf()->pubsetbuf(_readAheadBuffer.get(), _readAheadBytes);
         _file.open(_fileName.c_str(), std::ios::in | std::ios::binary);
         uassert(16814,
                 str::stream() << "error opening file \"" << _fileName
@@ -216,6 +237,8 @@ public:
                            "Data read from disk does not match what was written to disk. Possible "
                            "corruption of data."));
         }
+
+        _readAheadBuffer.reset();
     }
 
     bool more() {
@@ -353,6 +376,10 @@ private:
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
     std::ifstream _file;
 
+    // Buffer through which '_file' is read while it is open.
+    const size_t _readAheadBytes;
+    std::unique_ptr<char[]> _readAheadBuffer;
+
     // Checksum value that is updated with each read of a data object from disk. We can compare
     // this value with _originalChecksum to check for data corruption if and only if the
     // FileIterator is exhausted.
@@ -367,7 +394,8 @@ private:
 /**
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
- * is responsible for deleting the data source file upon destruction.
+ * is responsible for deleting the data source file upon destruction. An empty file name means that
+ * the caller remains responsible for the file.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -409,7 +437,9 @@ public:
         // file. Some systems will error closing the file if any file handles are still open.
         _current.reset();
         _heap.clear();
-        DESTRUCTOR_GUARD(boost::filesystem::remove(_itersSourceFileName));
+        if (!_itersSourceFileName.empty()) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(_itersSourceFileName));
+        }
     }
 
     void openSource() {}
@@ -513,6 +543,51 @@ private:
     std::string _itersSourceFileName;
 };
 
+/**
+ * Reduces the number of spilled ranges in 'iters' to at most 'opts.maxMergeFanIn' by merging
+ * consecutive groups of them into new ranges, which are appended to 'fileName' starting at
+ * 'nextSortedFileWriterOffset'. Each pass reduces the number of ranges by a factor of the fan-in,
+ * so every spilled datum is rewritten a logarithmic number of times. Merging consecutive ranges
+ * preserves the relative order of equal data, which the final merge relies upon for stability.
+ *
+ * The merged ranges remain in the file, which is deleted as a whole once the sort completes.
+ */
+template <typename Key, typename Value, typename Comparator>
+void mergeSpilledRanges(const SortOptions& opts,
+                        const Comparator& comp,
+                        const typename Sorter<Key, Value>::Settings& settings,
+                        const std::string& fileName,
+                        std::streampos* nextSortedFileWriterOffset,
+                        std::vector<std::shared_ptr<SortIteratorInterface<Key, Value>>>* iters) {
+    typedef SortIteratorInterface<Key, Value> Iterator;
+
+    const size_t fanIn = std::max<size_t>(opts.maxMergeFanIn, 2);
+    while (iters->size() > fanIn) {
+        std::vector<std::shared_ptr<Iterator>> mergedIters;
+        for (auto it = iters->begin(); it != iters->end();) {
+            const auto groupEnd = it + std::min<size_t>(fanIn, iters->end() - it);
+            if (groupEnd - it == 1) {
+                mergedIters.push_back(std::move(*it));
+                it = groupEnd;
+                continue;
+            }
+
+            std::vector<std::shared_ptr<Iterator>> group(it, groupEnd);
+            MergeIterator<Key, Value, Comparator> merged(group, "", opts, comp);
+            SortedFileWriter<Key, Value> writer(
+                opts, fileName, *nextSortedFileWriterOffset, settings);
+            while (merged.more()) {
+                auto next = merged.next();
+                writer.addAlreadySorted(next.first, next.second);
+            }
+            mergedIters.push_back(std::shared_ptr<Iterator>(writer.done()));
+            *nextSortedFileWriterOffset = writer.getFileEndOffset();
+            it = groupEnd;
+        }
+        iters->swap(mergedIters);
+    }
+}
+
 template <typename Key, typename Value, typename Comparator>
 class NoLimitSorter : public Sorter<Key, Value> {
 public:
@@ -561,6 +636,8 @@ public:
         }
 
         spill();
+        mergeSpilledRanges<Key, Value, Comparator>(
+            _opts, _comp, _settings, _fileName, &_nextSortedFileWriterOffset, &_iters);
         Iterator* mergeIt = Iterator::merge(_iters, _fileName, _opts, _comp);
         _done = true;
         return mergeIt;
@@ -611,9 +688,13 @@ private:
 
         SortedFileWriter<Key, Value> writer(
             _opts, _fileName, _nextSortedFileWriterOffset, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        for (const auto& data : _data) {
+            writer.addAlreadySorted(data.first, data.second);
         }
+
+        // Keep the capacity of '_data' for the data added before the next spill.
+        _data.clear();
+
         Iterator* iteratorPtr = writer.done();
         _nextSortedFileWriterOffset = writer.getFileEndOffset();
 
@@ -629,7 +710,7 @@ private:
     std::streampos _nextSortedFileWriterOffset = 0;
     bool _done = false;
     size_t _memUsed;
-    std::deque<Data> _data;                         // the "current" data
+    std::vector<Data> _data;                        // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
 };
 
@@ -769,6 +850,8 @@ public:
         }
 
         spill();
+        mergeSpilledRanges<Key, Value, Comparator>(
+            _opts, _comp, _settings, _fileName, &_nextSortedFileWriterOffset, &_iters);
         Iterator* iterator = Iterator::merge(_iters, _fileName, _opts, _comp);
         _done = true;
         return iterator;
@@ -946,7 +1029,7 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
                                                const std::string& fileName,
                                                const std::streampos fileStartOffset,
                                                const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _blockSize(spillBlockSize(opts)) {
 
     // This should be checked by consumers, but if we get here don't allow writes.
     uassert(
@@ -992,7 +1075,7 @@ void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value&
     _checksum =
         addDataToChecksum(_buffer.buf() + _nextObjPos, _buffer.len() - _nextObjPos, _checksum);
 
-    if (_buffer.len() > 64 * 1024)
+    if (static_cast<size_t>(_buffer.len()) > _blockSize)
         spill();
 }
 
@@ -1061,7 +1144,7 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _file.close();
 
     return new sorter::FileIterator<Key, Value>(
-        _fileName, _fileStartOffset, _fileEndOffset, _settings, _checksum);
+        _fileName, _fileStartOffset, _fileEndOffset, _settings, _checksum, _blockSize);
 }
 
 //
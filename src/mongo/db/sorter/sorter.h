@@ -105,7 +105,16 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // The maximum number of spilled ranges which are merged at once. If a sorter spills more
+    // ranges than this, they are merged into fewer, larger ranges before the final merge. This
+    // bounds the number of read buffers held in memory while merging.
+    size_t maxMergeFanIn;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          maxMergeFanIn(64) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -128,6 +137,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& MaxMergeFanIn(size_t newMaxMergeFanIn) {
+        maxMergeFanIn = newMaxMergeFanIn;
+        return *this;
+    }
 };
 
 /**
@@ -262,6 +276,10 @@ private:
     std::ofstream _file;
     BufBuilder _buffer;
 
+    // The buffered data is compressed and written to the file as a single block once it exceeds
+    // this size. The FileIterator reads the data back using a buffer of the same size.
+    size_t _blockSize;
+
     // Keeps track of the hash of all data objects spilled to disk. Passed to the FileIterator
     // to ensure data has not been corrupted after reading from disk.
     uint32_t _checksum = 0;
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/bufreader.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number. Each user of the Sorter must provide this function; see sorter.h.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> sorterBmFileCounter;
+    return "extsort-sorter-bm." + std::to_string(sorterBmFileCounter.fetchAndAdd(1));
+}
+
+}  // namespace
+}  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace {
+
+const size_t kPayloadSize = 100;
+
+/**
+ * Sort key of the benchmarked data.
+ */
+class BenchKey {
+public:
+    BenchKey(long long key = 0) : _key(key) {}
+
+    long long get() const {
+        return _key;
+    }
+
+    struct SorterDeserializeSettings {};
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(_key);
+    }
+    static BenchKey deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return buf.read<LittleEndian<long long>>().value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(BenchKey);
+    }
+    BenchKey getOwned() const {
+        return *this;
+    }
+
+private:
+    long long _key;
+};
+
+/**
+ * Payload of the benchmarked data, standing in for a document.
+ */
+class BenchValue {
+public:
+    BenchValue() = default;
+    explicit BenchValue(std::string payload) : _payload(std::move(payload)) {}
+
+    struct SorterDeserializeSettings {};
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendStr(_payload);
+    }
+    static BenchValue deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return BenchValue(buf.readCStr().toString());
+    }
+    int memUsageForSorter() const {
+        return sizeof(BenchValue) + _payload.capacity();
+    }
+    BenchValue getOwned() const {
+        return *this;
+    }
+
+private:
+    std::string _payload;
+};
+
+using BenchSorter = Sorter<BenchKey, BenchValue>;
+
+class BenchComparator {
+public:
+    int operator()(const BenchSorter::Data& lhs, const BenchSorter::Data& rhs) const {
+        if (lhs.first.get() == rhs.first.get())
+            return 0;
+        return lhs.first.get() < rhs.first.get() ? -1 : 1;
+    }
+};
+
+std::vector<long long> generateKeys(size_t numItems) {
+    std::mt19937_64 gen(1234);
+    std::vector<long long> keys(numItems);
+    for (auto&& key : keys) {
+        key = static_cast<long long>(gen());
+    }
+    return keys;
+}
+
+/**
+ * Adds 'state.range(0)' items in random order to a sorter limited to 'state.range(1)' bytes of
+ * memory, and reads back the sorted output. A memory limit of 0 means the sort is done entirely
+ * in memory.
+ */
+void runSort(benchmark::State& state, const SortOptions& baseOpts) {
+    const auto keys = generateKeys(state.range(0));
+    const std::string payload(kPayloadSize, 'x');
+
+    unittest::TempDir tempDir("sorterBm");
+    SortOptions opts = SortOptions(baseOpts).TempDir(tempDir.path());
+    if (state.range(1)) {
+        opts.MaxMemoryUsageBytes(state.range(1)).ExtSortAllowed();
+    } else {
+        opts.MaxMemoryUsageBytes(std::numeric_limits<size_t>::max());
+    }
+
+    const size_t expectedResults =
+        opts.limit ? std::min<size_t>(opts.limit, keys.size()) : keys.size();
+    for (auto keepRunning : state) {
+        std::unique_ptr<BenchSorter> sorter(BenchSorter::make(opts, BenchComparator()));
+        for (auto key : keys) {
+            sorter->add(key, BenchValue(payload));
+        }
+
+        std::unique_ptr<BenchSorter::Iterator> it(sorter->done());
+        size_t numReturned = 0;
+        while (it->more()) {
+            benchmark::DoNotOptimize(it->next());
+            ++numReturned;
+        }
+        invariant(numReturned == expectedResults);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_Sort(benchmark::State& state) {
+    runSort(state, SortOptions());
+}
+
+void BM_SortNarrowMerge(benchmark::State& state) {
+    // Forces the spilled ranges to be merged in several passes.
+    runSort(state, SortOptions().MaxMergeFanIn(8));
+}
+
+void BM_SortTopK(benchmark::State& state) {
+    runSort(state, SortOptions().Limit(1000));
+}
+
+// Arguments are the number of items and the memory limit in bytes.
+BENCHMARK(BM_Sort)
+    ->Args({100 * 1000, 0})
+    ->Args({1000 * 1000, 0})
+    ->Args({1000 * 1000, 16 * 1024 * 1024})
+    ->Args({1000 * 1000, 1024 * 1024})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortNarrowMerge)->Args({1000 * 1000, 1024 * 1024})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortTopK)->Args({1000 * 1000, 1024 * 1024})->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
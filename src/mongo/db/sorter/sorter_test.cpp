@@ -552,6 +552,16 @@ public:
     PseudoRandom _random;
 };
 
+template <bool Random = true>
+class LotsOfDataCascadingMerge : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        // Spill many more ranges than are merged at once, so that several merge passes are needed
+        // before the final merge.
+        return Parent::adjustSortOptions(opts).MaxMergeFanIn(4);
+    }
+};
+
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -594,6 +604,8 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataCascadingMerge</*random=*/false>>();
+        add<SorterTests::LotsOfDataCascadingMerge</*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
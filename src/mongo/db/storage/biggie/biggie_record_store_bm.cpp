@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_record_store.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+/**
+ * Inserts records into a single BiggieRecordStore from several threads at once. Every insert
+ * commits its own unit of work, so each one merges its working copy into the master tree
+ * concurrently with the others. The inserts never touch the same key, so they should never write
+ * conflict.
+ */
+class BiggieRecordStoreTest : public benchmark::Fixture {
+public:
+    void makeKClientsWithRecoveryUnits(int k) {
+        clients.reserve(k);
+        for (int i = 0; i < k; ++i) {
+            auto client = getGlobalServiceContext()->makeClient(str::stream()
+                                                                << "test client for thread " << i);
+            auto opCtx = client->makeOperationContext();
+            opCtx->setRecoveryUnit(std::make_unique<RecoveryUnit>(kvEngine.get()),
+                                   WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+            clients.emplace_back(std::move(client), std::move(opCtx));
+        }
+    }
+
+protected:
+    std::unique_ptr<KVEngine> kvEngine;
+    std::unique_ptr<RecordStore> recordStore;
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        clients;
+    AtomicWord<long long> writeConflicts;
+};
+
+BENCHMARK_DEFINE_F(BiggieRecordStoreTest, BM_InsertRecord)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        kvEngine = std::make_unique<KVEngine>();
+        recordStore = std::make_unique<RecordStore>("a.b",
+                                                    "ident"_sd /* ident */,
+                                                    false /* isCapped */,
+                                                    -1 /* cappedMaxSize */,
+                                                    -1 /* cappedMaxDocs */,
+                                                    nullptr /* cappedCallback */,
+                                                    nullptr /* visibilityManager */);
+        writeConflicts.store(0);
+        makeKClientsWithRecoveryUnits(state.threads);
+    }
+
+    const std::string data(static_cast<size_t>(state.range(0)), 'x');
+    for (auto keepRunning : state) {
+        OperationContext* opCtx = clients[state.thread_index].second.get();
+        while (true) {
+            try {
+                WriteUnitOfWork wuow(opCtx);
+                invariant(recordStore->insertRecord(opCtx, data.c_str(), data.size(), Timestamp()));
+                wuow.commit();
+                break;
+            } catch (const WriteConflictException&) {
+                writeConflicts.fetchAndAdd(1);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        state.counters["writeConflicts"] = writeConflicts.load();
+        clients.clear();
+        recordStore.reset();
+        kvEngine.reset();
+    }
+}
+
+BENCHMARK_REGISTER_F(BiggieRecordStoreTest, BM_InsertRecord)
+    ->Arg(16)
+    ->Arg(1024)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace biggie
+}  // namespace mongo
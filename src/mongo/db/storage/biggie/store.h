@@ -635,8 +635,14 @@ public:
 
         invariant(this->_root->_trieKey.size() == 0 && base._root->_trieKey.size() == 0 &&
                   other._root->_trieKey.size() == 0);
-        _merge3Helper(
-            this->_root.get(), base._root.get(), other._root.get(), context, trieKeyIndex);
+        PendingChanges pending;
+        _merge3Helper(this->_root.get(),
+                      base._root.get(),
+                      other._root.get(),
+                      context,
+                      trieKeyIndex,
+                      &pending);
+        _applyPendingChanges(pending);
         _root->_count = other._root->_count + deltaCount;
         _root->_dataSize = other._root->_dataSize + deltaDataSize;
     }
@@ -1251,18 +1257,42 @@ private:
         return context.back();
     }
 
+    /**
+     * Changes from the master tree which are merged element by element. They are applied once the
+     * whole tree has been traversed, because inserting or erasing keys can restructure the nodes
+     * that the traversal is holding on to.
+     */
+    struct PendingChanges {
+        std::vector<value_type> inserts;
+        std::vector<value_type> updates;
+        std::vector<Key> erasures;
+    };
+
+    void _applyPendingChanges(const PendingChanges& pending) {
+        for (const auto& value : pending.inserts)
+            this->insert(value_type(value));
+        for (const auto& value : pending.updates)
+            this->update(value_type(value));
+        for (const auto& key : pending.erasures)
+            this->erase(key);
+    }
+
     /**
      * Resolves conflicts within subtrees due to the complicated structure of path-compressed radix
-     * tries.
+     * tries. A null 'current' or 'otherNode' stands for a subtree whose keys were all removed. The
+     * changes to make to the working tree are added to 'pending'.
      */
-    void _mergeResolveConflict(const Node* current, const Node* baseNode, const Node* otherNode) {
+    void _mergeResolveConflict(const Node* current,
+                               const Node* baseNode,
+                               const Node* otherNode,
+                               PendingChanges* pending) {
 
         // Merges all differences between this and other, using base to determine whether operations
         // are allowed or should throw a merge conflict.
         RadixStore base, other, node;
-        node._root = std::make_shared<Head>(*current);
+        node._root = current ? std::make_shared<Head>(*current) : std::make_shared<Head>();
         base._root = std::make_shared<Head>(*baseNode);
-        other._root = std::make_shared<Head>(*otherNode);
+        other._root = otherNode ? std::make_shared<Head>(*otherNode) : std::make_shared<Head>();
 
         // Merges insertions and updates from the master tree into the working tree, if possible.
         for (const value_type otherVal : other) {
@@ -1274,7 +1304,7 @@ private:
                 if (thisIter->second == baseIter->second && baseIter->second != otherVal.second) {
                     // No changes occured in the working tree, so the value in the master tree can
                     // be merged in cleanly.
-                    this->update(RadixStore::value_type(otherVal));
+                    pending->updates.push_back(otherVal);
                 } else if (thisIter->second != baseIter->second &&
                            baseIter->second != otherVal.second) {
                     // Both the working copy and master nodes changed the same value at the same
@@ -1298,7 +1328,7 @@ private:
             } else if (thisIter == node.end() && baseIter == base.end()) {
                 // The working tree and merge base do not have any record of this node. The node can
                 // be merged in cleanly from the master tree.
-                this->insert(RadixStore::value_type(otherVal));
+                pending->inserts.push_back(otherVal);
             }
         }
 
@@ -1311,11 +1341,15 @@ private:
                 if (thisIter != node.end() && thisIter->second == baseVal.second) {
                     // Nothing changed between the working tree and merge base, so it is safe to
                     // perform the deletion that occured in the master tree.
-                    this->erase(baseVal.first);
+                    pending->erasures.push_back(baseVal.first);
                 } else if (thisIter != node.end() && thisIter->second != baseVal.second) {
                     // The working tree made a change to the node while the master tree removed the
                     // node, resulting in a merge conflict.
                     throw merge_conflict_exception();
+                } else if (thisIter == node.end()) {
+                    // The master tree and working tree both removed the same node, resulting in a
+                    // merge conflict, as when they both remove the same branch.
+                    throw merge_conflict_exception();
                 }
             }
         }
@@ -1323,9 +1357,10 @@ private:
 
     /**
      * Merges elements from the master tree into the working copy if they have no presence in the
-     * working copy, otherwise we throw a merge conflict.
+     * working copy, otherwise we throw a merge conflict. The insertions to make to the working copy
+     * are added to 'pending'.
      */
-    void _mergeTwoBranches(const Node* current, const Node* otherNode) {
+    void _mergeTwoBranches(const Node* current, const Node* otherNode, PendingChanges* pending) {
 
         RadixStore other, node;
         node._root = std::make_shared<Head>(*current);
@@ -1336,25 +1371,63 @@ private:
 
             if (thisIter != node.end())
                 throw merge_conflict_exception();
-            this->insert(RadixStore::value_type(otherVal));
+            pending->inserts.push_back(otherVal);
         }
     }
 
+    /**
+     * Returns true if 'first' and 'second', which are at the same position in two versions of the
+     * tree, store the same value.
+     */
+    static bool _hasSameData(const Node* first, const Node* second) {
+        if (!first->_data || !second->_data)
+            return !first->_data && !second->_data;
+        return first->_data->second == second->_data->second;
+    }
+
+    /**
+     * Merges the change from 'base' to 'other' of the value stored on the node at the back of
+     * 'context'. Throws merge_conflict_exception if the working tree changed that value as well.
+     */
+    void _mergeNodeData(const Node* base,
+                        const Node* other,
+                        std::vector<Node*>& context,
+                        std::vector<uint8_t>& trieKeyIndex) {
+        if (_hasSameData(base, other))
+            return;
+
+        if (!_hasSameData(context.back(), base))
+            throw merge_conflict_exception();
+
+        Node* current = _makeBranchUnique(context);
+        _rebuildContext(context, trieKeyIndex);
+        current->_data = boost::none;
+        if (other->_data)
+            current->_data.emplace(other->_data->first, other->_data->second);
+    }
+
     /**
      * Merges changes from base to other into current. Throws merge_conflict_exception if there are
      * merge conflicts.
+     *
+     * Only changes to the same key conflict. Branches which differ between the trees are compared
+     * pointer by pointer while their shapes match, and element by element otherwise.
      */
     void _merge3Helper(Node* current,
                        const Node* base,
                        const Node* other,
                        std::vector<Node*>& context,
-                       std::vector<uint8_t>& trieKeyIndex) {
+                       std::vector<uint8_t>& trieKeyIndex,
+                       PendingChanges* pending) {
         context.push_back(current);
 
         // Root doesn't have a trie key.
         if (!current->_trieKey.empty())
             trieKeyIndex.push_back(current->_trieKey.at(0));
 
+        // The value on this node is not part of any child branch, so it is merged on its own.
+        _mergeNodeData(base, other, context, trieKeyIndex);
+
         for (size_t key = 0; key < 256; ++key) {
             // Since _makeBranchUnique may make changes to the pointer addresses in recursive calls.
             current = context.back();
@@ -1380,11 +1453,15 @@ private:
                     _rebuildContext(context, trieKeyIndex);
 
                     current->_children[key] = other->_children[key];
-                } else if (!otherNode || (baseNode && baseNode != otherNode)) {
-                    // Either the master tree and working tree remove the same branch, or the master
-                    // tree updated the branch while the working tree removed the branch, resulting
-                    // in a merge conflict.
+                } else if (!otherNode) {
+                    // The master tree and working tree both removed the same branch, resulting in a
+                    // merge conflict.
                     throw merge_conflict_exception();
+                } else if (baseNode != otherNode) {
+                    // The working tree removed every key of the branch while the master tree
+                    // changed it. This only conflicts if the master tree changed one of the removed
+                    // keys, so resolve the differences element by element.
+                    _mergeResolveConflict(nullptr, baseNode, otherNode, pending);
                 }
             } else if (!unique) {
                 if (baseNode && !otherNode && baseNode == node) {
@@ -1400,10 +1477,6 @@ private:
                     current->_children[key] = other->_children[key];
                 }
             } else if (baseNode && otherNode && baseNode != otherNode) {
-                // If all three are unique and leaf nodes, then it is a merge conflict.
-                if (node->isLeaf() && baseNode->isLeaf() && otherNode->isLeaf())
-                    throw merge_conflict_exception();
-
                 // If the keys are all the exact same, then we can keep recursing.
                 // Otherwise, we manually resolve the differences element by element. The
                 // structure of compressed radix tries makes it difficult to compare the
@@ -1411,21 +1484,20 @@ private:
                 // element by element.
                 if (node->_trieKey == baseNode->_trieKey &&
                     baseNode->_trieKey == otherNode->_trieKey) {
-                    _merge3Helper(node, baseNode, otherNode, context, trieKeyIndex);
+                    _merge3Helper(node, baseNode, otherNode, context, trieKeyIndex, pending);
                 } else {
-                    _mergeResolveConflict(node, baseNode, otherNode);
-                    _rebuildContext(context, trieKeyIndex);
+                    _mergeResolveConflict(node, baseNode, otherNode, pending);
                 }
             } else if (baseNode && !otherNode) {
-                // Throw a write conflict since current has modified a branch but master has
-                // removed it.
-                throw merge_conflict_exception();
+                // The working tree modified a branch whose keys were all removed by the master
+                // tree. This only conflicts if the working tree changed one of the removed keys, so
+                // resolve the differences element by element.
+                _mergeResolveConflict(node, baseNode, nullptr, pending);
             } else if (!baseNode && otherNode) {
                 // Both the working tree and master added branches that were nonexistent in base.
                 // This requires us to resolve these differences element by element since the
                 // changes may not be conflicting.
-                _mergeTwoBranches(node, otherNode);
-                _rebuildContext(context, trieKeyIndex);
+                _mergeTwoBranches(node, otherNode, pending);
             }
         }
 
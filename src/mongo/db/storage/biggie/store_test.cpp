@@ -1635,6 +1635,176 @@ TEST_F(RadixStoreTest, MergeConflictingInsertions) {
     ASSERT_THROWS(thisStore.merge3(baseStore, otherStore), merge_conflict_exception);
 }
 
+TEST_F(RadixStoreTest, MergeConflictingDeletions) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fod", "2");
+
+    baseStore.insert(value_type(value1));
+    baseStore.insert(value_type(value2));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.erase(value1.first);
+    otherStore.erase(value1.first);
+
+    ASSERT_THROWS(thisStore.merge3(baseStore, otherStore), merge_conflict_exception);
+}
+
+TEST_F(RadixStoreTest, MergeConflictingDeletionOfBranchThisAndDeletionInBranchOther) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fod", "2");
+    value_type value3 = std::make_pair("bar", "3");
+
+    baseStore.insert(value_type(value1));
+    baseStore.insert(value_type(value2));
+    baseStore.insert(value_type(value3));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    // The working tree removes the whole "fo" branch, which the master tree still has.
+    thisStore.erase(value1.first);
+    thisStore.erase(value2.first);
+    otherStore.erase(value1.first);
+
+    ASSERT_THROWS(thisStore.merge3(baseStore, otherStore), merge_conflict_exception);
+}
+
+TEST_F(RadixStoreTest, MergeConflictingDeletionInBranchThisAndDeletionOfBranchOther) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fod", "2");
+    value_type value3 = std::make_pair("bar", "3");
+
+    baseStore.insert(value_type(value1));
+    baseStore.insert(value_type(value2));
+    baseStore.insert(value_type(value3));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.erase(value1.first);
+    otherStore.erase(value1.first);
+    otherStore.erase(value2.first);
+
+    ASSERT_THROWS(thisStore.merge3(baseStore, otherStore), merge_conflict_exception);
+}
+
+TEST_F(RadixStoreTest, MergeModificationOtherAndCopiedUnchangedNodeThis) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fob", "2");
+    value_type value3 = std::make_pair("foo", "3");
+
+    baseStore.insert(value_type(value1));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    // Leaves the working tree with a copy of the "foo" node which has the same value as in base.
+    thisStore.insert(value_type(value2));
+    thisStore.erase(value2.first);
+
+    otherStore.update(value_type(value3));
+
+    expected.insert(value_type(value3));
+
+    thisStore.merge3(baseStore, otherStore);
+
+    ASSERT_TRUE(thisStore == expected);
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(1));
+    ASSERT_EQ(thisStore.dataSize(), StringStore::size_type(1));
+}
+
+TEST_F(RadixStoreTest, MergeDeletionThisAndInsertionOtherInSameBranch) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fod", "2");
+
+    baseStore.insert(value_type(value1));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.erase(value1.first);
+    otherStore.insert(value_type(value2));
+
+    expected.insert(value_type(value2));
+
+    thisStore.merge3(baseStore, otherStore);
+
+    ASSERT_TRUE(thisStore == expected);
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(1));
+    ASSERT_EQ(thisStore.dataSize(), StringStore::size_type(1));
+}
+
+TEST_F(RadixStoreTest, MergeInsertionThisAndDeletionOtherInSameBranch) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("fod", "2");
+
+    baseStore.insert(value_type(value1));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.insert(value_type(value2));
+    otherStore.erase(value1.first);
+
+    expected.insert(value_type(value2));
+
+    thisStore.merge3(baseStore, otherStore);
+
+    ASSERT_TRUE(thisStore == expected);
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(1));
+    ASSERT_EQ(thisStore.dataSize(), StringStore::size_type(1));
+}
+
+TEST_F(RadixStoreTest, MergeModificationOtherOfNodeWithChildren) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("food", "2");
+    value_type value3 = std::make_pair("foot", "3");
+    value_type value4 = std::make_pair("foo", "4");
+
+    baseStore.insert(value_type(value1));
+    baseStore.insert(value_type(value2));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.insert(value_type(value3));
+    otherStore.update(value_type(value4));
+
+    expected.insert(value_type(value4));
+    expected.insert(value_type(value2));
+    expected.insert(value_type(value3));
+
+    thisStore.merge3(baseStore, otherStore);
+
+    ASSERT_TRUE(thisStore == expected);
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(3));
+    ASSERT_EQ(thisStore.dataSize(), StringStore::size_type(3));
+}
+
+TEST_F(RadixStoreTest, MergeConflictingModificationsOfNodeWithChildren) {
+    value_type value1 = std::make_pair("foo", "1");
+    value_type value2 = std::make_pair("food", "2");
+    value_type value3 = std::make_pair("foot", "3");
+    value_type value4 = std::make_pair("fool", "4");
+    value_type value5 = std::make_pair("foo", "5");
+    value_type value6 = std::make_pair("foo", "6");
+
+    baseStore.insert(value_type(value1));
+    baseStore.insert(value_type(value2));
+
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    thisStore.insert(value_type(value3));
+    thisStore.update(value_type(value5));
+    otherStore.insert(value_type(value4));
+    otherStore.update(value_type(value6));
+
+    ASSERT_THROWS(thisStore.merge3(baseStore, otherStore), merge_conflict_exception);
+}
+
 TEST_F(RadixStoreTest, UpperBoundTest) {
     value_type value1 = std::make_pair("foo", "1");
     value_type value2 = std::make_pair("bar", "2");
@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_id.h"
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace clustered_id {
+
+StatusWith<RecordId> keyForId(const BSONElement& id) {
+    if (id.type() != NumberInt && id.type() != NumberLong) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id of a document in a clustered collection must be a 32 or "
+                                 "64-bit integer, not "
+                              << typeName(id.type())};
+    }
+
+    const RecordId out(id.numberLong());
+    if (!out.isNormal()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id of a document in a clustered collection must be positive "
+                                 "and less than "
+                              << RecordId::kMinReservedRepr << ", not " << id.numberLong()};
+    }
+    return out;
+}
+
+StatusWith<RecordId> extractKey(const char* data, int len) {
+    DEV invariant(validateBSON(data, len, BSONVersion::kLatest).isOK());
+
+    const BSONObj obj(data);
+    const BSONElement elem = obj["_id"];
+    if (elem.eoo())
+        return {ErrorCodes::BadValue, "no _id field"};
+
+    return keyForId(elem);
+}
+
+}  // namespace clustered_id
+}  // namespace mongo
@@ -408,6 +408,8 @@ void BuilderBase<BufferT>::_appendAllElementsForIndexing(const BSONObj& obj,
 
 template <class BufferT>
 void BuilderBase<BufferT>::appendRecordId(RecordId loc) {
+    // Finish the key first if its elements were appended one at a time.
+    _prepareForRelease();
     _transition(BuildState::kAppendedRecordID);
     // The RecordId encoding must be able to determine the full length starting from the last
     // byte, without knowing where the first byte is since it is stored at the end of a
@@ -2121,6 +2123,9 @@ int BuilderBase<BufferT>::compareWithoutRecordId(const BuilderBase<BufferT>& oth
 }
 
 int Value::compare(const Value& other) const {
+    if (_normalizedPrefix != other._normalizedPrefix)
+        return _normalizedPrefix < other._normalizedPrefix ? -1 : 1;
+
     int a = getSize();
     int b = other.getSize();
 
@@ -2142,6 +2147,39 @@ int Value::compare(const Value& other) const {
     return a < b ? -1 : 1;
 }
 
+uint64_t getNormalizedPrefix(const char* buffer, size_t size) {
+    if (size >= kNormalizedPrefixSize)
+        return endian::bigToNative(ConstDataView(buffer).read<uint64_t>());
+
+    char padded[kNormalizedPrefixSize] = {};
+    if (size)
+        memcpy(padded, buffer, size);
+    return endian::bigToNative(ConstDataView(padded).read<uint64_t>());
+}
+
+size_t getSharedPrefixSize(const char* lhs, size_t lhsSize, const char* rhs, size_t rhsSize) {
+    const size_t min = std::min(lhsSize, rhsSize);
+    size_t size = 0;
+
+    // Skip over equal words before looking for the first differing byte.
+    while (size + sizeof(uint64_t) <= min &&
+           ConstDataView(lhs + size).read<uint64_t>() == ConstDataView(rhs + size).read<uint64_t>())
+        size += sizeof(uint64_t);
+
+    while (size < min && lhs[size] == rhs[size])
+        size++;
+
+    return size;
+}
+
+size_t getSeparatorSize(const char* left, size_t leftSize, const char* right, size_t rightSize) {
+    const size_t shared = getSharedPrefixSize(left, leftSize, right, rightSize);
+    // If 'left' is a prefix of 'right', the next byte of 'right' makes it greater. Otherwise the
+    // first differing byte of 'right' is already greater than that of 'left'.
+    invariant(shared < rightSize);
+    return shared + 1;
+}
+
 uint32_t TypeBits::readSizeFromBuffer(BufReader* reader) {
     const uint8_t firstByte = reader->peek<uint8_t>();
 
@@ -284,6 +284,31 @@ private:
 };
 
 
+/**
+ * Number of leading KeyString bytes that make up a normalized prefix.
+ */
+const size_t kNormalizedPrefixSize = sizeof(uint64_t);
+
+/**
+ * Returns the first kNormalizedPrefixSize bytes of a KeyString buffer as a big-endian integer,
+ * padding shorter buffers with zeros. Comparing two normalized prefixes as integers orders the same
+ * way as memcmp over those bytes, so only keys with equal prefixes need a full comparison.
+ */
+uint64_t getNormalizedPrefix(const char* buffer, size_t size);
+
+/**
+ * Returns the number of leading bytes two KeyString buffers have in common. Compound keys that
+ * only differ in their trailing fields share most of their encoding.
+ */
+size_t getSharedPrefixSize(const char* lhs, size_t lhsSize, const char* rhs, size_t rhsSize);
+
+/**
+ * Returns the length of the shortest prefix of 'right' that compares greater than 'left', which
+ * must compare less than 'right'. That prefix separates the two keys and can stand in for 'right'
+ * wherever only the ordering between them matters, such as in internal search structures.
+ */
+size_t getSeparatorSize(const char* left, size_t leftSize, const char* right, size_t rightSize);
+
 /**
  * Value owns a buffer that corresponds to a completely generated KeyString::Builder.
  */
@@ -291,7 +316,11 @@ class Value {
 
 public:
     Value(Version version, TypeBits typeBits, size_t size, ConstSharedBuffer buffer)
-        : _version(version), _typeBits(typeBits), _size(size), _buffer(std::move(buffer)) {}
+        : _version(version),
+          _typeBits(typeBits),
+          _size(size),
+          _buffer(std::move(buffer)),
+          _normalizedPrefix(getNormalizedPrefix(_buffer.get(), _size)) {}
 
     int compare(const Value& other) const;
 
@@ -312,6 +341,9 @@ private:
     TypeBits _typeBits;
     size_t _size;
     ConstSharedBuffer _buffer;
+
+    // Cached so that comparisons between keys that differ early never touch the buffers.
+    uint64_t _normalizedPrefix;
 };
 
 inline bool operator<(const Value& lhs, const Value& rhs) {
@@ -31,7 +31,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
+#include <functional>
 #include <random>
 #include <vector>
 
@@ -66,6 +68,7 @@ enum BsonValueType {
     STRING,
     ARRAY,
     DECIMAL,
+    COMPOUND,
 };
 
 BSONObj generateBson(BsonValueType bsonValueType) {
@@ -93,6 +96,11 @@ BSONObj generateBson(BsonValueType bsonValueType) {
                                          Decimal128::kRoundTo34Digits,
                                          Decimal128::kRoundTiesToAway)
                                   .quantize(Decimal128("0.01", Decimal128::kRoundTiesToAway)));
+        case COMPOUND:
+            // Models a {tenant, type, timestamp} index, where keys share a long leading prefix.
+            return BSON("" << std::string(kStrLenMultiplier, 't') << ""
+                           << static_cast<int>(expDist(gen) * 4) << ""
+                           << static_cast<long long>(expReal(gen)));
     }
     MONGO_UNREACHABLE;
 }
@@ -153,6 +161,86 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+void BM_KeyStringValueCompare(benchmark::State& state,
+                              const KeyString::Version version,
+                              BsonValueType bsonType) {
+    std::vector<KeyString::Value> values;
+    values.reserve(kSampleSize);
+    for (int i = 0; i < kSampleSize; i++) {
+        KeyString::HeapBuilder ks(version, generateBson(bsonType), ALL_ASCENDING);
+        values.push_back(ks.release());
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 1; i < kSampleSize; i++) {
+            benchmark::DoNotOptimize(values[i - 1].compare(values[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+}
+
+void BM_KeyStringMemcmp(benchmark::State& state,
+                        const KeyString::Version version,
+                        BsonValueType bsonType) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 1; i < kSampleSize; i++) {
+            const size_t lhsSize = bsonsAndKeyStrings.keystringLens[i - 1];
+            const size_t rhsSize = bsonsAndKeyStrings.keystringLens[i];
+            int cmp = memcmp(bsonsAndKeyStrings.keystrings[i - 1].get(),
+                             bsonsAndKeyStrings.keystrings[i].get(),
+                             std::min(lhsSize, rhsSize));
+            benchmark::DoNotOptimize(cmp ? cmp : int(lhsSize) - int(rhsSize));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+}
+
+void BM_KeyStringSeparator(benchmark::State& state,
+                           const KeyString::Version version,
+                           BsonValueType bsonType) {
+    std::vector<KeyString::Value> unsorted;
+    unsorted.reserve(kSampleSize);
+    for (int i = 0; i < kSampleSize; i++) {
+        KeyString::HeapBuilder ks(version, generateBson(bsonType), ALL_ASCENDING);
+        unsorted.push_back(ks.release());
+    }
+
+    // Value is not assignable, so sort references to the keys instead.
+    std::vector<std::reference_wrapper<const KeyString::Value>> values(unsorted.begin(),
+                                                                      unsorted.end());
+    std::sort(values.begin(), values.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.get() < rhs.get();
+    });
+
+    size_t separatorBytes = 0;
+    size_t keyBytes = 0;
+    for (size_t i = 1; i < kSampleSize; i++) {
+        const KeyString::Value& left = values[i - 1];
+        const KeyString::Value& right = values[i];
+        if (left == right)
+            continue;
+        separatorBytes += KeyString::getSeparatorSize(
+            left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize());
+        keyBytes += right.getSize();
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 1; i < kSampleSize; i++) {
+            const KeyString::Value& left = values[i - 1];
+            const KeyString::Value& right = values[i];
+            benchmark::DoNotOptimize(KeyString::getSharedPrefixSize(
+                left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+    state.counters["separatorRatio"] =
+        keyBytes ? static_cast<double>(separatorBytes) / keyBytes : 1.0;
+}
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -162,6 +250,8 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Compound, KeyString::Version::V0, COMPOUND);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Compound, KeyString::Version::V1, COMPOUND);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -172,5 +262,17 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Compound, KeyString::Version::V0, COMPOUND);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Compound, KeyString::Version::V1, COMPOUND);
+
+BENCHMARK_CAPTURE(BM_KeyStringMemcmp, V1_Int, KeyString::Version::V1, INT);
+BENCHMARK_CAPTURE(BM_KeyStringValueCompare, V1_Int, KeyString::Version::V1, INT);
+BENCHMARK_CAPTURE(BM_KeyStringMemcmp, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringValueCompare, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringMemcmp, V1_Compound, KeyString::Version::V1, COMPOUND);
+BENCHMARK_CAPTURE(BM_KeyStringValueCompare, V1_Compound, KeyString::Version::V1, COMPOUND);
+
+BENCHMARK_CAPTURE(BM_KeyStringSeparator, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringSeparator, V1_Compound, KeyString::Version::V1, COMPOUND);
 }  // namespace
 }  // namespace mongo
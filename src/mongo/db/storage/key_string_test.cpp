@@ -599,6 +599,63 @@ TEST_F(KeyStringBuilderTest, KeyStringBuilderDiscriminator) {
     ASSERT_EQ((uint8_t)'\004', end);
 }
 
+TEST_F(KeyStringBuilderTest, NormalizedPrefixOrdersLikeMemcmp) {
+    const std::vector<BSONObj> objs = {BSON("" << 1),
+                                       BSON("" << 2),
+                                       BSON("" << ""),
+                                       BSON("" << "a"),
+                                       BSON("" << "abcdefghijklmnop"),
+                                       BSON("" << "abcdefghijklmnoq"),
+                                       BSON("" << 1 << "" << 1),
+                                       BSON("" << 1 << "" << 2)};
+    for (const auto& a : objs) {
+        for (const auto& b : objs) {
+            KeyString::HeapBuilder ksA(version, a, ALL_ASCENDING);
+            KeyString::HeapBuilder ksB(version, b, ALL_ASCENDING);
+            const int cmp = ksA.compare(ksB);
+
+            const uint64_t prefixA = KeyString::getNormalizedPrefix(ksA.getBuffer(), ksA.getSize());
+            const uint64_t prefixB = KeyString::getNormalizedPrefix(ksB.getBuffer(), ksB.getSize());
+            if (prefixA != prefixB)
+                ASSERT_EQ(cmp < 0, prefixA < prefixB) << a << " " << b;
+
+            KeyString::Value valueA = ksA.release();
+            KeyString::Value valueB = ksB.release();
+            ASSERT_EQ(cmp, valueA.compare(valueB)) << a << " " << b;
+        }
+    }
+}
+
+TEST_F(KeyStringBuilderTest, SharedPrefixAndSeparator) {
+    const std::string tenant(32, 't');
+    KeyString::Builder left(version, BSON("" << tenant << "" << 1 << "" << 100), ALL_ASCENDING);
+    KeyString::Builder right(version, BSON("" << tenant << "" << 1 << "" << 200), ALL_ASCENDING);
+    ASSERT_LT(left.compare(right), 0);
+
+    const size_t shared = KeyString::getSharedPrefixSize(
+        left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize());
+    ASSERT_GT(shared, tenant.size());
+    ASSERT_LT(shared, left.getSize());
+    ASSERT_EQ(0, memcmp(left.getBuffer(), right.getBuffer(), shared));
+    ASSERT_NE(left.getBuffer()[shared], right.getBuffer()[shared]);
+
+    const size_t separatorSize = KeyString::getSeparatorSize(
+        left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize());
+    ASSERT_EQ(shared + 1, separatorSize);
+    ASSERT_LTE(separatorSize, right.getSize());
+    ASSERT_LT(memcmp(left.getBuffer(), right.getBuffer(), separatorSize), 0);
+
+    // A key that is a prefix of another is separated by one more byte of the longer key.
+    ASSERT_EQ(left.getSize(),
+              KeyString::getSharedPrefixSize(
+                  left.getBuffer(), left.getSize(), left.getBuffer(), left.getSize()));
+    KeyString::Builder longer(version, BSON("" << tenant << "" << 1 << "" << 100), ALL_ASCENDING);
+    longer.appendRecordId(RecordId(1));
+    ASSERT_EQ(left.getSize() + 1,
+              KeyString::getSeparatorSize(
+                  left.getBuffer(), left.getSize(), longer.getBuffer(), longer.getSize()));
+}
+
 TEST_F(KeyStringBuilderTest, DoubleInvalidIntegerPartV0) {
     // Test that an illegally encoded double throws an error.
     const char* data =
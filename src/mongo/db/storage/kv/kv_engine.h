@@ -394,6 +394,13 @@ public:
         return false;
     }
 
+    /**
+     * See `StorageEngine::supportsClusteredIdCollections`
+     */
+    virtual bool supportsClusteredIdCollections() const {
+        return false;
+    }
+
     virtual bool supportsReadConcernMajority() const {
         return false;
     }
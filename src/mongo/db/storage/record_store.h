@@ -186,6 +186,16 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Seeks to the first Record whose id is at or past 'start' in the direction of the cursor and
+     * returns it, or returns boost::none if there is no such Record.
+     *
+     * Only supported by cursors of RecordStores for which supportsSeekAtOrPast() returns true.
+     */
+    virtual boost::optional<Record> seekAtOrPast(const RecordId& start) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -471,6 +481,17 @@ public:
         return false;
     }
 
+    /**
+     * Can cursors over this RecordStore be positioned on an arbitrary, possibly non-existent,
+     * RecordId using SeekableRecordCursor::seekAtOrPast()?
+     *
+     * This allows the RecordId space of the RecordStore to be divided into ranges which are
+     * scanned independently, for instance by a parallel collection scan.
+     */
+    virtual bool supportsSeekAtOrPast() const {
+        return false;
+    }
+
     /**
      * Performs record store specific validation to ensure consistency of underlying data
      * structures. If corruption is found, details of the errors will be in the results parameter.
@@ -502,8 +523,17 @@ public:
     }
 
     /**
-     * Return the RecordId of an oplog entry as close to startingPosition as possible without
-     * being higher. If there are no entries <= startingPosition, return RecordId().
+     * Returns true if RecordIds in this RecordStore are derived from each document's _id rather
+     * than generated by the storage engine. See clustered_id.h.
+     */
+    virtual bool isClustered() const {
+        return false;
+    }
+
+    /**
+     * Return the RecordId of an oplog entry, or of a document in a clustered collection, as close
+     * to startingPosition as possible without being higher. If there are no entries <=
+     * startingPosition, return RecordId().
      *
      * If you don't implement the oplogStartHack, just use the default implementation which
      * returns boost::none.
@@ -348,6 +348,14 @@ public:
         return false;
     }
 
+    /**
+     * Returns true if the storage engine can create collections whose RecordIds are derived from
+     * the _id of each document. See clustered_id.h.
+     */
+    virtual bool supportsClusteredIdCollections() const {
+        return false;
+    }
+
     virtual bool supportsReadConcernMajority() const {
         return false;
     }
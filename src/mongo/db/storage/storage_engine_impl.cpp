@@ -784,6 +784,10 @@ bool StorageEngineImpl::supportsReadConcernSnapshot() const {
     return _engine->supportsReadConcernSnapshot();
 }
 
+bool StorageEngineImpl::supportsClusteredIdCollections() const {
+    return _engine->supportsClusteredIdCollections();
+}
+
 bool StorageEngineImpl::supportsReadConcernMajority() const {
     return _engine->supportsReadConcernMajority();
 }
@@ -147,6 +147,8 @@ public:
 
     bool supportsReadConcernSnapshot() const final;
 
+    bool supportsClusteredIdCollections() const final;
+
     bool supportsReadConcernMajority() const final;
 
     bool supportsOplogStones() const final;
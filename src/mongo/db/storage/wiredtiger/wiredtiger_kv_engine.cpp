@@ -1218,6 +1218,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedCallback = nullptr;
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
+    params.isClustered = options.clustered;
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -1889,6 +1890,10 @@ bool WiredTigerKVEngine::supportsReadConcernSnapshot() const {
     return true;
 }
 
+bool WiredTigerKVEngine::supportsClusteredIdCollections() const {
+    return true;
+}
+
 bool WiredTigerKVEngine::supportsReadConcernMajority() const {
     return _keepDataHistory;
 }
@@ -236,6 +236,8 @@ public:
 
     bool supportsReadConcernSnapshot() const final override;
 
+    bool supportsClusteredIdCollections() const final override;
+
     bool supportsOplogStones() const final override;
 
     /*
@@ -51,6 +51,8 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -641,6 +643,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _uri(WiredTigerKVEngine::kTableUriPrefix + params.ident),
       _ident(params.ident),
       _tableId(WiredTigerSession::genTableId()),
+      _noOverwriteTableId(WiredTigerSession::genTableId()),
       _engineName(params.engineName),
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
@@ -650,6 +653,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
                     getGlobalReplSettings().usingReplSets() ||
                         repl::ReplSettings::shouldRecoverFromOplogAsStandalone())),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClustered(params.isClustered),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -1255,7 +1259,11 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     if (_isCapped && totalLength > _cappedMaxSize)
         return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
 
-    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    // Clustered collections must not silently overwrite an existing document with the same _id.
+    // Their inserts use cursors opened with overwrite=false, which are cached under a table id of
+    // their own.
+    WiredTigerCursor curwrap(
+        _uri, _isClustered ? _noOverwriteTableId : _tableId, !_isClustered, opCtx);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
     invariant(c);
@@ -1270,6 +1278,15 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            StatusWith<RecordId> status =
+                clustered_id::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
+            // Documents in a batch are not required to be in _id order.
+            highestId = std::max(highestId, record.id);
+            continue;
         } else if (_isCapped) {
             record.id = _nextId();
         } else {
@@ -1302,6 +1319,13 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         WiredTigerItem value(record.data.data(), record.data.size());
         c->set_value(c, value.Get());
         int ret = WT_OP_CHECK(c->insert(c));
+        if (ret == WT_DUPLICATE_KEY) {
+            invariant(_isClustered);
+            return buildDupKeyErrorStatus(BSONObj(record.data.data())["_id"].wrap(""),
+                                          NamespaceString(ns()),
+                                          "_id_",
+                                          BSON("_id" << 1));
+        }
         if (ret)
             return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
     }
@@ -1592,6 +1616,22 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
     OperationContext* opCtx, const RecordId& startingPosition) const {
     dassert(opCtx->lockState()->isReadLocked());
 
+    if (_isClustered) {
+        WiredTigerCursor cursor(_uri, _tableId, true, opCtx);
+        WT_CURSOR* c = cursor.get();
+
+        int cmp;
+        setKey(c, startingPosition);
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+        if (ret == 0 && cmp > 0)
+            ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
+        if (ret == WT_NOTFOUND)
+            return RecordId();
+        invariantWTOK(ret);
+
+        return getKey(c);
+    }
+
     if (!_isOplog)
         return boost::none;
 
@@ -1896,6 +1936,55 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+boost::optional<Record> WiredTigerRecordStoreCursorBase::seekAtOrPast(const RecordId& start) {
+    invariant(_hasRestored);
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+    setKey(c, start);
+
+    int cmp;
+    // Nothing after the next line can throw WCEs.
+    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+    if (ret == WT_NOTFOUND) {
+        _eof = true;
+        return {};
+    }
+    invariantWTOK(ret);
+
+    // 'search_near' may land on the record on either side of 'start'. If it landed behind 'start'
+    // in the direction of the scan, the record we want is the adjacent one.
+    if ((_forward && cmp < 0) || (!_forward && cmp > 0)) {
+        ret = wiredTigerPrepareConflictRetry(_opCtx,
+                                             [&] { return _forward ? c->next(c) : c->prev(c); });
+        if (ret == WT_NOTFOUND) {
+            _eof = true;
+            return {};
+        }
+        invariantWTOK(ret);
+    }
+
+    RecordId id;
+    if (hasWrongPrefix(c, &id)) {
+        _eof = true;
+        return {};
+    }
+    if (!id.isValid()) {
+        id = getKey(c);
+    }
+
+    if (_oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
+        _eof = true;
+        return {};
+    }
+
+    WT_ITEM value;
+    invariantWTOK(c->get_value(c, &value));
+
+    _lastReturnedId = id;
+    _eof = false;
+    return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+}
+
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
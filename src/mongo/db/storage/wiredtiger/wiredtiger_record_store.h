@@ -112,6 +112,7 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        bool isClustered = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -129,6 +130,10 @@ public:
 
     virtual bool isCapped() const;
 
+    bool isClustered() const final {
+        return _isClustered;
+    }
+
     virtual int64_t storageSize(OperationContext* opCtx,
                                 BSONObjBuilder* extraInfo = nullptr,
                                 int infoLevel = 0) const;
@@ -184,6 +189,10 @@ public:
         return true;
     }
 
+    bool supportsSeekAtOrPast() const final {
+        return true;
+    }
+
     virtual void validate(OperationContext* opCtx,
                           ValidateResults* results,
                           BSONObjBuilder* output);
@@ -327,6 +336,9 @@ private:
     const std::string _uri;
     const std::string _ident;
     const uint64_t _tableId;  // not persisted
+    // Identifies the cached cursors opened with overwrite=false, which must never be handed out to
+    // users of '_tableId' or vice versa. Not persisted.
+    const uint64_t _noOverwriteTableId;
 
     // Canonical engine name to use for retrieving options
     const std::string _engineName;
@@ -338,6 +350,8 @@ private:
     const bool _isLogged;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if RecordIds are derived from the _id of each document. See clustered_id.h.
+    const bool _isClustered;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -417,6 +431,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    boost::optional<Record> seekAtOrPast(const RecordId& start);
+
     void save();
 
     void saveUnpositioned();
@@ -33,9 +33,12 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -45,7 +48,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -197,11 +202,22 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+
+// There is little to gain from more shards than cores, and each idle session is only reachable
+// from other shards by stealing.
+size_t numSessionCacheShards() {
+    return std::max(1UL, std::min(ProcessInfo::getNumAvailableCores(), 128UL));
+}
+
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
     : _engine(engine),
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _shards(numSessionCacheShards()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
@@ -209,6 +225,7 @@ WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource*
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _shards(numSessionCacheShards()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -267,19 +284,65 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
+    Timer waitTimer;
+    stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+
+    // A flush which is already in progress may have started before the caller's last write, so
+    // only one which starts from now on is sure to cover it.
+    const uint64_t flushNeeded = _lastFlushStarted + 1;
+    ++_numWaitersForNextFlush;
+    if (_gatheringWaiters) {
+        _groupCommitArrivalCond.notify_one();
+    }
+
+    while (_lastFlushCompleted < flushNeeded) {
+        if (_flushInProgress) {
+            _groupCommitFlushedCond.wait(lk);
+            continue;
+        }
+
+        // Nobody is flushing, so flush for ourselves and every waiter which arrived after the
+        // last flush started.
+        _flushInProgress = true;
+        _gatherGroupCommitWaiters(lk);
+        const uint64_t flush = ++_lastFlushStarted;
+        const uint64_t batchSize = std::exchange(_numWaitersForNextFlush, 0);
+
+        lk.unlock();
+        _flushForGroupCommit();
+        lk.lock();
+
+        _lastFlushCompleted = flush;
+        _flushInProgress = false;
+        _avgFlushBatchSize = 0.875 * _avgFlushBatchSize + 0.125 * batchSize;
+        _groupCommitStats.flushes++;
+        _groupCommitStats.waiters += batchSize;
+        _groupCommitStats.maxBatchSize =
+            std::max(_groupCommitStats.maxBatchSize, static_cast<long long>(batchSize));
+        _groupCommitFlushedCond.notify_all();
+    }
+
+    _groupCommitStats.totalWaitMicros += waitTimer.micros();
+}
+
+void WiredTigerSessionCache::_gatherGroupCommitWaiters(stdx::unique_lock<stdx::mutex>& lk) {
+    // A lone writer should not wait for company which is not coming.
+    const int maxDelayMicros = gWiredTigerGroupCommitMaxDelayMicros.load();
+    if (maxDelayMicros <= 0 || _avgFlushBatchSize < 2) {
         return;
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    const auto expectedBatchSize = static_cast<uint64_t>(_avgFlushBatchSize);
+    Timer delayTimer;
+    _gatheringWaiters = true;
+    _groupCommitArrivalCond.wait_for(lk, Microseconds(maxDelayMicros).toSystemDuration(), [&] {
+        return _numWaitersForNextFlush >= expectedBatchSize;
+    });
+    _gatheringWaiters = false;
+    _groupCommitStats.totalDelayMicros += delayTimer.micros();
+}
 
+void WiredTigerSessionCache::_flushForGroupCommit() {
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
     stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
@@ -321,9 +384,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto& shard : _shards) {
+        scoped_spinlock lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -331,15 +396,53 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto& shard : _shards) {
+        scoped_spinlock lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto& shard : _shards) {
+        count += shard.numSessions.load();
+    }
+    return count;
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long numReused = 0;
+    long long numStolen = 0;
+    long long numCreated = 0;
+    long long numIdle = 0;
+    for (auto& shard : _shards) {
+        numReused += shard.numReused.loadRelaxed();
+        numStolen += shard.numStolen.loadRelaxed();
+        numCreated += shard.numCreated.loadRelaxed();
+        numIdle += shard.numSessions.loadRelaxed();
+    }
+
+    {
+        BSONObjBuilder bob(builder->subobjStart("sessionCache"));
+        bob.append("shards", static_cast<long long>(_shards.size()));
+        bob.append("idleSessions", numIdle);
+        bob.append("sessionsReused", numReused);
+        bob.append("sessionsStolen", numStolen);
+        bob.append("sessionsCreated", numCreated);
+        bob.done();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+    BSONObjBuilder bob(builder->subobjStart("groupCommit"));
+    bob.append("flushes", _groupCommitStats.flushes);
+    bob.append("waiters", _groupCommitStats.waiters);
+    bob.append("maxBatchSize", _groupCommitStats.maxBatchSize);
+    bob.append("recentAverageBatchSize", _avgFlushBatchSize);
+    bob.append("totalWaitMicros", _groupCommitStats.totalWaitMicros);
+    bob.append("totalDelayMicros", _groupCommitStats.totalDelayMicros);
+    bob.done();
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -349,30 +452,35 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    for (auto& shard : _shards) {
+        scoped_spinlock lock(shard.lock);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = shard.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
             }
         }
+        shard.numSessions.store(shard.sessions.size());
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // the shards are emptied, so a session released to a shard after it has been emptied is seen
+    // to be from an old epoch and is freed rather than cached.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto& shard : _shards) {
+        scoped_spinlock lock(shard.lock);
+        swap.insert(swap.end(), shard.sessions.begin(), shard.sessions.end());
+        shard.sessions.clear();
+        shard.numSessions.store(0);
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -389,20 +497,34 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            // Reset the idle time
-            cachedSession->setIdleExpireTime(Date_t::min());
-            return UniqueWiredTigerSession(cachedSession);
+    // Look in this thread's own shard first, then steal from the others, skipping those which
+    // look empty without taking their locks.
+    const size_t homeIndex = _homeShardIndex();
+    Shard& home = _shards[homeIndex];
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        Shard& shard = _shards[(homeIndex + i) % _shards.size()];
+        if (shard.numSessions.loadRelaxed() == 0) {
+            continue;
         }
+
+        scoped_spinlock lock(shard.lock);
+        if (shard.sessions.empty()) {
+            continue;
+        }
+
+        // Get the most recently used session so that if we discard sessions, we're
+        // discarding older ones
+        WiredTigerSession* cachedSession = shard.sessions.back();
+        shard.sessions.pop_back();
+        shard.numSessions.store(shard.sessions.size());
+        (i == 0 ? home.numReused : home.numStolen).fetchAndAdd(1);
+        // Reset the idle time
+        cachedSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(cachedSession);
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
+    home.numCreated.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -457,10 +579,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        Shard& home = _shards[_homeShardIndex()];
+        scoped_spinlock lock(home.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            home.sessions.push_back(session);
+            home.numSessions.store(home.sessions.size());
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -473,6 +597,13 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+size_t WiredTigerSessionCache::_homeShardIndex() const {
+    // Threads are spread over the shards in the order they first use a session cache.
+    static AtomicWord<unsigned> nextThreadIndex{0};
+    static thread_local const unsigned threadIndex = nextThreadIndex.fetchAndAdd(1);
+    return threadIndex % _shards.size();
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
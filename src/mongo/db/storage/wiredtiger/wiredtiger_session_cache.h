@@ -31,17 +31,22 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -96,7 +101,8 @@ public:
      * error if the record does not exist.
      *
      * This may return a cursor from the cursor cache and these cursors should *always* be released
-     * into the cache by calling releaseCursor().
+     * into the cache by calling releaseCursor(). Cached cursors are found by 'id' alone, so every
+     * cursor with the same 'id' must be opened with the same 'allowOverwrite'.
      */
     WT_CURSOR* getCursor(const std::string& uri, uint64_t id, bool allowOverwrite);
 
@@ -191,6 +197,10 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into shards, one per core, each with its own lock. Every thread is assigned
+ *  a home shard, which it releases sessions to and looks for them in first, only stealing from
+ *  the other shards when its own is empty.
  */
 class WiredTigerSessionCache {
 public:
@@ -223,6 +233,13 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Appends the number of sessions this cache has handed out from a thread's own shard, stolen
+     * from another shard, and newly created, and the number and sizes of the group commits done
+     * by waitUntilDurable(), for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -257,6 +274,9 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers not forcing a checkpoint share journal flushes: all callers which arrive
+     * while a flush is in progress are woken together by the next one.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
@@ -317,9 +337,24 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    struct Shard {
+        SpinLock lock;
+        SessionCache sessions;  // guarded by 'lock'
+
+        // The size of 'sessions', which can be read without the lock to skip empty shards.
+        AtomicWord<size_t> numSessions{0};
+
+        // Counts of how the sessions handed out to the threads whose home this shard is were found.
+        AtomicWord<long long> numReused{0};
+        AtomicWord<long long> numStolen{0};
+        AtomicWord<long long> numCreated{0};
+    };
+
+    // Cache aligned so that threads working on different shards do not share cache lines.
+    using AlignedShard = CacheAligned<Shard>;
+    std::vector<AlignedShard, boost::alignment::aligned_allocator<AlignedShard>> _shards;
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -327,9 +362,31 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicWord<unsigned long long> _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicWord<unsigned> _lastSyncTime;
-    stdx::mutex _lastSyncMutex;
+    // Group commit for waitUntilDurable. Journal flushes are numbered in the order they start, and
+    // only one is in progress at a time. A waiter needs the first flush to start after it arrives,
+    // so waiters arriving while a flush is in progress are all covered by the next one, which the
+    // first of them to find no flush in progress performs for the others.
+    mutable stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _groupCommitFlushedCond;  // Notified when a flush completes.
+    stdx::condition_variable _groupCommitArrivalCond;  // Notified when a waiter arrives.
+    uint64_t _lastFlushStarted = 0;                    // guarded by _groupCommitMutex
+    uint64_t _lastFlushCompleted = 0;                  // guarded by _groupCommitMutex
+    bool _flushInProgress = false;                     // guarded by _groupCommitMutex
+    bool _gatheringWaiters = false;                    // guarded by _groupCommitMutex
+    uint64_t _numWaitersForNextFlush = 0;              // guarded by _groupCommitMutex
+
+    // A moving average of the number of waiters each flush covers, which decides whether it is
+    // worth holding the next flush back for more waiters to arrive.
+    double _avgFlushBatchSize = 1;  // guarded by _groupCommitMutex
+
+    struct GroupCommitStats {
+        long long flushes = 0;
+        long long waiters = 0;
+        long long maxBatchSize = 0;
+        long long totalWaitMicros = 0;
+        long long totalDelayMicros = 0;
+    };
+    GroupCommitStats _groupCommitStats;  // guarded by _groupCommitMutex
 
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
@@ -349,6 +406,25 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Called by the waiter which is about to flush the journal for a group of waiters. When
+     * recent flushes have covered several waiters, waits up to wiredTigerGroupCommitMaxDelayMicros
+     * for about as many to have arrived, so that one flush covers them all.
+     */
+    void _gatherGroupCommitWaiters(stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Flushes the journal, or takes a checkpoint when there is no journal, and reports the last
+     * write before it as durable to the journal listener.
+     */
+    void _flushForGroupCommit();
+
+    /**
+     * Returns the index of the shard the current thread releases sessions to and looks for them in
+     * first.
+     */
+    size_t _homeShardIndex() const;
 };
 
 /**
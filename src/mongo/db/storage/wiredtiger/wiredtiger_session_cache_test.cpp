@@ -33,8 +33,10 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -113,4 +115,87 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+BSONObj getSessionCacheStats(WiredTigerSessionCache* sessionCache) {
+    BSONObjBuilder bob;
+    sessionCache->appendStats(&bob);
+    return bob.obj()["sessionCache"].Obj().getOwned();
+}
+
+TEST(WiredTigerSessionCacheTest, ReuseSessionReleasedByAnotherThread) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Release a session to the shard of another thread.
+    stdx::thread([&] { UniqueWiredTigerSession session = sessionCache->getSession(); }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // This thread finds it whether or not both threads share a shard, rather than creating one.
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    BSONObj stats = getSessionCacheStats(sessionCache);
+    ASSERT_EQUALS(stats["sessionsCreated"].numberLong(), 1);
+    ASSERT_EQUALS(stats["sessionsReused"].numberLong() + stats["sessionsStolen"].numberLong(), 1);
+    ASSERT_EQUALS(stats["idleSessions"].numberLong(), 1);
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllEmptiesEveryShard) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Release sessions to the shards of several threads.
+    const int kNumThreads = 4;
+    std::vector<UniqueWiredTigerSession> sessions;
+    for (int i = 0; i < kNumThreads; ++i) {
+        sessions.push_back(sessionCache->getSession());
+    }
+    std::vector<stdx::thread> threads;
+    for (auto& session : sessions) {
+        threads.emplace_back([&session] { session.reset(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), static_cast<size_t>(kNumThreads));
+
+    // A session held across closeAll() is freed rather than cached when released.
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    session.reset();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, ConcurrentWaitUntilDurableShareFlushes) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    const int kNumThreads = 8;
+    const int kWaitsPerThread = 20;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kWaitsPerThread; ++j) {
+                sessionCache->waitUntilDurable(/*forceCheckpoint=*/false,
+                                               /*stableCheckpoint=*/false);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every wait is covered by exactly one flush, and no flush happens without a waiter.
+    BSONObjBuilder bob;
+    sessionCache->appendStats(&bob);
+    BSONObj stats = bob.obj()["groupCommit"].Obj().getOwned();
+    ASSERT_EQUALS(stats["waiters"].numberLong(), kNumThreads * kWaitsPerThread);
+    ASSERT_GTE(stats["flushes"].numberLong(), 1);
+    ASSERT_LTE(stats["flushes"].numberLong(), kNumThreads * kWaitsPerThread);
+    ASSERT_LTE(stats["maxBatchSize"].numberLong(), kNumThreads);
+}
+
 }  // namespace mongo
@@ -95,6 +95,16 @@ public:
     }
 
     virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        const bool isClustered = false;
+        return newNonCappedRecordStore(ns, isClustered);
+    }
+
+    std::unique_ptr<RecordStore> newClusteredRecordStore(const std::string& ns) {
+        const bool isClustered = true;
+        return newNonCappedRecordStore(ns, isClustered);
+    }
+
+    std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns, bool isClustered) {
         WiredTigerRecoveryUnit* ru =
             checked_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -123,6 +133,7 @@ public:
         params.cappedMaxDocs = -1;
         params.cappedCallback = nullptr;
         params.sizeStorer = nullptr;
+        params.isClustered = isClustered;
 
         auto ret = std::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
         ret->postConstructorInit(&opCtx);
@@ -297,6 +308,70 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+TEST(WiredTigerRecordStoreTest, ClusteredInsertOfDuplicateIdFails) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newClusteredRecordStore("a.clustered"));
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    const BSONObj original = BSON("_id" << 1 << "v" << 1);
+    RecordId id;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res =
+            rs->insertRecord(opCtx.get(), original.objdata(), original.objsize(), Timestamp());
+        ASSERT_OK(res.getStatus());
+        id = res.getValue();
+        uow.commit();
+    }
+
+    // Leave an overwriting cursor on the table in the session's cursor cache.
+    const BSONObj updated = BSON("_id" << 1 << "v" << 2);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), id, updated.objdata(), updated.objsize()));
+        uow.commit();
+    }
+
+    const BSONObj duplicate = BSON("_id" << 1 << "v" << 3);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res =
+            rs->insertRecord(opCtx.get(), duplicate.objdata(), duplicate.objsize(), Timestamp());
+        ASSERT_EQ(ErrorCodes::DuplicateKey, res.getStatus());
+    }
+
+    ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+    ASSERT_BSONOBJ_EQ(updated, rs->dataFor(opCtx.get(), id).toBson());
+}
+
+TEST(WiredTigerRecordStoreTest, ClusteredUpdateAfterInsertOnSameSession) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newClusteredRecordStore("a.clustered"));
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    // Leave a non-overwriting cursor on the table in the session's cursor cache.
+    const BSONObj original = BSON("_id" << 2 << "v" << 1);
+    RecordId id;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res =
+            rs->insertRecord(opCtx.get(), original.objdata(), original.objsize(), Timestamp());
+        ASSERT_OK(res.getStatus());
+        id = res.getValue();
+        uow.commit();
+    }
+
+    const BSONObj updated = BSON("_id" << 2 << "v" << 2);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), id, updated.objdata(), updated.objsize()));
+        uow.commit();
+    }
+
+    ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+    ASSERT_BSONOBJ_EQ(updated, rs->dataFor(opCtx.get(), id).toBson());
+}
+
 class SizeStorerUpdateTest : public mongo::unittest::Test {
 private:
     virtual void setUp() {
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -151,6 +152,69 @@ public:
     }
 };
 
+/** Index creation generates keys on several threads and merges their sorted output. */
+class InsertBuildMultipleKeyGenerationThreads : public IndexBuildBase {
+public:
+    void run() {
+        const int numThreadsBefore = maxIndexBuildKeyGenerationThreads.load();
+        maxIndexBuildKeyGenerationThreads.store(4);
+        ON_BLOCK_EXIT([&] { maxIndexBuildKeyGenerationThreads.store(numThreadsBefore); });
+
+        // Create a new collection with enough documents for several batches, each of which makes
+        // the index multikey.
+        const int numDocs = 5000;
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            ASSERT_OK(db->dropCollection(&_opCtx, _nss));
+            coll = db->createCollection(&_opCtx, _nss);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < numDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << BSON_ARRAY(i << i + 1))),
+                    nullOpDebug,
+                    true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer;
+        const BSONObj spec = BSON("name"
+                                  << "a"
+                                  << "key" << BSON("a" << 1) << "v"
+                                  << static_cast<int>(kIndexVersion));
+
+        ON_BLOCK_EXIT([&] { indexer.cleanUpAfterBuild(&_opCtx, coll); });
+
+        ASSERT_OK(indexer.init(&_opCtx, coll, spec, MultiIndexBlock::kNoopOnInitFn).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(&_opCtx, coll));
+        ASSERT_OK(indexer.checkConstraints(&_opCtx));
+
+        WriteUnitOfWork wunit(&_opCtx);
+        ASSERT_OK(indexer.commit(
+            &_opCtx, coll, MultiIndexBlock::kNoopOnCreateEachFn, MultiIndexBlock::kNoopOnCommitFn));
+        wunit.commit();
+
+        const IndexDescriptor* desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a");
+        ASSERT(desc);
+        ASSERT(coll->getIndexCatalog()->getEntry(desc)->isMultikey(&_opCtx));
+
+        // Every value but the smallest and largest is indexed for two documents.
+        for (int value : {0, 1, numDocs / 2, numDocs - 1, numDocs}) {
+            auto cursor = _client.query(_nss, Query(BSON("a" << value)).hint(BSON("a" << 1)));
+            int count = 0;
+            while (cursor->more()) {
+                cursor->next();
+                ++count;
+            }
+            ASSERT_EQ(value == 0 || value == numDocs ? 1 : 2, count);
+        }
+    }
+};
+
 /** Index creation enforces unique constraints unless told not to. */
 template <bool background>
 class InsertBuildEnforceUnique : public IndexBuildBase {
@@ -640,6 +704,7 @@ public:
             add<InsertBuildEnforceUnique<true>>();
             add<InsertBuildEnforceUnique<false>>();
         }
+        add<InsertBuildMultipleKeyGenerationThreads>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIdIndexInterrupt>();
         add<SameSpecDifferentOption>();
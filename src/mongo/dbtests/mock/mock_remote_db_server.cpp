@@ -196,8 +196,19 @@ mongo::BSONArray MockRemoteDBServer::query(MockRemoteDBServer::InstanceID id,
 
     auto ns = nsOrUuid.uuid() ? _uuidToNs[*nsOrUuid.uuid()] : nsOrUuid.nss()->ns();
     const vector<BSONObj>& coll = _dataMgr[ns];
+    // Only the index bounds of the query are honored; the filter and everything else is ignored.
+    const BSONObj min = query.obj.getObjectField("$min");
+    const BSONObj max = query.obj.getObjectField("$max");
     BSONArrayBuilder result;
     for (vector<BSONObj>::const_iterator iter = coll.begin(); iter != coll.end(); ++iter) {
+        if (!min.isEmpty() &&
+            iter->extractFieldsUnDotted(min).woCompare(min, BSONObj(), false) < 0) {
+            continue;
+        }
+        if (!max.isEmpty() &&
+            iter->extractFieldsUnDotted(max).woCompare(max, BSONObj(), false) >= 0) {
+            continue;
+        }
         result.append(iter->copy());
     }
 
@@ -434,6 +434,56 @@ public:
     }
 };
 
+// Same as above, but the consumer needs only record ids, so the stage
+// falls back to intersecting record ids rather than failing.
+class QueryStageAndHashTwoLeafFirstChildLargeKeysRecordIdIntersection : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        // Generate large keys for {foo: 1, big: 1} index.
+        std::string big(512, 'a');
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "big" << big));
+        }
+
+        addIndex(BSON("foo" << 1 << "big" << 1));
+        addIndex(BSON("bar" << 1));
+
+        // Lower buffer limit to 20 * sizeof(big) to exceed it before hashed
+        // AND is done reading the first child.
+        WorkingSet ws;
+        auto ah = std::make_unique<AndHashStage>(&_opCtx, &ws, 20 * big.size());
+        ah->allowRecordIdIntersection();
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1 << "big" << 1), coll));
+        params.bounds.startKey = BSON("" << 20 << "" << big);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, nullptr));
+
+        // Bar <= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 10);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, nullptr));
+
+        // foo == bar for 0..10.
+        ASSERT_EQUALS(11, countResults(ah.get()));
+
+        const AndHashStats* stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT(stats->recordIdIntersection);
+        ASSERT_LESS_THAN_OR_EQUALS(ah->getMemUsage(), 20 * big.size());
+    }
+};
+
 // An AND with three children.
 // Add large keys (512 bytes) to index of last child to verify that
 // keys in last child are not buffered
@@ -1343,6 +1393,7 @@ public:
         add<QueryStageAndHashDeleteDuringYield>();
         add<QueryStageAndHashTwoLeaf>();
         add<QueryStageAndHashTwoLeafFirstChildLargeKeys>();
+        add<QueryStageAndHashTwoLeafFirstChildLargeKeysRecordIdIntersection>();
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
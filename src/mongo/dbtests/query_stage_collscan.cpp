@@ -42,15 +42,18 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace query_stage_collection_scan {
 
@@ -238,6 +241,103 @@ TEST_F(QueryStageCollectionScanTest, QueryStageCollscanObjectsInOrderBackward) {
     ASSERT_EQUALS(numObj(), count);
 }
 
+// Working the scan in batches produces the same results and stats as working it one result at a
+// time.
+TEST_F(QueryStageCollectionScanTest, QueryStageCollscanWorkBatchMatchesWork) {
+    AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+    auto collection = ctx.getCollection();
+
+    CollectionScanParams params;
+    params.direction = CollectionScanParams::FORWARD;
+    params.tailable = false;
+
+    BSONObj filterObj = BSON("foo" << BSON("$lt" << 25));
+    const boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(&_opCtx, nullptr));
+    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filterObj, expCtx);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+    WorkingSet singleWs;
+    CollectionScan singleScan(&_opCtx, collection, params, &singleWs, filterExpr.get());
+    vector<int> singleResults;
+    while (!singleScan.isEOF()) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        if (PlanStage::ADVANCED == singleScan.work(&id)) {
+            singleResults.push_back(singleWs.get(id)->obj.value()["foo"].numberInt());
+            singleWs.free(id);
+        }
+    }
+
+    WorkingSet batchWs;
+    CollectionScan batchScan(&_opCtx, collection, params, &batchWs, filterExpr.get());
+    vector<int> batchResults;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (PlanStage::IS_EOF != state) {
+        vector<WorkingSetID> ids;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        state = batchScan.workBatch(&batchWs, 7, &ids, &id);
+        ASSERT_LTE(ids.size(), 7U);
+        ASSERT(PlanStage::IS_EOF == state || PlanStage::ADVANCED == state ||
+               PlanStage::NEED_TIME == state);
+        for (auto&& resultId : ids) {
+            WorkingSetMember* member = batchWs.get(resultId);
+            ASSERT(member->obj.value().isOwned());
+            batchResults.push_back(member->obj.value()["foo"].numberInt());
+            batchWs.free(resultId);
+        }
+    }
+
+    ASSERT(singleResults == batchResults);
+    ASSERT_EQUALS(25U, batchResults.size());
+    ASSERT_EQUALS(singleScan.getCommonStats()->works, batchScan.getCommonStats()->works);
+    ASSERT_EQUALS(singleScan.getCommonStats()->advanced, batchScan.getCommonStats()->advanced);
+    ASSERT_EQUALS(singleScan.getCommonStats()->needTime, batchScan.getCommonStats()->needTime);
+}
+
+TEST_F(QueryStageCollectionScanTest, QueryStageParallelCollscanReturnsAllMatches) {
+    AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+    auto collection = ctx.getCollection();
+    if (!collection->getRecordStore()->supportsSeekAtOrPast()) {
+        return;
+    }
+
+    // Use a small chunk size so that each worker needs several rounds to scan its range.
+    const int originalChunkSize = internalQueryParallelCollectionScanChunkSize.load();
+    internalQueryParallelCollectionScanChunkSize.store(3);
+    ON_BLOCK_EXIT([&] { internalQueryParallelCollectionScanChunkSize.store(originalChunkSize); });
+
+    BSONObj filterObj = BSON("foo" << BSON("$lt" << 25));
+    const boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(&_opCtx, nullptr));
+    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filterObj, expCtx);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+    WorkingSet ws;
+    ParallelCollectionScan scan(&_opCtx, collection, 4, &ws, filterExpr.get());
+    vector<int> results;
+    while (!scan.isEOF()) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = scan.work(&id);
+        ASSERT_NE(PlanStage::FAILURE, state);
+        if (PlanStage::ADVANCED == state) {
+            results.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+            ws.free(id);
+        }
+    }
+
+    // The parallel scan returns documents in no particular order.
+    std::sort(results.begin(), results.end());
+    ASSERT_EQUALS(25U, results.size());
+    for (int i = 0; i < 25; ++i) {
+        ASSERT_EQUALS(i, results[i]);
+    }
+
+    auto stats = scan.getStats();
+    auto specificStats = static_cast<const ParallelCollectionScanStats*>(stats->specific.get());
+    ASSERT_EQUALS(static_cast<size_t>(numObj()), specificStats->docsTested);
+    ASSERT_EQUALS(25U, stats->common.advanced);
+}
+
 // Scan through half the objects, delete the one we're about to fetch, then expect to get the "next"
 // object we would have gotten after that.
 TEST_F(QueryStageCollectionScanTest, QueryStageCollscanDeleteUpcomingObject) {
@@ -34,6 +34,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/catalog/collection.h"
@@ -223,6 +224,69 @@ public:
     }
 };
 
+//
+// Test fetching in batches, with and without preserving the order of the child.
+//
+class FetchStageBatched : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(10), recordIds.size());
+
+        // The document with foo == 4 is deleted before it is fetched.
+        remove(BSON("foo" << 4));
+
+        // The child returns the RecordIds in descending order, in batches of 4, 4 and 2.
+        ASSERT(std::vector<int>({9, 8, 7, 6, 5, 3, 2, 1, 0}) ==
+               fetchAll(coll, recordIds, true /* preserveOrder */));
+        ASSERT(std::vector<int>({6, 7, 8, 9, 2, 3, 5, 0, 1}) ==
+               fetchAll(coll, recordIds, false /* preserveOrder */));
+    }
+
+private:
+    std::vector<int> fetchAll(Collection* coll,
+                              const set<RecordId>& recordIds,
+                              bool preserveOrder) {
+        WorkingSet ws;
+        auto mockStage = std::make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        FetchStage fetchStage(&_opCtx, &ws, mockStage.release(), nullptr, coll);
+        fetchStage.setBatchSize(4, preserveOrder);
+
+        std::vector<int> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = fetchStage.work(&id))) {
+            if (PlanStage::ADVANCED == state) {
+                results.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+            }
+        }
+
+        const FetchStats* stats = static_cast<const FetchStats*>(fetchStage.getSpecificStats());
+        ASSERT_EQUALS(size_t(3), stats->batches);
+        return results;
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -230,6 +294,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatched>();
     }
 };
 
@@ -560,6 +560,262 @@ TEST_F(QueryStageMultiPlanTest, MPSSummaryStats) {
     ASSERT_LTE(stats.totalKeysExamined, static_cast<size_t>(N));
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSTrialsCandidatesConcurrently) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10) << "bar" << (i % 7)));
+    }
+
+    addIndex(BSON("foo" << 1));
+    addIndex(BSON("bar" << 1));
+
+    const bool oldEnableParallelPlanEvaluation = internalQueryEnableParallelPlanEvaluation.load();
+    internalQueryEnableParallelPlanEvaluation.store(true);
+    ON_BLOCK_EXIT([&] {
+        internalQueryEnableParallelPlanEvaluation.store(oldEnableParallelPlanEvaluation);
+    });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("foo" << 7 << "bar" << 3));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    auto exec = uassertStatusOK(
+        getExecutor(opCtx(), coll, std::move(cq), PlanExecutor::WRITE_CONFLICT_RETRY_ONLY, 0));
+    ASSERT_EQ(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+
+    auto mps = static_cast<MultiPlanStage*>(exec->getRootStage());
+    ASSERT_TRUE(mps->bestPlanChosen());
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+    ASSERT_TRUE(mpsStats->concurrentTrial);
+    ASSERT_EQ(mpsStats->candidates.size(), 2U);
+    for (auto&& candidateStats : mpsStats->candidates) {
+        ASSERT_GT(candidateStats.rounds, 0U);
+    }
+
+    // Results buffered by the winner during the trial period are returned along with the rest.
+    int results = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+        ASSERT_EQ(obj["foo"].numberInt(), 7);
+        ASSERT_EQ(obj["bar"].numberInt(), 3);
+        ++results;
+    }
+    ASSERT_EQ(PlanExecutor::IS_EOF, state);
+
+    int expected = 0;
+    for (int i = 0; i < N; ++i) {
+        expected += (i % 10 == 7 && i % 7 == 3);
+    }
+    ASSERT_EQ(results, expected);
+
+    BSONObjBuilder bob;
+    Explain::explainStages(
+        exec.get(), coll, ExplainOptions::Verbosity::kExecAllPlans, BSONObj(), &bob);
+    auto allPlansStats = bob.done()["executionStats"]["allPlansExecution"].Array();
+    ASSERT_EQ(allPlansStats.size(), 2UL);
+    for (auto&& planStats : allPlansStats) {
+        ASSERT_TRUE(planStats["trialWallTimeMicros"].isNumber());
+        ASSERT_TRUE(planStats["trialCpuTimeMicros"].isNumber());
+    }
+}
+
+/**
+ * Enables concurrent trials of the candidate plans until destroyed.
+ */
+class EnableParallelPlanEvaluation {
+public:
+    EnableParallelPlanEvaluation() : _old(internalQueryEnableParallelPlanEvaluation.load()) {
+        internalQueryEnableParallelPlanEvaluation.store(true);
+    }
+
+    ~EnableParallelPlanEvaluation() {
+        internalQueryEnableParallelPlanEvaluation.store(_old);
+    }
+
+private:
+    const bool _old;
+};
+
+/**
+ * Adds an index scan for foo == 7 and a collection scan with the same filter to 'mps', each with
+ * a WorkingSet of its own so that they can be trialed concurrently.
+ */
+void addConcurrentCandidates(OperationContext* opCtx,
+                             const Collection* coll,
+                             MultiPlanStage* mps,
+                             MatchExpression* filter,
+                             WorkingSet* sharedWs) {
+    auto ixScanWs = std::make_unique<WorkingSet>();
+    auto ixScanRoot = getIxScanPlan(opCtx, coll, ixScanWs.get(), 7);
+    mps->addPlan(createQuerySolution(), ixScanRoot.release(), std::move(ixScanWs), sharedWs);
+
+    auto collScanWs = std::make_unique<WorkingSet>();
+    auto collScanRoot = getCollScanPlan(opCtx, coll, collScanWs.get(), filter);
+    mps->addPlan(createQuerySolution(), collScanRoot.release(), std::move(collScanWs), sharedWs);
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSConcurrentTrialStopsWhenOperationIsKilled) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+    addIndex(BSON("foo" << 1));
+
+    EnableParallelPlanEvaluation enableParallelPlanEvaluation;
+
+    // Kill a separate operation, so that the fixture can still clean up after the test.
+    auto client = serviceContext()->makeClient("killedOperation");
+    AlternativeClientRegion acr(client);
+    auto killedOpCtx = cc().makeOperationContext();
+
+    AutoGetCollectionForReadCommand ctx(killedOpCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    BSONObj filterObj = BSON("foo" << 7);
+    auto filter = makeMatchExpressionFromFilter(killedOpCtx.get(), filterObj);
+    auto cq = makeCanonicalQuery(killedOpCtx.get(), nss, filterObj);
+    WorkingSet sharedWs;
+    MultiPlanStage mps(killedOpCtx.get(), coll, cq.get(), MultiPlanStage::CachingMode::NeverCache);
+    addConcurrentCandidates(killedOpCtx.get(), coll, &mps, filter.get(), &sharedWs);
+
+    killedOpCtx->markKilled(ErrorCodes::Interrupted);
+
+    // The interrupt is reported before the operation gets a chance to yield, which would have
+    // failed with ExceededTimeLimit instead.
+    AlwaysTimeOutYieldPolicy alwaysTimeOutPolicy(serviceContext()->getFastClockSource());
+    ASSERT_EQ(ErrorCodes::Interrupted, mps.pickBestPlan(&alwaysTimeOutPolicy));
+
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps.getSpecificStats());
+    ASSERT_TRUE(mpsStats->concurrentTrial);
+    for (auto&& child : mps.getChildren()) {
+        ASSERT_EQ(0U, child->getStats()->common.works);
+    }
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSConcurrentTrialYieldsBetweenRounds) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+    addIndex(BSON("foo" << 1));
+
+    EnableParallelPlanEvaluation enableParallelPlanEvaluation;
+
+    // End every round after a single unit of work.
+    const int oldYieldPeriodMS = internalQueryExecYieldPeriodMS.load();
+    internalQueryExecYieldPeriodMS.store(0);
+    ON_BLOCK_EXIT([&] { internalQueryExecYieldPeriodMS.store(oldYieldPeriodMS); });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    BSONObj filterObj = BSON("foo" << 7);
+    auto filter = makeMatchExpressionFromFilter(_opCtx.get(), filterObj);
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, filterObj);
+    WorkingSet sharedWs;
+    MultiPlanStage mps(_opCtx.get(), coll, cq.get(), MultiPlanStage::CachingMode::NeverCache);
+    addConcurrentCandidates(_opCtx.get(), coll, &mps, filter.get(), &sharedWs);
+
+    // The operation yields through the policy once the first round is over.
+    AlwaysTimeOutYieldPolicy alwaysTimeOutPolicy(serviceContext()->getFastClockSource());
+    ASSERT_EQ(ErrorCodes::ExceededTimeLimit, mps.pickBestPlan(&alwaysTimeOutPolicy));
+
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps.getSpecificStats());
+    ASSERT_TRUE(mpsStats->concurrentTrial);
+    ASSERT_EQ(mpsStats->candidates.size(), 2U);
+    for (auto&& candidateStats : mpsStats->candidates) {
+        ASSERT_EQ(1U, candidateStats.rounds);
+    }
+    for (auto&& child : mps.getChildren()) {
+        ASSERT_EQ(1U, child->getStats()->common.works);
+    }
+
+    // The operation still holds its collection lock once planning is over.
+    ASSERT_TRUE(_opCtx->lockState()->isCollectionLockedForMode(nss, MODE_IS));
+}
+
+/**
+ * Records whether it is worked on behalf of an operation other than 'callerOpCtx', and whether
+ * 'callerOpCtx' holds its lock on 'nss' at the time. Hits EOF after 'numWorks' units of work.
+ */
+class LockCheckingStage final : public PlanStage {
+public:
+    LockCheckingStage(OperationContext* opCtx, const NamespaceString& nss, int numWorks)
+        : PlanStage("LOCK_CHECKING", opCtx), _callerOpCtx(opCtx), _nss(nss), _numWorks(numWorks) {}
+
+    bool isEOF() final {
+        return _works >= _numWorks;
+    }
+
+    StageState doWork(WorkingSetID* out) final {
+        // The caller waits for this round to finish, so its lock state cannot change under us.
+        workedOffCaller = workedOffCaller && getOpCtx() != _callerOpCtx;
+        callerHeldLock =
+            callerHeldLock && _callerOpCtx->lockState()->isCollectionLockedForMode(_nss, MODE_IS);
+        return ++_works >= _numWorks ? PlanStage::IS_EOF : PlanStage::NEED_TIME;
+    }
+
+    StageType stageType() const final {
+        return STAGE_EOF;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final {
+        _commonStats.isEOF = isEOF();
+        return std::make_unique<PlanStageStats>(_commonStats, STAGE_EOF);
+    }
+
+    const SpecificStats* getSpecificStats() const final {
+        return nullptr;
+    }
+
+    bool workedOffCaller = true;
+    bool callerHeldLock = true;
+
+private:
+    OperationContext* const _callerOpCtx;
+    const NamespaceString _nss;
+    const int _numWorks;
+    int _works = 0;
+};
+
+TEST_F(QueryStageMultiPlanTest, MPSConcurrentTrialRunsUnderCallersLocks) {
+    insert(BSON("foo" << 1));
+
+    EnableParallelPlanEvaluation enableParallelPlanEvaluation;
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, BSON("foo" << 1));
+    WorkingSet sharedWs;
+    MultiPlanStage mps(_opCtx.get(), coll, cq.get(), MultiPlanStage::CachingMode::NeverCache);
+
+    std::vector<LockCheckingStage*> stages;
+    for (int numWorks : {10, 20}) {
+        auto stage = std::make_unique<LockCheckingStage>(_opCtx.get(), nss, numWorks);
+        stages.push_back(stage.get());
+        mps.addPlan(
+            createQuerySolution(), stage.release(), std::make_unique<WorkingSet>(), &sharedWs);
+    }
+
+    AlwaysTimeOutYieldPolicy alwaysTimeOutPolicy(serviceContext()->getFastClockSource());
+    ASSERT_OK(mps.pickBestPlan(&alwaysTimeOutPolicy));
+
+    // A candidate may not have been worked at all if the other one hit EOF first.
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps.getSpecificStats());
+    ASSERT_TRUE(mpsStats->concurrentTrial);
+    size_t totalWorks = 0;
+    for (auto&& stage : stages) {
+        totalWorks += stage->getStats()->common.works;
+        ASSERT_TRUE(stage->workedOffCaller);
+        ASSERT_TRUE(stage->callerHeldLock);
+    }
+    ASSERT_GT(totalWorks, 0U);
+}
+
 TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfExceedsTimeLimitDuringPlanning) {
     const int N = 5000;
     for (int i = 0; i < N; ++i) {
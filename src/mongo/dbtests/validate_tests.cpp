@@ -830,7 +830,8 @@ public:
                          IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
                          &keys,
                          nullptr,
-                         nullptr);
+                         nullptr,
+                         id1);
             auto removeStatus =
                 iam->removeKeys(&_opCtx, {keys.begin(), keys.end()}, id1, options, &numDeleted);
             auto insertStatus = iam->insert(&_opCtx, badKey, id1, options, &insertResult);
@@ -1260,7 +1261,8 @@ public:
                          IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
                          &keys,
                          nullptr,
-                         nullptr);
+                         nullptr,
+                         rid);
             auto removeStatus =
                 iam->removeKeys(&_opCtx, {keys.begin(), keys.end()}, rid, options, &numDeleted);
 
@@ -133,6 +133,14 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
         OpMsg::appendChecksum(&dbresponse->response);
     }
 
+    // The command may have asked for a different body to be run as the next request.
+    if (dbresponse->nextInvocation) {
+        OpMsgRequest nextRequest;
+        nextRequest.body = *dbresponse->nextInvocation;
+        requestMsg = nextRequest.serialize();
+        OpMsg::setFlag(&requestMsg, OpMsg::kExhaustSupported);
+    }
+
     // Return an augmented form of the initial request, which is to be used as the next request to
     // be processed by the database. The id of the response is used as the request id of this
     // 'synthetic' request. Re-checksum if needed.
@@ -89,6 +89,10 @@ public:
         if (_uassertInHandler)
             uassert(40469, "Synthetic uassert failure", false);
 
+        if (request.operation() == dbMsg) {
+            _lastRequestBody = OpMsg::parseOwned(request).body;
+        }
+
         DbResponse dbResponse;
         if (OpMsg::isFlagSet(request, OpMsg::kExhaustSupported)) {
             auto reply = OpMsg::parse(res);
@@ -96,6 +100,7 @@ public:
             if (reply.body["ok"].trueValue() && !cursorObj.isEmpty()) {
                 dbResponse.exhaustCursorId = cursorObj.getField("id").numberLong();
                 dbResponse.exhaustNS = cursorObj.getField("ns").String();
+                dbResponse.nextInvocation = _nextInvocation;
             }
         }
         dbResponse.response = res;
@@ -127,6 +132,14 @@ public:
         _responseMessage = std::move(m);
     }
 
+    void setNextInvocation(boost::optional<BSONObj> nextInvocation) {
+        _nextInvocation = std::move(nextInvocation);
+    }
+
+    BSONObj lastRequestBody() const {
+        return _lastRequestBody;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -139,6 +152,12 @@ private:
 
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
+
+    // The body of the next exhaust request to return from 'handleRequest', if any.
+    boost::optional<BSONObj> _nextInvocation;
+
+    // The body of the last request passed to 'handleRequest'.
+    BSONObj _lastRequestBody;
 };
 
 using namespace transport;
@@ -490,6 +509,42 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaust) {
     ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
 }
 
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustUsesNextInvocation) {
+    // Construct a 'getMore' OP_MSG request with the exhaust flag set.
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    Message getMoreWithExhaust = getMoreRequestWithExhaust(nss, cursorId, initRequestId);
+
+    // Ask for a different body to be run as the next 'synthetic' exhaust request.
+    const BSONObj nextInvocation =
+        BSON("getMore" << cursorId << "collection" << nss << "lastKnownCommittedOpTime"
+                       << BSON("ts" << Timestamp(2, 1) << "t" << 1LL));
+    _sep->setNextInvocation(nextInvocation);
+
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()));
+    Message getMoreRes = buildOpMsg(getMoreResBody);
+    runSourceAndSinkTest(_tl, _sep, getMoreWithExhaust, getMoreRes, State::Process, State::Process);
+
+    auto msg = _tl->getLastSunk();
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    auto firstResponseId = msg.header().getId();
+
+    // End the stream on the next request, which should have been built from 'nextInvocation'.
+    _sep->setNextInvocation(boost::none);
+    _sep->setResponseMessage(buildOpMsg(BSON(
+        "ok" << 1 << "cursor" << BSON("id" << 0 << "ns" << nss << "nextBatch" << BSONArray()))));
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    ASSERT_BSONOBJ_EQ(nextInvocation, _sep->lastRequestBody());
+
+    msg = _tl->getLastSunk();
+    ASSERT_FALSE(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
+}
+
 TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAndEmptyResponseNamespace) {
     // Construct a 'getMore' OP_MSG request with the exhaust flag set.
     const int32_t initRequestId = 1;